@@ -0,0 +1,75 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// TheSuperHackers @feature Records the time spent in each phase of GameLogic::update for every
+// logic frame and writes it as one CSV row per frame. Used by replay simulation with -replayProfile.
+class LogicFrameProfiler
+{
+public:
+
+	enum Phase
+	{
+		PHASE_SCRIPT_ENGINE,
+		PHASE_TERRAIN_LOGIC,
+		PHASE_CRC,
+		PHASE_COMMAND_LIST,
+		PHASE_SLEEPY_UPDATES,
+		PHASE_AI,
+		PHASE_BUILD_ASSISTANT,
+		PHASE_PARTITION_MANAGER,
+		PHASE_DESTROY_LIST,
+		PHASE_WEAPON_LOCOMOTOR_STORES,
+		PHASE_OTHER, ///< Everything not listed above, e.g. the recorder, stats collector and victory conditions
+
+		PHASE_COUNT
+	};
+
+	LogicFrameProfiler();
+	~LogicFrameProfiler();
+
+	Bool open(const AsciiString& filename); ///< Create the CSV file and write the header row.
+	void close();
+	Bool isOpen() const { return m_file != NULL; }
+
+	void beginReplay(UnsignedInt replayIndex); ///< Set the value of the replay column for all following frames.
+
+	void beginFrame(UnsignedInt frame);
+	void endPhase(Phase phase); ///< Add the time since the previous phase ended to the given phase.
+	void endFrame(UnsignedInt objectCount, UnsignedInt sleepyUpdateCount, UnsignedInt pathfindQueueDepth);
+
+private:
+
+	Int64 now() const;
+
+	FILE* m_file;
+	Int64 m_ticksPerSec;
+	Int64 m_frameStart;
+	Int64 m_phaseStart;
+	Int64 m_phaseTicks[PHASE_COUNT];
+	UnsignedInt m_frame;
+	UnsignedInt m_replayIndex;
+	Bool m_inFrame;
+};
+
+// Only set while a profile is being recorded.
+extern LogicFrameProfiler* TheLogicFrameProfiler;
+
+#define LOGIC_FRAME_PROFILE_PHASE(phase) \
+	do { if (TheLogicFrameProfiler) TheLogicFrameProfiler->endPhase(LogicFrameProfiler::phase); } while (0)
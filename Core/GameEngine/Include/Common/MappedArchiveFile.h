@@ -0,0 +1,61 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Common/RAMFile.h"
+
+//===============================
+// MappedArchiveFile
+//===============================
+/**
+	* Read only RAMFile that points directly into a memory mapped archive instead of owning a copy
+	* of the data. The mapping is owned by the archive and must outlive every file opened from it,
+	* unless the file was given a view of its own that is released when the file is closed.
+	*/
+//===============================
+
+class MappedArchiveFile : public RAMFile
+{
+	MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE(MappedArchiveFile, "MappedArchiveFile")
+
+	public:
+
+		typedef void (*ReleaseViewFunc)( void *view, size_t viewSize );
+
+		MappedArchiveFile();
+		//virtual				~MappedArchiveFile();
+
+		Bool					openFromMappedView(const AsciiString& filename, const Char *data, Int size); ///< reference size bytes of mapped archive data without copying them.
+		Bool					openFromOwnedView(const AsciiString& filename, void *view, size_t viewSize, const Char *data, Int size, ReleaseViewFunc releaseView); ///< like openFromMappedView, but the file owns the view that data points into.
+
+		virtual Bool	open( const Char *filename, Int access = NONE, size_t bufferSize = 0 ) { DEBUG_CRASH(("MappedArchiveFile can only be opened from a mapped view.")); return FALSE; }
+		virtual Bool	open( File *file ) { DEBUG_CRASH(("MappedArchiveFile can only be opened from a mapped view.")); return FALSE; }
+		virtual Bool	openFromArchive(File *archiveFile, const AsciiString& filename, Int offset, Int size) { DEBUG_CRASH(("MappedArchiveFile can only be opened from a mapped view.")); return FALSE; }
+		virtual void	close( void );
+
+		virtual char* readEntireAndClose();								///< returns a copy, because the caller deletes the buffer and the mapped data does not belong to us.
+
+	protected:
+
+		void					releaseView( void );
+
+		void					*m_view;						///< view owned by this file, or NULL if the archive owns the mapping
+		size_t				m_viewSize;
+		ReleaseViewFunc	m_releaseView;
+};
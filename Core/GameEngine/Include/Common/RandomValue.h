@@ -35,5 +35,7 @@ extern void InitRandom( UnsignedInt seed );
 extern void InitGameLogicRandom( UnsignedInt seed ); ///< Set the GameLogic seed to a known value at game start
 extern UnsignedInt GetGameLogicRandomSeed( void );   ///< Get the seed (used for replays)
 extern UnsignedInt GetGameLogicRandomSeedCRC( void );///< Get the seed (used for CRCs)
+extern void GetGameLogicRandomState( UnsignedInt state[6] );	///< Get the full GameLogic generator state (used for replay checkpoints)
+extern void SetGameLogicRandomState( const UnsignedInt state[6] );	///< Restore a state from GetGameLogicRandomState
 
 //--------------------------------------------------------------------------------------------------------------
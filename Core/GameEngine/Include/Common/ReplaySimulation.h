@@ -26,7 +26,10 @@ public:
 	// Simulate a list of replays without graphics.
 	// Returns exit code 1 if mismatch or other error occurred
 	// Returns exit code 0 if all replays were successfully simulated without mismatches
-	static int simulateReplays(const std::vector<AsciiString> &filenames, int maxProcesses);
+	// TheSuperHackers @feature The worker arguments are passed on to every worker process, so that options
+	// which change how a replay is checked also apply with -jobs. They must not contain spaces.
+	static int simulateReplays(const std::vector<AsciiString> &filenames, int maxProcesses,
+		const std::vector<AsciiString> &workerArguments = std::vector<AsciiString>());
 
 	static void stop() { s_isRunning = false; }
 
@@ -37,7 +40,9 @@ public:
 private:
 
 	static int simulateReplaysInThisProcess(const std::vector<AsciiString> &filenames);
-	static int simulateReplaysInWorkerProcesses(const std::vector<AsciiString> &filenames, int maxProcesses);
+	static int simulateReplaysInWorkerProcesses(const std::vector<AsciiString> &filenames, int maxProcesses,
+		const std::vector<AsciiString> &workerArguments);
+	static int simulateReplaysWithProfile(const std::vector<AsciiString> &filenames, int maxProcesses);
 	static std::vector<AsciiString> resolveFilenameWildcards(const std::vector<AsciiString> &filenames);
 
 private:
@@ -18,6 +18,10 @@
 
 #pragma once
 
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
 // Helper class that allows you to start a worker process and retrieve its exit code
 // and console output as a string.
 // It also makes sure that the started process is killed in case our process exits in any way.
@@ -26,7 +30,13 @@ class WorkerProcess
 public:
 	WorkerProcess();
 
+#ifdef _WIN32
+	// command is the full command line, including the quoted executable path
 	bool startProcess(UnicodeString command);
+#else
+	// arguments[0] is the path of the executable, the rest are passed to it unchanged
+	bool startProcess(const std::vector<AsciiString>& arguments);
+#endif
 
 	void update();
 
@@ -47,9 +57,14 @@ private:
 	bool fetchStdOutput();
 
 private:
+#ifdef _WIN32
 	HANDLE m_processHandle;
 	HANDLE m_readHandle;
 	HANDLE m_jobHandle;
+#else
+	pid_t m_processId;
+	int m_readFd;
+#endif
 	AsciiString m_stdOutput;
 	DWORD m_exitcode;
 	bool m_isDone;
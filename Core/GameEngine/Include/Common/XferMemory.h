@@ -0,0 +1,89 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: XferMemory.h /////////////////////////////////////////////////////////////////////////////
+// Desc:   Xfer memory buffer write and read implementations
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
+#include "Common/XferLoad.h"
+#include "Common/XferSave.h"
+
+//-------------------------------------------------------------------------------------------------
+/** TheSuperHackers @feature Writes the same data layout as XferSave, but into a growing memory
+	* buffer instead of a file. Used for game state checkpoints that never touch the disk */
+//-------------------------------------------------------------------------------------------------
+class XferMemorySave : public XferSave
+{
+
+public:
+
+	XferMemorySave( void );
+	virtual ~XferMemorySave( void );
+
+	// Xfer methods
+	virtual void open( AsciiString identifier );		///< start writing into an empty buffer
+	virtual void close( void );											///< stop writing, the buffer is kept
+	virtual Int beginBlock( void );									///< write placeholder block size
+	virtual void endBlock( void );									///< back patch the size of the last begin block
+	virtual void skip( Int dataSize );							///< skipping during a write appends zeros
+
+	const UnsignedByte *getData( void ) const { return m_buffer.empty() ? NULL : &m_buffer[0]; }
+	Int getDataSize( void ) const { return (Int)m_buffer.size(); }
+	void swapData( std::vector<UnsignedByte> &data ) { m_buffer.swap( data ); }	///< hand the written data over without a copy
+
+protected:
+
+	virtual void xferImplementation( void *data, Int dataSize );		///< the xfer implementation
+
+	std::vector<UnsignedByte> m_buffer;										///< the written data
+	std::vector<size_t> m_blockOffsets;										///< stack of begin block offsets
+	Bool m_isOpen;
+
+};
+
+//-------------------------------------------------------------------------------------------------
+/** TheSuperHackers @feature Reads data written by XferMemorySave from a memory buffer owned by
+	* the caller. The buffer must stay alive until the xfer is closed */
+//-------------------------------------------------------------------------------------------------
+class XferMemoryLoad : public XferLoad
+{
+
+public:
+
+	XferMemoryLoad( const UnsignedByte *data, Int dataSize );
+	virtual ~XferMemoryLoad( void );
+
+	// Xfer methods
+	virtual void open( AsciiString identifier );				///< start reading at the buffer start
+	virtual void close( void );													///< stop reading
+	virtual Int beginBlock( void );											///< read placeholder block size
+	virtual void skip( Int dataSize );									///< skip forward dataSize bytes in the buffer
+
+protected:
+
+	virtual void xferImplementation( void *data, Int dataSize );		///< the xfer implementation
+
+	const UnsignedByte *m_data;												///< the buffer to read from
+	Int m_dataSize;																		///< size of the buffer in bytes
+	Int m_readPos;																		///< current read position in the buffer
+	Bool m_isOpen;
+
+};
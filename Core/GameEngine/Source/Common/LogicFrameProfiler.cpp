@@ -0,0 +1,145 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "Common/LogicFrameProfiler.h"
+
+
+LogicFrameProfiler* TheLogicFrameProfiler = NULL;
+
+static const char* const s_phaseColumnNames[LogicFrameProfiler::PHASE_COUNT] =
+{
+	"script_us",
+	"terrain_us",
+	"crc_us",
+	"commands_us",
+	"sleepy_us",
+	"ai_us",
+	"build_assistant_us",
+	"partition_us",
+	"destroy_list_us",
+	"weapon_locomotor_us",
+	"other_us",
+};
+
+LogicFrameProfiler::LogicFrameProfiler()
+	: m_file(NULL)
+	, m_ticksPerSec(1)
+	, m_frameStart(0)
+	, m_phaseStart(0)
+	, m_frame(0)
+	, m_replayIndex(0)
+	, m_inFrame(FALSE)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	m_ticksPerSec = freq.QuadPart;
+
+	for (Int i = 0; i < PHASE_COUNT; ++i)
+		m_phaseTicks[i] = 0;
+}
+
+LogicFrameProfiler::~LogicFrameProfiler()
+{
+	close();
+}
+
+Bool LogicFrameProfiler::open(const AsciiString& filename)
+{
+	close();
+
+	m_file = fopen(filename.str(), "w");
+	if (m_file == NULL)
+		return FALSE;
+
+	// Give the file a large buffer, we write one row per logic frame
+	setvbuf(m_file, NULL, _IOFBF, 64 * 1024);
+
+	fprintf(m_file, "replay,frame,total_us");
+	for (Int i = 0; i < PHASE_COUNT; ++i)
+		fprintf(m_file, ",%s", s_phaseColumnNames[i]);
+	fprintf(m_file, ",objects,sleepy_updates,pathfind_queue\n");
+
+	return TRUE;
+}
+
+void LogicFrameProfiler::close()
+{
+	if (m_file != NULL)
+	{
+		fclose(m_file);
+		m_file = NULL;
+	}
+	m_inFrame = FALSE;
+}
+
+void LogicFrameProfiler::beginReplay(UnsignedInt replayIndex)
+{
+	m_replayIndex = replayIndex;
+}
+
+Int64 LogicFrameProfiler::now() const
+{
+	LARGE_INTEGER tick;
+	QueryPerformanceCounter(&tick);
+	return tick.QuadPart;
+}
+
+void LogicFrameProfiler::beginFrame(UnsignedInt frame)
+{
+	for (Int i = 0; i < PHASE_COUNT; ++i)
+		m_phaseTicks[i] = 0;
+
+	m_frame = frame;
+	m_frameStart = now();
+	m_phaseStart = m_frameStart;
+	m_inFrame = TRUE;
+}
+
+void LogicFrameProfiler::endPhase(Phase phase)
+{
+	if (!m_inFrame)
+		return;
+
+	const Int64 tick = now();
+	m_phaseTicks[phase] += tick - m_phaseStart;
+	m_phaseStart = tick;
+}
+
+void LogicFrameProfiler::endFrame(UnsignedInt objectCount, UnsignedInt sleepyUpdateCount, UnsignedInt pathfindQueueDepth)
+{
+	if (!m_inFrame)
+		return;
+
+	m_inFrame = FALSE;
+
+	// Everything after the last explicit phase belongs to the remainder
+	const Int64 tick = now();
+	m_phaseTicks[PHASE_OTHER] += tick - m_phaseStart;
+
+	if (m_file == NULL)
+		return;
+
+	const double microsecondsPerTick = 1000000.0 / (double)m_ticksPerSec;
+
+	fprintf(m_file, "%u,%u,%u", m_replayIndex, m_frame, (UnsignedInt)((tick - m_frameStart) * microsecondsPerTick));
+	for (Int i = 0; i < PHASE_COUNT; ++i)
+		fprintf(m_file, ",%u", (UnsignedInt)(m_phaseTicks[i] * microsecondsPerTick));
+	fprintf(m_file, ",%u,%u,%u\n", objectCount, sleepyUpdateCount, pathfindQueueDepth);
+}
@@ -208,6 +208,18 @@ UnsignedInt GetGameLogicRandomSeedCRC( void )
 	return c.get();
 }
 
+// TheSuperHackers @feature The GameLogic generator state is not part of save games, so replay
+// checkpoints carry it separately to continue with the exact same random sequence.
+void GetGameLogicRandomState( UnsignedInt state[6] )
+{
+	memcpy(state, theGameLogicSeed, sizeof(theGameLogicSeed));
+}
+
+void SetGameLogicRandomState( const UnsignedInt state[6] )
+{
+	memcpy(theGameLogicSeed, state, sizeof(theGameLogicSeed));
+}
+
 void InitRandom( void )
 {
 #ifdef DETERMINISTIC
@@ -22,11 +22,16 @@
 
 #include "Common/GameEngine.h"
 #include "Common/LocalFileSystem.h"
+#include "Common/LogicFrameProfiler.h"
 #include "Common/Recorder.h"
 #include "Common/WorkerProcess.h"
 #include "GameLogic/GameLogic.h"
 #include "GameClient/GameClient.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 
 Bool ReplaySimulation::s_isRunning = false;
 UnsignedInt ReplaySimulation::s_replayIndex = 0;
@@ -34,17 +39,56 @@ UnsignedInt ReplaySimulation::s_replayCount = 0;
 
 namespace
 {
-int countProcessesRunning(const std::vector<WorkerProcess>& processes)
+struct ReplayJob
+{
+	ReplayJob() : frameCount(0), startTimeMillis(0), wallTimeMillis(0), exitcode(0) {}
+
+	AsciiString filename;
+	UnsignedInt frameCount; // from the replay header, 0 if the header could not be read
+	UnsignedInt startTimeMillis;
+	UnsignedInt wallTimeMillis;
+	DWORD exitcode;
+};
+
+struct ReplayWorker
+{
+	WorkerProcess process;
+	size_t jobIndex;
+	Bool timed;
+};
+
+struct LongerReplayFirst
+{
+	const std::vector<ReplayJob>* jobs;
+	bool operator()(size_t a, size_t b) const { return (*jobs)[a].frameCount > (*jobs)[b].frameCount; }
+};
+
+int countProcessesRunning(const std::vector<ReplayWorker>& workers)
 {
 	int numProcessesRunning = 0;
 	size_t i = 0;
-	for (; i < processes.size(); ++i)
+	for (; i < workers.size(); ++i)
 	{
-		if (processes[i].isRunning())
+		if (workers[i].process.isRunning())
 			++numProcessesRunning;
 	}
 	return numProcessesRunning;
 }
+
+// Print one line per replay in a fixed, comma separated format, so that build scripts can parse it.
+void printReplaySummary(const std::vector<ReplayJob>& jobs)
+{
+	printf("Replay Summary Begin\n");
+	printf("replay,exitcode,frames,wall_ms,frames_per_sec\n");
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		const ReplayJob& job = jobs[i];
+		const double framesPerSec = job.wallTimeMillis != 0 ? job.frameCount * 1000.0 / job.wallTimeMillis : 0.0;
+		printf("\"%s\",%u,%u,%u,%.1f\n",
+			job.filename.str(), (unsigned int)job.exitcode, job.frameCount, job.wallTimeMillis, framesPerSec);
+	}
+	printf("Replay Summary End\n");
+}
 } // namespace
 
 int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString> &filenames)
@@ -60,6 +104,8 @@ int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString
 		// If we are not in headless mode, we need to run the replay in the engine.
 		for (; s_replayIndex < s_replayCount; ++s_replayIndex)
 		{
+			if (TheLogicFrameProfiler)
+				TheLogicFrameProfiler->beginReplay(s_replayIndex);
 			TheRecorder->playbackFile(filenames[s_replayIndex]);
 			TheGameEngine->execute();
 			if (TheRecorder->sawCRCMismatch())
@@ -80,6 +126,8 @@ int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString
 		AsciiString filename = filenames[i];
 		printf("Simulating Replay \"%s\"\n", filename.str());
 		fflush(stdout);
+		if (TheLogicFrameProfiler)
+			TheLogicFrameProfiler->beginReplay(static_cast<UnsignedInt>(i));
 		DWORD startTimeMillis = GetTickCount();
 		if (TheRecorder->simulateReplay(filename))
 		{
@@ -129,62 +177,134 @@ int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString
 	return numErrors != 0 ? 1 : 0;
 }
 
-int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiString> &filenames, int maxProcesses)
+int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiString> &filenames, int maxProcesses,
+	const std::vector<AsciiString> &workerArguments)
 {
 	DWORD totalStartTimeMillis = GetTickCount();
 
+#ifdef _WIN32
 	WideChar exePath[1024];
 	GetModuleFileNameW(NULL, exePath, ARRAY_SIZE(exePath));
+#else
+	char exePath[1024];
+	ssize_t exePathLength = readlink("/proc/self/exe", exePath, ARRAY_SIZE(exePath)-1);
+	if (exePathLength <= 0)
+	{
+		printf("Cannot determine the path of this executable\n");
+		return 1;
+	}
+	exePath[exePathLength] = 0;
+#endif
+
+	// TheSuperHackers @performance Read the length of every replay first and start the longest ones first.
+	// Otherwise a long replay that happens to come last in the list holds up the whole batch at the end.
+	std::vector<ReplayJob> jobs(filenames.size());
+	std::vector<size_t> jobOrder(filenames.size());
+	for (size_t i = 0; i < filenames.size(); i++)
+	{
+		jobs[i].filename = filenames[i];
+		jobOrder[i] = i;
 
-	std::vector<WorkerProcess> processes;
+		RecorderClass::ReplayHeader header;
+		header.forPlayback = FALSE;
+		header.filename = filenames[i];
+		if (TheRecorder->readReplayHeader(header))
+			jobs[i].frameCount = header.frameCount;
+	}
+	LongerReplayFirst longerReplayFirst;
+	longerReplayFirst.jobs = &jobs;
+	std::stable_sort(jobOrder.begin(), jobOrder.end(), longerReplayFirst);
+
+	std::vector<ReplayWorker> workers;
 	int filenamePositionStarted = 0;
 	int filenamePositionDone = 0;
 	int numErrors = 0;
 
 	while (true)
 	{
-		int i;
-		for (i = 0; i < processes.size(); i++)
-			processes[i].update();
+		size_t i;
+		for (i = 0; i < workers.size(); i++)
+		{
+			workers[i].process.update();
 
-		// Get result of finished processes and print output in order
-		while (!processes.empty())
+			// Stop the clock as soon as the worker is done, not when it is its turn to print
+			if (workers[i].process.isDone() && !workers[i].timed)
+			{
+				ReplayJob& job = jobs[workers[i].jobIndex];
+				job.wallTimeMillis = GetTickCount() - job.startTimeMillis;
+				job.exitcode = workers[i].process.getExitCode();
+				workers[i].timed = TRUE;
+			}
+		}
+
+		// Get result of finished processes and print output in the order they were started
+		while (!workers.empty())
 		{
-			if (!processes[0].isDone())
+			if (!workers[0].process.isDone())
 				break;
-			AsciiString stdOutput = processes[0].getStdOutput();
+			AsciiString stdOutput = workers[0].process.getStdOutput();
 			printf("%d/%d %s", filenamePositionDone+1, (int)filenames.size(), stdOutput.str());
-			DWORD exitcode = processes[0].getExitCode();
+			DWORD exitcode = workers[0].process.getExitCode();
 			if (exitcode != 0)
 				printf("Error!\n");
 			fflush(stdout);
 			numErrors += exitcode == 0 ? 0 : 1;
-			processes.erase(processes.begin());
+			workers.erase(workers.begin());
 			filenamePositionDone++;
 		}
 
-		int numProcessesRunning = countProcessesRunning(processes);
+		int numProcessesRunning = countProcessesRunning(workers);
 
 		// Add new processes when we are below the limit and there are replays left
 		while (numProcessesRunning < maxProcesses && filenamePositionStarted < filenames.size())
 		{
+			const size_t jobIndex = jobOrder[filenamePositionStarted];
+			ReplayJob& job = jobs[jobIndex];
+
+			workers.push_back(ReplayWorker());
+			workers.back().jobIndex = jobIndex;
+			workers.back().timed = FALSE;
+			job.startTimeMillis = GetTickCount();
+
+#ifdef _WIN32
 			UnicodeString filenameWide;
-			filenameWide.translate(filenames[filenamePositionStarted]);
+			filenameWide.translate(job.filename);
 			UnicodeString command;
-			command.format(L"\"%s\"%s%s -replay \"%s\"",
+			command.format(L"\"%s\"%s%s",
 				exePath,
 				TheGlobalData->m_windowed ? L" -win" : L"",
-				TheGlobalData->m_headless ? L" -headless" : L"",
-				filenameWide.str());
+				TheGlobalData->m_headless ? L" -headless" : L"");
+			for (size_t a = 0; a < workerArguments.size(); a++)
+			{
+				UnicodeString argumentWide;
+				argumentWide.translate(workerArguments[a]);
+				command.concat(L' ');
+				command.concat(argumentWide);
+			}
+			UnicodeString replayArgument;
+			replayArgument.format(L" -replay \"%s\"", filenameWide.str());
+			command.concat(replayArgument);
+
+			workers.back().process.startProcess(command);
+#else
+			std::vector<AsciiString> arguments;
+			arguments.push_back(exePath);
+			if (TheGlobalData->m_windowed)
+				arguments.push_back("-win");
+			if (TheGlobalData->m_headless)
+				arguments.push_back("-headless");
+			arguments.insert(arguments.end(), workerArguments.begin(), workerArguments.end());
+			arguments.push_back("-replay");
+			arguments.push_back(job.filename);
 
-			processes.push_back(WorkerProcess());
-			processes.back().startProcess(command);
+			workers.back().process.startProcess(arguments);
+#endif
 
 			filenamePositionStarted++;
 			numProcessesRunning++;
 		}
 
-		if (processes.empty())
+		if (workers.empty())
 			break;
 
 		// Don't waste CPU here, our workers need every bit of CPU time they can get
@@ -198,11 +318,40 @@ int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiSt
 
 	UnsignedInt realTime = (GetTickCount()-totalStartTimeMillis) / 1000;
 	printf("Total Wall Time: %d:%02d:%02d\n", realTime/60/60, realTime/60%60, realTime%60);
+
+	printReplaySummary(jobs);
 	fflush(stdout);
 
 	return numErrors != 0 ? 1 : 0;
 }
 
+int ReplaySimulation::simulateReplaysWithProfile(const std::vector<AsciiString> &filenames, int maxProcesses)
+{
+	// Worker processes would compete for the CPU and distort each other's timings,
+	// so profiled replays are always simulated one after another in this process.
+	if (maxProcesses != SIMULATE_REPLAYS_SEQUENTIAL)
+		printf("Ignoring -jobs because -replayProfile is used\n");
+
+	LogicFrameProfiler profiler;
+	if (!profiler.open(TheGlobalData->m_replayProfileFile))
+	{
+		printf("Cannot open profile file \"%s\"\n", TheGlobalData->m_replayProfileFile.str());
+		return 1;
+	}
+
+	// The replay column in the profile is the index into this list
+	for (size_t i = 0; i < filenames.size(); i++)
+		printf("Profile Replay %d: \"%s\"\n", (int)i, filenames[i].str());
+	fflush(stdout);
+
+	TheLogicFrameProfiler = &profiler;
+	int exitcode = simulateReplaysInThisProcess(filenames);
+	TheLogicFrameProfiler = NULL;
+	profiler.close();
+
+	return exitcode;
+}
+
 std::vector<AsciiString> ReplaySimulation::resolveFilenameWildcards(const std::vector<AsciiString> &filenames)
 {
 	// If some filename contains wildcards, search for actual filenames.
@@ -245,11 +394,14 @@ std::vector<AsciiString> ReplaySimulation::resolveFilenameWildcards(const std::v
 	return filenamesResolved;
 }
 
-int ReplaySimulation::simulateReplays(const std::vector<AsciiString> &filenames, int maxProcesses)
+int ReplaySimulation::simulateReplays(const std::vector<AsciiString> &filenames, int maxProcesses,
+	const std::vector<AsciiString> &workerArguments)
 {
 	std::vector<AsciiString> filenamesResolved = resolveFilenameWildcards(filenames);
+	if (TheGlobalData->m_replayProfileFile.isNotEmpty())
+		return simulateReplaysWithProfile(filenamesResolved, maxProcesses);
 	if (maxProcesses == SIMULATE_REPLAYS_SEQUENTIAL)
 		return simulateReplaysInThisProcess(filenamesResolved);
 	else
-		return simulateReplaysInWorkerProcesses(filenamesResolved, maxProcesses);
+		return simulateReplaysInWorkerProcesses(filenamesResolved, maxProcesses, workerArguments);
 }
@@ -0,0 +1,132 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PreRTS.h"
+
+#include "Common/MappedArchiveFile.h"
+
+
+//=================================================================
+// MappedArchiveFile::MappedArchiveFile
+//=================================================================
+
+MappedArchiveFile::MappedArchiveFile()
+	: m_view(NULL)
+	, m_viewSize(0)
+	, m_releaseView(NULL)
+{
+}
+
+//=================================================================
+// MappedArchiveFile::~MappedArchiveFile
+//=================================================================
+
+MappedArchiveFile::~MappedArchiveFile()
+{
+	// The data belongs to the archive mapping, so RAMFile must not delete it.
+	m_data = NULL;
+	releaseView();
+}
+
+//=================================================================
+// MappedArchiveFile::openFromMappedView
+//=================================================================
+
+Bool MappedArchiveFile::openFromMappedView(const AsciiString& filename, const Char *data, Int size)
+{
+	if (data == NULL && size != 0) {
+		return FALSE;
+	}
+
+	if (File::open(filename.str(), File::READ | File::BINARY) == FALSE) {
+		return FALSE;
+	}
+
+	// RAMFile never writes through m_data, and nothing else can because this file is read only.
+	m_data = const_cast<Char *>(data);
+	m_size = size;
+	m_pos = 0;
+	m_nameStr = filename;
+
+	return TRUE;
+}
+
+//=================================================================
+// MappedArchiveFile::openFromOwnedView
+//=================================================================
+
+Bool MappedArchiveFile::openFromOwnedView(const AsciiString& filename, void *view, size_t viewSize, const Char *data, Int size, ReleaseViewFunc releaseView)
+{
+	if (openFromMappedView(filename, data, size) == FALSE) {
+		return FALSE;
+	}
+
+	m_view = view;
+	m_viewSize = viewSize;
+	m_releaseView = releaseView;
+
+	return TRUE;
+}
+
+//=================================================================
+// MappedArchiveFile::close
+//=================================================================
+
+void MappedArchiveFile::close( void )
+{
+	m_data = NULL;
+	releaseView();
+	RAMFile::close();
+}
+
+//=================================================================
+// MappedArchiveFile::releaseView
+//=================================================================
+
+void MappedArchiveFile::releaseView( void )
+{
+	if (m_view != NULL && m_releaseView != NULL) {
+		m_releaseView(m_view, m_viewSize);
+	}
+
+	m_view = NULL;
+	m_viewSize = 0;
+	m_releaseView = NULL;
+}
+
+//=================================================================
+// MappedArchiveFile::readEntireAndClose
+//=================================================================
+/**
+	The caller owns the returned buffer and frees it with delete[], so a pointer
+	into the mapping cannot be handed out and the data has to be copied here.
+	This is the one copy a RAMFile made when it was opened, so callers of this
+	function pay what they did before, and every other reader gets the data
+	without a copy.
+*/
+char* MappedArchiveFile::readEntireAndClose()
+{
+	char* tmp = MSGNEW("RAMFILE") char [ m_size > 0 ? m_size : 1 ];
+	if (m_data != NULL && m_size > 0) {
+		memcpy(tmp, m_data, m_size);
+	}
+
+	close();
+
+	return tmp;
+}
@@ -0,0 +1,275 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: XferMemory.cpp ///////////////////////////////////////////////////////////////////////////
+// Desc:   Xfer implementations for saving to and loading from a memory buffer
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+#include "Common/Debug.h"
+#include "Common/XferMemory.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// XferMemorySave /////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferMemorySave::XferMemorySave( void )
+{
+
+	m_isOpen = FALSE;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferMemorySave::~XferMemorySave( void )
+{
+
+	DEBUG_ASSERTCRASH( m_blockOffsets.empty(), ("XferMemorySave::~XferMemorySave - begin block without end block") );
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Start writing into an empty buffer, 'identifier' is only used for error reporting */
+//-------------------------------------------------------------------------------------------------
+void XferMemorySave::open( AsciiString identifier )
+{
+
+	if( m_isOpen )
+	{
+
+		DEBUG_CRASH(( "Cannot open '%s' cause we've already got '%s' open",
+									identifier.str(), m_identifier.str() ));
+		throw XFER_FILE_ALREADY_OPEN;
+
+	}
+
+	// call base class
+	Xfer::open( identifier );
+
+	m_buffer.clear();
+	m_blockOffsets.clear();
+	m_isOpen = TRUE;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Stop writing. The written data stays available through getData() */
+//-------------------------------------------------------------------------------------------------
+void XferMemorySave::close( void )
+{
+
+	if( m_isOpen == FALSE )
+	{
+
+		DEBUG_CRASH(( "Xfer close called, but no buffer was open" ));
+		throw XFER_FILE_NOT_OPEN;
+
+	}
+
+	m_isOpen = FALSE;
+	m_identifier.clear();
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Write a placeholder block size and remember where it is, just like XferSave::beginBlock */
+//-------------------------------------------------------------------------------------------------
+Int XferMemorySave::beginBlock( void )
+{
+
+	m_blockOffsets.push_back( m_buffer.size() );
+
+	XferBlockSize blockSize = 0;
+	xferImplementation( &blockSize, sizeof( XferBlockSize ) );
+
+	return XFER_OK;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Back patch the size of the data written since the last begin block */
+//-------------------------------------------------------------------------------------------------
+void XferMemorySave::endBlock( void )
+{
+
+	if( m_blockOffsets.empty() )
+	{
+
+		DEBUG_CRASH(( "Xfer end block called, but no matching begin block was found" ));
+		throw XFER_BEGIN_END_MISMATCH;
+
+	}
+
+	const size_t blockOffset = m_blockOffsets.back();
+	m_blockOffsets.pop_back();
+
+	XferBlockSize blockSize = (XferBlockSize)(m_buffer.size() - blockOffset - sizeof( XferBlockSize ));
+	memcpy( &m_buffer[ blockOffset ], &blockSize, sizeof( XferBlockSize ) );
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Skip forward 'dataSize' bytes, which leaves zeros like seeking past the end of a file does */
+//-------------------------------------------------------------------------------------------------
+void XferMemorySave::skip( Int dataSize )
+{
+
+	DEBUG_ASSERTCRASH( dataSize >= 0, ("XferMemorySave::skip - dataSize '%d' must be greater than 0", dataSize) );
+
+	m_buffer.resize( m_buffer.size() + dataSize, 0 );
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Perform the write operation */
+//-------------------------------------------------------------------------------------------------
+void XferMemorySave::xferImplementation( void *data, Int dataSize )
+{
+
+	DEBUG_ASSERTCRASH( m_isOpen, ("XferMemorySave - '%s' is not open", m_identifier.str()) );
+
+	const UnsignedByte *bytes = static_cast<const UnsignedByte *>( data );
+	m_buffer.insert( m_buffer.end(), bytes, bytes + dataSize );
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// XferMemoryLoad /////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferMemoryLoad::XferMemoryLoad( const UnsignedByte *data, Int dataSize )
+{
+
+	m_data = data;
+	m_dataSize = dataSize;
+	m_readPos = 0;
+	m_isOpen = FALSE;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferMemoryLoad::~XferMemoryLoad( void )
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Start reading at the beginning of the buffer */
+//-------------------------------------------------------------------------------------------------
+void XferMemoryLoad::open( AsciiString identifier )
+{
+
+	if( m_isOpen )
+	{
+
+		DEBUG_CRASH(( "Cannot open '%s' cause we've already got '%s' open",
+									identifier.str(), m_identifier.str() ));
+		throw XFER_FILE_ALREADY_OPEN;
+
+	}
+
+	// call base class
+	Xfer::open( identifier );
+
+	m_readPos = 0;
+	m_isOpen = TRUE;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void XferMemoryLoad::close( void )
+{
+
+	if( m_isOpen == FALSE )
+	{
+
+		DEBUG_CRASH(( "Xfer close called, but no buffer was open" ));
+		throw XFER_FILE_NOT_OPEN;
+
+	}
+
+	m_isOpen = FALSE;
+	m_identifier.clear();
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Read a block size descriptor from the buffer at the current position */
+//-------------------------------------------------------------------------------------------------
+Int XferMemoryLoad::beginBlock( void )
+{
+
+	if( m_readPos + (Int)sizeof( XferBlockSize ) > m_dataSize )
+	{
+
+		DEBUG_CRASH(( "Xfer - Error reading block size for '%s'", m_identifier.str() ));
+		return 0;
+
+	}
+
+	XferBlockSize blockSize;
+	memcpy( &blockSize, m_data + m_readPos, sizeof( XferBlockSize ) );
+	m_readPos += sizeof( XferBlockSize );
+
+	return blockSize;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Skip forward 'dataSize' bytes in the buffer */
+//-------------------------------------------------------------------------------------------------
+void XferMemoryLoad::skip( Int dataSize )
+{
+
+	DEBUG_ASSERTCRASH( dataSize >= 0, ("XferMemoryLoad::skip - dataSize '%d' must be greater than 0", dataSize) );
+
+	if( dataSize < 0 || m_readPos + dataSize > m_dataSize )
+		throw XFER_SKIP_ERROR;
+
+	m_readPos += dataSize;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Perform the read operation */
+//-------------------------------------------------------------------------------------------------
+void XferMemoryLoad::xferImplementation( void *data, Int dataSize )
+{
+
+	DEBUG_ASSERTCRASH( m_isOpen, ("XferMemoryLoad - '%s' is not open", m_identifier.str()) );
+
+	if( m_readPos + dataSize > m_dataSize )
+	{
+
+		DEBUG_CRASH(( "XferMemoryLoad - Error reading from '%s'", m_identifier.str() ));
+		throw XFER_READ_ERROR;
+
+	}
+
+	memcpy( data, m_data + m_readPos, dataSize );
+	m_readPos += dataSize;
+
+}
@@ -19,6 +19,8 @@
 #include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
 #include "Common/WorkerProcess.h"
 
+#ifdef _WIN32
+
 // We need Job-related functions, but these aren't defined in the Windows-headers that VC6 uses.
 // So we define them here and load them dynamically.
 #if defined(_MSC_VER) && _MSC_VER < 1300
@@ -128,21 +130,6 @@ bool WorkerProcess::isRunning() const
 	return m_processHandle != NULL;
 }
 
-bool WorkerProcess::isDone() const
-{
-	return m_isDone;
-}
-
-DWORD WorkerProcess::getExitCode() const
-{
-	return m_exitcode;
-}
-
-AsciiString WorkerProcess::getStdOutput() const
-{
-	return m_stdOutput;
-}
-
 bool WorkerProcess::fetchStdOutput()
 {
 	while (true)
@@ -229,3 +216,173 @@ void WorkerProcess::kill()
 	m_isDone = false;
 }
 
+#else // _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
+
+WorkerProcess::WorkerProcess()
+{
+	m_processId = -1;
+	m_readFd = -1;
+	m_exitcode = 0;
+	m_isDone = false;
+}
+
+bool WorkerProcess::startProcess(const std::vector<AsciiString>& arguments)
+{
+	m_stdOutput.clear();
+	m_isDone = false;
+
+	if (arguments.empty())
+		return false;
+
+	// Create pipe for reading console output.
+	// The read end must not be inherited by workers we start later, or their pipes never report end of file.
+	int fds[2];
+	if (pipe(fds) != 0)
+		return false;
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+	// Build the argument list before forking, the child must not allocate memory
+	std::vector<char*> argv;
+	for (size_t i = 0; i < arguments.size(); ++i)
+		argv.push_back(const_cast<char*>(arguments[i].str()));
+	argv.push_back(NULL);
+
+#if defined(__linux__)
+	const pid_t parentId = getpid();
+#endif
+	const pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(fds[0]);
+		close(fds[1]);
+		return false;
+	}
+
+	if (pid == 0)
+	{
+		// We are the child. Only async-signal-safe calls from here on.
+#if defined(__linux__)
+		// We want to make sure that when our process is killed, our workers automatically terminate as well.
+		// On Linux, the way to do this is to ask for a signal when the parent dies.
+		prctl(PR_SET_PDEATHSIG, SIGKILL);
+		if (getppid() != parentId)
+			_exit(1);
+#endif
+		dup2(fds[1], STDOUT_FILENO);
+		dup2(fds[1], STDERR_FILENO);
+		close(fds[0]);
+		close(fds[1]);
+		execv(argv[0], &argv[0]);
+		_exit(127);
+	}
+
+	close(fds[1]);
+	m_readFd = fds[0];
+	fcntl(m_readFd, F_SETFL, fcntl(m_readFd, F_GETFL) | O_NONBLOCK);
+	m_processId = pid;
+
+	return true;
+}
+
+bool WorkerProcess::isRunning() const
+{
+	return m_processId > 0;
+}
+
+bool WorkerProcess::fetchStdOutput()
+{
+	while (true)
+	{
+		// The pipe is non-blocking, so read won't block
+		DEBUG_ASSERTCRASH(m_readFd >= 0, ("Is not expected invalid"));
+		char buffer[1024];
+		ssize_t readBytes = read(m_readFd, buffer, ARRAY_SIZE(buffer)-1);
+		if (readBytes < 0)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+			{
+				// Child process is still running and we have all output so far
+				return false;
+			}
+			return true;
+		}
+		if (readBytes == 0)
+		{
+			// End of file, the child process closed its end of the pipe
+			return true;
+		}
+
+		buffer[readBytes] = 0;
+		m_stdOutput.concat(buffer);
+	}
+}
+
+void WorkerProcess::update()
+{
+	if (!isRunning())
+		return;
+
+	if (!fetchStdOutput())
+	{
+		// There is still potential output pending
+		return;
+	}
+
+	// Pipe broke, that means the process already exited. But we wait here just to make sure
+	int status = 0;
+	while (waitpid(m_processId, &status, 0) < 0 && errno == EINTR)
+	{
+	}
+	m_exitcode = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+	m_processId = -1;
+
+	close(m_readFd);
+	m_readFd = -1;
+
+	m_isDone = true;
+}
+
+void WorkerProcess::kill()
+{
+	if (!isRunning())
+		return;
+
+	::kill(m_processId, SIGKILL);
+	waitpid(m_processId, NULL, 0);
+	m_processId = -1;
+
+	if (m_readFd >= 0)
+	{
+		close(m_readFd);
+		m_readFd = -1;
+	}
+
+	m_stdOutput.clear();
+	m_isDone = false;
+}
+
+#endif // _WIN32
+
+bool WorkerProcess::isDone() const
+{
+	return m_isDone;
+}
+
+DWORD WorkerProcess::getExitCode() const
+{
+	return m_exitcode;
+}
+
+AsciiString WorkerProcess::getStdOutput() const
+{
+	return m_stdOutput;
+}
@@ -32,6 +32,22 @@
 #include "Common/AsciiString.h"
 #include "Common/List.h"
 
+// TheSuperHackers @performance Read only files are returned as views into the memory mapped BIG file
+// instead of being copied to the heap. 64 bit builds map every BIG file as a whole. A 32 bit process
+// does not have the address space for that, so there every large file is given a view of its own
+// while it is open, and small files are still copied.
+#ifndef RTS_BIG_FILE_MAPPING
+#define RTS_BIG_FILE_MAPPING 1
+#endif
+
+#if RTS_BIG_FILE_MAPPING && !defined(RTS_BIG_FILE_WHOLE_MAPPING)
+#if defined(_WIN64) || defined(__LP64__)
+#define RTS_BIG_FILE_WHOLE_MAPPING 1
+#else
+#define RTS_BIG_FILE_WHOLE_MAPPING 0
+#endif
+#endif
+
 class StdBIGFile : public ArchiveFile
 {
 	public:
@@ -48,6 +64,24 @@ class StdBIGFile : public ArchiveFile
 
 	protected:
 
+#if RTS_BIG_FILE_MAPPING
+		Bool					openMapping( void );											///< Map the BIG file read only. Returns FALSE if it cannot be mapped.
+		void					closeMapping( void );
+		File*					openMappedFile( const ArchivedFileInfo *fileInfo );	///< Returns NULL if the file has to be copied instead.
+#endif
+
 		AsciiString		m_name;		///< BIG file name
 		AsciiString		m_path;		///< BIG file path
+
+#if RTS_BIG_FILE_MAPPING
+#if RTS_BIG_FILE_WHOLE_MAPPING
+		const Char		*m_mappedData;	///< Start of the mapped BIG file, or NULL
+#elif defined(_WIN32)
+		void					*m_mappingHandle;	///< File mapping object the views of the files are mapped from, or NULL
+#else
+		int						m_mappingDescriptor;	///< File descriptor the views of the files are mapped from, or -1
+#endif
+		size_t				m_mappedSize;		///< Size of the mapped BIG file, or 0 if it cannot be mapped
+		Bool					m_mapAttempted;	///< Only try to map once, fall back to copying if that failed
+#endif
 };
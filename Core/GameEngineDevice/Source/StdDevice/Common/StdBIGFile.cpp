@@ -28,12 +28,30 @@
 
 #include "Common/LocalFile.h"
 #include "Common/LocalFileSystem.h"
+#include "Common/MappedArchiveFile.h"
 #include "Common/RAMFile.h"
 #include "Common/StreamingArchiveFile.h"
 #include "Common/GameMemory.h"
 #include "Common/PerfTimer.h"
 #include "StdDevice/Common/StdBIGFile.h"
 
+#if RTS_BIG_FILE_MAPPING
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if !RTS_BIG_FILE_WHOLE_MAPPING
+// Files smaller than this are copied. A view takes up at least one allocation granularity of address
+// space and costs a system call to map and unmap, which small files are not worth.
+static const UnsignedInt MIN_MAPPED_VIEW_FILE_SIZE = 64 * 1024;
+#endif
+#endif
+
 //============================================================================
 // StdBIGFile::StdBIGFile
 //============================================================================
@@ -41,6 +59,17 @@
 StdBIGFile::StdBIGFile(AsciiString name, AsciiString path)
 	: m_name(name)
 	, m_path(path)
+#if RTS_BIG_FILE_MAPPING
+#if RTS_BIG_FILE_WHOLE_MAPPING
+	, m_mappedData(NULL)
+#elif defined(_WIN32)
+	, m_mappingHandle(NULL)
+#else
+	, m_mappingDescriptor(-1)
+#endif
+	, m_mappedSize(0)
+	, m_mapAttempted(FALSE)
+#endif
 {
 
 }
@@ -51,7 +80,9 @@ StdBIGFile::StdBIGFile(AsciiString name, AsciiString path)
 
 StdBIGFile::~StdBIGFile()
 {
-
+#if RTS_BIG_FILE_MAPPING
+	closeMapping();
+#endif
 }
 
 //============================================================================
@@ -66,6 +97,16 @@ File* StdBIGFile::openFile( const Char *filename, Int access )
 		return NULL;
 	}
 
+#if RTS_BIG_FILE_MAPPING
+	// requesting read only access. Point straight into the mapped BIG file instead of copying the data.
+	if ((access & (File::WRITE | File::STREAMING)) == 0) {
+		File *mappedFile = openMappedFile(fileInfo);
+		if (mappedFile != NULL) {
+			return mappedFile;
+		}
+	}
+#endif
+
 	RAMFile *ramFile = NULL;
 
 	if (BitIsSet(access, File::STREAMING))
@@ -100,6 +141,209 @@ File* StdBIGFile::openFile( const Char *filename, Int access )
 	return localFile;
 }
 
+#if RTS_BIG_FILE_MAPPING
+
+//============================================================================
+// StdBIGFile::openMapping
+//============================================================================
+
+Bool StdBIGFile::openMapping( void )
+{
+	if (m_mapAttempted) {
+		return m_mappedSize != 0;
+	}
+	m_mapAttempted = TRUE;
+
+	if (m_file == NULL) {
+		return FALSE;
+	}
+
+	const char *archivePath = m_file->getName();
+	size_t fileSize = 0;
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(archivePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return FALSE;
+	}
+
+	LARGE_INTEGER fileSizeInfo;
+	if (!GetFileSizeEx(fileHandle, &fileSizeInfo) || fileSizeInfo.QuadPart <= 0 || (ULONGLONG)fileSizeInfo.QuadPart > (size_t)-1) {
+		CloseHandle(fileHandle);
+		return FALSE;
+	}
+	fileSize = (size_t)fileSizeInfo.QuadPart;
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fileHandle);
+	if (mappingHandle == NULL) {
+		return FALSE;
+	}
+
+#if RTS_BIG_FILE_WHOLE_MAPPING
+	// the view keeps the mapping object alive until it is unmapped.
+	void *view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mappingHandle);
+	if (view == NULL) {
+		return FALSE;
+	}
+	m_mappedData = static_cast<const Char *>(view);
+#else
+	// the views of the files are mapped from this object when they are opened.
+	m_mappingHandle = mappingHandle;
+#endif
+#else
+	int fd = ::open(archivePath, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return FALSE;
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0 || (unsigned long long)fileStat.st_size > (size_t)-1) {
+		::close(fd);
+		return FALSE;
+	}
+	fileSize = (size_t)fileStat.st_size;
+
+#if RTS_BIG_FILE_WHOLE_MAPPING
+	// the mapping stays valid after the descriptor is closed.
+	void *view = mmap(NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED) {
+		return FALSE;
+	}
+	m_mappedData = static_cast<const Char *>(view);
+#else
+	// the views of the files are mapped from this descriptor when they are opened.
+	m_mappingDescriptor = fd;
+#endif
+#endif
+
+	m_mappedSize = fileSize;
+
+	DEBUG_LOG(("StdBIGFile::openMapping - mapped %s, %u bytes", archivePath, (UnsignedInt)m_mappedSize));
+
+	return TRUE;
+}
+
+//============================================================================
+// StdBIGFile::closeMapping
+//============================================================================
+
+void StdBIGFile::closeMapping( void )
+{
+	if (m_mappedSize == 0) {
+		return;
+	}
+
+	// the views of files that are still open stay valid on their own.
+#if RTS_BIG_FILE_WHOLE_MAPPING
+#ifdef _WIN32
+	UnmapViewOfFile(m_mappedData);
+#else
+	munmap(const_cast<Char *>(m_mappedData), m_mappedSize);
+#endif
+	m_mappedData = NULL;
+#elif defined(_WIN32)
+	CloseHandle(m_mappingHandle);
+	m_mappingHandle = NULL;
+#else
+	::close(m_mappingDescriptor);
+	m_mappingDescriptor = -1;
+#endif
+
+	m_mappedSize = 0;
+}
+
+#if !RTS_BIG_FILE_WHOLE_MAPPING
+
+//============================================================================
+// getMappingGranularity
+//============================================================================
+
+static size_t getMappingGranularity( void )
+{
+#ifdef _WIN32
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	return systemInfo.dwAllocationGranularity;
+#else
+	return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+//============================================================================
+// releaseMappedView
+//============================================================================
+
+static void releaseMappedView( void *view, size_t viewSize )
+{
+#ifdef _WIN32
+	UnmapViewOfFile(view);
+#else
+	munmap(view, viewSize);
+#endif
+}
+
+#endif // !RTS_BIG_FILE_WHOLE_MAPPING
+
+//============================================================================
+// StdBIGFile::openMappedFile
+//============================================================================
+
+File* StdBIGFile::openMappedFile( const ArchivedFileInfo *fileInfo )
+{
+	if (openMapping() == FALSE || fileInfo->m_size > m_mappedSize || fileInfo->m_offset > m_mappedSize - fileInfo->m_size) {
+		return NULL;
+	}
+
+	MappedArchiveFile *mappedFile = NULL;
+
+#if RTS_BIG_FILE_WHOLE_MAPPING
+	mappedFile = newInstance( MappedArchiveFile );
+	mappedFile->deleteOnClose();
+	if (mappedFile->openFromMappedView(fileInfo->m_filename, m_mappedData + fileInfo->m_offset, fileInfo->m_size) == FALSE) {
+		mappedFile->close();
+		return NULL;
+	}
+#else
+	if (fileInfo->m_size < MIN_MAPPED_VIEW_FILE_SIZE) {
+		return NULL;
+	}
+
+	// a view has to start at a multiple of the allocation granularity.
+	static const size_t granularity = getMappingGranularity();
+	const size_t viewOffset = fileInfo->m_offset - fileInfo->m_offset % granularity;
+	const size_t viewSize = fileInfo->m_offset - viewOffset + fileInfo->m_size;
+
+#ifdef _WIN32
+	void *view = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, (DWORD)viewOffset, viewSize);
+	if (view == NULL) {
+		return NULL;
+	}
+#else
+	void *view = mmap(NULL, viewSize, PROT_READ, MAP_SHARED, m_mappingDescriptor, (off_t)viewOffset);
+	if (view == MAP_FAILED) {
+		return NULL;
+	}
+#endif
+
+	const Char *data = static_cast<const Char *>(view) + (fileInfo->m_offset - viewOffset);
+
+	mappedFile = newInstance( MappedArchiveFile );
+	mappedFile->deleteOnClose();
+	if (mappedFile->openFromOwnedView(fileInfo->m_filename, view, viewSize, data, fileInfo->m_size, releaseMappedView) == FALSE) {
+		releaseMappedView(view, viewSize);
+		mappedFile->close();
+		return NULL;
+	}
+#endif
+
+	return mappedFile;
+}
+
+#endif // RTS_BIG_FILE_MAPPING
+
 //============================================================================
 // StdBIGFile::closeAllFiles
 //============================================================================
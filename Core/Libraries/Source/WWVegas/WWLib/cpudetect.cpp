@@ -28,6 +28,13 @@
 #include <windows.h>
 #endif
 
+#if defined(_MSC_VER) && _MSC_VER >= 1700 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <immintrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#include <cpuid.h>
+#endif
+
 #ifdef _UNIX
 # include <time.h>  // for time(), localtime() and timezone variable.
 #endif
@@ -104,6 +111,7 @@ bool CPUDetectClass::HasCPUIDInstruction=false;
 bool CPUDetectClass::HasRDTSCInstruction=false;
 bool CPUDetectClass::HasSSESupport=false;
 bool CPUDetectClass::HasSSE2Support=false;
+bool CPUDetectClass::HasAVX2Support=false;
 bool CPUDetectClass::HasCMOVSupport=false;
 bool CPUDetectClass::HasMMXSupport=false;
 bool CPUDetectClass::Has3DNowSupport=false;
@@ -864,6 +872,36 @@ void CPUDetectClass::Init_CPUID_Instruction()
 #endif	// defined(_MSC_VER) && _MSC_VER < 1300
 }
 
+// TheSuperHackers @performance AVX2 needs both the CPU support and an OS that saves the YMM registers
+// on a context switch, which XGETBV reports. Compilers that cannot emit AVX2 code never report it.
+static bool Detect_AVX2_Support()
+{
+#if defined(_MSC_VER) && _MSC_VER >= 1700 && (defined(_M_IX86) || defined(_M_X64))
+	int regs[4];
+	__cpuid(regs, 0);
+	if (regs[0] < 7) return false;
+	__cpuid(regs, 1);
+	const int osxsave_and_avx = (1<<27)|(1<<28);
+	if ((regs[2] & osxsave_and_avx) != osxsave_and_avx) return false;
+	if ((_xgetbv(0) & 6) != 6) return false;	// XMM and YMM state
+	__cpuidex(regs, 7, 0);
+	return (regs[1] & (1<<5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+	unsigned int eax, ebx, ecx, edx;
+	if (__get_cpuid_max(0, NULL) < 7) return false;
+	__cpuid(1, eax, ebx, ecx, edx);
+	const unsigned int osxsave_and_avx = (1u<<27)|(1u<<28);
+	if ((ecx & osxsave_and_avx) != osxsave_and_avx) return false;
+	unsigned int xcr0_lo, xcr0_hi;
+	__asm__ __volatile__ ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+	if ((xcr0_lo & 6) != 6) return false;	// XMM and YMM state
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx & (1u<<5)) != 0;
+#else
+	return false;
+#endif
+}
+
 void CPUDetectClass::Init_Processor_Features()
 {
 	if (!CPUDetectClass::Has_CPUID_Instruction()) return;
@@ -875,6 +913,7 @@ void CPUDetectClass::Init_Processor_Features()
 	HasMMXSupport=(!!(FeatureBits&(1<<23)));
 	HasSSESupport=!!(FeatureBits&(1<<25));
 	HasSSE2Support=!!(FeatureBits&(1<<26));
+	HasAVX2Support=Detect_AVX2_Support();
 
 	Has3DNowSupport=false;
 	ExtendedFeatureBits=0;
@@ -1041,6 +1080,7 @@ void CPUDetectClass::Init_Processor_Log()
 	SYSLOG(("MMX: %s\r\n",CPUDetectClass::Has_MMX_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("SSE: %s\r\n",CPUDetectClass::Has_SSE_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("SSE2: %s\r\n",CPUDetectClass::Has_SSE2_Instruction_Set() ? "Yes" : "No"));
+	SYSLOG(("AVX2: %s\r\n",CPUDetectClass::Has_AVX2_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("3DNow!: %s\r\n",CPUDetectClass::Has_3DNow_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("Extended 3DNow!: %s\r\n",CPUDetectClass::Has_Extended_3DNow_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("CPU Feature bits: 0x%x\r\n",CPUDetectClass::Get_Feature_Bits()));
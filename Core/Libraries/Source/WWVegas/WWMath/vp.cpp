@@ -45,6 +45,22 @@
 #include "cpudetect.h"
 #include <memory.h>
 
+#if (defined(_MSC_VER) && _MSC_VER >= 1300 && (defined(_M_IX86) || defined(_M_X64))) || defined(__SSE__)
+#define VP_HAS_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
+// The AVX2 code is only ever run after CPUDetectClass has found AVX2, so the rest of the file is built without it.
+#if defined(VP_HAS_SSE_INTRINSICS) && defined(_MSC_VER) && _MSC_VER >= 1700
+#define VP_HAS_AVX2_INTRINSICS
+#define VP_TARGET_AVX2
+#include <immintrin.h>
+#elif defined(VP_HAS_SSE_INTRINSICS) && (defined(__GNUC__) || defined(__clang__))
+#define VP_HAS_AVX2_INTRINSICS
+#define VP_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
 #define SHUFFLE(x, y, z, w)	(((x)&3)<< 6|((y)&3)<<4|((z)&3)<< 2|((w)&3))
 #define	BROADCAST(XMM, INDEX)	__asm	shufps	XMM,XMM,(((INDEX)&3)<< 6|((INDEX)&3)<<4|((INDEX)&3)<< 2|((INDEX)&3))
 
@@ -324,6 +340,183 @@ void VectorProcessorClass::Transform(Vector4* dst,const Vector3 *src, const Matr
 	}
 }
 
+static inline const Matrix3D& Get_Bone_Transform(const Matrix3D* bone_tms, const int bone_tm_stride, const int bone)
+{
+	return *(const Matrix3D*)((const char*)bone_tms + bone * bone_tm_stride);
+}
+
+#ifdef VP_HAS_SSE_INTRINSICS
+/*
+** The bone transform is kept as four columns, with a zero in the fourth lane. Each output component is
+** summed in the same order as Matrix3D::mulVector3Array, so results match the scalar path exactly.
+*/
+static inline void Load_Bone_Columns(const Matrix3D& tm, __m128& c0, __m128& c1, __m128& c2, __m128& c3)
+{
+	c0 = _mm_loadu_ps(&tm[0][0]);
+	c1 = _mm_loadu_ps(&tm[1][0]);
+	c2 = _mm_loadu_ps(&tm[2][0]);
+	c3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+}
+
+static inline __m128 Transform_Column_Sum(const Vector3& v, const __m128& c0, const __m128& c1, const __m128& c2, const __m128& c3)
+{
+	__m128 r = _mm_mul_ps(c0, _mm_set1_ps(v.X));
+	r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(v.Y)));
+	r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(v.Z)));
+	return _mm_add_ps(r, c3);
+}
+
+static inline void Store_Vector3(Vector3* dst, const __m128& r)
+{
+	_mm_storel_pi((__m64*)&dst->X, r);
+	_mm_store_ss(&dst->Z, _mm_movehl_ps(r, r));
+}
+
+static void Transform_Skinned_SSE(Vector3* dst_vert, Vector3* dst_norm, const Vector3* src_vert, const Vector3* src_norm,
+	const unsigned short* bone_links, const Matrix3D* bone_tms, const int bone_tm_stride, const int count)
+{
+	const __m128 zero = _mm_setzero_ps();
+	__m128 c0, c1, c2, c3;
+	int bone = bone_links[0];
+	Load_Bone_Columns(Get_Bone_Transform(bone_tms, bone_tm_stride, bone), c0, c1, c2, c3);
+
+	for (int i = 0; i < count; i++)
+	{
+		if (bone_links[i] != bone)
+		{
+			bone = bone_links[i];
+			Load_Bone_Columns(Get_Bone_Transform(bone_tms, bone_tm_stride, bone), c0, c1, c2, c3);
+		}
+
+		Store_Vector3(dst_vert + i, Transform_Column_Sum(src_vert[i], c0, c1, c2, c3));
+		if (dst_norm)
+		{
+			// Normals are not translated, the scalar path adds a zero translation instead.
+			Store_Vector3(dst_norm + i, Transform_Column_Sum(src_norm[i], c0, c1, c2, zero));
+		}
+	}
+}
+#endif
+
+#ifdef VP_HAS_AVX2_INTRINSICS
+/*
+** Transforms two vertices at a time, the first in the low and the second in the high half of each register.
+** The multiplies and adds are the ones of the SSE path, without fused multiply-add, so results stay identical.
+*/
+static inline VP_TARGET_AVX2 __m256 Combine_Halves(const __m128& low, const __m128& high)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+static inline VP_TARGET_AVX2 __m256 Transform_Column_Sum_Pair(const __m256& v, const __m256& c0, const __m256& c1, const __m256& c2, const __m256& c3)
+{
+	// Spread X, Y and Z of both vertices over their halves. v holds X0 Y0 Z0 X1 Y1 Z1.
+	const __m256i x_index = _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3);
+	const __m256i y_index = _mm256_setr_epi32(1, 1, 1, 1, 4, 4, 4, 4);
+	const __m256i z_index = _mm256_setr_epi32(2, 2, 2, 2, 5, 5, 5, 5);
+
+	__m256 r = _mm256_mul_ps(c0, _mm256_permutevar8x32_ps(v, x_index));
+	r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_permutevar8x32_ps(v, y_index)));
+	r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permutevar8x32_ps(v, z_index)));
+	return _mm256_add_ps(r, c3);
+}
+
+static VP_TARGET_AVX2 void Transform_Skinned_AVX2(Vector3* dst_vert, Vector3* dst_norm, const Vector3* src_vert, const Vector3* src_norm,
+	const unsigned short* bone_links, const Matrix3D* bone_tms, const int bone_tm_stride, const int count)
+{
+	// Two Vector3 are six floats, the mask keeps the load from reading past the last vertex.
+	const __m256i two_vectors = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+	const __m256 zero = _mm256_setzero_ps();
+	__m256 c0, c1, c2, c3;
+	int bone0 = -1;
+	int bone1 = -1;
+
+	int i = 0;
+	for (; i + 1 < count; i += 2)
+	{
+		if (bone_links[i] != bone0 || bone_links[i + 1] != bone1)
+		{
+			bone0 = bone_links[i];
+			bone1 = bone_links[i + 1];
+			__m128 a0, a1, a2, a3;
+			Load_Bone_Columns(Get_Bone_Transform(bone_tms, bone_tm_stride, bone0), a0, a1, a2, a3);
+			__m128 b0 = a0, b1 = a1, b2 = a2, b3 = a3;
+			if (bone1 != bone0)
+				Load_Bone_Columns(Get_Bone_Transform(bone_tms, bone_tm_stride, bone1), b0, b1, b2, b3);
+			c0 = Combine_Halves(a0, b0);
+			c1 = Combine_Halves(a1, b1);
+			c2 = Combine_Halves(a2, b2);
+			c3 = Combine_Halves(a3, b3);
+		}
+
+		__m256 r = Transform_Column_Sum_Pair(_mm256_maskload_ps(&src_vert[i].X, two_vectors), c0, c1, c2, c3);
+		Store_Vector3(dst_vert + i, _mm256_castps256_ps128(r));
+		Store_Vector3(dst_vert + i + 1, _mm256_extractf128_ps(r, 1));
+		if (dst_norm)
+		{
+			// Normals are not translated, the scalar path adds a zero translation instead.
+			r = Transform_Column_Sum_Pair(_mm256_maskload_ps(&src_norm[i].X, two_vectors), c0, c1, c2, zero);
+			Store_Vector3(dst_norm + i, _mm256_castps256_ps128(r));
+			Store_Vector3(dst_norm + i + 1, _mm256_extractf128_ps(r, 1));
+		}
+	}
+
+	// Leave the upper halves clean for the SSE code that follows.
+	_mm256_zeroupper();
+
+	if (i < count)
+	{
+		Transform_Skinned_SSE(dst_vert + i, dst_norm ? dst_norm + i : NULL, src_vert + i, dst_norm ? src_norm + i : NULL,
+			bone_links + i, bone_tms, bone_tm_stride, count - i);
+	}
+}
+#endif
+
+void VectorProcessorClass::Transform_Skinned(Vector3* dst_vert, Vector3* dst_norm, const Vector3* src_vert, const Vector3* src_norm,
+	const unsigned short* bone_links, const Matrix3D* bone_tms, const int bone_tm_stride, const int count)
+{
+	if (count<=0) return;
+
+#ifdef VP_HAS_AVX2_INTRINSICS
+	if (CPUDetectClass::Has_AVX2_Instruction_Set()) {
+		Transform_Skinned_AVX2(dst_vert, dst_norm, src_vert, src_norm, bone_links, bone_tms, bone_tm_stride, count);
+		return;
+	}
+#endif
+#ifdef VP_HAS_SSE_INTRINSICS
+	if (CPUDetectClass::Has_SSE_Instruction_Set()) {
+		Transform_Skinned_SSE(dst_vert, dst_norm, src_vert, src_norm, bone_links, bone_tms, bone_tm_stride, count);
+		return;
+	}
+#endif
+
+	Transform_Skinned_Scalar(dst_vert, dst_norm, src_vert, src_norm, bone_links, bone_tms, bone_tm_stride, count);
+}
+
+void VectorProcessorClass::Transform_Skinned_Scalar(Vector3* dst_vert, Vector3* dst_norm, const Vector3* src_vert, const Vector3* src_norm,
+	const unsigned short* bone_links, const Matrix3D* bone_tms, const int bone_tm_stride, const int count)
+{
+	if (count<=0) return;
+
+	// Transform runs of vertices that use the same bone
+	for (int vi = 0; vi < count;) {
+		const int bone = bone_links[vi];
+		int end = vi + 1;
+		while (end < count && bone_links[end] == bone) {
+			end++;
+		}
+
+		Matrix3D tm = Get_Bone_Transform(bone_tms, bone_tm_stride, bone);
+		Transform(dst_vert + vi, src_vert + vi, tm, end - vi);
+		if (dst_norm) {
+			tm.Set_Translation(Vector3(0.0f,0.0f,0.0f));
+			Transform(dst_norm + vi, src_norm + vi, tm, end - vi);
+		}
+		vi = end;
+	}
+}
+
 void VectorProcessorClass::Copy(Vector2 *dst, const Vector2 *src, int count)
 {
 	if (count<=0) return;
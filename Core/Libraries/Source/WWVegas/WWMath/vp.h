@@ -58,6 +58,13 @@ class VectorProcessorClass
 public:
 	static void Transform(Vector3* dst,const Vector3 *src, const Matrix3D& matrix, const int count);
 	static void Transform(Vector4* dst,const Vector3 *src, const Matrix4x4& matrix, const int count);
+	// TheSuperHackers @performance Transforms the positions and optionally the normals of a skin in one pass,
+	// each vertex by the bone transform its bone link selects. Bone transforms are bone_tm_stride bytes apart.
+	static void Transform_Skinned(Vector3* dst_vert, Vector3* dst_norm, const Vector3* src_vert, const Vector3* src_norm,
+		const unsigned short* bone_links, const Matrix3D* bone_tms, const int bone_tm_stride, const int count);
+	// Transform_Skinned without the SSE and AVX2 paths, so tools can compare them.
+	static void Transform_Skinned_Scalar(Vector3* dst_vert, Vector3* dst_norm, const Vector3* src_vert, const Vector3* src_norm,
+		const unsigned short* bone_links, const Matrix3D* bone_tms, const int bone_tm_stride, const int count);
 	static void Copy(unsigned *dst,const unsigned *src, const int count);
 	static void Copy(Vector2 *dst,const Vector2 *src, const int count);
 	static void Copy(Vector3 *dst,const Vector3 *src, const int count);
@@ -622,6 +622,7 @@ public:
 		const Coord3D *to, ObjectID ignoreObject=INVALID_ID );  ///< Can we build any path at all between the locations	(terrain, buildings & units check - slower)
 
 	Bool queueForPath(ObjectID id);	 ///< The object wants to request a pathfind, so put it on the list to process.
+	Int getQueuedPathfindRequestCount() const;	///< Number of pathfind requests waiting in the queue.
 	void processPathfindQueue(void); ///< Process some or all of the queued pathfinds.
 	void forceMapRecalculation( );	///< Force pathfind map recomputation. If region is given, only that area is recomputed
 
@@ -872,6 +873,14 @@ inline void Pathfinder::setIgnoreObstacleID( ObjectID objID )
 	m_ignoreObstacleID = objID;
 }
 
+inline Int Pathfinder::getQueuedPathfindRequestCount() const
+{
+	Int count = m_queuePRTail - m_queuePRHead;
+	if (count < 0)
+		count += PATHFIND_QUEUE_LEN;
+	return count;
+}
+
 inline void Pathfinder::worldToGrid( const Coord3D *pos, ICoord2D *cellIndex )
 {
 	cellIndex->x = REAL_TO_INT(pos->x/PATHFIND_CELL_SIZE);
@@ -458,6 +458,16 @@ Int parseJobs(char *args[], int num)
 	return 1;
 }
 
+Int parseReplayProfile(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_replayProfileFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
 Int parseXRes(char *args[], int num)
 {
 	if (num > 1)
@@ -1163,6 +1173,10 @@ static CommandLineParam paramsForStartup[] =
 	// (If you have 4 cores, call it with -jobs 4)
 	// If you do not call this, all replays will be simulated in sequence in the same process.
 	{ "-jobs", parseJobs },
+
+	// TheSuperHackers @feature Write the cost of every GameLogic::update phase per logic frame to the given CSV file.
+	// Combine this with -replay and -headless. Replays are then always simulated in this process.
+	{ "-replayProfile", parseReplayProfile },
 };
 
 // These Params are parsed during Engine Init before INI data is loaded
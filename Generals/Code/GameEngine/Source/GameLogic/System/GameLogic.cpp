@@ -40,6 +40,7 @@
 #include "Common/GameUtility.h"
 #include "Common/INI.h"
 #include "Common/LatchRestore.h"
+#include "Common/LogicFrameProfiler.h"
 #include "Common/MapObject.h"
 #include "Common/MultiplayerSettings.h"
 #include "Common/OSDisplay.h"
@@ -3157,10 +3158,14 @@ void GameLogic::update( void )
 	UnsignedInt now = TheGameLogic->getFrame();
 	TheGameClient->setFrame(now);
 
+	if (TheLogicFrameProfiler)
+		TheLogicFrameProfiler->beginFrame(now);
+
 	// update (execute) scripts
 	{
 		TheScriptEngine->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_SCRIPT_ENGINE);
 
 	Bool freezeTime = TheTacticalView->isTimeFrozen() && !TheTacticalView->isCameraMovementFinished();
 	freezeTime = freezeTime || TheScriptEngine->isTimeFrozenDebug() || TheScriptEngine->isTimeFrozenScript();
@@ -3183,6 +3188,7 @@ void GameLogic::update( void )
 	{
 		TheTerrainLogic->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_TERRAIN_LOGIC);
 
 	// force CRC calculation, so we can keep a cache of the last N CRCs.  We do this right where the recorder
 	// would be getting the CRC anyway, so replays can get the CRCs from the exact instant in time as the original.
@@ -3215,6 +3221,7 @@ void GameLogic::update( void )
 
 		DEBUG_LOG(("Appended %sCRC on frame %d: %8.8X", isPlayback ? "Playback " : "", m_frame, m_CRC));
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_CRC);
 
 	// collect stats
 	if(TheStatsCollector)
@@ -3226,11 +3233,13 @@ void GameLogic::update( void )
 	{
 		TheRecorder->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_OTHER);
 
 	// process client commands
 	{
 		processCommandList( TheCommandList );
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_COMMAND_LIST);
 
 #ifdef ALLOW_NONSLEEPY_UPDATES
 	{
@@ -3302,20 +3311,30 @@ void GameLogic::update( void )
 
 	validateSleepyUpdate();
 
+	UnsignedInt pathfindQueueDepth = 0;
+	if (TheLogicFrameProfiler)
+	{
+		TheLogicFrameProfiler->endPhase(LogicFrameProfiler::PHASE_SLEEPY_UPDATES);
+		pathfindQueueDepth = TheAI->pathfinder()->getQueuedPathfindRequestCount();
+	}
+
 	// update the Artificial Intelligence system
 	{
 		TheAI->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_AI);
 
 	// production updates
 	{
 		TheBuildAssistant->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_BUILD_ASSISTANT);
 
 	// update partition info
 	{
 		ThePartitionManager->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_PARTITION_MANAGER);
 
 	//
 	// End of frame clean-up
@@ -3323,18 +3342,23 @@ void GameLogic::update( void )
 
 	// destroy all pending objects
 	processDestroyList();
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_DESTROY_LIST);
 
 	// reset the command list, destroying all messages
 	TheCommandList->reset();
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_OTHER);
 
 	TheWeaponStore->UPDATE();
 	TheLocomotorStore->UPDATE();
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_WEAPON_LOCOMOTOR_STORES);
 	TheVictoryConditions->UPDATE();
 
+	UnsignedInt objectCount = 0;
 	{
 		//Handle disabled statii (and re-enable objects once frame matches)
 		for( Object *obj = m_objList; obj; obj = obj->getNextObject() )
 		{
+			++objectCount;
 			if( obj->isDisabled() )
 			{
 				obj->checkDisabledStatus();
@@ -3342,6 +3366,9 @@ void GameLogic::update( void )
 		}
 	}
 
+	if (TheLogicFrameProfiler)
+		TheLogicFrameProfiler->endFrame(objectCount, (UnsignedInt)m_sleepyUpdates.size(), pathfindQueueDepth);
+
 	// increment world time
 	if (!m_startNewGame)
 	{
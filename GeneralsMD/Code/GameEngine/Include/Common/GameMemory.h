@@ -59,6 +59,14 @@
 	#define MEMORYPOOL_DEBUG
 #endif
 
+// TheSuperHackers @performance Give every thread a small cache ("magazine") of free blocks per pool,
+// so that most allocations and frees do not need to take TheMemoryPoolCriticalSection.
+// The debug pool keeps per-block tags, fillers and checkpoints, so it always goes through the shared blobs.
+// Off unless MEMORYPOOL_MAGAZINES is defined, until the contention win has been measured.
+#if defined(MEMORYPOOL_DEBUG) && defined(MEMORYPOOL_MAGAZINES)
+	#undef MEMORYPOOL_MAGAZINES
+#endif
+
 // SYSTEM INCLUDES ////////////////////////////////////////////////////////////
 
 #include <new.h>
@@ -223,6 +231,7 @@ class MemoryPool;
 class MemoryPoolFactory;
 class DynamicMemoryAllocator;
 class BlockCheckpointInfo;
+struct MemoryPoolMagazine;
 
 // TYPE DEFINES ///////////////////////////////////////////////////////////////
 
@@ -246,6 +255,15 @@ enum
 	MAX_DYNAMICMEMORYALLOCATOR_SUBPOOLS = 8	///< The max number of subpools allowed in a DynamicMemoryAllocator
 };
 
+#ifdef MEMORYPOOL_MAGAZINES
+enum
+{
+	MAX_MEMORYPOOL_MAGAZINE_SLOTS = 1024,			///< The max number of pools that get per-thread magazines; any further pools always use the shared blobs
+	MAX_MEMORYPOOL_MAGAZINE_BLOCKS = 32,			///< The max number of free blocks a thread caches per pool
+	MAX_MEMORYPOOL_MAGAZINE_BYTES = 16 * 1024	///< The max number of bytes a thread caches per pool (limits the magazine size for large blocks)
+};
+#endif
+
 #ifdef MEMORYPOOL_CHECKPOINTING
 // ----------------------------------------------------------------------------
 /**
@@ -306,6 +324,12 @@ private:
 	MemoryPoolBlob		*m_firstBlob;								///< head of linked list: first blob for this pool.
 	MemoryPoolBlob		*m_lastBlob;								///< tail of linked list: last blob for this pool. (needed for efficiency)
 	MemoryPoolBlob		*m_firstBlobWithFreeBlocks;	///< first blob in this pool that has at least one unallocated block.
+#ifdef MEMORYPOOL_MAGAZINES
+	Int								m_magazineSlot;							///< index of this pool in the per-thread magazine table, or -1 if it has no magazines
+	Int								m_magazineCapacity;					///< max number of free blocks a thread may cache for this pool (0 to disable)
+	UnsignedInt				m_magazineGeneration;				///< changes whenever the blobs are thrown away, invalidating all cached blocks
+	Int								m_magazineBlocksInPool;			///< number of free blocks cached in the magazines of all threads. they are not in use, but their blobs count them as allocated.
+#endif
 
 private:
 	/// create a new blob with the given number of blocks.
@@ -314,6 +338,25 @@ private:
 	/// destroy a blob.
 	Int freeBlob(MemoryPoolBlob *blob);
 
+	/// return a blob that has at least one free block. if allowOverflow is true, create an overflow blob if necessary (will throw on failure), otherwise return null.
+	MemoryPoolBlob* findBlobWithFreeBlocks(Bool allowOverflow);
+
+#ifdef MEMORYPOOL_MAGAZINES
+	/// return the calling thread's magazine for this pool, or null if this pool does not use magazines.
+	MemoryPoolMagazine* getThreadMagazine();
+
+	/// move a batch of free blocks from the shared blobs into the magazine. (will throw on failure)
+	void refillMagazine(MemoryPoolMagazine *magazine);
+
+	/// return the given number of blocks from the magazine to the shared blobs.
+	void drainMagazine(MemoryPoolMagazine *magazine, Int count);
+
+	/// update m_usedBlocksInPool and m_peakUsedBlocksInPool without holding the lock.
+	void adjustUsedBlockCount(Int delta);
+
+	friend void releaseThreadMemoryPoolMagazines();
+#endif
+
 public:
 
 	// 'public' funcs that are really only for use by MemoryPoolFactory
@@ -369,6 +412,9 @@ public:
 	/// return the high-water mark for getUsedBlockCount()
 	Int getPeakBlockCount();
 
+	/// return the number of free blocks that are cached in thread magazines. they are part of getFreeBlockCount(), but other threads cannot use them.
+	Int getMagazineBlockCount();
+
 	/// return the initial allocation count for this pool
 	Int getInitialBlockCount();
 
@@ -780,6 +826,11 @@ inline Int MemoryPool::getFreeBlockCount() { return getTotalBlockCount() - getUs
 inline Int MemoryPool::getUsedBlockCount() { return m_usedBlocksInPool; }
 inline Int MemoryPool::getTotalBlockCount() { return m_totalBlocksInPool; }
 inline Int MemoryPool::getPeakBlockCount() { return m_peakUsedBlocksInPool; }
+#ifdef MEMORYPOOL_MAGAZINES
+inline Int MemoryPool::getMagazineBlockCount() { return m_magazineBlocksInPool; }
+#else
+inline Int MemoryPool::getMagazineBlockCount() { return 0; }
+#endif
 inline Int MemoryPool::getInitialBlockCount() { return m_initialAllocationCount; }
 
 // ----------------------------------------------------------------------------
@@ -817,6 +868,13 @@ extern Bool isMemoryManagerOfficiallyInited();
 */
 extern void shutdownMemoryManager();
 
+/**
+	Return all blocks cached by the calling thread back to their pools and free the
+	thread's magazine table. This runs automatically when any thread exits, so it
+	only needs to be called directly to hand the blocks back early.
+*/
+extern void releaseThreadMemoryPoolMagazines();
+
 extern MemoryPoolFactory *TheMemoryPoolFactory;
 extern DynamicMemoryAllocator *TheDynamicMemoryAllocator;
 
@@ -139,6 +139,11 @@ extern Bool isMemoryManagerOfficiallyInited();
 */
 extern void shutdownMemoryManager();
 
+/**
+	Does nothing. Exists for parity with the pooled implementation.
+*/
+inline void releaseThreadMemoryPoolMagazines() {}
+
 extern MemoryPoolFactory *TheMemoryPoolFactory;
 extern DynamicMemoryAllocator *TheDynamicMemoryAllocator;
 
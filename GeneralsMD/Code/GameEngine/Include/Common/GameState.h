@@ -38,6 +38,7 @@
 
 // FORWARD REFERENCES /////////////////////////////////////////////////////////////////////////////
 class GameWindow;
+class SaveGameWriter;
 class WindowLayout;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -132,6 +133,9 @@ enum SaveCode CPP_11(: Int)
 	SC_ERROR,
 };
 
+/// called on the main thread once an asynchronous save is on disk or has failed
+typedef void (*SaveGameCallback)( SaveCode code, AsciiString filename, void *userData );
+
 enum SnapshotType CPP_11(: Int) {
 	SNAPSHOT_SAVELOAD,
 	SNAPSHOT_DEEPCRC_LOGICONLY,
@@ -153,15 +157,20 @@ public:
 	// subsystem interface
 	virtual void init( void );
 	virtual void reset( void );
-	virtual void update( void ) { }
+	virtual void update( void );															///< report finished asynchronous saves
 
 	// save game methods
 	SaveCode saveGame( AsciiString filename,
 										 UnicodeString desc,
 										 SaveFileType saveType,
-										 SnapshotType which = SNAPSHOT_SAVELOAD  );  ///< save a game
+										 SnapshotType which = SNAPSHOT_SAVELOAD,
+										 SaveGameCallback callback = NULL,
+										 void *callbackUserData = NULL );  ///< save a game, the file is written in the background
+	void waitForPendingSaves( void );														///< block until every save is on disk and reported
 	SaveCode missionSave( void );																	 ///< do a in between mission save
 	SaveCode loadGame( AvailableGameInfo gameInfo );							 ///< load a save file
+	SaveCode saveCheckpoint( Xfer *xfer );												 ///< save the game into an open xfer without any user interface
+	SaveCode loadCheckpoint( Xfer *xfer );												 ///< replace the game with one from saveCheckpoint
 	SaveGameInfo *getSaveGameInfo( void ) { return &m_gameInfo; }
 
 	// snapshot interaction
@@ -227,6 +236,8 @@ private:
 	AvailableGameInfo *m_availableGames;		///< list of available games we can save over or load from
 
 	Bool m_isInLoadGame; // Brutal hack to allow bone pos validation while loading games
+
+	SaveGameWriter *m_saveGameWriter;		///< writes save files on a background thread, created on first save
 };
 
 // EXTERNALS //////////////////////////////////////////////////////////////////////////////////////
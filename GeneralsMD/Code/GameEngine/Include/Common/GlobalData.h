@@ -269,6 +269,7 @@ public:
 	Bool m_useFX;									///< If false, don't render effects
 	Bool m_showClientPhysics;
 	Bool m_showTerrainNormals;
+	Bool m_parallelAnimationUpdate;	///< update the hierarchies of drawn render objects on worker threads before rendering them
 
 	UnsignedInt m_noDraw;					///< Used to disable drawing, to profile game logic code.
 	AIDebugOptions m_debugAI;			///< Used to display AI debug information
@@ -351,6 +352,14 @@ public:
 
 	std::vector<AsciiString> m_simulateReplays; ///< If not empty, simulate this list of replays and exit.
 	Int m_simulateReplayJobs; ///< Maximum number of processes to use for simulation, or SIMULATE_REPLAYS_SEQUENTIAL for sequential simulation
+	AsciiString m_replayProfileFile; ///< If not empty, write per frame GameLogic timings of the simulated replays to this CSV file.
+	UnsignedInt m_replayCheckpointInterval; ///< If not 0, replay playback keeps a compressed in-memory checkpoint every this many logic frames.
+	Bool m_bisectReplayCRC; ///< If true, a replay CRC mismatch rewinds to a checkpoint and prints the logic CRC of every frame up to the mismatch.
+	Int m_replaySeekFrame; ///< If not negative, replay playback rewinds once to this frame when it reaches the end of the replay.
+	Bool m_verifyScriptConditions; ///< If true, reused script condition results are checked against full evaluation and a difference fails the replay.
+	Bool m_verifyThreatValues; ///< If true, threat and cash values are checked against per player circles and a difference fails the replay.
+	Bool m_verifyScriptLookups; ///< If true, script name lookups through hash indices are checked against linear searches and a difference fails the replay.
+	Bool m_compactReplays; ///< If true, new replays store their commands in a compressed and indexed ReplayContainer instead of the retail layout.
 
 	Int m_maxParticleCount;						///< maximum number of particles that can exist
 	Int m_maxFieldParticleCount;			///< maximum number of field-type particles that can exist (roughly)
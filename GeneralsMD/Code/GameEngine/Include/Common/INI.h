@@ -128,9 +128,10 @@ struct FieldParse
 //-------------------------------------------------------------------------------------------------
 class MultiIniFieldParse
 {
-private:
+public:
 	enum { MAX_MULTI_FIELDS = 16 };
 
+private:
 	const FieldParse* m_fieldParse[MAX_MULTI_FIELDS];
 	UnsignedInt				m_extraOffset[MAX_MULTI_FIELDS];
 	Int								m_count;
@@ -159,6 +160,31 @@ public:
 typedef void (*INIBlockParse)( INI *ini );
 typedef void (*BuildMultiIniFieldProc)(MultiIniFieldParse& p);
 
+//-------------------------------------------------------------------------------------------------
+/** All lines of an INI file, cleaned up the way INI reads them: comments cut off, control
+	* characters turned into spaces and over long lines split. Lexing touches no game state,
+	* so it can be done on any thread. */
+//-------------------------------------------------------------------------------------------------
+class INILexedFile
+{
+public:
+	INILexedFile() : m_lineCount(0), m_firstTabLine(0), m_firstTruncatedLine(0) {}
+
+	void lex( const char *data, Int size );	///< split the raw file contents into lines
+	void clear( void );
+
+	const char *getLines( void ) const { return m_lines.empty() ? NULL : &m_lines[0]; }	///< null terminated lines, back to back
+	UnsignedInt getLineCount( void ) const { return m_lineCount; }	///< always at least 1, the last line ends at the end of the file
+	UnsignedInt getFirstTabLine( void ) const { return m_firstTabLine; }	///< first line with a tab character, 0 if none
+	UnsignedInt getFirstTruncatedLine( void ) const { return m_firstTruncatedLine; }	///< first line longer than INI_MAX_CHARS_PER_LINE, 0 if none
+
+private:
+	std::vector<char> m_lines;
+	UnsignedInt m_lineCount;
+	UnsignedInt m_firstTabLine;
+	UnsignedInt m_firstTruncatedLine;
+};
+
 //-------------------------------------------------------------------------------------------------
 /** INI Reader interface */
 //-------------------------------------------------------------------------------------------------
@@ -395,19 +421,19 @@ protected:
 	static Bool isValidINIFilename( const char *filename ); ///< is this a valid .ini filename
 
 	void prepFile( AsciiString filename, INILoadType loadType );
+	void prepLexedFile( AsciiString filename, const INILexedFile *lexedFile, INILoadType loadType );
 	void unPrepFile();
 
-	void readLine( void );
+	UnsignedInt loadLexed( AsciiString filename, const INILexedFile *lexedFile, INILoadType loadType, Xfer *pXfer );
+	UnsignedInt loadFiles( const std::vector<AsciiString>& filenames, INILoadType loadType, Xfer *pXfer );
+	void parseFile( void );
 
-	File *m_file;															///< file pointer of file currently loading
+	void readLine( void );
 
-  enum
-  {
-    INI_READ_BUFFER = 8192                  ///< size of internal read buffer
-  };
-  char m_readBuffer[INI_READ_BUFFER];       ///< internal read buffer
-  unsigned m_readBufferNext;                ///< next char in read buffer
-  unsigned m_readBufferUsed;                ///< number of bytes in read buffer
+	const INILexedFile *m_lexedFile;					///< lines of the file currently loading
+	INILexedFile m_ownLexedFile;							///< storage for m_lexedFile when the file was lexed by load()
+	const char *m_nextLine;										///< next line to be returned by readLine()
+	UnsignedInt m_linesLeft;									///< lines left in m_lexedFile
 
 	AsciiString m_filename;										///< filename of file currently loading
 	INILoadType m_loadType;										///< load time for current file
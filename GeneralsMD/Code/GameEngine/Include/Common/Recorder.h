@@ -54,6 +54,8 @@ enum RecorderModeType CPP_11(: Int) {
 };
 
 class CRCInfo;
+class ReplayContainerWriter;
+class ReplayContainerReader;
 
 class RecorderClass : public SubsystemInterface {
 public:
@@ -84,10 +86,35 @@ public:
 #endif
 	Bool isPlaybackInProgress() const;
 
+	// TheSuperHackers @feature Replay checkpoints. A checkpoint is a compressed in-memory save game plus the
+	// playback position, taken between two logic frames every TheGlobalData->m_replayCheckpointInterval frames.
+	Bool updateCheckpoints();													///< Take or restore a checkpoint before a logic update. Returns TRUE if the game was replaced and the update must be skipped.
+	Bool seekPlayback(UnsignedInt frame);							///< Continue playback from the latest checkpoint at or before frame. Returns FALSE if there is none.
+
 public:
 	void handleCRCMessage(UnsignedInt newCRC, Int playerIndex, Bool fromPlayback);
 protected:
 	CRCInfo *m_crcInfo;
+
+	struct ReplayCheckpoint;
+	typedef std::vector<ReplayCheckpoint*> ReplayCheckpointVec;
+
+	void takeCheckpoint();
+	Bool restoreCheckpoint(const ReplayCheckpoint *checkpoint);
+	const ReplayCheckpoint *findCheckpoint(UnsignedInt frame) const;
+	void clearCheckpoints();
+	Bool beginCRCMismatchBisect(UnsignedInt mismatchFrame);
+	Bool beginEndOfReplaySeek();
+
+	ReplayCheckpointVec m_checkpoints;								///< sorted by frame
+	UnsignedInt m_checkpointInterval;									///< 0 if checkpoints are disabled
+	UnsignedInt m_nextCheckpointFrame;
+	UnsignedInt m_seekFrame;													///< pending seek request, or NO_SEEK_FRAME
+	UnsignedInt m_endOfReplaySeekFrame;								///< frame to seek to when the replay ends, or NO_SEEK_FRAME
+	UnsignedInt m_crcLogFirstFrame;										///< first frame of the CRC mismatch bisect window
+	UnsignedInt m_crcLogLastFrame;										///< last frame of the CRC mismatch bisect window
+	Bool m_restoringCheckpoint;
+	Bool m_bisectingCRCMismatch;
 public:
 
 	// read in info relating to a replay, conditionally setting up m_file for playback
@@ -110,6 +137,7 @@ public:
 		Bool playerDiscons[MAX_SLOTS];
 		AsciiString gameOptions;
 		Int localPlayerIndex;
+		Bool compact;																		///< commands are stored in a ReplayContainer
 	};
 	Bool readReplayHeader( ReplayHeader& header );
 
@@ -131,6 +159,7 @@ public:
 	void logPlayerDisconnect(UnicodeString player, Int slot);
 	void logCRCMismatch( void );
 	Bool sawCRCMismatch() const;
+	void logVerificationFailure(const char *failure);	///< A -verify check failed. Fails the replay that is played back like a CRC mismatch.
 	void cleanUpReplayFile( void );										///< after a crash, send replay/debug info to a central repository
 
 	void setArchiveEnabled(Bool enable) { m_archiveReplays = enable; } ///< Enable or disable replay archiving.
@@ -150,6 +179,13 @@ protected:
 	void writeArgument(GameMessageArgumentDataType type, const GameMessageArgumentType arg);
 	void readArgument(GameMessageArgumentDataType type, GameMessage *msg);
 
+	// TheSuperHackers @feature Commands go through these, so that they can be stored in a compact replay container.
+	void writeCommandData(const void *data, Int dataSize);
+	Int readCommandData(void *data, Int dataSize);
+	UnsignedInt getCommandPosition() const;
+	void setCommandPosition(UnsignedInt position);
+	void closeReplayContainer();
+
 	struct CullBadCommandsResult
 	{
 		CullBadCommandsResult() : hasClearGameDataMessage(false) {}
@@ -159,6 +195,8 @@ protected:
 	CullBadCommandsResult cullBadCommands(); ///< prevent the user from giving mouse commands that he shouldn't be able to do during playback.
 
 	File* m_file;
+	ReplayContainerWriter* m_containerWriter;					///< set while recording a compact replay
+	ReplayContainerReader* m_containerReader;					///< set while playing back a compact replay
 	AsciiString m_fileName;
 	Int m_currentFilePosition;
 	RecorderModeType m_mode;
@@ -0,0 +1,109 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: ReplayContainer.h ////////////////////////////////////////////////////////////////////////
+// Desc:   Compact replay command container
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class File;
+
+//-------------------------------------------------------------------------------------------------
+/** TheSuperHackers @feature A compact replay has the regular replay header, followed by the commands
+	* in compressed blocks and an index of all blocks at the end of the file. Inside a block, frame
+	* numbers and ids are delta encoded and integer arguments are varint encoded.
+	*
+	* The recorder keeps writing and reading the commands in the original replay layout. The writer
+	* encodes every finished command and the reader decodes one block at a time back into that layout,
+	* so positions in the original layout remain valid to seek to. */
+//-------------------------------------------------------------------------------------------------
+
+struct ReplayBlockIndexEntry
+{
+	UnsignedInt firstFrame;						///< frame of the first command in the block, a frame never spans two blocks
+	UnsignedInt fileOffset;						///< file offset of the block
+	UnsignedInt position;							///< position of the first command in the original layout
+};
+
+typedef std::vector<ReplayBlockIndexEntry> ReplayBlockIndex;
+
+/// Values the commands of a block are delta encoded against.
+struct ReplayDeltaState
+{
+	void reset( UnsignedInt frame ) { lastFrame = frame; lastObjectID = 0; lastDrawableID = 0; }
+
+	UnsignedInt lastFrame;
+	UnsignedInt lastObjectID;
+	UnsignedInt lastDrawableID;
+};
+
+//-------------------------------------------------------------------------------------------------
+class ReplayContainerWriter
+{
+
+public:
+
+	ReplayContainerWriter( File *file );			///< file must be positioned behind the replay header
+
+	void write( const void *data, Int dataSize );		///< append data of the current command in the original layout
+	void endCommand( void );												///< encode the current command
+	void finish( void );														///< write the open block and the index
+
+protected:
+
+	void flushBlock( void );
+
+	File *m_file;
+	std::vector<UnsignedByte> m_command;		///< the current command in the original layout
+	std::vector<UnsignedByte> m_block;			///< encoded commands of the open block
+	ReplayBlockIndex m_index;
+	ReplayDeltaState m_delta;
+	UnsignedInt m_blockFirstFrame;
+	UnsignedInt m_blockPosition;						///< position of the open block in the original layout
+	UnsignedInt m_blockSize;								///< size of the open block in the original layout
+
+};
+
+//-------------------------------------------------------------------------------------------------
+class ReplayContainerReader
+{
+
+public:
+
+	ReplayContainerReader( File *file );			///< file must be positioned behind the replay header
+
+	Int read( void *data, Int dataSize );		///< read in the original layout, returns the number of bytes read
+	UnsignedInt position( void ) const;			///< position in the original layout
+	Bool seek( UnsignedInt position );			///< seek to a position in the original layout
+	Bool isDamaged( void ) const { return m_damaged; }	///< true if reading stopped at a block that could not be decoded
+
+protected:
+
+	Bool readIndex( UnsignedInt firstBlockOffset );
+	void scanBlocks( UnsignedInt firstBlockOffset );
+	Bool loadBlock( size_t block );
+
+	File *m_file;
+	ReplayBlockIndex m_index;
+	size_t m_block;													///< index of the decoded block, or m_index.size() if there is none
+	std::vector<UnsignedByte> m_decoded;		///< the decoded block in the original layout
+	UnsignedInt m_readPos;									///< read position in m_decoded
+	Bool m_damaged;													///< a block could not be decoded
+
+};
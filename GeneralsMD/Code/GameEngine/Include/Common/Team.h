@@ -321,7 +321,7 @@ public:
 	/**
 		Note that a team member entered or exited a trigger area.
 	*/
-	void setEnteredExited(void) {m_enteredOrExited = true;}
+	void setEnteredExited(void);
 
 	/**
 		Did a team member enter or exit a trigger area.
@@ -57,6 +57,18 @@ enum ParticleSystemID CPP_11(: Int)
 	INVALID_PARTICLE_SYSTEM_ID = 0
 };
 
+namespace rts
+{
+	template<> struct hash<ParticleSystemID>
+	{
+		size_t operator()(ParticleSystemID id) const
+		{
+			std::hash<UnsignedInt> tmp;
+			return tmp((UnsignedInt)id);
+		}
+	};
+}
+
 #define MAX_VOLUME_PARTICLE_DEPTH ( 16 )
 #define DEFAULT_VOLUME_PARTICLE_DEPTH ( 0 )//The Default is not to do the volume thing!
 #define OPTIMUM_VOLUME_PARTICLE_DEPTH ( 6 )
@@ -723,6 +735,7 @@ public:
 
 	typedef std::list<ParticleSystem*> ParticleSystemList;
 	typedef std::list<ParticleSystem*>::iterator ParticleSystemListIt;
+	typedef std::hash_map<ParticleSystemID, ParticleSystemListIt, rts::hash<ParticleSystemID>, rts::equal_to<ParticleSystemID> > ParticleSystemIDMap;
 	typedef std::hash_map<AsciiString, ParticleSystemTemplate *, rts::hash<AsciiString>, rts::equal_to<AsciiString> > TemplateMap;
 
 	ParticleSystemManager( void );
@@ -776,6 +789,9 @@ public:
 
 	UnsignedInt getParticleSystemCount( void ) const { return m_particleSystemCount; }
 
+	UnsignedInt getSystemLookupCountThisFrame( void ) const { return m_systemLookupCountThisFrame; }	///< findParticleSystem calls since the last update
+	UnsignedInt getEvictedParticleCountThisFrame( void ) const { return m_evictedParticleCountThisFrame; }	///< particles removed by removeOldestParticles since the last update
+
 	// @todo const this jkmcd
 	ParticleSystemList &getAllParticleSystems( void ) { return m_allParticleSystemList; }
 
@@ -787,6 +803,7 @@ public:
 	// these are only for use by partcle systems to link and unlink themselves
 	void friend_addParticleSystem( ParticleSystem *particleSystemToAdd );
 	void friend_removeParticleSystem( ParticleSystem *particleSystemToRemove );
+	void friend_changeParticleSystemID( ParticleSystem *particleSystem, ParticleSystemID oldID );
 
 protected:
 
@@ -801,6 +818,7 @@ protected:
 	ParticleSystemID m_uniqueSystemID;					///< unique system ID to assign to each system created
 
 	ParticleSystemList m_allParticleSystemList;
+	ParticleSystemIDMap m_systemIDMap;					///< TheSuperHackers @performance live systems by ID, for findParticleSystem and removal
 
 	UnsignedInt m_particleCount;
 	UnsignedInt m_fieldParticleCount; ///< this does not need to be xfered, since it is evaluated every frame
@@ -808,6 +826,8 @@ protected:
 	Int m_onScreenParticleCount;                ///< number of particles displayed on screen per frame
 	UnsignedInt m_lastLogicFrameUpdate;
 	Int m_localPlayerIndex;	///<used to tell particle systems which particles can be skipped due to player shroud status
+	UnsignedInt m_systemLookupCountThisFrame;
+	UnsignedInt m_evictedParticleCountThisFrame;
 
 private:
 	TemplateMap m_templateMap;		///< a hash map of all particle system templates
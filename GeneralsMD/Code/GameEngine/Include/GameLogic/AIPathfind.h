@@ -35,6 +35,7 @@
 #include "GameLogic/LocomotorSet.h"
 #include "GameLogic/GameLogic.h"
 #include "Common/GameDefines.h"
+#include "Common/STLTypedefs.h"
 
 class Bridge;
 class Object;
@@ -221,9 +222,12 @@ public:
 	static PathfindCellInfo * getACellInfo(PathfindCell *cell, const ICoord2D &pos);
 	static void releaseACellInfo(PathfindCellInfo *theInfo);
 
+	static UnsignedInt64 getAllocatedCellsKey(void) {return s_allocatedCellsKey;}	///< Changes whenever the set of cells that have an info changes.
+
 protected:
 	static PathfindCellInfo *s_infoArray;
 	static PathfindCellInfo *s_firstFree;							///<
+	static UnsignedInt64 s_allocatedCellsKey;					///< Hashes of all cells that have an info, xor'ed together.
 
 
 	PathfindCellInfo *m_nextOpen, *m_prevOpen;						///< for A* "open" list, shared by closed list
@@ -636,7 +640,10 @@ public:
 	Bool slowDoesPathExist( Object *obj, const Coord3D *from,
 		const Coord3D *to, ObjectID ignoreObject=INVALID_ID );  ///< Can we build any path at all between the locations	(terrain, buildings & units check - slower)
 
+	void getHierarchicalPathCacheStats(UnsignedInt *hits, UnsignedInt *misses) const;	///< Hierarchical searches answered from / added to the cache.
+
 	Bool queueForPath(ObjectID id);	 ///< The object wants to request a pathfind, so put it on the list to process.
+	Int getQueuedPathfindRequestCount() const;	///< Number of pathfind requests waiting in the queue.
 	void processPathfindQueue(void); ///< Process some or all of the queued pathfinds.
 	void forceMapRecalculation( );	///< Force pathfind map recomputation. If region is given, only that area is recomputed
 
@@ -829,6 +836,35 @@ protected:
 		Bool center, Int pathDiameter );	///< Work backwards from goal cell to construct final path
 	Path *buildHierachicalPath( const Coord3D *fromPos, PathfindCell *goalCell);	///< Work backwards from goal cell to construct final path
 
+	struct HierarchicalPathKey
+	{
+		PathfindCell *startCell;
+		PathfindCell *goalCell;
+		LocomotorSurfaceTypeMask locomotorSurface;
+		Bool crusher;
+		Bool closestOK;
+		Bool isHuman;
+
+		bool operator<(const HierarchicalPathKey &other) const;
+	};
+	struct HierarchicalPathCell
+	{
+		PathfindCell *cell;
+		ICoord2D pos;
+	};
+	struct HierarchicalPathEntry
+	{
+		UnsignedInt64 allocatedCellsKey;							///< PathfindCellInfo::getAllocatedCellsKey() when the search started
+		Int cellsExamined;														///< What the search added to m_cumulativeCellsAllocated
+		std::vector<HierarchicalPathCell> cells;			///< Path cells from goal to start, empty if no path was found
+	};
+	typedef std::map<HierarchicalPathKey, HierarchicalPathEntry> HierarchicalPathCache;
+
+	static Bool isHierarchicalPathCacheUsable(void);
+	void invalidateHierarchicalPathCache(void);		///< Called whenever the zones, cells or bridges the hierarchical search looks at change.
+	HierarchicalPathEntry *storeHierarchicalPath(const HierarchicalPathKey &key, UnsignedInt64 allocatedCellsKey, PathfindCell *lastCell);
+	Path *buildCachedHierarchicalPath(const Coord3D *fromPos, const HierarchicalPathEntry &entry, Bool &built);
+
 	void  prependCells( Path *path, const Coord3D *fromPos,
 																	PathfindCell *goalCell, Bool center ); ///< Add pathfind cells to a path.
 
@@ -879,6 +915,10 @@ private:
 	Int						m_queuePRHead;
 	Int						m_queuePRTail;
 	Int						m_cumulativeCellsAllocated;
+
+	HierarchicalPathCache	m_hierarchicalPathCache;	///< Results of recent hierarchical searches.
+	UnsignedInt		m_hierarchicalPathCacheHits;
+	UnsignedInt		m_hierarchicalPathCacheMisses;
 };
 
 
@@ -887,6 +927,14 @@ inline void Pathfinder::setIgnoreObstacleID( ObjectID objID )
 	m_ignoreObstacleID = objID;
 }
 
+inline Int Pathfinder::getQueuedPathfindRequestCount() const
+{
+	Int count = m_queuePRTail - m_queuePRHead;
+	if (count < 0)
+		count += PATHFIND_QUEUE_LEN;
+	return count;
+}
+
 inline void Pathfinder::worldToGrid( const Coord3D *pos, ICoord2D *cellIndex )
 {
 	cellIndex->x = REAL_TO_INT(pos->x/PATHFIND_CELL_SIZE);
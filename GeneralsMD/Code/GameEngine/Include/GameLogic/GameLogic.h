@@ -257,7 +257,8 @@ public:
 	void setSuperweaponRestriction(void);
 
 #ifdef DUMP_PERF_STATS
-	void getAIMetricsStatistics(UnsignedInt* numAI, UnsignedInt* numMoving, UnsignedInt* numAttacking, UnsignedInt* numWaitingForPath, UnsignedInt* overallFailedPathfinds);
+	void getAIMetricsStatistics(UnsignedInt* numAI, UnsignedInt* numMoving, UnsignedInt* numAttacking, UnsignedInt* numWaitingForPath, UnsignedInt* overallFailedPathfinds,
+		UnsignedInt* hierarchicalPathCacheHits, UnsignedInt* hierarchicalPathCacheMisses);
 	void resetOverallFailedPathfinds() { m_overallFailedPathfinds = 0; }
 	void incrementOverallFailedPathfinds() { m_overallFailedPathfinds++; }
 	UnsignedInt getOverallFailedPathfinds() const { return m_overallFailedPathfinds; }
@@ -358,7 +359,15 @@ private:
 	// never modify it directly; please use the proper access methods.
 	// (for an excellent discussion of priority queues, please see:
 	// http://dogma.net/markn/articles/pq_stl/priority.htm)
-	std::vector<UpdateModulePtr> m_sleepyUpdates;
+	// TheSuperHackers @performance Each entry carries a copy of its module's priority, so sifting
+	// the heap compares contiguous keys instead of chasing every module pointer. The copy is
+	// refreshed in rebalanceSleepyUpdate, which must follow every wake frame change.
+	struct SleepyUpdateEntry
+	{
+		UnsignedInt priority;
+		UpdateModulePtr module;
+	};
+	std::vector<SleepyUpdateEntry> m_sleepyUpdates;
 
 #ifdef ALLOW_NONSLEEPY_UPDATES
 	// this is a plain old list, not a pq.
@@ -670,12 +670,9 @@ protected:
 	void shroud();
 	void unshroud();
 
-	/// value and threat functions are protected, and should only be called from handleValueMap
-	void addValue();
-	void removeValue();
-
-	void addThreat();
-	void removeThreat();
+	/// value and threat functions are protected, and should only be called from handleValueMap and handleThreatMap
+	void makeValueSighting( SightingInfo *info );
+	void makeThreatSighting( SightingInfo *info );
 
 	virtual void reactToTransformChange(const Matrix3D* oldMtx, const Coord3D* oldPos, Real oldAngle);
 
@@ -78,6 +78,7 @@ const Real HUGE_DIST = 1000000.0f;
 //-----------------------------------------------------------------------------
 
 struct Coord3D;
+struct ThreatValueFootprint;
 
 class CellAndObjectIntersection;
 class Object;
@@ -298,8 +299,6 @@ private:
 	Real													m_loTerrainZ;			///< lowest terrain-pt in this cell
 	Real													m_hiTerrainZ;			///< highest terrain-pt in this cell
 #endif
-	Int														m_threatValue[MAX_PLAYER_COUNT];
-	Int														m_cashValue[MAX_PLAYER_COUNT];
 	Short													m_coiCount;					///< number of COIs in this cell.
 	Short													m_cellX;						///< x-coord of this cell within the Partition Mgr coords (NOT in world coords)
 	Short													m_cellY;						///< y-coord of this cell within the Partition Mgr coords (NOT in world coords)
@@ -330,15 +329,6 @@ public:
 	void removeShrouder( Int playerIndex );
 	CellShroudStatus getShroudStatusForPlayer( Int playerIndex ) const;
 
-	// @todo: All of these are inline candidates
-	UnsignedInt getThreatValue( Int playerIndex );
-	void addThreatValue( Int playerIndex, UnsignedInt threatValue );
-	void removeThreatValue( Int playerIndex, UnsignedInt threatValue );
-
-	UnsignedInt getCashValue( Int playerIndex );
-	void addCashValue( Int playerIndex, UnsignedInt cashValue );
-	void removeCashValue( Int playerIndex, UnsignedInt cashValue );
-
 	void invalidateShroudedStatusForAllCois(Int playerIndex);
 
 #ifdef PM_CACHE_TERRAIN_HEIGHT
@@ -361,6 +351,36 @@ public:
 	void friend_removeFromCellList(CellAndObjectIntersection *coi);
 };
 
+//=====================================
+/**
+	TheSuperHackers @performance A PartitionQueryContext carries the visited-set
+	of one getClosestObjects query. Each PartitionData keeps one done flag per
+	context slot, and a context owns its slot until it is destroyed, so queries
+	can nest (e.g. a filter that runs its own query) and can run on several
+	threads at once, as long as nobody modifies the partition meanwhile.
+	If every slot is taken, the context falls back to a private set.
+*/
+//=====================================
+enum { PARTITION_QUERY_CONTEXT_SLOTS = 8 };
+
+class PartitionQueryContext
+{
+public:
+	PartitionQueryContext();
+	~PartitionQueryContext();
+
+	/// return TRUE the first time this is called for the given data, FALSE afterwards.
+	Bool markVisited(PartitionData *data);
+
+private:
+	PartitionQueryContext(const PartitionQueryContext&);						///< not copyable
+	PartitionQueryContext& operator=(const PartitionQueryContext&);	///< not copyable
+
+	Int													m_slot;							///< done flag slot owned by this context, or -1
+	Int													m_iterFlag;					///< done flag value that marks data visited by this query
+	std::set<PartitionData*>		*m_overflowVisited;	///< visited-set used only when no slot was free
+};
+
 //=====================================
 /**
 	A PartitionData is the part of an Object that understands
@@ -390,7 +410,7 @@ private:
 	Int													m_coiArrayCount;					///< number of COIs allocated (may be more than are in use)
 	Int													m_coiInUseCount;					///< number of COIs that are actually in use
 	CellAndObjectIntersection		*m_coiArray;							///< The array of COIs
-	Int													m_doneFlag;
+	Int													m_doneFlag[PARTITION_QUERY_CONTEXT_SLOTS];	///< per PartitionQueryContext slot
 	DirtyStatus									m_dirtyStatus;
 	ObjectShroudStatus					m_shroudedness[MAX_PLAYER_COUNT];
 	ObjectShroudStatus					m_shroudednessPrevious[MAX_PLAYER_COUNT];	///<previous frames value of m_shroudedness
@@ -545,10 +565,9 @@ public:
 	Int friend_getCoiInUseCount() { return m_coiInUseCount; } ///< this is only for use by PartitionManager
 	Bool friend_collidesWith(const PartitionData *that, CollideLocAndNormal *cinfo) const { return collidesWith(that, cinfo); }	///< this is only for use by PartitionContactList
 
-	// these are only for use by getClosestObjects.
-	// (note, if we ever use other bits in this, smarten this up...)
-	Int friend_getDoneFlag() { return m_doneFlag; }
-	void friend_setDoneFlag(Int i) { m_doneFlag = i; }
+	// these are only for use by PartitionQueryContext.
+	Int friend_getDoneFlag(Int slot) const { return m_doneFlag[slot]; }
+	void friend_setDoneFlag(Int slot, Int i) { m_doneFlag[slot] = i; }
 
 	inline Bool isInListDirtyModules(PartitionData* const* pListHead) const
 	{
@@ -1246,6 +1265,10 @@ private:
 	Int							m_cellCountY;			///< number of cells, y
 	Int							m_totalCellCount;	///< x * y
 	PartitionCell*	m_cells;					///< array of cells
+	UnsignedInt*		m_threatValues;		///< TheSuperHackers @performance one plane of m_totalCellCount threat values per player
+	UnsignedInt*		m_cashValues;			///< TheSuperHackers @performance one plane of m_totalCellCount cash values per player
+	UnsignedInt*		m_threatValuesReference;	///< with -verifyThreatValues, threat values updated with per player circles
+	UnsignedInt*		m_cashValuesReference;		///< with -verifyThreatValues, cash values updated with per player circles
 	PartitionData*	m_dirtyModules;
 	Bool						m_updatedSinceLastReset;	///< Used to force a return of OBJECTSHROUD_INVALID before update has been called.
 
@@ -1256,6 +1279,9 @@ private:
 	RadiusVec				m_radiusVec;
 #endif
 
+	std::vector< std::vector<Int> > m_circleHalfWidths;	///< half width of every row of a DiscreteCircle, by cell radius
+	std::vector<UnsignedInt> m_threatValueRow;					///< scratch row for threat and cash value changes
+
 protected:
 
 	/**
@@ -1293,17 +1319,14 @@ protected:
 	void calcRadiusVec();
 #endif
 
-	// These are all friend functions now. They will continue to function as before, but can be passed into
-	// the DiscreteCircle::drawCircle function.
-	friend void hLineAddLooker(Int x1, Int x2, Int y, void *playerIndex);
-	friend void hLineRemoveLooker(Int x1, Int x2, Int y, void *playerIndex);
-	friend void hLineAddShrouder(Int x1, Int x2, Int y, void *playerIndex);
-	friend void hLineRemoveShrouder(Int x1, Int x2, Int y, void *playerIndex);
+	typedef void (PartitionCell::*ShroudCellFunc)( Int playerIndex );
 
-	friend void hLineAddThreat(Int x1, Int x2, Int y, void *threatValueParms);
-	friend void hLineRemoveThreat(Int x1, Int x2, Int y, void *threatValueParms);
-	friend void hLineAddValue(Int x1, Int x2, Int y, void *threatValueParms);
-	friend void hLineRemoveValue(Int x1, Int x2, Int y, void *threatValueParms);
+	// TheSuperHackers @performance The circle is rasterized once into spans clipped to the map, and
+	// every span is applied to all players of the mask, instead of drawing the circle once per player.
+	const std::vector<Int>& getCircleHalfWidths( Int cellRadius );
+	void applyShroudCircle( Real centerX, Real centerY, Real radius, PlayerMaskType playerMask, ShroudCellFunc func );
+	void moveThreatValueFootprint( UnsignedInt *planes, const ThreatValueFootprint &oldFootprint, const ThreatValueFootprint &newFootprint );
+	void verifyThreatValueFootprint( const UnsignedInt *planes, const ThreatValueFootprint &oldFootprint, const ThreatValueFootprint &newFootprint, Int yStart, Int yEnd );
 
 	void processPendingUndoShroudRevealQueue(Bool considerTimestamp = TRUE);				///< keep popping and processing untill you get to one that is in the future
 	void resetPendingUndoShroudRevealQueue();					///< Just delete everything in the queue without doing anything with them
@@ -1358,6 +1381,15 @@ public:
 	void doValueAffect( Real centerX, Real centerY, Real radius, UnsignedInt valueVal, PlayerMaskType playerMask);
 	void undoValueAffect( Real centerX, Real centerY, Real radius, UnsignedInt valueVal, PlayerMaskType playerMask);
 
+	/** TheSuperHackers @performance Move a threat or value from the last sighting to the new one, where
+		m_data holds the threat or value. Only the difference between both is applied, and nothing at all if
+		they cover the same cells. Either one may be invalid. */
+	void moveThreatAffect( const SightingInfo *lastThreat, const SightingInfo *newThreat );
+	void moveValueAffect( const SightingInfo *lastValue, const SightingInfo *newValue );
+
+	UnsignedInt getThreatValue( const PartitionCell *cell, Int playerIndex ) const;
+	UnsignedInt getCashValue( const PartitionCell *cell, Int playerIndex ) const;
+
 	void getCellCenterPos(Int x, Int y, Real& xx, Real& yy);
 
 	// find the cell that covers the world coords (wx,wy) and return its coords.
@@ -87,6 +87,7 @@ protected:
 
 	static PolygonTrigger* ThePolygonTriggerListPtr;
 	static Int s_currentID; ///< Current id for new triggers.
+	static UnsignedInt s_listGeneration; ///< Changes whenever a trigger is added, removed, relinked or renamed.
 
 protected:
 	void reallocate(void);
@@ -104,6 +105,7 @@ public:
 public:
 	static PolygonTrigger *getFirstPolygonTrigger(void) {return ThePolygonTriggerListPtr;}
 	static PolygonTrigger *getPolygonTriggerByID(Int triggerID);
+	static UnsignedInt getListGeneration(void) {return s_listGeneration;}
 	static Bool ParsePolygonTriggersDataChunk(DataChunkInput &file, DataChunkInfo *info, void *userData);
 	/// Writes Triggers Info
 	static void WritePolygonTriggersDataChunk(DataChunkOutput &chunkWriter);
@@ -112,12 +114,12 @@ public:
 public:
 	static void addPolygonTrigger(PolygonTrigger *pTrigger);
 	static void removePolygonTrigger(PolygonTrigger *pTrigger);
-	void setNextPoly(PolygonTrigger *nextPoly) {m_nextPolygonTrigger = nextPoly;} ///< Link the next map object.
+	void setNextPoly(PolygonTrigger *nextPoly) {m_nextPolygonTrigger = nextPoly; ++s_listGeneration;} ///< Link the next map object.
 	void addPoint(const ICoord3D &point);
 	void setPoint(const ICoord3D &point, Int ndx);
 	void insertPoint(const ICoord3D &point, Int ndx);
 	void deletePoint(Int ndx);
-	void setTriggerName(AsciiString name) {m_triggerName = name;};
+	void setTriggerName(AsciiString name) {m_triggerName = name; ++s_listGeneration;};
 
 	void setLayerName(AsciiString name) {m_layerName = name;};
 	AsciiString getLayerName(void)  const {return m_layerName;}
@@ -379,6 +379,15 @@ protected:
 	void executeScript(Script* pScript);
 	Script* findScript(const AsciiString& name);
 	ScriptGroup* findGroup(const AsciiString& name);
+	ScriptGroup* searchGroup(const AsciiString& name) const;
+	Script* searchScript(const AsciiString& name) const;
+	void buildScriptIndex(void);
+	void rebuildCounterAndFlagIndex(void);
+	Int searchCounter(const AsciiString& name) const;
+	Int searchFlag(const AsciiString& name) const;
+	Int findNamedObject(const AsciiString& name);
+	Int searchNamedObject(const AsciiString& name) const;
+	void verifyLookup(const char* kind, const AsciiString& name, Bool matches);
 	void setSway(ScriptAction* pAction);
 	void setCounter(ScriptAction* pAction);
 	void addCounter(ScriptAction* pAction);
@@ -418,6 +427,34 @@ protected:
 
 	VecSequentialScriptPtr m_sequentialScripts;
 
+	// TheSuperHackers @performance Name lookups for script operands. Each index maps a name to its
+	// first match in the search order of the linear lookup it replaces.
+	typedef std::hash_map<AsciiString, Int, rts::hash<AsciiString>, rts::equal_to<AsciiString> > NameToIndexMap;
+	typedef std::hash_map<AsciiString, Script*, rts::hash<AsciiString>, rts::equal_to<AsciiString> > NameToScriptMap;
+	typedef std::hash_map<AsciiString, ScriptGroup*, rts::hash<AsciiString>, rts::equal_to<AsciiString> > NameToScriptGroupMap;
+
+	// TheSuperHackers @performance Inputs a script condition can depend on. A script whose conditions only
+	// read tracked inputs reuses its last result until one of those inputs changes.
+	enum ScriptConditionInput
+	{
+		SCRIPT_INPUT_COUNTERS,				///< counter values, including countdown timers ticking down
+		SCRIPT_INPUT_TIMERS,					///< timers started, stopped, adjusted or expiring
+		SCRIPT_INPUT_FLAGS,						///< flag values and ui interactions
+		SCRIPT_INPUT_NAMED_OBJECTS,		///< the named object cache
+		SCRIPT_INPUT_OBJECT_COUNTS,		///< objects created, completed or destroyed
+		SCRIPT_INPUT_TRIGGER_AREAS,		///< objects entering or exiting trigger areas
+
+		SCRIPT_INPUT_COUNT
+	};
+	enum { SCRIPT_INPUTS_UNTRACKED = 1 << SCRIPT_INPUT_COUNT };	///< reads state that has no change notification
+
+	static Int getConditionInputs(Condition* pCondition);
+	Int classifyConditionInputs(Script* pScript);
+	Bool evaluateScriptConditions(Script* pScript);
+	void noteScriptInputChanged(ScriptConditionInput input) { m_scriptInputChangedAt[input] = ++m_scriptInputGeneration; }
+	void invalidateScriptConditionResults(void);
+	void notifyOfTriggerAreaEnteredOrExited(void);
+
 	void evaluateAndProgressAllSequentialScripts(void);
 	VecSequentialScriptPtrIt cleanupSequentialScript(VecSequentialScriptPtrIt it, Bool cleanDanglers);
 
@@ -443,6 +480,13 @@ protected:
 	Team* m_conditionTeam;				///< Team that is being used to evaluate conditions, used for THIS_TEAM
 	Object* m_conditionObject;				///< Unit that is being used to evaluate conditions, used for THIS_OBJECT
 	VecNamedRequests	m_namedObjects;
+	NameToIndexMap		m_counterIndex;					///< counter name to index into m_counters
+	NameToIndexMap		m_flagIndex;						///< flag name to index into m_flags
+	NameToIndexMap		m_namedObjectIndex;			///< object name to index into m_namedObjects
+	Bool							m_namedObjectIndexValid;	///< if false, m_namedObjectIndex must be rebuilt before use
+	NameToScriptMap		m_scriptIndex;					///< script name to script, for findScript
+	NameToScriptGroupMap	m_scriptGroupIndex;	///< group name to group, for findGroup
+	Bool							m_scriptIndexValid;			///< if false, findScript and findGroup search the sides
 	Bool							m_firstUpdate;
 	Player* m_currentPlayer;
 	Player* m_skirmishHumanPlayer;
@@ -458,6 +502,9 @@ protected:
 	Int								m_fadeFramesDecrease;
 
 	UnsignedInt				m_frameObjectCountChanged;
+	UnsignedInt				m_scriptInputGeneration;		///< incremented on every change to a tracked script input
+	UnsignedInt				m_scriptInputChangedAt[SCRIPT_INPUT_COUNT];	///< generation of the last change to each input
+	UnsignedInt				m_frameTriggerAreaChanged;	///< last frame a team member entered or exited a trigger area
 
 	ObjectTypeCount		m_objectCounts[MAX_PLAYER_COUNT];
 
@@ -632,8 +632,14 @@ protected:	// Note - If you add any member vars, you must take them into account
 	Real				m_conditionTime;		///< Amount of time (cum) to evaluate conditions.
 	Real				m_curTime;		///< Amount of time (cum) to evaluate conditions.
 	Int					m_conditionExecutedCount; ///< Number of times conditions evaluated.
+	Int					m_conditionInputs; ///< Runtime inputs the conditions read, as classified by ScriptEngine.
+	UnsignedInt m_conditionResultGeneration; ///< Runtime input generation of the cached condition result, 0 if none.
+	Int					m_conditionResultPlayer; ///< Runtime index of the player the cached result was evaluated for.
+	Bool				m_conditionResult; ///< Runtime cached condition result.
 
 public:
+	enum { CONDITION_INPUTS_UNKNOWN = -1 };
+
 	Script();
 	//~Script();
 	Script* duplicate(void) const;	// note, duplicates just this node, not the full list.
@@ -653,7 +659,7 @@ public:
 	void setHard(Bool hard) { m_hard = hard; }
 	void setSubroutine(Bool subr) { m_isSubroutine = subr; }
 	void setNextScript(Script* pScr) { m_nextScript = pScr; }
-	void setOrCondition(OrCondition* pCond) { m_condition = pCond; }
+	void setOrCondition(OrCondition* pCond) { m_condition = pCond; invalidateConditionCache(); }
 	void setAction(ScriptAction* pAction) { m_action = pAction; }
 	void setFalseAction(ScriptAction* pAction) { m_actionFalse = pAction; }
 	void updateFrom(Script* pSrc); ///< Updates this from pSrc.  pSrc IS MODIFIED - it's guts are removed.  jba.
@@ -701,6 +707,18 @@ public:
 	// Support routines for ScriptEngine -
 	AsciiString getConditionTeamName(void) { return m_conditionTeamName; }
 	void setConditionTeamName(AsciiString teamName) { m_conditionTeamName = teamName; }
+	Int getConditionInputs(void) const { return m_conditionInputs; }
+	void setConditionInputs(Int inputs) { m_conditionInputs = inputs; }
+	UnsignedInt getConditionResultGeneration(void) const { return m_conditionResultGeneration; }
+	Int getConditionResultPlayer(void) const { return m_conditionResultPlayer; }
+	Bool getConditionResult(void) const { return m_conditionResult; }
+	void setConditionResult(Bool result, UnsignedInt generation, Int playerIndex)
+	{
+		m_conditionResult = result;
+		m_conditionResultGeneration = generation;
+		m_conditionResultPlayer = playerIndex;
+	}
+	void invalidateConditionCache(void) { m_conditionInputs = CONDITION_INPUTS_UNKNOWN; m_conditionResultGeneration = 0; }
 };
 
 //-------------------------------------------------------------------------------------------------
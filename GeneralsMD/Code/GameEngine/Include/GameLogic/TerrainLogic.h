@@ -257,7 +257,7 @@ public:
 	virtual Waypoint *getFirstWaypoint(void) { return m_waypointListHead; }
 
 	/// Return the waypoint with the given name
-	virtual Waypoint *getWaypointByName( AsciiString name );
+	virtual Waypoint *getWaypointByName( const AsciiString& name );
 
 	/// Return the waypoint with the given ID
 	virtual Waypoint *getWaypointByID( UnsignedInt id );
@@ -269,7 +269,7 @@ public:
 	virtual Bool isPurposeOfPath( Waypoint *pWay, AsciiString label );
 
 	/// Return the trigger area with the given name
-	virtual PolygonTrigger *getTriggerAreaByName( AsciiString name );
+	virtual PolygonTrigger *getTriggerAreaByName( const AsciiString& name );
 
 	///Gets the first bridge.  Traverse all bridges using bridge->getNext();
 	virtual Bridge *getFirstBridge(void) const { return m_bridgeListHead; }
@@ -347,6 +347,16 @@ protected:
 	Waypoint *m_waypointListHead;
 	Bridge *m_bridgeListHead;
 
+	// TheSuperHackers @performance Scripts look up waypoints and trigger areas by name every frame.
+	// Each index maps a name to its first match in the list the linear lookup used to scan.
+	typedef std::hash_map<AsciiString, Waypoint*, rts::hash<AsciiString>, rts::equal_to<AsciiString> > NameToWaypointMap;
+	typedef std::hash_map<AsciiString, PolygonTrigger*, rts::hash<AsciiString>, rts::equal_to<AsciiString> > NameToTriggerAreaMap;
+
+	NameToWaypointMap m_waypointIndex;						///< waypoint name to waypoint, kept up to date by addWaypoint and deleteWaypoints
+	NameToTriggerAreaMap m_triggerAreaIndex;			///< trigger name to trigger area, rebuilt when the trigger list changes
+	UnsignedInt m_triggerAreaIndexGeneration;			///< PolygonTrigger list generation m_triggerAreaIndex was built from
+	Bool m_triggerAreaIndexValid;
+
 	Bool		m_bridgeDamageStatesChanged;
 
 	AsciiString m_filenameString;  ///< filename for terrain data
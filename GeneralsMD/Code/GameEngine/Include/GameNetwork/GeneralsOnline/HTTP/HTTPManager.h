@@ -3,6 +3,8 @@
 #include "HTTPRequest.h"
 #include "GameNetwork/GeneralsOnline/Vendor/libcurl/multi.h"
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 #include <thread>
 #include <atomic>
@@ -36,9 +38,6 @@ public:
 
 	void Tick();
 
-	void AddHandleToMulti(CURL* pNewHandle);
-	void RemoveHandleFromMulti(CURL* pHandleToRemove);
-
 	void SendGETRequest(const char* szURI, EIPProtocolVersion protover, std::map<std::string, std::string>& inHeaders, std::function<void(bool bSuccess, int statusCode, std::string strBody, HTTPRequest* pReq)> completionCallback, std::function<void(size_t bytesReceived)> progressCallback = nullptr, int timeoutMS = -1);
 	void SendPOSTRequest(const char* szURI, EIPProtocolVersion protover, std::map<std::string, std::string>& inHeaders, const char* szPostData, std::function<void(bool bSuccess, int statusCode, std::string strBody, HTTPRequest* pReq)> completionCallback, std::function<void(size_t bytesReceived)> progressCallback = nullptr, int timeoutMS = -1);
 	void SendPUTRequest(const char* szURI, EIPProtocolVersion protover, std::map<std::string, std::string>& inHeaders, const char* szData, std::function<void(bool bSuccess, int statusCode, std::string strBody, HTTPRequest* pReq)> completionCallback, std::function<void(size_t bytesReceived)> progressCallback = nullptr, int timeoutMS = -1);
@@ -56,6 +55,13 @@ private:
 	HTTPRequest* PlatformCreateRequest(EHTTPVerb htpVerb, EIPProtocolVersion protover, const char* szURI, std::map<std::string, std::string>& inHeaders, std::function<void(bool bSuccess, int statusCode, std::string strBody, HTTPRequest* pReq)> completionCallback,
 		std::function<void(size_t bytesReceived)> progressCallback = nullptr, int timeoutMS = -1) noexcept;
 
+	// TheSuperHackers @performance curl is driven by its own thread blocking in curl_multi_poll. Requests are handed
+	// to it and back through lock-free intrusive queues, so the main thread never waits on socket I/O.
+	void IOThreadMain();
+
+	static void PushQueuedRequest(std::atomic<HTTPRequest*>& queueHead, HTTPRequest* pRequest);
+	static HTTPRequest* PopAllQueuedRequests(std::atomic<HTTPRequest*>& queueHead);
+
 private:
 	CURLM* m_pCurl = nullptr;
 
@@ -66,7 +72,16 @@ private:
 	std::atomic<bool> m_bShuttingDown = false;
 
 	std::vector<HTTPRequest*> m_vecRequestsPendingStart = std::vector<HTTPRequest*>();
-	std::vector<HTTPRequest*> m_vecRequestsInFlight = std::vector<HTTPRequest*>();
+
+	// main thread only
+	std::unordered_set<HTTPRequest*> m_setRequestsInFlight = std::unordered_set<HTTPRequest*>();
+
+	// IO thread only
+	std::unordered_map<CURL*, HTTPRequest*> m_mapRequestsByHandle = std::unordered_map<CURL*, HTTPRequest*>();
+
+	std::thread m_ioThread;
+	std::atomic<HTTPRequest*> m_pRequestsToAdd = nullptr;		// main thread -> IO thread
+	std::atomic<HTTPRequest*> m_pRequestsCompleted = nullptr;	// IO thread -> main thread
 };
 
 
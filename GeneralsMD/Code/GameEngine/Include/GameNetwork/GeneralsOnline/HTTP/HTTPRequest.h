@@ -4,12 +4,15 @@
 #include <map>
 #include <string>
 #include <functional>
+#include <atomic>
 
 enum class EHTTPVerb;
 enum class EIPProtocolVersion;
 
 class HTTPRequest
 {
+	friend class HTTPManager;
+
 public:
 	HTTPRequest(EHTTPVerb httpVerb, EIPProtocolVersion protover, const char* szURI, std::map<std::string, std::string>& inHeaders, std::function<void(bool bSuccess, int statusCode, std::string strBody, HTTPRequest* pReq)> completionCallback, std::function<void(size_t bytesReceived)>
 		progressCallback = nullptr, int timeout = -1) noexcept;
@@ -35,12 +38,16 @@ public:
 	bool HasStarted() const { return m_bIsStarted; }
 	bool IsComplete() const { return m_bIsComplete; }
 
+	// TheSuperHackers @performance Transfers run on the HTTPManager IO thread, so writes only flag that progress
+	// changed and the callback itself is invoked from HTTPManager::Tick on the main thread.
 	bool NeedsProgressUpdate() const { return m_bNeedsProgressUpdate; }
 	void InvokeProgressUpdateCallback()
 	{
+		m_bNeedsProgressUpdate = false;
+
 		if (m_progressCallback != nullptr)
 		{
-			m_progressCallback(m_currentBufSize_Used);
+			m_progressCallback(m_bytesReceived);
 		}
 	}
 
@@ -88,12 +95,17 @@ private:
 
 	const size_t g_initialBufSize = (1024 * 32); // 32KB
 
-	bool m_bNeedsProgressUpdate = false;
+	std::atomic<bool> m_bNeedsProgressUpdate = false;
+	std::atomic<size_t> m_bytesReceived = 0;
 	bool m_bIsStarted = false;
 	bool m_bIsComplete = false;
 
 	struct curl_slist* headers = nullptr;
 
+	// link for the HTTPManager hand-over queues, a request is only ever in one of them at a time
+	HTTPRequest* m_pNextQueued = nullptr;
+	CURLcode m_completionResult = CURL_LAST;
+
 	std::function<void(bool bSuccess, int statusCode, std::string strBody, HTTPRequest* pReq)> m_completionCallback = nullptr;
 
 	std::function<void(size_t bytesReceived)> m_progressCallback = nullptr;
@@ -42,6 +42,8 @@ public:
 	EConnectionState GetState() const { return m_State; }
 
 	int SendGamePacket(void* pBuffer, uint32_t totalDataSize);
+	SteamNetworkingMessage_t* CreateGamePacketMessage(const void* pBuffer, uint32_t totalDataSize, int sendFlags);
+	static int GetGamePacketSendFlags();
 
 	void UpdateLatencyHistogram();
 
@@ -41,5 +41,12 @@ public:
 	inline Bool allowBroadcasts(Bool val) override { return false; }
 
 private:
-	
+
+	// TheSuperHackers @performance Bookkeeping for m_outBuffer so that queueSend and doSend do not have
+	// to scan all MAX_MESSAGES slots, and reusable storage for the messages doSend hands to Steam in one batch.
+	Int m_numQueuedSends;																///< number of m_outBuffer slots in use
+	Int m_firstFreeSendSlot;														///< no m_outBuffer slot below this index is free
+	std::vector<SteamNetworkingMessage_t*> m_sendBatch;
+	std::vector<Int> m_sendBatchSlots;
+	std::vector<int64> m_sendBatchResults;
 };
\ No newline at end of file
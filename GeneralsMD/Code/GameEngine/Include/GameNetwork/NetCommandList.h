@@ -26,6 +26,7 @@
 
 #include "Common/GameMemory.h"
 #include "GameNetwork/NetCommandRef.h"
+#include <Utility/hash_map_adapter.h>
 
 /**
  * The NetCommandList is a ordered linked list of NetCommandRef objects.
@@ -38,8 +39,15 @@
  * found.  We can get away with this inefficient method since these occurances
  * will be rare.  Also, the list is not expected to ever have more than 30 or so
  * commands on it at a time.  Five commands would probably be a normal amount.
+ *
+ * TheSuperHackers @performance The resend list of a peer on a bad link can grow to
+ * hundreds of commands. Once a list holds NET_COMMAND_LIST_INDEX_THRESHOLD commands,
+ * it builds an index keyed by player id and command id so that acks and lookups do not
+ * walk the list. The list order itself is unchanged.
  */
 
+enum { NET_COMMAND_LIST_INDEX_THRESHOLD = 32 };
+
 class NetCommandList : public MemoryPoolObject
 {
 	MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE(NetCommandList, "NetCommandList")
@@ -57,12 +65,29 @@ public:
 																								///< message given the player id and the command id.
 																								///< This will only check against messages of types that require
 																								///< a command id.
+	NetCommandRef * findMessageByID(UnsignedShort commandID, UnsignedByte playerID);	///< Like findMessage, but also matches messages of
+																								///< types that don't require a command id.
 	void removeMessage(NetCommandRef *msg);			///< Remove the given message from the list.
 	void appendList(NetCommandList *list);			///< Append the given list to the end of this list.
 	Int length();									///< Returns the number of nodes in this list.  This is inefficient and is meant to be a debug tool.
 
 protected:
+	struct IndexEntry
+	{
+		NetCommandRef *ref;							///< The only message with this key, NULL if there is more than one or it is not known.
+		Int count;									///< Number of messages in the list with this key.
+	};
+	typedef std::hash_map<UnsignedInt, IndexEntry> Index;
+
+	NetCommandRef * insertMessage(NetCommandMsg *cmdMsg);	///< Does the ordered insert for addMessage.
+	NetCommandRef * findIndexedMessage(UnsignedShort commandID, UnsignedInt playerID, Bool &found);
+	void indexMessage(NetCommandRef *msg);
+	void unindexMessage(NetCommandRef *msg);
+	static UnsignedInt getIndexKey(UnsignedShort commandID, UnsignedInt playerID) { return (playerID << 16) | commandID; }
+
 	NetCommandRef *m_first;							///< Head of the list.
 	NetCommandRef *m_last;							///< Tail of the list.
 	NetCommandRef *m_lastMessageInserted;			///< The last message that was inserted to this list.
+	Int m_count;									///< Number of messages in the list.
+	Index *m_index;									///< Lookup by player id and command id, NULL until the list grows long enough.
 };
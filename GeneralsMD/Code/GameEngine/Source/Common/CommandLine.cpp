@@ -170,6 +170,13 @@ Int parseFullViewport(char *args[], int num)
 	return 1;
 }
 
+Int parseParallelAnimUpdate(char *args[], int num)
+{
+	TheWritableGlobalData->m_parallelAnimationUpdate = TRUE;
+
+	return 1;
+}
+
 #if defined(RTS_DEBUG)
 
 //=============================================================================
@@ -206,6 +213,7 @@ Int parseNoMilCap(char *args[], int)
 
 	return 1;
 }
+
 #endif // RTS_DEBUG
 
 //=============================================================================
@@ -458,6 +466,76 @@ Int parseJobs(char *args[], int num)
 	return 1;
 }
 
+Int parseReplayCheckpoints(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_replayCheckpointInterval = atoi(args[1]);
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBisectReplayCRC(char *args[], int num)
+{
+	TheWritableGlobalData->m_bisectReplayCRC = TRUE;
+
+	// Rewinding needs checkpoints, so take one every 30 seconds of game time unless told otherwise.
+	if (TheGlobalData->m_replayCheckpointInterval == 0)
+		TheWritableGlobalData->m_replayCheckpointInterval = 30 * LOGICFRAMES_PER_SECOND;
+
+	return 1;
+}
+
+Int parseReplaySeek(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_replaySeekFrame = atoi(args[1]);
+
+		// Rewinding needs checkpoints, so take one every 30 seconds of game time unless told otherwise.
+		if (TheGlobalData->m_replayCheckpointInterval == 0)
+			TheWritableGlobalData->m_replayCheckpointInterval = 30 * LOGICFRAMES_PER_SECOND;
+
+		return 2;
+	}
+	return 1;
+}
+
+Int parseVerifyScriptConditions(char *args[], int num)
+{
+	TheWritableGlobalData->m_verifyScriptConditions = TRUE;
+	return 1;
+}
+
+Int parseVerifyThreatValues(char *args[], int num)
+{
+	TheWritableGlobalData->m_verifyThreatValues = TRUE;
+	return 1;
+}
+
+Int parseVerifyScriptLookups(char *args[], int num)
+{
+	TheWritableGlobalData->m_verifyScriptLookups = TRUE;
+	return 1;
+}
+
+Int parseCompactReplays(char *args[], int num)
+{
+	TheWritableGlobalData->m_compactReplays = TRUE;
+	return 1;
+}
+
+Int parseReplayProfile(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_replayProfileFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
 Int parseXRes(char *args[], int num)
 {
 	if (num > 1)
@@ -1175,6 +1253,42 @@ static CommandLineParam paramsForStartup[] =
 	// (If you have 4 cores, call it with -jobs 4)
 	// If you do not call this, all replays will be simulated in sequence in the same process.
 	{ "-jobs", parseJobs },
+
+	// TheSuperHackers @feature Write the cost of every GameLogic::update phase per logic frame to the given CSV file.
+	// Combine this with -replay and -headless. Replays are then always simulated in this process.
+	{ "-replayProfile", parseReplayProfile },
+
+	// TheSuperHackers @feature Keep a compressed in-memory checkpoint every N logic frames during replay playback,
+	// so that playback can seek back to any earlier frame without starting over from frame 0.
+	{ "-replayCheckpoints", parseReplayCheckpoints },
+
+	// TheSuperHackers @feature On a replay CRC mismatch, rewind to the latest checkpoint before the last matching CRC
+	// and print the logic CRC of every frame up to the mismatch. Diff that output against a build that does not
+	// mismatch to find the first diverging frame. Implies -replayCheckpoints 900 unless it is given.
+	{ "-bisectReplayCRC", parseBisectReplayCRC },
+
+	// TheSuperHackers @feature When the replay ends, rewind once to the latest checkpoint at or before the given frame
+	// and play the rest again. The recorded CRCs are checked again on the second pass, so combined with -headless
+	// this verifies that checkpoints restore the game exactly. Implies -replayCheckpoints 900 unless it is given.
+	{ "-replaySeek", parseReplaySeek },
+
+	// TheSuperHackers @feature Evaluate the conditions of every script that reuses its last condition result
+	// and compare the two. A difference fails the replay like a CRC mismatch does.
+	{ "-verifyScriptConditions", parseVerifyScriptConditions },
+
+	// TheSuperHackers @feature Also keep the threat and cash values of the partition manager with one circle per player
+	// and footprint, as before they were merged into rows, and compare the two after every change. A difference fails
+	// the replay like a CRC mismatch does.
+	{ "-verifyThreatValues", parseVerifyThreatValues },
+
+	// TheSuperHackers @feature Also resolve every script name lookup that goes through a hash index (counters, flags,
+	// named units, scripts, script groups, waypoints and trigger areas) with the linear search it replaced, and compare
+	// the two. A difference fails the replay like a CRC mismatch does.
+	{ "-verifyScriptLookups", parseVerifyScriptLookups },
+
+	// TheSuperHackers @feature Record replays in the compressed and indexed GENRPZ layout instead of the retail one.
+	// The retail game and replay tools cannot read that layout, so it is opt-in. Both layouts can always be played back.
+	{ "-compactReplays", parseCompactReplays },
 };
 
 // These Params are parsed during Engine Init before INI data is loaded
@@ -1195,6 +1309,10 @@ static CommandLineParam paramsForEngineInit[] =
 	// TheSuperHackers @feature xezon 03/08/2025 Force full viewport for 'Control Bar Pro' Addons like GenTool did it.
 	{ "-forcefullviewport", parseFullViewport },
 
+	// TheSuperHackers @feature Update the animations of the drawn render objects on up to three worker threads
+	// before rendering them. Without it they are updated on the main thread while rendering, in the original order.
+	{ "-parallelAnimUpdate", parseParallelAnimUpdate },
+
 #if defined(RTS_DEBUG)
 	{ "-noaudio", parseNoAudio },
 	{ "-map", parseMapName },
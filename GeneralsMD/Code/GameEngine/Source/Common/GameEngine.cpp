@@ -993,6 +993,9 @@ void GameEngine::update(void)
 			}
 
 			TheCDManager->UPDATE();
+
+			// report save games that finished writing in the background
+			TheGameState->UPDATE();
 		}
 
 		const Bool canUpdate = canUpdateGameLogic();
@@ -33,6 +33,38 @@
 #include "Common/ReplaySimulation.h"
 
 
+/**
+ * The replay options that worker processes need to check a replay the same way as this process.
+ */
+static std::vector<AsciiString> getReplayWorkerArguments()
+{
+	std::vector<AsciiString> arguments;
+	AsciiString value;
+
+	if (TheGlobalData->m_replayCheckpointInterval != 0)
+	{
+		value.format("%u", TheGlobalData->m_replayCheckpointInterval);
+		arguments.push_back("-replayCheckpoints");
+		arguments.push_back(value);
+	}
+	if (TheGlobalData->m_bisectReplayCRC)
+		arguments.push_back("-bisectReplayCRC");
+	if (TheGlobalData->m_replaySeekFrame >= 0)
+	{
+		value.format("%d", TheGlobalData->m_replaySeekFrame);
+		arguments.push_back("-replaySeek");
+		arguments.push_back(value);
+	}
+	if (TheGlobalData->m_verifyScriptConditions)
+		arguments.push_back("-verifyScriptConditions");
+	if (TheGlobalData->m_verifyThreatValues)
+		arguments.push_back("-verifyThreatValues");
+	if (TheGlobalData->m_verifyScriptLookups)
+		arguments.push_back("-verifyScriptLookups");
+
+	return arguments;
+}
+
 /**
  * This is the entry point for the game system.
  */
@@ -47,7 +79,8 @@ Int GameMain()
 
 	if (!TheGlobalData->m_simulateReplays.empty())
 	{
-		exitcode = ReplaySimulation::simulateReplays(TheGlobalData->m_simulateReplays, TheGlobalData->m_simulateReplayJobs);
+		exitcode = ReplaySimulation::simulateReplays(TheGlobalData->m_simulateReplays, TheGlobalData->m_simulateReplayJobs,
+			getReplayWorkerArguments());
 	}
 	else
 	{
@@ -497,6 +497,7 @@ GlobalData* GlobalData::m_theOriginal = NULL;
 #if defined(RTS_DEBUG)
 	{ "DisableCameraFade",			INI::parseBool,				NULL,			offsetof( GlobalData, m_disableCameraFade ) },
 	{ "DisableScriptedInputDisabling",			INI::parseBool,		NULL,			offsetof( GlobalData, m_disableScriptedInputDisabling ) },
+	{ "VerifyScriptConditions",			INI::parseBool,				NULL,			offsetof( GlobalData, m_verifyScriptConditions ) },
 	{ "DisableMilitaryCaption",			INI::parseBool,				NULL,			offsetof( GlobalData, m_disableMilitaryCaption ) },
 	{ "BenchmarkTimer",			INI::parseInt,				NULL,			offsetof( GlobalData, m_benchmarkTimer ) },
 	{ "CheckMemoryLeaks", INI::parseBool, NULL, offsetof(GlobalData, m_checkForLeaks) },
@@ -831,6 +832,7 @@ GlobalData::GlobalData()
 	m_debugSupplyCenterPlacement = FALSE;
 	m_debugAIObstacles = FALSE;
 	m_showClientPhysics = TRUE;
+	m_parallelAnimationUpdate = FALSE;
 	m_showTerrainNormals = FALSE;
 	m_showObjectHealth = FALSE;
 
@@ -980,6 +982,14 @@ GlobalData::GlobalData()
 
 	m_simulateReplays.clear();
 	m_simulateReplayJobs = SIMULATE_REPLAYS_SEQUENTIAL;
+	m_replayProfileFile.clear();
+	m_replayCheckpointInterval = 0;
+	m_bisectReplayCRC = FALSE;
+	m_replaySeekFrame = -1;
+	m_verifyScriptConditions = FALSE;
+	m_verifyThreatValues = FALSE;
+	m_verifyScriptLookups = FALSE;
+	m_compactReplays = FALSE;
 
 	for (i = LEVEL_FIRST; i <= LEVEL_LAST; ++i)
 		m_healthBonus[i] = 1.0f;
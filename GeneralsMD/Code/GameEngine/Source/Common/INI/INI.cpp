@@ -59,6 +59,10 @@
 #include "GameLogic/ScriptEngine.h"
 #include "GameLogic/Weapon.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // PRIVATE DATA ///////////////////////////////////////////////////////////////////////////////////
@@ -179,8 +183,9 @@ Bool INI::isValidINIFilename(const char* filename)
 INI::INI(void)
 {
 
-	m_file = NULL;
-	m_readBufferNext = m_readBufferUsed = 0;
+	m_lexedFile = NULL;
+	m_nextLine = NULL;
+	m_linesLeft = 0;
 	m_filename = "None";
 	m_loadType = INI_LOAD_INVALID;
 	m_lineNum = 0;
@@ -204,6 +209,44 @@ INI::~INI(void)
 
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Append all INI files in the specified directory (and subdirectories if indicated) to
+	* filenames, in the order they must be loaded. Files in subdirectories come *after*
+	* all the files in the directory itself */
+//-------------------------------------------------------------------------------------------------
+static void getDirectoryLoadOrder(AsciiString dirName, Bool subdirs, std::vector<AsciiString>& filenames)
+{
+	FilenameList filenameList;
+	dirName.concat('\\');
+	TheFileSystem->getFileListInDirectory(dirName, "*.ini", filenameList, subdirs);
+	// Load the INI files in the dir now, in a sorted order.  This keeps things the same between machines
+	// in a network game.
+	FilenameList::const_iterator it = filenameList.begin();
+	while (it != filenameList.end())
+	{
+		AsciiString tempname;
+		tempname = (*it).str() + dirName.getLength();
+
+		if ((tempname.find('\\') == NULL) && (tempname.find('/') == NULL)) {
+			// this file doesn't reside in a subdirectory, load it first.
+			filenames.push_back(*it);
+		}
+		++it;
+	}
+
+	it = filenameList.begin();
+	while (it != filenameList.end())
+	{
+		AsciiString tempname;
+		tempname = (*it).str() + dirName.getLength();
+
+		if ((tempname.find('\\') != NULL) || (tempname.find('/') != NULL)) {
+			filenames.push_back(*it);
+		}
+		++it;
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 UnsignedInt INI::loadFileDirectory(AsciiString fileDirName, INILoadType loadType, Xfer* pXfer, Bool subdirs)
 {
@@ -224,13 +267,21 @@ UnsignedInt INI::loadFileDirectory(AsciiString fileDirName, INILoadType loadType
 		iniFile.concat(ext);
 	}
 
+	// sanity
+	if (iniDir.isEmpty())
+		throw INI_INVALID_DIRECTORY;
+
+	std::vector<AsciiString> filenames;
+
 	if (TheFileSystem->doesFileExist(iniFile.str()))
 	{
-		filesRead += load(iniFile, loadType, pXfer);
+		filenames.push_back(iniFile);
 	}
 
 	// Load any additional ini files from a "filename" directory and its subdirectories.
-	filesRead += loadDirectory(iniDir, loadType, pXfer, subdirs);
+	getDirectoryLoadOrder(iniDir, subdirs, filenames);
+
+	filesRead += loadFiles(filenames, loadType, pXfer);
 
 	// Expect to open and load at least one file.
 	if (filesRead == 0)
@@ -248,46 +299,175 @@ UnsignedInt INI::loadFileDirectory(AsciiString fileDirName, INILoadType loadType
 	//-------------------------------------------------------------------------------------------------
 UnsignedInt INI::loadDirectory(AsciiString dirName, INILoadType loadType, Xfer* pXfer, Bool subdirs)
 {
-	UnsignedInt filesRead = 0;
-
 	// sanity
 	if (dirName.isEmpty())
 		throw INI_INVALID_DIRECTORY;
 
-	try
+	std::vector<AsciiString> filenames;
+	getDirectoryLoadOrder(dirName, subdirs, filenames);
+
+	return loadFiles(filenames, loadType, pXfer);
+}
+
+//-------------------------------------------------------------------------------------------------
+/** One file of a parallel directory load. The main thread fills in the file contents,
+	* a worker thread lexes them */
+//-------------------------------------------------------------------------------------------------
+struct INILexJob
+{
+	INILexJob() : data(NULL), size(0), opened(FALSE), lexed(FALSE) {}
+
+	char *data;
+	Int size;
+	Bool opened;
+	Bool lexed;
+	INILexedFile lexedFile;
+};
+
+//-------------------------------------------------------------------------------------------------
+/** Worker threads that lex INI files as soon as the main thread has read them. Lexing only
+	* touches the job it works on, so the workers never get in the way of the main thread
+	* parsing the files that are already done */
+//-------------------------------------------------------------------------------------------------
+class INILexWorkers
+{
+public:
+	INILexWorkers(std::vector<INILexJob>& jobs) : m_jobs(jobs), m_readCount(0), m_nextJob(0), m_stop(false) {}
+	~INILexWorkers() { stop(); }
+
+	void start(UnsignedInt threadCount)
+	{
+		for (UnsignedInt i = 0; i < threadCount; ++i)
+			m_threads.push_back(std::thread(&INILexWorkers::run, this));
+	}
+
+	void stop()
 	{
-		FilenameList filenameList;
-		dirName.concat('\\');
-		TheFileSystem->getFileListInDirectory(dirName, "*.ini", filenameList, subdirs);
-		// Load the INI files in the dir now, in a sorted order.  This keeps things the same between machines
-		// in a network game.
-		FilenameList::const_iterator it = filenameList.begin();
-		while (it != filenameList.end())
 		{
-			AsciiString tempname;
-			tempname = (*it).str() + dirName.getLength();
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_readCondition.notify_all();
 
-			if ((tempname.find('\\') == NULL) && (tempname.find('/') == NULL)) {
-				// this file doesn't reside in a subdirectory, load it first.
-				filesRead += load(*it, loadType, pXfer);
-			}
-			++it;
+		for (size_t i = 0; i < m_threads.size(); ++i)
+			m_threads[i].join();
+		m_threads.clear();
+	}
+
+	void setReadCount(size_t readCount)	///< the first readCount jobs have their file contents now
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_readCount = readCount;
 		}
+		m_readCondition.notify_all();
+	}
 
-		it = filenameList.begin();
-		while (it != filenameList.end())
+	void waitUntilLexed(size_t index)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_lexedCondition.wait(lock, [this, index] { return m_jobs[index].lexed; });
+	}
+
+private:
+	void run()
+	{
+		for (;;)
 		{
-			AsciiString tempname;
-			tempname = (*it).str() + dirName.getLength();
+			size_t index;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_readCondition.wait(lock, [this] { return m_stop || m_nextJob < m_readCount || m_nextJob == m_jobs.size(); });
+				if (m_stop || m_nextJob == m_jobs.size())
+					break;
+				index = m_nextJob++;
+			}
+
+			INILexJob& job = m_jobs[index];
+			if (job.opened)
+				job.lexedFile.lex(job.data, job.size);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				job.lexed = TRUE;
+			}
+			m_lexedCondition.notify_all();
+		}
+	}
+
+	std::vector<INILexJob>& m_jobs;
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_readCondition;	///< signaled when more files were read or the workers must stop
+	std::condition_variable m_lexedCondition;	///< signaled when a file was lexed
+	size_t m_readCount;
+	size_t m_nextJob;
+	bool m_stop;
+};
 
-			if ((tempname.find('\\') != NULL) || (tempname.find('/') != NULL)) {
-				filesRead += load(*it, loadType, pXfer);
+//-------------------------------------------------------------------------------------------------
+/** Load the given INI files in order.
+	* TheSuperHackers @performance Splitting a file into lines does not depend on game state,
+	* so with more than one file the files are lexed on worker threads while the main thread
+	* parses them in their original order. The file system is not thread safe, so the files
+	* are still read on the main thread. The lines are exactly what load() would see, so the
+	* INI CRC does not change */
+//-------------------------------------------------------------------------------------------------
+UnsignedInt INI::loadFiles(const std::vector<AsciiString>& filenames, INILoadType loadType, Xfer* pXfer)
+{
+	UnsignedInt filesRead = 0;
+	const size_t fileCount = filenames.size();
+	const UnsignedInt hardwareThreads = std::thread::hardware_concurrency();
+
+	if (fileCount < 2 || hardwareThreads <= 1)
+	{
+		for (size_t i = 0; i < fileCount; ++i)
+			filesRead += load(filenames[i], loadType, pXfer);
+
+		return filesRead;
+	}
+
+	std::vector<INILexJob> jobs(fileCount);
+
+	try
+	{
+		// The main thread reads and parses, so leave it a core of its own
+		INILexWorkers workers(jobs);
+		workers.start(min(hardwareThreads - 1, (UnsignedInt)fileCount));
+
+		for (size_t i = 0; i < fileCount; ++i)
+		{
+			File *file = TheFileSystem->openFile(filenames[i].str(), File::READ);
+			if (file != NULL)
+			{
+				jobs[i].size = file->size();
+				jobs[i].data = file->readEntireAndClose();
+				jobs[i].opened = TRUE;
 			}
-			++it;
+			workers.setReadCount(i + 1);
+		}
+
+		for (size_t i = 0; i < fileCount; ++i)
+		{
+			workers.waitUntilLexed(i);
+
+			// a file that could not be opened goes through load() so it fails exactly like before
+			if (jobs[i].opened)
+				filesRead += loadLexed(filenames[i], &jobs[i].lexedFile, loadType, pXfer);
+			else
+				filesRead += load(filenames[i], loadType, pXfer);
+
+			delete [] jobs[i].data;
+			jobs[i].data = NULL;
+			jobs[i].lexedFile.clear();
 		}
 	}
 	catch (...)
 	{
+		// the workers are joined by now
+		for (size_t i = 0; i < fileCount; ++i)
+			delete [] jobs[i].data;
+
 		// propagate the exception
 		throw;
 	}
@@ -300,7 +480,7 @@ UnsignedInt INI::loadDirectory(AsciiString dirName, INILoadType loadType, Xfer*
 void INI::prepFile(AsciiString filename, INILoadType loadType)
 {
 	// if we have a file open already -- we can't do another one
-	if (m_file != NULL)
+	if (m_lexedFile != NULL)
 	{
 
 		DEBUG_CRASH(("INI::load, cannot open file '%s', file already open", filename.str()));
@@ -309,8 +489,8 @@ void INI::prepFile(AsciiString filename, INILoadType loadType)
 	}
 
 	// open the file
-	m_file = TheFileSystem->openFile(filename.str(), File::READ);
-	if (m_file == NULL)
+	File *file = TheFileSystem->openFile(filename.str(), File::READ);
+	if (file == NULL)
 	{
 
 		DEBUG_CRASH(("INI::load, cannot open file '%s'", filename.str()));
@@ -318,7 +498,35 @@ void INI::prepFile(AsciiString filename, INILoadType loadType)
 
 	}
 
-	m_file = m_file->convertToRAMFile();
+	const Int size = file->size();
+	char *data = file->readEntireAndClose();
+	m_ownLexedFile.lex(data, size);
+	delete [] data;
+
+	prepLexedFile(filename, &m_ownLexedFile, loadType);
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void INI::prepLexedFile(AsciiString filename, const INILexedFile *lexedFile, INILoadType loadType)
+{
+	// if we have a file open already -- we can't do another one
+	if (m_lexedFile != NULL)
+	{
+
+		DEBUG_CRASH(("INI::load, cannot open file '%s', file already open", filename.str()));
+		throw INI_FILE_ALREADY_OPEN;
+
+	}
+
+	DEBUG_ASSERTCRASH(lexedFile->getFirstTabLine() == 0, ("tab characters are not allowed in INI files (%s). please check your editor settings. Line Number %d",
+		filename.str(), lexedFile->getFirstTabLine()));
+	DEBUG_ASSERTCRASH(lexedFile->getFirstTruncatedLine() == 0, ("Buffer too small (%d) and was truncated, increase INI_MAX_CHARS_PER_LINE",
+		INI_MAX_CHARS_PER_LINE));
+
+	m_lexedFile = lexedFile;
+	m_nextLine = lexedFile->getLines();
+	m_linesLeft = lexedFile->getLineCount();
 
 	// save our filename
 	m_filename = filename;
@@ -331,10 +539,11 @@ void INI::prepFile(AsciiString filename, INILoadType loadType)
 //-------------------------------------------------------------------------------------------------
 void INI::unPrepFile()
 {
-	// close the file
-	m_file->close();
-	m_file = NULL;
-	m_readBufferUsed = m_readBufferNext = 0;
+	// forget the file
+	m_lexedFile = NULL;
+	m_ownLexedFile.clear();
+	m_nextLine = NULL;
+	m_linesLeft = 0;
 	m_filename = "None";
 	m_loadType = INI_LOAD_INVALID;
 	m_lineNum = 0;
@@ -355,8 +564,9 @@ static INIBlockParse findBlockParse(const char* token)
 	return NULL;
 }
 
+#ifdef RTS_DEBUG
 //-------------------------------------------------------------------------------------------------
-static INIFieldParseProc findFieldParse(const FieldParse* parseTable, const char* token, int& offset, const void*& userData)
+static INIFieldParseProc findFieldParseLinear(const FieldParse* parseTable, const char* token, int& offset, const void*& userData)
 {
 	const FieldParse* parse = parseTable;
 	for (; parse->token; ++parse)
@@ -380,6 +590,121 @@ static INIFieldParseProc findFieldParse(const FieldParse* parseTable, const char
 		return NULL;
 	}
 }
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// TheSuperHackers @performance Every FieldParse table is indexed with an open addressing hash of its
+// tokens the first time it is used, so a field lookup costs one hash and usually one strcmp instead of
+// a strcmp per table entry. The index is keyed by the table address, so tables must be static data.
+//-------------------------------------------------------------------------------------------------
+class FieldParseIndex
+{
+public:
+	FieldParseIndex() : m_mask(0), m_terminator(NULL) {}
+
+	void build(const FieldParse* parseTable)
+	{
+		const FieldParse* parse = parseTable;
+		UnsignedInt count = 0;
+		for (; parse->token; ++parse)
+			++count;
+		m_terminator = parse;
+
+		// keep the load factor at or below one half
+		UnsignedInt slotCount = 4;
+		while (slotCount < count * 2)
+			slotCount <<= 1;
+		m_mask = slotCount - 1;
+		m_slots.assign(slotCount, (const FieldParse*)NULL);
+
+		for (parse = parseTable; parse->token; ++parse)
+		{
+			UnsignedInt slot = hashToken(parse->token) & m_mask;
+			Bool duplicate = FALSE;
+			while (m_slots[slot] != NULL)
+			{
+				// the linear search returned the first of duplicate tokens, so keep that one
+				if (strcmp(m_slots[slot]->token, parse->token) == 0)
+				{
+					duplicate = TRUE;
+					break;
+				}
+				slot = (slot + 1) & m_mask;
+			}
+			if (!duplicate)
+				m_slots[slot] = parse;
+		}
+	}
+
+	INIFieldParseProc find(const char* token, int& offset, const void*& userData) const
+	{
+		UnsignedInt slot = hashToken(token) & m_mask;
+		for (const FieldParse* parse = m_slots[slot]; parse != NULL; parse = m_slots[slot])
+		{
+			if (strcmp(parse->token, token) == 0)
+			{
+				offset = parse->offset;
+				userData = parse->userData;
+				return parse->parse;
+			}
+			slot = (slot + 1) & m_mask;
+		}
+
+		// same catch-all semantics as the terminating entry of the table
+		if (m_terminator->parse)
+		{
+			offset = m_terminator->offset;
+			userData = token;
+			return m_terminator->parse;
+		}
+		return NULL;
+	}
+
+private:
+	static UnsignedInt hashToken(const char* token)
+	{
+		// FNV-1a
+		UnsignedInt hash = 2166136261u;
+		for (; *token; ++token)
+			hash = (hash ^ (UnsignedByte)*token) * 16777619u;
+		return hash;
+	}
+
+	std::vector<const FieldParse*> m_slots;
+	UnsignedInt m_mask;
+	const FieldParse* m_terminator;
+};
+
+typedef std::map<const FieldParse*, FieldParseIndex> FieldParseIndexMap;
+static FieldParseIndexMap s_fieldParseIndices;
+
+//-------------------------------------------------------------------------------------------------
+static const FieldParseIndex* getFieldParseIndex(const FieldParse* parseTable)
+{
+	FieldParseIndexMap::iterator it = s_fieldParseIndices.find(parseTable);
+	if (it == s_fieldParseIndices.end())
+	{
+		it = s_fieldParseIndices.insert(FieldParseIndexMap::value_type(parseTable, FieldParseIndex())).first;
+		it->second.build(parseTable);
+	}
+	return &it->second;
+}
+
+//-------------------------------------------------------------------------------------------------
+static INIFieldParseProc findFieldParse(const FieldParseIndex* index, const FieldParse* parseTable, const char* token, int& offset, const void*& userData)
+{
+	INIFieldParseProc parse = index->find(token, offset, userData);
+
+#ifdef RTS_DEBUG
+	int linearOffset = 0;
+	const void* linearUserData = NULL;
+	INIFieldParseProc linearParse = findFieldParseLinear(parseTable, token, linearOffset, linearUserData);
+	DEBUG_ASSERTCRASH(parse == linearParse && (parse == NULL || (offset == linearOffset && userData == linearUserData)),
+		("FieldParse index disagrees with the table for field '%s'", token));
+#endif
+
+	return parse;
+}
 
 //-------------------------------------------------------------------------------------------------
 /** Load and parse an INI file */
@@ -393,51 +718,34 @@ UnsignedInt INI::load(AsciiString filename, INILoadType loadType, Xfer* pXfer)
 
 	try
 	{
+		parseFile();
+	}
+	catch (...)
+	{
+		unPrepFile();
 
-		// read all lines in the file
-		DEBUG_ASSERTCRASH(m_endOfFile == FALSE, ("INI::load, EOF at the beginning!"));
-		while (m_endOfFile == FALSE)
-		{
-			// read this line
-			readLine();
-
-			AsciiString currentLine = m_buffer;
+		// propagate the exception.
+		throw;
+	}
 
-			// the first word is the type of data we're processing
-			const char* token = strtok(m_buffer, m_seps);
-			if (token)
-			{
-				INIBlockParse parse = findBlockParse(token);
-				if (parse)
-				{
-#ifdef DEBUG_CRASHING
-					strcpy(m_curBlockStart, m_buffer);
-#endif
-					try {
-						(*parse)(this);
+	unPrepFile();
 
-					}
-					catch (...) {
-						DEBUG_CRASH(("Error parsing block '%s' in INI file '%s'", token, m_filename.str()));
-						char buff[1024];
-						sprintf(buff, "Error parsing INI file '%s' (Line: '%s')\n", m_filename.str(), currentLine.str());
+	return 1;
+}
 
-						throw INIException(buff);
-					}
-#ifdef DEBUG_CRASHING
-					strcpy(m_curBlockStart, "NO_BLOCK");
-#endif
-				}
-				else
-				{
-					DEBUG_ASSERTCRASH(0, ("[LINE: %d - FILE: '%s'] Unknown block '%s'",
-						getLineNum(), getFilename().str(), token));
-					throw INI_UNKNOWN_TOKEN;
-				}
+//-------------------------------------------------------------------------------------------------
+/** Parse an INI file that has already been lexed */
+//-------------------------------------------------------------------------------------------------
+UnsignedInt INI::loadLexed(AsciiString filename, const INILexedFile* lexedFile, INILoadType loadType, Xfer* pXfer)
+{
+	setFPMode(); // so we have consistent Real values for GameLogic -MDC
 
-			}
+	s_xfer = pXfer;
+	prepLexedFile(filename, lexedFile, loadType);
 
-		}
+	try
+	{
+		parseFile();
 	}
 	catch (...)
 	{
@@ -453,73 +761,159 @@ UnsignedInt INI::load(AsciiString filename, INILoadType loadType, Xfer* pXfer)
 }
 
 //-------------------------------------------------------------------------------------------------
-/** Read a line from the already open file.  Any comments will be removed and
-	* therefore ignored from any given line */
-	//-------------------------------------------------------------------------------------------------
-void INI::readLine(void)
+/** Parse all blocks of the prepped file */
+//-------------------------------------------------------------------------------------------------
+void INI::parseFile(void)
 {
-	// sanity
-	DEBUG_ASSERTCRASH(m_file, ("readLine(), file pointer is NULL"));
-
-	if (m_endOfFile)
-		*m_buffer = 0;
-	else
+	// read all lines in the file
+	DEBUG_ASSERTCRASH(m_endOfFile == FALSE, ("INI::load, EOF at the beginning!"));
+	while (m_endOfFile == FALSE)
 	{
-		char* p = m_buffer;
-		while (p != m_buffer + INI_MAX_CHARS_PER_LINE)
+		// read this line
+		readLine();
+
+		AsciiString currentLine = m_buffer;
+
+		// the first word is the type of data we're processing
+		const char* token = strtok(m_buffer, m_seps);
+		if (token)
 		{
-			// get next character
-			if (m_readBufferNext == m_readBufferUsed)
+			INIBlockParse parse = findBlockParse(token);
+			if (parse)
 			{
-				// refill buffer
-				m_readBufferNext = 0;
-				m_readBufferUsed = m_file->read(m_readBuffer, INI_READ_BUFFER);
+#ifdef DEBUG_CRASHING
+				strcpy(m_curBlockStart, m_buffer);
+#endif
+				try {
+					(*parse)(this);
 
-				// EOF?
-				if (!m_readBufferUsed)
-				{
-					m_endOfFile = true;
-					*p = 0;
-					break;
 				}
+				catch (...) {
+					DEBUG_CRASH(("Error parsing block '%s' in INI file '%s'", token, m_filename.str()));
+					char buff[1024];
+					sprintf(buff, "Error parsing INI file '%s' (Line: '%s')\n", m_filename.str(), currentLine.str());
+
+					throw INIException(buff);
+				}
+#ifdef DEBUG_CRASHING
+				strcpy(m_curBlockStart, "NO_BLOCK");
+#endif
+			}
+			else
+			{
+				DEBUG_ASSERTCRASH(0, ("[LINE: %d - FILE: '%s'] Unknown block '%s'",
+					getLineNum(), getFilename().str(), token));
+				throw INI_UNKNOWN_TOKEN;
 			}
-			*p = m_readBuffer[m_readBufferNext++];
 
-			// CR?
-			if (*p == '\n')
+		}
+
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Split an INI file into lines. Any comments will be removed and therefore ignored
+	* from any given line. This must produce exactly the lines the original character by
+	* character readLine() did, because they feed the INI CRC */
+//-------------------------------------------------------------------------------------------------
+void INILexedFile::lex(const char* data, Int size)
+{
+	// Every line but the last ends in a character we drop, so the lines never take more than one extra byte
+	m_lines.resize(size + 1);
+	m_lineCount = 0;
+	m_firstTabLine = 0;
+	m_firstTruncatedLine = 0;
+
+	char* out = &m_lines[0];
+	const char* in = data;
+	const char* const end = data + size;
+	Bool endOfFile = FALSE;
+
+	while (endOfFile == FALSE)
+	{
+		char* line = out;
+		Int count = 0;
+
+		++m_lineCount;
+
+		while (count != INI_MAX_CHARS_PER_LINE)
+		{
+			// EOF?
+			if (in == end)
 			{
-				*p = 0;
+				endOfFile = TRUE;
 				break;
 			}
 
-			DEBUG_ASSERTCRASH(*p != '\t', ("tab characters are not allowed in INI files (%s). please check your editor settings. Line Number %d", m_filename.str(), getLineNum()));
+			char c = *in++;
+
+			// CR?
+			if (c == '\n')
+				break;
+
+			if (c == '\t' && m_firstTabLine == 0)
+				m_firstTabLine = m_lineCount;
 
 			// comment?
-			if (*p == ';')
-				*p = 0;
+			if (c == ';')
+				c = 0;
 			// whitespace?
-			else if (*p > 0 && *p < 32)
-				*p = ' ';
-			p++;
-		}
-		*p = 0;
+			else if (c > 0 && c < 32)
+				c = ' ';
 
-		// increase our line count
-		m_lineNum++;
+			*out++ = c;
+			++count;
+		}
 
-		// check for at the max
-		if (p == m_buffer + INI_MAX_CHARS_PER_LINE)
+		// a line that fills the whole buffer loses its last character, the rest continues on the next line
+		if (count == INI_MAX_CHARS_PER_LINE)
 		{
+			if (m_firstTruncatedLine == 0)
+				m_firstTruncatedLine = m_lineCount;
+			--out;
+		}
 
-			DEBUG_ASSERTCRASH(0, ("Buffer too small (%d) and was truncated, increase INI_MAX_CHARS_PER_LINE",
-				INI_MAX_CHARS_PER_LINE));
+		// only keep the line up to the first comment
+		char* terminator = (char*)memchr(line, 0, out - line);
+		if (terminator != NULL)
+			out = terminator;
+		*out++ = 0;
+	}
+}
 
-		}
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void INILexedFile::clear(void)
+{
+	std::vector<char>().swap(m_lines);
+	m_lineCount = 0;
+	m_firstTabLine = 0;
+	m_firstTruncatedLine = 0;
+}
 
-		// ensure buffer is always null-terminated, even if we hit the buffer limit
-		// this prevents buffer overruns when the buffer is passed to strtok() and other string functions
-		if (p >= m_buffer + INI_MAX_CHARS_PER_LINE)
-			m_buffer[INI_MAX_CHARS_PER_LINE - 1] = '\0';
+//-------------------------------------------------------------------------------------------------
+/** Read the next line of the already open file into m_buffer */
+//-------------------------------------------------------------------------------------------------
+void INI::readLine(void)
+{
+	// sanity
+	DEBUG_ASSERTCRASH(m_lexedFile, ("readLine(), file pointer is NULL"));
+
+	if (m_endOfFile)
+		*m_buffer = 0;
+	else
+	{
+		// lexed lines are never longer than INI_MAX_CHARS_PER_LINE - 1
+		const size_t length = strlen(m_nextLine);
+		memcpy(m_buffer, m_nextLine, length + 1);
+		m_nextLine += length + 1;
+
+		// the last line ends at the end of the file
+		if (--m_linesLeft == 0)
+			m_endOfFile = true;
+
+		// increase our line count
+		m_lineNum++;
 	}
 
 	if (s_xfer)
@@ -1527,6 +1921,11 @@ void INI::initFromINIMulti(void* what, const MultiIniFieldParse& parseTableList)
 		throw INI_INVALID_PARAMS;
 	}
 
+	// look up the indices of all tables once per block instead of once per field
+	const FieldParseIndex* parseIndices[MultiIniFieldParse::MAX_MULTI_FIELDS];
+	for (int ptIdx = 0; ptIdx < parseTableList.getCount(); ++ptIdx)
+		parseIndices[ptIdx] = getFieldParseIndex(parseTableList.getNthFieldParse(ptIdx));
+
 	// read each of the data fields
 	while (!done)
 	{
@@ -1550,7 +1949,7 @@ void INI::initFromINIMulti(void* what, const MultiIniFieldParse& parseTableList)
 				{
 					int offset = 0;
 					const void* userData = 0;
-					INIFieldParseProc parse = findFieldParse(parseTableList.getNthFieldParse(ptIdx), field, offset, userData);
+					INIFieldParseProc parse = findFieldParse(parseIndices[ptIdx], parseTableList.getNthFieldParse(ptIdx), field, offset, userData);
 					if (parse)
 					{
 						// parse this block and check for parse errors
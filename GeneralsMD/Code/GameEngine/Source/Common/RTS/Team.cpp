@@ -1799,6 +1799,14 @@ Bool Team::hasAnyObjects() const
 	return false;
 }
 
+// ------------------------------------------------------------------------
+void Team::setEnteredExited(void)
+{
+	m_enteredOrExited = true;
+	if (TheScriptEngine)
+		TheScriptEngine->notifyOfTriggerAreaEnteredOrExited();
+}
+
 // ------------------------------------------------------------------------
 /** Clears m_enteredExited, checks & clears m_created. */
 void Team::updateState(void)
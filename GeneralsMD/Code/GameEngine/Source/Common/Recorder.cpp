@@ -31,6 +31,10 @@
 #include "Common/Player.h"
 #include "Common/GlobalData.h"
 #include "Common/GameEngine.h"
+#include "Common/GameState.h"
+#include "Common/LatchRestore.h"
+#include "Common/XferMemory.h"
+#include "Common/ReplayContainer.h"
 #include "GameClient/ClientInstance.h"
 #include "GameClient/GameWindow.h"
 #include "GameClient/GameWindowManager.h"
@@ -49,14 +53,23 @@
 #include "Common/version.h"
 #include "../NGMPGame.h"
 #include "../OnlineServices_Init.h"
+#include "Compression.h"
 
 extern NGMPGame* TheNGMPGame;
 
 constexpr const char s_genrep[] = "GENREP";
+// TheSuperHackers @feature Same header, but the commands are stored in a ReplayContainer. Must be as long as s_genrep.
+constexpr const char s_genrepCompact[] = "GENRPZ";
+static_assert(sizeof(s_genrep) == sizeof(s_genrepCompact), "replay header offsets depend on the tag length");
 constexpr const UnsignedInt replayBufferBytes = 8192;
 
 Int REPLAY_CRC_INTERVAL = 100;
 
+static const UnsignedInt NO_SEEK_FRAME = ~0u;
+
+// TheSuperHackers @info Long replays thin out their checkpoints instead of growing without bound.
+static const size_t MAX_REPLAY_CHECKPOINTS = 64;
+
 const char* replayExtention = ".rep";
 const char* lastReplayFileName = "00000000";	// a name the user is unlikely to ever type, but won't cause panic & confusion
 
@@ -379,6 +392,9 @@ RecorderClass::RecorderClass()
 	m_nextFrame = 0;
 	m_wasDesync = FALSE;
 	//
+	m_restoringCheckpoint = FALSE;
+	m_containerWriter = NULL;
+	m_containerReader = NULL;
 
 	init(); // just for the heck of it.
 }
@@ -387,6 +403,8 @@ RecorderClass::RecorderClass()
  * Destructor
  */
 RecorderClass::~RecorderClass() {
+	closeReplayContainer();
+	clearCheckpoints();
 }
 
 /**
@@ -413,6 +431,15 @@ void RecorderClass::init() {
 	m_doingAnalysis = FALSE;
 	m_playbackFrameCount = 0;
 
+	clearCheckpoints();
+	m_checkpointInterval = 0;
+	m_nextCheckpointFrame = 0;
+	m_seekFrame = NO_SEEK_FRAME;
+	m_endOfReplaySeekFrame = NO_SEEK_FRAME;
+	m_crcLogFirstFrame = 0;
+	m_crcLogLastFrame = 0;
+	m_bisectingCRCMismatch = FALSE;
+
 	OptionPreferences optionPref;
 	m_archiveReplays = optionPref.getArchiveReplaysEnabled();
 }
@@ -421,6 +448,11 @@ void RecorderClass::init() {
  * Reset the recorder to the "initialized state."
  */
 void RecorderClass::reset() {
+	// TheSuperHackers @feature Restoring a checkpoint resets the whole engine, but the playback continues.
+	if (m_restoringCheckpoint)
+		return;
+
+	closeReplayContainer();
 	if (m_file != NULL) {
 		m_file->close();
 		m_file = NULL;
@@ -467,8 +499,8 @@ void RecorderClass::updatePlayback() {
 	if (m_doingAnalysis)
 		curFrame = m_nextFrame;
 
-	// While there are commands to be queued up for this frame, do it.
-	while (m_nextFrame == curFrame) {
+	// While there are commands to be queued up for this frame, do it. A seek replaces the playback position.
+	while (m_nextFrame == curFrame && m_seekFrame == NO_SEEK_FRAME) {
 		appendNextCommand();	// append the next command to TheCommandQueue
 		readNextFrame();	// Read the next command's frame number for playback.
 	}
@@ -479,6 +511,7 @@ void RecorderClass::updatePlayback() {
  * reaching the end of the playback file.
  */
 void RecorderClass::stopPlayback() {
+	closeReplayContainer();
 	if (m_file != NULL) {
 		m_file->close();
 		m_file = NULL;
@@ -574,7 +607,7 @@ void RecorderClass::startRecording(GameDifficulty diff, Int originalGameMode, In
 		return;
 	}
 	// TheSuperHackers @info the null terminator needs to be ignored to maintain retail replay file layout
-	m_file->writeFormat("%s", s_genrep);
+	m_file->writeFormat("%s", TheGlobalData->m_compactReplays ? s_genrepCompact : s_genrep);
 
 	//
 	// save space for stats to be filled in.
@@ -718,6 +751,10 @@ void RecorderClass::startRecording(GameDifficulty diff, Int originalGameMode, In
 
 	DEBUG_LOG(("RecorderClass::startRecording() - diff=%d, mode=%d, FPS=%d", diff, originalGameMode, maxFPS));
 
+	// Everything after the header are commands.
+	if (TheGlobalData->m_compactReplays)
+		m_containerWriter = NEW ReplayContainerWriter(m_file);
+
 	/*
 	// Write the map name.
 	fprintf(m_file, "%s", (TheGlobalData->m_mapName).str());
@@ -732,6 +769,7 @@ void RecorderClass::startRecording(GameDifficulty diff, Int originalGameMode, In
  * every game.
  */
 void RecorderClass::stopRecording() {
+	closeReplayContainer();
 	logGameEnd();
 	if (TheNetwork)
 	{
@@ -801,15 +839,15 @@ void RecorderClass::archiveReplay(AsciiString fileName)
 void RecorderClass::writeToFile(GameMessage* msg) {
 	// Write the frame number for this command.
 	UnsignedInt frame = TheGameLogic->getFrame();
-	m_file->write(&frame, sizeof(frame));
+	writeCommandData(&frame, sizeof(frame));
 
 	// Write the command type
 	GameMessage::Type type = msg->getType();
-	m_file->write(&type, sizeof(type));
+	writeCommandData(&type, sizeof(type));
 
 	// Write the player index
 	Int playerIndex = msg->getPlayerIndex();
-	m_file->write(&playerIndex, sizeof(playerIndex));
+	writeCommandData(&playerIndex, sizeof(playerIndex));
 
 #ifdef DEBUG_LOGGING
 	AsciiString commandName = msg->getCommandAsString();
@@ -830,15 +868,15 @@ void RecorderClass::writeToFile(GameMessage* msg) {
 
 	GameMessageParser* parser = newInstance(GameMessageParser)(msg);
 	UnsignedByte numTypes = parser->getNumTypes();
-	m_file->write(&numTypes, sizeof(numTypes));
+	writeCommandData(&numTypes, sizeof(numTypes));
 
 	GameMessageParserArgumentType* argType = parser->getFirstArgumentType();
 	while (argType != NULL) {
 		UnsignedByte type = (UnsignedByte)(argType->getType());
-		m_file->write(&type, sizeof(type));
+		writeCommandData(&type, sizeof(type));
 
 		UnsignedByte argTypeCount = (UnsignedByte)(argType->getArgCount());
-		m_file->write(&argTypeCount, sizeof(argTypeCount));
+		writeCommandData(&argTypeCount, sizeof(argTypeCount));
 
 		argType = argType->getNext();
 	}
@@ -857,6 +895,8 @@ void RecorderClass::writeToFile(GameMessage* msg) {
 	deleteInstance(parser);
 	parser = NULL;
 
+	if (m_containerWriter != NULL)
+		m_containerWriter->endCommand();
 }
 
 void RecorderClass::writeArgument(GameMessageArgumentDataType type, const GameMessageArgumentType arg) {
@@ -864,37 +904,37 @@ void RecorderClass::writeArgument(GameMessageArgumentDataType type, const GameMe
 	switch (type) {
 
 	case ARGUMENTDATATYPE_INTEGER:
-		m_file->write(&(arg.integer), sizeof(arg.integer));
+		writeCommandData(&(arg.integer), sizeof(arg.integer));
 		break;
 	case ARGUMENTDATATYPE_REAL:
-		m_file->write(&(arg.real), sizeof(arg.real));
+		writeCommandData(&(arg.real), sizeof(arg.real));
 		break;
 	case ARGUMENTDATATYPE_BOOLEAN:
-		m_file->write(&(arg.boolean), sizeof(arg.boolean));
+		writeCommandData(&(arg.boolean), sizeof(arg.boolean));
 		break;
 	case ARGUMENTDATATYPE_OBJECTID:
-		m_file->write(&(arg.objectID), sizeof(arg.objectID));
+		writeCommandData(&(arg.objectID), sizeof(arg.objectID));
 		break;
 	case ARGUMENTDATATYPE_DRAWABLEID:
-		m_file->write(&(arg.drawableID), sizeof(arg.drawableID));
+		writeCommandData(&(arg.drawableID), sizeof(arg.drawableID));
 		break;
 	case ARGUMENTDATATYPE_TEAMID:
-		m_file->write(&(arg.teamID), sizeof(arg.teamID));
+		writeCommandData(&(arg.teamID), sizeof(arg.teamID));
 		break;
 	case ARGUMENTDATATYPE_LOCATION:
-		m_file->write(&(arg.location), sizeof(arg.location));
+		writeCommandData(&(arg.location), sizeof(arg.location));
 		break;
 	case ARGUMENTDATATYPE_PIXEL:
-		m_file->write(&(arg.pixel), sizeof(arg.pixel));
+		writeCommandData(&(arg.pixel), sizeof(arg.pixel));
 		break;
 	case ARGUMENTDATATYPE_PIXELREGION:
-		m_file->write(&(arg.pixelRegion), sizeof(arg.pixelRegion));
+		writeCommandData(&(arg.pixelRegion), sizeof(arg.pixelRegion));
 		break;
 	case ARGUMENTDATATYPE_TIMESTAMP:
-		m_file->write(&(arg.timestamp), sizeof(arg.timestamp));
+		writeCommandData(&(arg.timestamp), sizeof(arg.timestamp));
 		break;
 	case ARGUMENTDATATYPE_WIDECHAR:
-		m_file->write(&(arg.wChar), sizeof(arg.wChar));
+		writeCommandData(&(arg.wChar), sizeof(arg.wChar));
 		break;
 	default:
 		DEBUG_LOG(("Unknown GameMessageArgumentDataType in RecorderClass::writeArgument"));
@@ -902,6 +942,64 @@ void RecorderClass::writeArgument(GameMessageArgumentDataType type, const GameMe
 	}
 }
 
+/**
+ * Write command data to m_file, or to the replay container when recording a compact replay.
+ */
+void RecorderClass::writeCommandData(const void *data, Int dataSize)
+{
+	if (m_containerWriter != NULL)
+		m_containerWriter->write(data, dataSize);
+	else
+		m_file->write(data, dataSize);
+}
+
+/**
+ * Read command data from m_file, or from the replay container when playing back a compact replay.
+ */
+Int RecorderClass::readCommandData(void *data, Int dataSize)
+{
+	if (m_containerReader != NULL)
+		return m_containerReader->read(data, dataSize);
+
+	return m_file->read(data, dataSize);
+}
+
+UnsignedInt RecorderClass::getCommandPosition() const
+{
+	if (m_containerReader != NULL)
+		return m_containerReader->position();
+
+	return m_file->position();
+}
+
+void RecorderClass::setCommandPosition(UnsignedInt position)
+{
+	if (m_containerReader != NULL)
+		m_containerReader->seek(position);
+	else
+		m_file->seek(position, File::START);
+}
+
+/**
+ * Write the index of a compact replay that is being recorded, and forget the replay container.
+ * Must be called before m_file is closed.
+ */
+void RecorderClass::closeReplayContainer()
+{
+	if (m_containerWriter != NULL)
+	{
+		m_containerWriter->finish();
+		delete m_containerWriter;
+		m_containerWriter = NULL;
+	}
+
+	if (m_containerReader != NULL)
+	{
+		delete m_containerReader;
+		m_containerReader = NULL;
+	}
+}
+
 /**
  * Read in a replay header, for (1) populating a replay listbox or (2) starting playback.  In
  * case (2), set FILE *m_file.
@@ -924,7 +1022,8 @@ Bool RecorderClass::readReplayHeader(ReplayHeader& header)
 	// Read the GENREP header.
 	char genrep[sizeof(s_genrep) - 1] = { 0 };
 	m_file->read(&genrep, sizeof(s_genrep) - 1);
-	if (strncmp(genrep, s_genrep, sizeof(s_genrep) - 1)) {
+	header.compact = strncmp(genrep, s_genrepCompact, sizeof(s_genrepCompact) - 1) == 0;
+	if (!header.compact && strncmp(genrep, s_genrep, sizeof(s_genrep) - 1)) {
 		DEBUG_LOG(("RecorderClass::readReplayHeader - replay file did not have GENREP at the start."));
 		m_file->close();
 		m_file = NULL;
@@ -1115,6 +1214,19 @@ Bool RecorderClass::sawCRCMismatch() const
 	return m_crcInfo->sawCRCMismatch();
 }
 
+void RecorderClass::logVerificationFailure(const char *failure)
+{
+	DEBUG_LOG(("Verification failed in Frame %d: %s", TheGameLogic->getFrame(), failure));
+
+	// Print the failure in case we are simulating replays from console.
+	printf("Verification failed in Frame %d: %s\n", TheGameLogic->getFrame(), failure);
+
+	// TheSuperHackers @info The replay simulation stops a replay and counts it as an error on a CRC mismatch,
+	// so a failed verification is reported the same way.
+	if (isPlaybackMode())
+		m_crcInfo->setSawCRCMismatch();
+}
+
 void RecorderClass::handleCRCMessage(UnsignedInt newCRC, Int playerIndex, Bool fromPlayback)
 {
 	if (fromPlayback)
@@ -1163,6 +1275,9 @@ void RecorderClass::handleCRCMessage(UnsignedInt newCRC, Int playerIndex, Bool f
 			// Print Mismatch in case we are simulating replays from console.
 			printf("CRC Mismatch in Frame %d\n", mismatchFrame);
 
+			if (TheGlobalData->m_bisectReplayCRC && !m_bisectingCRCMismatch && beginCRCMismatchBisect(mismatchFrame))
+				return;
+
 			// TheSuperHackers @tweak Pause the game on mismatch.
 			// But not when a window with focus is opened, because that can make resuming difficult.
 			if (TheWindowManager->winGetFocus() == NULL)
@@ -1182,6 +1297,262 @@ void RecorderClass::handleCRCMessage(UnsignedInt newCRC, Int playerIndex, Bool f
 	//DEBUG_LOG(("RecorderClass::handleCRCMessage() - Skipping CRC of %8.8X from %d (our index is %d)", newCRC, playerIndex, localPlayerIndex));
 }
 
+/**
+ * A replay checkpoint. The save game does not contain the logic random generator or anything of the
+ * playback itself, so those are kept next to it.
+ */
+struct RecorderClass::ReplayCheckpoint
+{
+	ReplayCheckpoint(const CRCInfo& info) : crcInfo(info) {}
+
+	UnsignedInt frame;
+	UnsignedInt logicCRC;							///< logic CRC at the time the checkpoint was taken, to verify the restore
+	Int uncompressedSize;
+	std::vector<UnsignedByte> data;		///< compressed save game data
+	UnsignedInt filePosition;					///< position of the next command, see getCommandPosition
+	UnsignedInt nextFrame;
+	UnsignedInt randomState[6];
+	CRCInfo crcInfo;									///< local CRCs still waiting to be compared with the recorded ones
+};
+
+/**
+ * Called at the start of every logic update during playback, which is the only time the game state is
+ * complete and no command of the current frame has been queued yet.
+ */
+Bool RecorderClass::updateCheckpoints()
+{
+	if (m_checkpointInterval == 0 || m_file == NULL)
+		return FALSE;
+
+	const UnsignedInt frame = TheGameLogic->getFrame();
+
+	if (m_seekFrame != NO_SEEK_FRAME)
+	{
+		const UnsignedInt seekFrame = m_seekFrame;
+		m_seekFrame = NO_SEEK_FRAME;
+
+		// Going back always needs a checkpoint, going forward only uses one if it skips frames.
+		const ReplayCheckpoint *checkpoint = findCheckpoint(seekFrame);
+		if (checkpoint != NULL && (seekFrame < frame || checkpoint->frame > frame))
+		{
+			if (!restoreCheckpoint(checkpoint))
+			{
+				DEBUG_CRASH(("RecorderClass::updateCheckpoints - Cannot restore the checkpoint of frame %d", checkpoint->frame));
+				stopPlayback();
+				return TRUE;
+			}
+
+			// Simulate the rest without drawing, like -jumpToFrame does.
+			if (m_mode != RECORDERMODETYPE_SIMULATION_PLAYBACK && seekFrame > checkpoint->frame)
+				TheWritableGlobalData->m_noDraw = seekFrame;
+
+			return TRUE;
+		}
+	}
+
+	if (m_bisectingCRCMismatch && frame >= m_crcLogFirstFrame && frame <= m_crcLogLastFrame)
+	{
+		const UnsignedInt crc = TheGameLogic->getCRC(CRC_RECALC);
+		DEBUG_LOG(("Logic CRC at start of frame %d is %8.8X", frame, crc));
+		printf("Logic CRC at start of frame %u is %8.8X\n", frame, crc);
+	}
+
+	// Commands that are still queued would be lost in the checkpoint, so wait for a frame without any.
+	if (frame >= m_nextCheckpointFrame && TheCommandList->getFirstMessage() == NULL)
+		takeCheckpoint();
+
+	return FALSE;
+}
+
+/**
+ * Request to continue playback from frame. The seek happens at the start of the next logic update.
+ */
+Bool RecorderClass::seekPlayback(UnsignedInt frame)
+{
+	if (!isPlaybackInProgress() || findCheckpoint(frame) == NULL)
+		return FALSE;
+
+	m_seekFrame = frame;
+	return TRUE;
+}
+
+void RecorderClass::takeCheckpoint()
+{
+	const UnsignedInt frame = TheGameLogic->getFrame();
+
+	AsciiString name;
+	name.format("ReplayCheckpoint%u", frame);
+
+	XferMemorySave xfer;
+	xfer.open(name);
+	const SaveCode code = TheGameState->saveCheckpoint(&xfer);
+	xfer.close();
+
+	const CompressionType compression = COMPRESSION_ZLIB1;
+	ReplayCheckpoint *checkpoint = NEW ReplayCheckpoint(*m_crcInfo);
+	Int compressedSize = 0;
+	if (code == SC_OK)
+	{
+		checkpoint->data.resize(CompressionManager::getMaxCompressedSize(xfer.getDataSize(), compression));
+		compressedSize = CompressionManager::compressData(compression,
+			(void *)xfer.getData(), xfer.getDataSize(), &checkpoint->data[0], (Int)checkpoint->data.size());
+	}
+
+	if (compressedSize == 0)
+	{
+		// Do not try again every frame.
+		DEBUG_CRASH(("RecorderClass::takeCheckpoint - Cannot save a checkpoint on frame %d, checkpoints are disabled", frame));
+		delete checkpoint;
+		m_checkpointInterval = 0;
+		return;
+	}
+
+	checkpoint->data.resize(compressedSize);
+	checkpoint->frame = frame;
+	checkpoint->logicCRC = TheGameLogic->getCRC(CRC_RECALC);
+	checkpoint->uncompressedSize = xfer.getDataSize();
+	checkpoint->filePosition = getCommandPosition();
+	checkpoint->nextFrame = m_nextFrame;
+	GetGameLogicRandomState(checkpoint->randomState);
+
+	DEBUG_LOG(("RecorderClass::takeCheckpoint - Frame %d, %d bytes compressed to %d", frame, checkpoint->uncompressedSize, compressedSize));
+
+	m_checkpoints.push_back(checkpoint);
+	m_nextCheckpointFrame = frame + m_checkpointInterval;
+
+	if (m_checkpoints.size() > MAX_REPLAY_CHECKPOINTS)
+	{
+		// Drop every second checkpoint, but keep the first and the newest one, and take them half as often.
+		size_t kept = 1;
+		for (size_t i = 1; i < m_checkpoints.size(); ++i)
+		{
+			if (i % 2 == 0 || i == m_checkpoints.size() - 1)
+				m_checkpoints[kept++] = m_checkpoints[i];
+			else
+				delete m_checkpoints[i];
+		}
+		m_checkpoints.resize(kept);
+		m_checkpointInterval *= 2;
+	}
+}
+
+Bool RecorderClass::restoreCheckpoint(const ReplayCheckpoint *checkpoint)
+{
+	std::vector<UnsignedByte> data(checkpoint->uncompressedSize);
+	const Int size = CompressionManager::decompressData((void *)&checkpoint->data[0], (Int)checkpoint->data.size(),
+		&data[0], checkpoint->uncompressedSize);
+	if (size != checkpoint->uncompressedSize)
+		return FALSE;
+
+	AsciiString name;
+	name.format("ReplayCheckpoint%u", checkpoint->frame);
+
+	XferMemoryLoad xfer(&data[0], size);
+	xfer.open(name);
+	SaveCode code;
+	{
+		LatchRestore<Bool> restoring(m_restoringCheckpoint, TRUE);
+		code = TheGameState->loadCheckpoint(&xfer);
+	}
+	xfer.close();
+
+	if (code != SC_OK)
+		return FALSE;
+
+	SetGameLogicRandomState(checkpoint->randomState);
+	setCommandPosition(checkpoint->filePosition);
+	m_nextFrame = checkpoint->nextFrame;
+	*m_crcInfo = checkpoint->crcInfo;
+
+	// Messages of the frame we left behind must not reach the restored game.
+	TheCommandList->reset();
+
+	// Anything that the save game misses shows up here instead of as a misleading CRC mismatch later on.
+	// A restore must give the exact game that was saved, so a different CRC fails the replay check.
+	const UnsignedInt crc = TheGameLogic->getCRC(CRC_RECALC);
+	if (crc != checkpoint->logicCRC)
+	{
+		AsciiString failure;
+		failure.format("Checkpoint of frame %u restored with CRC %8.8X instead of %8.8X", checkpoint->frame, crc, checkpoint->logicCRC);
+		logVerificationFailure(failure.str());
+	}
+
+	return TRUE;
+}
+
+/**
+ * Returns the latest checkpoint at or before frame, or NULL.
+ */
+const RecorderClass::ReplayCheckpoint *RecorderClass::findCheckpoint(UnsignedInt frame) const
+{
+	// Binary search for the first checkpoint after frame.
+	size_t lo = 0;
+	size_t hi = m_checkpoints.size();
+	while (lo < hi)
+	{
+		const size_t mid = (lo + hi) / 2;
+		if (m_checkpoints[mid]->frame <= frame)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo > 0 ? m_checkpoints[lo - 1] : NULL;
+}
+
+void RecorderClass::clearCheckpoints()
+{
+	for (size_t i = 0; i < m_checkpoints.size(); ++i)
+		delete m_checkpoints[i];
+	m_checkpoints.clear();
+}
+
+/**
+ * The recorded CRCs only say that the game diverged somewhere after the last matching CRC. Rewind to
+ * before it and print the logic CRC of every frame in between, so that the output can be compared with
+ * the output of a build that plays this replay without mismatch.
+ */
+Bool RecorderClass::beginCRCMismatchBisect(UnsignedInt mismatchFrame)
+{
+	const UnsignedInt crcInterval = REPLAY_CRC_INTERVAL > 0 ? REPLAY_CRC_INTERVAL : 1;
+	const UnsignedInt lastMatchFrame = mismatchFrame > crcInterval ? mismatchFrame - crcInterval : 0;
+	if (!seekPlayback(lastMatchFrame))
+		return FALSE;
+
+	m_bisectingCRCMismatch = TRUE;
+	m_crcLogFirstFrame = lastMatchFrame;
+	m_crcLogLastFrame = mismatchFrame;
+#ifdef DEBUG_CRC
+	TheCRCFirstFrameToLog = lastMatchFrame;
+	TheCRCLastFrameToLog = mismatchFrame + 1;
+#endif
+
+	printf("Rewinding to frame %u to print the logic CRC of frames %u to %u\n",
+		findCheckpoint(lastMatchFrame)->frame, lastMatchFrame, mismatchFrame);
+	return TRUE;
+}
+
+/**
+ * Called where the replay would end the game. Seeks to the frame given with -replaySeek instead, once.
+ */
+Bool RecorderClass::beginEndOfReplaySeek()
+{
+	if (m_endOfReplaySeekFrame == NO_SEEK_FRAME)
+		return FALSE;
+
+	const UnsignedInt frame = m_endOfReplaySeekFrame;
+	m_endOfReplaySeekFrame = NO_SEEK_FRAME;
+
+	if (!seekPlayback(frame))
+	{
+		printf("No replay checkpoint at or before frame %u, cannot seek\n", frame);
+		return FALSE;
+	}
+
+	printf("Seeking from the end of the replay at frame %u to frame %u, resuming from the checkpoint of frame %u\n",
+		TheGameLogic->getFrame(), frame, findCheckpoint(frame)->frame);
+	return TRUE;
+}
+
 /**
  * Returns true if this version of the file is the same as our version of the game
  */
@@ -1227,6 +1598,8 @@ Bool RecorderClass::playbackFile(AsciiString filename)
 
 	m_mode = RECORDERMODETYPE_PLAYBACK;
 
+	closeReplayContainer();
+
 	ReplayHeader header;
 	header.forPlayback = TRUE;
 	header.filename = filename;
@@ -1312,6 +1685,9 @@ Bool RecorderClass::playbackFile(AsciiString filename)
 
 	DEBUG_LOG(("RecorderClass::playbackFile() - original game was mode %d", m_originalGameMode));
 
+	if (header.compact)
+		m_containerReader = NEW ReplayContainerReader(m_file);
+
 	// TheSuperHackers @fix helmutbuhler 03/04/2025
 	// In case we restart a replay, we need to clear the command list.
 	// Otherwise a crc message remains and messes up the crc calculation on the restarted replay.
@@ -1339,6 +1715,13 @@ Bool RecorderClass::playbackFile(AsciiString filename)
 
 	m_currentReplayFilename = filename;
 	m_playbackFrameCount = header.frameCount;
+
+	clearCheckpoints();
+	m_checkpointInterval = m_doingAnalysis ? 0 : TheGlobalData->m_replayCheckpointInterval;
+	m_nextCheckpointFrame = 1;
+	m_seekFrame = NO_SEEK_FRAME;
+	m_endOfReplaySeekFrame = TheGlobalData->m_replaySeekFrame >= 0 ? (UnsignedInt)TheGlobalData->m_replaySeekFrame : NO_SEEK_FRAME;
+	m_bisectingCRCMismatch = FALSE;
 	return TRUE;
 }
 
@@ -1403,11 +1786,15 @@ AsciiString RecorderClass::readAsciiString() {
  * is stopped and the next frame is said to be -1.
  */
 void RecorderClass::readNextFrame() {
-	Int bytesRead = m_file->read(&m_nextFrame, sizeof(m_nextFrame));
+	Int bytesRead = readCommandData(&m_nextFrame, sizeof(m_nextFrame));
 	if (bytesRead != sizeof(m_nextFrame)) {
 		DEBUG_LOG(("RecorderClass::readNextFrame - read failed on frame %d", TheGameLogic->getFrame()));
 		m_nextFrame = -1;
-		stopPlayback();
+		// A damaged compact replay ends early, which must not pass for a complete replay.
+		if (m_containerReader != NULL && m_containerReader->isDamaged())
+			logVerificationFailure("The replay file is damaged, playback ends early");
+		if (!beginEndOfReplaySeek())
+			stopPlayback();
 	}
 }
 
@@ -1416,7 +1803,7 @@ void RecorderClass::readNextFrame() {
  */
 void RecorderClass::appendNextCommand() {
 	GameMessage::Type type;
-	Int bytesRead = m_file->read(&type, sizeof(type));
+	Int bytesRead = readCommandData(&type, sizeof(type));
 	if (bytesRead != sizeof(type)) {
 		DEBUG_LOG(("RecorderClass::appendNextCommand - read failed on frame %d", m_nextFrame/*TheGameLogic->getFrame()*/));
 		return;
@@ -1437,7 +1824,7 @@ void RecorderClass::appendNextCommand() {
 #endif // DEBUG_LOGGING
 
 	Int playerIndex = -1;
-	m_file->read(&playerIndex, sizeof(playerIndex));
+	readCommandData(&playerIndex, sizeof(playerIndex));
 	msg->friend_setPlayerIndex(playerIndex);
 
 	// don't debug log this if we're debugging sync errors, as it will cause diff problems between a game and it's replay...
@@ -1456,14 +1843,14 @@ void RecorderClass::appendNextCommand() {
 
 	UnsignedByte numTypes = 0;
 	Int totalArgs = 0;
-	m_file->read(&numTypes, sizeof(numTypes));
+	readCommandData(&numTypes, sizeof(numTypes));
 
 	GameMessageParser* parser = newInstance(GameMessageParser)();
 	for (UnsignedByte i = 0; i < numTypes; ++i) {
 		UnsignedByte type = (UnsignedByte)ARGUMENTDATATYPE_UNKNOWN;
-		m_file->read(&type, sizeof(type));
+		readCommandData(&type, sizeof(type));
 		UnsignedByte numArgs = 0;
-		m_file->read(&numArgs, sizeof(numArgs));
+		readCommandData(&numArgs, sizeof(numArgs));
 		parser->addArgType((GameMessageArgumentDataType)type, numArgs);
 		totalArgs += numArgs;
 	}
@@ -1506,12 +1893,17 @@ void RecorderClass::appendNextCommand() {
 
 	deleteInstance(parser);
 	parser = NULL;
+
+	// The recorded game ends with this message, so -replaySeek rewinds here instead of letting it quit the game.
+	// The whole record has been read by now, so the seek cannot leave the file in the middle of it.
+	if (type == GameMessage::MSG_CLEAR_GAME_DATA)
+		beginEndOfReplaySeek();
 }
 
 void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage* msg) {
 	if (type == ARGUMENTDATATYPE_INTEGER) {
 		Int theint;
-		m_file->read(&theint, sizeof(theint));
+		readCommandData(&theint, sizeof(theint));
 		msg->appendIntegerArgument(theint);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1522,7 +1914,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_REAL) {
 		Real thereal;
-		m_file->read(&thereal, sizeof(thereal));
+		readCommandData(&thereal, sizeof(thereal));
 		msg->appendRealArgument(thereal);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1533,7 +1925,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_BOOLEAN) {
 		Bool thebool;
-		m_file->read(&thebool, sizeof(thebool));
+		readCommandData(&thebool, sizeof(thebool));
 		msg->appendBooleanArgument(thebool);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1544,7 +1936,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_OBJECTID) {
 		ObjectID theid;
-		m_file->read(&theid, sizeof(theid));
+		readCommandData(&theid, sizeof(theid));
 		msg->appendObjectIDArgument(theid);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1555,7 +1947,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_DRAWABLEID) {
 		DrawableID theid;
-		m_file->read(&theid, sizeof(theid));
+		readCommandData(&theid, sizeof(theid));
 		msg->appendDrawableIDArgument(theid);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1566,7 +1958,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_TEAMID) {
 		UnsignedInt theid;
-		m_file->read(&theid, sizeof(theid));
+		readCommandData(&theid, sizeof(theid));
 		msg->appendTeamIDArgument(theid);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1577,7 +1969,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_LOCATION) {
 		Coord3D loc;
-		m_file->read(&loc, sizeof(loc));
+		readCommandData(&loc, sizeof(loc));
 		msg->appendLocationArgument(loc);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1589,7 +1981,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_PIXEL) {
 		ICoord2D pixel;
-		m_file->read(&pixel, sizeof(pixel));
+		readCommandData(&pixel, sizeof(pixel));
 		msg->appendPixelArgument(pixel);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1600,7 +1992,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_PIXELREGION) {
 		IRegion2D reg;
-		m_file->read(&reg, sizeof(reg));
+		readCommandData(&reg, sizeof(reg));
 		msg->appendPixelRegionArgument(reg);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1611,7 +2003,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_TIMESTAMP) {  // Not to be confused with Terrance Stamp... Kneel before Zod!!!
 		UnsignedInt stamp;
-		m_file->read(&stamp, sizeof(stamp));
+		readCommandData(&stamp, sizeof(stamp));
 		msg->appendTimestampArgument(stamp);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -1622,7 +2014,7 @@ void RecorderClass::readArgument(GameMessageArgumentDataType type, GameMessage*
 	}
 	else if (type == ARGUMENTDATATYPE_WIDECHAR) {
 		WideChar theid;
-		m_file->read(&theid, sizeof(theid));
+		readCommandData(&theid, sizeof(theid));
 		msg->appendWideCharArgument(theid);
 #ifdef DEBUG_LOGGING
 		if (m_doingAnalysis)
@@ -0,0 +1,678 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: ReplayContainer.cpp //////////////////////////////////////////////////////////////////////
+// Desc:   Compact replay command container
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+#include "Common/ReplayContainer.h"
+#include "Common/file.h"
+#include "Common/MessageStream.h"
+#include "Compression.h"
+
+// File layout behind the replay header:
+//   blocks: UnsignedInt firstFrame, UnsignedInt size in the original layout, Int stored size, stored data
+//   index:  UnsignedInt firstFrame, UnsignedInt fileOffset, UnsignedInt position for every block
+//   UnsignedInt index file offset, UnsignedInt block count, "RIDX"
+// The stored data is compressed unless compression did not make it smaller. Encoded commands always
+// start with a zero frame delta byte, so they never look like compressed data.
+
+static const char s_replayIndexTag[] = "RIDX";
+static const UnsignedInt REPLAY_BLOCK_HEADER_SIZE = 3 * sizeof(UnsignedInt);
+static const UnsignedInt REPLAY_INDEX_ENTRY_SIZE = 3 * sizeof(UnsignedInt);
+static const UnsignedInt REPLAY_INDEX_TRAILER_SIZE = 2 * sizeof(UnsignedInt) + sizeof(s_replayIndexTag) - 1;
+
+// A block is closed once it is this large, or once it spans this much game time. The latter is
+// also the most a crashed game can lose, because only closed blocks are written to the file.
+static const size_t REPLAY_BLOCK_BYTES = 32 * 1024;
+static const UnsignedInt REPLAY_BLOCK_FRAMES = 60 * LOGICFRAMES_PER_SECOND;
+
+// A frame with a lot of commands closes the block inside the frame before it passes half of this.
+// Encoded commands are at most a quarter larger than the original, so no written block gets near
+// this, and readers reject any block whose sizes are larger.
+static const UnsignedInt REPLAY_BLOCK_MAX_BYTES = 64 * REPLAY_BLOCK_BYTES;
+
+// Blocks are written rarely and read once, so spend the time on the best ratio.
+static const CompressionType REPLAY_BLOCK_COMPRESSION = COMPRESSION_ZLIB9;
+
+static_assert(sizeof(ObjectID) == sizeof(UnsignedInt) && sizeof(DrawableID) == sizeof(UnsignedInt), "ids are delta encoded as UnsignedInt");
+
+namespace
+{
+
+class ReplayByteReader
+{
+public:
+	ReplayByteReader(const UnsignedByte *data, size_t size) : m_cur(data), m_end(data + size) {}
+
+	Bool atEnd(void) const { return m_cur == m_end; }
+
+	Bool raw(void *data, size_t size)
+	{
+		if ((size_t)(m_end - m_cur) < size)
+			return FALSE;
+		memcpy(data, m_cur, size);
+		m_cur += size;
+		return TRUE;
+	}
+
+	Bool varUInt(UnsignedInt &value)
+	{
+		value = 0;
+		for (Int shift = 0; shift < 35 && m_cur < m_end; shift += 7)
+		{
+			const UnsignedByte b = *m_cur++;
+			value |= (UnsignedInt)(b & 0x7f) << shift;
+			if ((b & 0x80) == 0)
+				return TRUE;
+		}
+		return FALSE;
+	}
+
+	Bool varInt(Int &value)
+	{
+		UnsignedInt zigzag;
+		if (!varUInt(zigzag))
+			return FALSE;
+		value = (Int)(zigzag >> 1) ^ -(Int)(zigzag & 1);
+		return TRUE;
+	}
+
+private:
+	const UnsignedByte *m_cur;
+	const UnsignedByte *m_end;
+};
+
+void appendRaw(std::vector<UnsignedByte> &out, const void *data, size_t size)
+{
+	const UnsignedByte *bytes = (const UnsignedByte *)data;
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+void appendVarUInt(std::vector<UnsignedByte> &out, UnsignedInt value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((UnsignedByte)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((UnsignedByte)value);
+}
+
+void appendVarInt(std::vector<UnsignedByte> &out, Int value)
+{
+	// zigzag, so that small negative values stay small
+	appendVarUInt(out, ((UnsignedInt)value << 1) ^ (UnsignedInt)(value >> 31));
+}
+
+/// Size of an argument in the original layout, as written by RecorderClass::writeArgument.
+size_t getArgumentSize(GameMessageArgumentDataType type)
+{
+	switch (type)
+	{
+		case ARGUMENTDATATYPE_INTEGER:			return sizeof(GameMessageArgumentType::integer);
+		case ARGUMENTDATATYPE_REAL:					return sizeof(GameMessageArgumentType::real);
+		case ARGUMENTDATATYPE_BOOLEAN:			return sizeof(GameMessageArgumentType::boolean);
+		case ARGUMENTDATATYPE_OBJECTID:			return sizeof(GameMessageArgumentType::objectID);
+		case ARGUMENTDATATYPE_DRAWABLEID:		return sizeof(GameMessageArgumentType::drawableID);
+		case ARGUMENTDATATYPE_TEAMID:				return sizeof(GameMessageArgumentType::teamID);
+		case ARGUMENTDATATYPE_LOCATION:			return sizeof(GameMessageArgumentType::location);
+		case ARGUMENTDATATYPE_PIXEL:				return sizeof(GameMessageArgumentType::pixel);
+		case ARGUMENTDATATYPE_PIXELREGION:	return sizeof(GameMessageArgumentType::pixelRegion);
+		case ARGUMENTDATATYPE_TIMESTAMP:		return sizeof(GameMessageArgumentType::timestamp);
+		case ARGUMENTDATATYPE_WIDECHAR:			return sizeof(GameMessageArgumentType::wChar);
+		default:														return 0;
+	}
+}
+
+UnsignedInt &getLastID(GameMessageArgumentDataType type, ReplayDeltaState &delta)
+{
+	return type == ARGUMENTDATATYPE_OBJECTID ? delta.lastObjectID : delta.lastDrawableID;
+}
+
+Bool encodeArgument(GameMessageArgumentDataType type, ReplayByteReader &in, ReplayDeltaState &delta, std::vector<UnsignedByte> &out)
+{
+	switch (type)
+	{
+		case ARGUMENTDATATYPE_INTEGER:
+		case ARGUMENTDATATYPE_PIXEL:
+		case ARGUMENTDATATYPE_PIXELREGION:
+		{
+			// one, two or four Ints
+			Int values[4];
+			const size_t count = getArgumentSize(type) / sizeof(Int);
+			if (!in.raw(values, count * sizeof(Int)))
+				return FALSE;
+			for (size_t i = 0; i < count; ++i)
+				appendVarInt(out, values[i]);
+			return TRUE;
+		}
+		case ARGUMENTDATATYPE_OBJECTID:
+		case ARGUMENTDATATYPE_DRAWABLEID:
+		{
+			// commands tend to name the same or nearby objects
+			UnsignedInt id;
+			if (!in.raw(&id, sizeof(id)))
+				return FALSE;
+			UnsignedInt &lastID = getLastID(type, delta);
+			appendVarInt(out, (Int)(id - lastID));
+			lastID = id;
+			return TRUE;
+		}
+		case ARGUMENTDATATYPE_TEAMID:
+		case ARGUMENTDATATYPE_TIMESTAMP:
+		{
+			UnsignedInt value;
+			if (!in.raw(&value, sizeof(value)))
+				return FALSE;
+			appendVarUInt(out, value);
+			return TRUE;
+		}
+		case ARGUMENTDATATYPE_WIDECHAR:
+		{
+			WideChar value;
+			if (!in.raw(&value, sizeof(value)))
+				return FALSE;
+			appendVarUInt(out, (UnsignedInt)value);
+			return TRUE;
+		}
+		default:
+		{
+			// reals, booleans and locations are kept as they are
+			UnsignedByte value[sizeof(GameMessageArgumentType)];
+			const size_t size = getArgumentSize(type);
+			if (!in.raw(value, size))
+				return FALSE;
+			appendRaw(out, value, size);
+			return TRUE;
+		}
+	}
+}
+
+Bool decodeArgument(GameMessageArgumentDataType type, ReplayByteReader &in, ReplayDeltaState &delta, std::vector<UnsignedByte> &out)
+{
+	switch (type)
+	{
+		case ARGUMENTDATATYPE_INTEGER:
+		case ARGUMENTDATATYPE_PIXEL:
+		case ARGUMENTDATATYPE_PIXELREGION:
+		{
+			Int values[4];
+			const size_t count = getArgumentSize(type) / sizeof(Int);
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (!in.varInt(values[i]))
+					return FALSE;
+			}
+			appendRaw(out, values, count * sizeof(Int));
+			return TRUE;
+		}
+		case ARGUMENTDATATYPE_OBJECTID:
+		case ARGUMENTDATATYPE_DRAWABLEID:
+		{
+			Int idDelta;
+			if (!in.varInt(idDelta))
+				return FALSE;
+			UnsignedInt &lastID = getLastID(type, delta);
+			lastID += (UnsignedInt)idDelta;
+			appendRaw(out, &lastID, sizeof(lastID));
+			return TRUE;
+		}
+		case ARGUMENTDATATYPE_TEAMID:
+		case ARGUMENTDATATYPE_TIMESTAMP:
+		{
+			UnsignedInt value;
+			if (!in.varUInt(value))
+				return FALSE;
+			appendRaw(out, &value, sizeof(value));
+			return TRUE;
+		}
+		case ARGUMENTDATATYPE_WIDECHAR:
+		{
+			UnsignedInt value;
+			if (!in.varUInt(value))
+				return FALSE;
+			const WideChar wideChar = (WideChar)value;
+			appendRaw(out, &wideChar, sizeof(wideChar));
+			return TRUE;
+		}
+		default:
+		{
+			UnsignedByte value[sizeof(GameMessageArgumentType)];
+			const size_t size = getArgumentSize(type);
+			if (!in.raw(value, size))
+				return FALSE;
+			appendRaw(out, value, size);
+			return TRUE;
+		}
+	}
+}
+
+/// Encode one command in the original layout, see RecorderClass::writeToFile.
+Bool encodeCommand(const std::vector<UnsignedByte> &command, ReplayDeltaState &delta, std::vector<UnsignedByte> &out)
+{
+	ReplayByteReader in(&command[0], command.size());
+
+	UnsignedInt frame;
+	GameMessage::Type type;
+	Int playerIndex;
+	UnsignedByte numTypes;
+	if (!in.raw(&frame, sizeof(frame)) || !in.raw(&type, sizeof(type)) || !in.raw(&playerIndex, sizeof(playerIndex)) || !in.raw(&numTypes, sizeof(numTypes)))
+		return FALSE;
+
+	appendVarUInt(out, frame - delta.lastFrame);
+	delta.lastFrame = frame;
+	appendVarUInt(out, (UnsignedInt)type);
+	appendVarInt(out, playerIndex);
+	out.push_back(numTypes);
+
+	UnsignedByte argTypes[UCHAR_MAX];
+	UnsignedByte argCounts[UCHAR_MAX];
+	for (UnsignedByte i = 0; i < numTypes; ++i)
+	{
+		if (!in.raw(&argTypes[i], sizeof(argTypes[i])) || !in.raw(&argCounts[i], sizeof(argCounts[i])))
+			return FALSE;
+		out.push_back(argTypes[i]);
+		out.push_back(argCounts[i]);
+	}
+
+	for (UnsignedByte i = 0; i < numTypes; ++i)
+	{
+		for (UnsignedByte j = 0; j < argCounts[i]; ++j)
+		{
+			if (!encodeArgument((GameMessageArgumentDataType)argTypes[i], in, delta, out))
+				return FALSE;
+		}
+	}
+
+	return in.atEnd();
+}
+
+/// Decode one command back into the original layout.
+Bool decodeCommand(ReplayByteReader &in, ReplayDeltaState &delta, std::vector<UnsignedByte> &out)
+{
+	UnsignedInt frameDelta;
+	UnsignedInt typeValue;
+	Int playerIndex;
+	UnsignedByte numTypes;
+	if (!in.varUInt(frameDelta) || !in.varUInt(typeValue) || !in.varInt(playerIndex) || !in.raw(&numTypes, sizeof(numTypes)))
+		return FALSE;
+
+	delta.lastFrame += frameDelta;
+	const GameMessage::Type type = (GameMessage::Type)typeValue;
+	appendRaw(out, &delta.lastFrame, sizeof(delta.lastFrame));
+	appendRaw(out, &type, sizeof(type));
+	appendRaw(out, &playerIndex, sizeof(playerIndex));
+	appendRaw(out, &numTypes, sizeof(numTypes));
+
+	UnsignedByte argTypes[UCHAR_MAX];
+	UnsignedByte argCounts[UCHAR_MAX];
+	for (UnsignedByte i = 0; i < numTypes; ++i)
+	{
+		if (!in.raw(&argTypes[i], sizeof(argTypes[i])) || !in.raw(&argCounts[i], sizeof(argCounts[i])))
+			return FALSE;
+		out.push_back(argTypes[i]);
+		out.push_back(argCounts[i]);
+	}
+
+	for (UnsignedByte i = 0; i < numTypes; ++i)
+	{
+		for (UnsignedByte j = 0; j < argCounts[i]; ++j)
+		{
+			if (!decodeArgument((GameMessageArgumentDataType)argTypes[i], in, delta, out))
+				return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+} // namespace
+
+ReplayContainerWriter::ReplayContainerWriter(File *file)
+{
+	m_file = file;
+	m_delta.reset(0);
+	m_blockFirstFrame = 0;
+	m_blockPosition = 0;
+	m_blockSize = 0;
+}
+
+void ReplayContainerWriter::write(const void *data, Int dataSize)
+{
+	appendRaw(m_command, data, dataSize);
+}
+
+void ReplayContainerWriter::endCommand(void)
+{
+	UnsignedInt frame = 0;
+	if (m_command.size() < sizeof(frame))
+	{
+		m_command.clear();
+		return;
+	}
+	memcpy(&frame, &m_command[0], sizeof(frame));
+
+	// normally close a block between two frames, so that the index can point at the start of any frame,
+	// but never let a frame with a lot of commands grow a block past what readers accept
+	if (!m_block.empty() && frame != m_delta.lastFrame &&
+			(m_block.size() >= REPLAY_BLOCK_BYTES || frame - m_blockFirstFrame >= REPLAY_BLOCK_FRAMES))
+		flushBlock();
+	else if (!m_block.empty() && m_blockSize + m_command.size() > REPLAY_BLOCK_MAX_BYTES / 2)
+		flushBlock();
+
+	if (m_block.empty())
+	{
+		m_blockFirstFrame = frame;
+		m_delta.reset(frame);
+	}
+
+	const size_t blockSize = m_block.size();
+	const ReplayDeltaState delta = m_delta;
+	if (encodeCommand(m_command, m_delta, m_block))
+	{
+		m_blockSize += (UnsignedInt)m_command.size();
+	}
+	else
+	{
+		DEBUG_CRASH(("ReplayContainerWriter::endCommand - Cannot encode a command of frame %d", frame));
+		m_block.resize(blockSize);
+		m_delta = delta;
+	}
+
+	m_command.clear();
+}
+
+/**
+ * Compress the open block and append it to the file
+ */
+void ReplayContainerWriter::flushBlock(void)
+{
+	if (m_block.empty())
+		return;
+
+	std::vector<UnsignedByte> compressed(CompressionManager::getMaxCompressedSize((Int)m_block.size(), REPLAY_BLOCK_COMPRESSION));
+	Int storedSize = CompressionManager::compressData(REPLAY_BLOCK_COMPRESSION,
+		&m_block[0], (Int)m_block.size(), &compressed[0], (Int)compressed.size());
+	const UnsignedByte *stored = &compressed[0];
+	if (storedSize <= 0 || storedSize >= (Int)m_block.size())
+	{
+		stored = &m_block[0];
+		storedSize = (Int)m_block.size();
+	}
+
+	ReplayBlockIndexEntry entry;
+	entry.firstFrame = m_blockFirstFrame;
+	entry.fileOffset = m_file->position();
+	entry.position = m_blockPosition;
+	m_index.push_back(entry);
+
+	m_file->write(&m_blockFirstFrame, sizeof(m_blockFirstFrame));
+	m_file->write(&m_blockSize, sizeof(m_blockSize));
+	m_file->write(&storedSize, sizeof(storedSize));
+	m_file->write(stored, storedSize);
+
+	DEBUG_LOG(("ReplayContainerWriter::flushBlock - Frame %d, %d bytes stored in %d", m_blockFirstFrame, m_blockSize, storedSize));
+
+	m_blockPosition += m_blockSize;
+	m_blockSize = 0;
+	m_block.clear();
+}
+
+/**
+ * Write the open block and the index. Nothing must be written afterwards
+ */
+void ReplayContainerWriter::finish(void)
+{
+	flushBlock();
+
+	const UnsignedInt indexOffset = m_file->position();
+	for (ReplayBlockIndex::const_iterator it = m_index.begin(); it != m_index.end(); ++it)
+	{
+		m_file->write(&it->firstFrame, sizeof(it->firstFrame));
+		m_file->write(&it->fileOffset, sizeof(it->fileOffset));
+		m_file->write(&it->position, sizeof(it->position));
+	}
+
+	const UnsignedInt count = (UnsignedInt)m_index.size();
+	m_file->write(&indexOffset, sizeof(indexOffset));
+	m_file->write(&count, sizeof(count));
+	m_file->write(s_replayIndexTag, sizeof(s_replayIndexTag) - 1);
+}
+
+ReplayContainerReader::ReplayContainerReader(File *file)
+{
+	m_file = file;
+	m_readPos = 0;
+	m_damaged = FALSE;
+
+	const UnsignedInt firstBlockOffset = m_file->position();
+	if (!readIndex(firstBlockOffset))
+	{
+		// a game that did not end properly has no index, but the blocks written so far are intact
+		DEBUG_LOG(("ReplayContainerReader - No block index, scanning the blocks"));
+		m_index.clear();
+		scanBlocks(firstBlockOffset);
+	}
+
+	m_block = 0;
+	if (!loadBlock(0))
+		m_block = m_index.size();
+}
+
+/**
+ * Read the index at the end of the file
+ */
+Bool ReplayContainerReader::readIndex(UnsignedInt firstBlockOffset)
+{
+	const UnsignedInt fileSize = m_file->size();
+	if (fileSize < firstBlockOffset + REPLAY_INDEX_TRAILER_SIZE)
+		return FALSE;
+
+	UnsignedInt indexOffset = 0;
+	UnsignedInt count = 0;
+	char tag[sizeof(s_replayIndexTag) - 1] = { 0 };
+	m_file->seek(fileSize - REPLAY_INDEX_TRAILER_SIZE, File::START);
+	m_file->read(&indexOffset, sizeof(indexOffset));
+	m_file->read(&count, sizeof(count));
+	m_file->read(tag, sizeof(tag));
+
+	if (memcmp(tag, s_replayIndexTag, sizeof(tag)) != 0)
+		return FALSE;
+	if (indexOffset < firstBlockOffset || indexOffset > fileSize - REPLAY_INDEX_TRAILER_SIZE)
+		return FALSE;
+	if (count != (fileSize - REPLAY_INDEX_TRAILER_SIZE - indexOffset) / REPLAY_INDEX_ENTRY_SIZE)
+		return FALSE;
+
+	m_file->seek(indexOffset, File::START);
+	m_index.resize(count);
+	for (ReplayBlockIndex::iterator it = m_index.begin(); it != m_index.end(); ++it)
+	{
+		m_file->read(&it->firstFrame, sizeof(it->firstFrame));
+		m_file->read(&it->fileOffset, sizeof(it->fileOffset));
+		m_file->read(&it->position, sizeof(it->position));
+	}
+
+	return TRUE;
+}
+
+/**
+ * Rebuild the index from the block headers
+ */
+void ReplayContainerReader::scanBlocks(UnsignedInt firstBlockOffset)
+{
+	const UnsignedInt fileSize = m_file->size();
+	UnsignedInt offset = firstBlockOffset;
+	UnsignedInt position = 0;
+
+	while (offset + REPLAY_BLOCK_HEADER_SIZE <= fileSize)
+	{
+		UnsignedInt firstFrame = 0;
+		UnsignedInt size = 0;
+		Int storedSize = 0;
+		m_file->seek(offset, File::START);
+		m_file->read(&firstFrame, sizeof(firstFrame));
+		m_file->read(&size, sizeof(size));
+		m_file->read(&storedSize, sizeof(storedSize));
+
+		if (storedSize <= 0 || (UnsignedInt)storedSize > fileSize - offset - REPLAY_BLOCK_HEADER_SIZE ||
+				(UnsignedInt)storedSize > REPLAY_BLOCK_MAX_BYTES || size > REPLAY_BLOCK_MAX_BYTES)
+			break;
+
+		ReplayBlockIndexEntry entry;
+		entry.firstFrame = firstFrame;
+		entry.fileOffset = offset;
+		entry.position = position;
+		m_index.push_back(entry);
+
+		position += size;
+		offset += REPLAY_BLOCK_HEADER_SIZE + storedSize;
+	}
+}
+
+/**
+ * Decode a block into m_decoded. A block that cannot be decoded ends the stream
+ */
+Bool ReplayContainerReader::loadBlock(size_t block)
+{
+	if (block >= m_index.size())
+		return FALSE;
+
+	// the index may come from a damaged file, so no size is trusted before it is checked
+	const UnsignedInt fileSize = m_file->size();
+	const UnsignedInt fileOffset = m_index[block].fileOffset;
+
+	UnsignedInt firstFrame = 0;
+	UnsignedInt size = 0;
+	Int storedSize = 0;
+	Bool ok = fileOffset <= fileSize && fileSize - fileOffset >= REPLAY_BLOCK_HEADER_SIZE;
+	if (ok)
+	{
+		m_file->seek(fileOffset, File::START);
+		m_file->read(&firstFrame, sizeof(firstFrame));
+		m_file->read(&size, sizeof(size));
+		m_file->read(&storedSize, sizeof(storedSize));
+		ok = storedSize > 0 && (UnsignedInt)storedSize <= fileSize - fileOffset - REPLAY_BLOCK_HEADER_SIZE &&
+			(UnsignedInt)storedSize <= REPLAY_BLOCK_MAX_BYTES && size <= REPLAY_BLOCK_MAX_BYTES;
+	}
+
+	std::vector<UnsignedByte> encoded;
+	if (ok)
+	{
+		std::vector<UnsignedByte> stored(storedSize);
+		ok = m_file->read(&stored[0], storedSize) == storedSize;
+		if (ok && CompressionManager::isDataCompressed(&stored[0], storedSize))
+		{
+			const Int uncompressedSize = CompressionManager::getUncompressedSize(&stored[0], storedSize);
+			ok = uncompressedSize > 0 && (UnsignedInt)uncompressedSize <= REPLAY_BLOCK_MAX_BYTES;
+			if (ok)
+			{
+				encoded.resize(uncompressedSize);
+				ok = CompressionManager::decompressData(&stored[0], storedSize, &encoded[0], uncompressedSize) == uncompressedSize;
+			}
+		}
+		else
+		{
+			encoded.swap(stored);
+		}
+	}
+
+	m_decoded.clear();
+	m_decoded.reserve(size);
+	m_readPos = 0;
+
+	if (ok)
+	{
+		ReplayDeltaState delta;
+		delta.reset(firstFrame);
+		ReplayByteReader in(&encoded[0], encoded.size());
+		while (ok && !in.atEnd())
+			ok = decodeCommand(in, delta, m_decoded) && m_decoded.size() <= size;
+	}
+
+	if (!ok || m_decoded.size() != size)
+	{
+		// A damaged file is not a bug in the game, so only log it. Reading stops here as if the replay ended.
+		DEBUG_LOG(("ReplayContainerReader::loadBlock - Block %d of frame %d is damaged", (Int)block, firstFrame));
+		m_damaged = TRUE;
+		m_decoded.clear();
+		m_block = m_index.size();
+		return FALSE;
+	}
+
+	m_block = block;
+	return TRUE;
+}
+
+Int ReplayContainerReader::read(void *data, Int dataSize)
+{
+	UnsignedByte *dest = (UnsignedByte *)data;
+	Int bytesRead = 0;
+
+	while (bytesRead < dataSize)
+	{
+		if (m_readPos >= m_decoded.size() && !loadBlock(m_block + 1))
+			break;
+
+		const Int available = (Int)(m_decoded.size() - m_readPos);
+		const Int count = min(available, dataSize - bytesRead);
+		memcpy(dest + bytesRead, &m_decoded[m_readPos], count);
+		m_readPos += count;
+		bytesRead += count;
+	}
+
+	return bytesRead;
+}
+
+UnsignedInt ReplayContainerReader::position(void) const
+{
+	if (m_block >= m_index.size())
+		return 0;
+
+	return m_index[m_block].position + m_readPos;
+}
+
+Bool ReplayContainerReader::seek(UnsignedInt position)
+{
+	// binary search for the first block after position
+	size_t lo = 0;
+	size_t hi = m_index.size();
+	while (lo < hi)
+	{
+		const size_t mid = (lo + hi) / 2;
+		if (m_index[mid].position <= position)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == 0)
+		return FALSE;
+
+	const size_t block = lo - 1;
+	if (block != m_block && !loadBlock(block))
+		return FALSE;
+
+	const UnsignedInt offset = position - m_index[block].position;
+	if (offset > m_decoded.size())
+		return FALSE;
+
+	m_readPos = offset;
+	return TRUE;
+}
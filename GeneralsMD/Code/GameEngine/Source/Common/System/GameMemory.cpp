@@ -1487,6 +1487,36 @@ void Checkpointable::debugResetCheckpoints()
 }
 #endif
 
+#ifdef MEMORYPOOL_MAGAZINES
+// ----------------------------------------------------------------------------
+#if defined(_MSC_VER)
+	#define MEMORYPOOL_THREAD_LOCAL __declspec(thread)
+#else
+	#define MEMORYPOOL_THREAD_LOCAL __thread
+#endif
+
+/**
+	A per-thread stack of free blocks for one pool. The blocks are chained through their
+	free-list links, just like the free list of a blob, but their owning blobs still count
+	them as used. A magazine is only ever touched by the thread that owns it, so no locking
+	is needed until it has to be refilled from (or drained to) the shared blobs.
+*/
+struct MemoryPoolMagazine
+{
+	MemoryPoolSingleBlock	*m_firstBlock;		///< top of the stack of cached blocks
+	Int										m_count;					///< number of cached blocks
+	UnsignedInt						m_generation;			///< generation of the pool the cached blocks were taken from
+};
+
+/// the calling thread's magazines, indexed by MemoryPool::m_magazineSlot. allocated on first use.
+static MEMORYPOOL_THREAD_LOCAL MemoryPoolMagazine *theThreadMagazines = NULL;
+
+/// the pool that owns each magazine slot, so a thread can return its blocks when it is done.
+static MemoryPool *theMagazineSlotPools[MAX_MEMORYPOOL_MAGAZINE_SLOTS];
+static Int theNextMagazineSlot = 0;
+static UnsignedInt theNextMagazineGeneration = 0;
+#endif
+
 //-----------------------------------------------------------------------------
 // METHODS for MemoryPool
 //-----------------------------------------------------------------------------
@@ -1508,6 +1538,12 @@ MemoryPool::MemoryPool() :
 	m_firstBlob(NULL),
 	m_lastBlob(NULL),
 	m_firstBlobWithFreeBlocks(NULL)
+#ifdef MEMORYPOOL_MAGAZINES
+	, m_magazineSlot(-1)
+	, m_magazineCapacity(0)
+	, m_magazineGeneration(0)
+	, m_magazineBlocksInPool(0)
+#endif
 {
 }
 
@@ -1530,6 +1566,33 @@ void MemoryPool::init(MemoryPoolFactory *factory, const char *poolName, Int allo
 	m_lastBlob = NULL;
 	m_firstBlobWithFreeBlocks = NULL;
 
+#ifdef MEMORYPOOL_MAGAZINES
+	{
+		ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+		if (m_magazineSlot < 0 && theNextMagazineSlot < MAX_MEMORYPOOL_MAGAZINE_SLOTS)
+		{
+			m_magazineSlot = theNextMagazineSlot++;
+			theMagazineSlotPools[m_magazineSlot] = this;
+		}
+
+		// a pool that is not allowed to grow must not have its blocks hiding in other threads' magazines.
+		m_magazineCapacity = 0;
+		if (m_magazineSlot >= 0 && m_overflowAllocationCount > 0)
+		{
+			m_magazineCapacity = MAX_MEMORYPOOL_MAGAZINE_BYTES / m_allocationSize;
+			if (m_magazineCapacity > MAX_MEMORYPOOL_MAGAZINE_BLOCKS)
+				m_magazineCapacity = MAX_MEMORYPOOL_MAGAZINE_BLOCKS;
+			if (m_magazineCapacity < 2)
+				m_magazineCapacity = 0;	// not worth caching blocks this large
+		}
+
+		// any blocks still sitting in magazines belong to blobs that no longer exist.
+		m_magazineGeneration = ++theNextMagazineGeneration;
+		m_magazineBlocksInPool = 0;
+	}
+#endif
+
 	// go ahead and init the initial block here (will throw on failure)
 	createBlob(m_initialAllocationCount);
 }
@@ -1546,6 +1609,11 @@ MemoryPool::~MemoryPool()
 	{
 		freeBlob(m_firstBlob);
 	}
+
+#ifdef MEMORYPOOL_MAGAZINES
+	if (m_magazineSlot >= 0)
+		theMagazineSlotPools[m_magazineSlot] = NULL;
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -1622,14 +1690,12 @@ Int MemoryPool::freeBlob(MemoryPoolBlob* blob)
 
 //-----------------------------------------------------------------------------
 /**
-	allocate a block from this pool and return it, but don't bother zeroing
-	out the block. if unable to allocate, throw ERROR_OUT_OF_MEMORY. this
-	function will never return null.
+	return a blob of this pool that has at least one free block. if there is none,
+	create an overflow blob when allowOverflow is true (throws ERROR_OUT_OF_MEMORY if
+	the pool is not allowed to grow), otherwise return null.
 */
-void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG1)
+MemoryPoolBlob* MemoryPool::findBlobWithFreeBlocks(Bool allowOverflow)
 {
-	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
-
 	if (m_firstBlobWithFreeBlocks != NULL && !m_firstBlobWithFreeBlocks->hasAnyFreeBlocks())
 	{
 		// hmm... the current 'free' blob has nothing available. look and see if there
@@ -1650,7 +1716,11 @@ void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG
 	// allocate an overflow block.
 	if (m_firstBlobWithFreeBlocks == NULL)
 	{
-		if (m_overflowAllocationCount == 0)
+		if (!allowOverflow)
+		{
+			return NULL;
+		}
+		else if (m_overflowAllocationCount == 0)
 		{
 			throw ERROR_OUT_OF_MEMORY;	// this pool is not allowed to grow
 		}
@@ -1660,7 +1730,167 @@ void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG
 		}
 	}
 
-	MemoryPoolBlob *blob = m_firstBlobWithFreeBlocks;
+	return m_firstBlobWithFreeBlocks;
+}
+
+#ifdef MEMORYPOOL_MAGAZINES
+//-----------------------------------------------------------------------------
+/**
+	return the calling thread's magazine for this pool, or null if this pool
+	does not use magazines. the thread's magazine table is allocated on first use.
+*/
+inline MemoryPoolMagazine* MemoryPool::getThreadMagazine()
+{
+	if (m_magazineCapacity == 0)
+		return NULL;
+
+	MemoryPoolMagazine *magazines = theThreadMagazines;
+	if (magazines == NULL)
+	{
+		magazines = (MemoryPoolMagazine *)::sysAllocateDoNotZero(sizeof(MemoryPoolMagazine) * MAX_MEMORYPOOL_MAGAZINE_SLOTS);	// will throw on failure
+		memset(magazines, 0, sizeof(MemoryPoolMagazine) * MAX_MEMORYPOOL_MAGAZINE_SLOTS);
+		theThreadMagazines = magazines;
+	}
+
+	MemoryPoolMagazine *magazine = &magazines[m_magazineSlot];
+	if (magazine->m_generation != m_magazineGeneration)
+	{
+		// the pool was reset since we last used it, so the blobs these blocks came from
+		// are gone. just forget about them.
+		magazine->m_firstBlock = NULL;
+		magazine->m_count = 0;
+		magazine->m_generation = m_magazineGeneration;
+	}
+
+	return magazine;
+}
+
+//-----------------------------------------------------------------------------
+/**
+	move up to half a magazine's worth of free blocks from the shared blobs into
+	the given (empty) magazine. only the first block may grow the pool, so a refill
+	never creates an overflow blob just to top up the magazine.
+*/
+void MemoryPool::refillMagazine(MemoryPoolMagazine *magazine)
+{
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	const Int batchCount = m_magazineCapacity / 2;
+	for (Int i = 0; i < batchCount; ++i)
+	{
+		MemoryPoolBlob *blob = findBlobWithFreeBlocks(magazine->m_count == 0);	// throws on failure
+		if (blob == NULL)
+			break;
+
+		MemoryPoolSingleBlock *block = blob->allocateSingleBlock();
+		DEBUG_ASSERTCRASH(block, ("should not fail here"));
+
+		block->setNextFreeBlock(magazine->m_firstBlock);
+		magazine->m_firstBlock = block;
+		++magazine->m_count;
+		++m_magazineBlocksInPool;
+	}
+}
+
+//-----------------------------------------------------------------------------
+/**
+	return the given number of blocks from the magazine to their blobs. the most
+	recently freed blocks stay in the magazine, since they are the most likely to
+	still be in the cpu cache; the ones at the bottom of the stack are handed back.
+*/
+void MemoryPool::drainMagazine(MemoryPoolMagazine *magazine, Int count)
+{
+	if (count > magazine->m_count)
+		count = magazine->m_count;
+	if (count <= 0)
+		return;
+
+	const Int keepCount = magazine->m_count - count;
+	MemoryPoolSingleBlock *block;
+	if (keepCount == 0)
+	{
+		block = magazine->m_firstBlock;
+		magazine->m_firstBlock = NULL;
+	}
+	else
+	{
+		MemoryPoolSingleBlock *lastKept = magazine->m_firstBlock;
+		for (Int i = 1; i < keepCount; ++i)
+			lastKept = lastKept->getNextFreeBlock();
+		block = lastKept->getNextFreeBlock();
+		lastKept->setNextFreeBlock(NULL);
+	}
+	magazine->m_count = keepCount;
+
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	m_magazineBlocksInPool -= count;
+
+	while (block != NULL)
+	{
+		MemoryPoolSingleBlock *nextBlock = block->getNextFreeBlock();
+		MemoryPoolBlob *blob = block->getOwningBlob();
+		DEBUG_ASSERTCRASH(blob && blob->getOwningPool() == this, ("block does not belong to this pool"));
+
+		blob->freeSingleBlock(block);
+
+		if (!m_firstBlobWithFreeBlocks)
+			m_firstBlobWithFreeBlocks = blob;
+
+		block = nextBlock;
+	}
+}
+
+//-----------------------------------------------------------------------------
+/**
+	blocks handed out from magazines are counted without holding the lock, so the
+	used count and its peak are updated atomically.
+*/
+inline void MemoryPool::adjustUsedBlockCount(Int delta)
+{
+	const Int used = ::InterlockedExchangeAdd((LONG *)&m_usedBlocksInPool, delta) + delta;
+	if (delta <= 0)
+		return;
+
+	Int peak = m_peakUsedBlocksInPool;
+	while (peak < used)
+	{
+		const Int previousPeak = ::InterlockedCompareExchange((LONG *)&m_peakUsedBlocksInPool, used, peak);
+		if (previousPeak == peak)
+			break;
+		peak = previousPeak;
+	}
+}
+#endif
+
+//-----------------------------------------------------------------------------
+/**
+	allocate a block from this pool and return it, but don't bother zeroing
+	out the block. if unable to allocate, throw ERROR_OUT_OF_MEMORY. this
+	function will never return null.
+*/
+void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG1)
+{
+#ifdef MEMORYPOOL_MAGAZINES
+	MemoryPoolMagazine *magazine = getThreadMagazine();
+	if (magazine != NULL)
+	{
+		if (magazine->m_firstBlock == NULL)
+			refillMagazine(magazine);	// throws on failure
+
+		MemoryPoolSingleBlock *block = magazine->m_firstBlock;
+		magazine->m_firstBlock = block->getNextFreeBlock();
+		--magazine->m_count;
+
+		adjustUsedBlockCount(1);
+
+		return block->getUserData();
+	}
+#endif
+
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	MemoryPoolBlob *blob = findBlobWithFreeBlocks(true);	// throws on failure
 
 	DEBUG_ASSERTCRASH(blob, ("no blob with free blocks available in MemoryPool::allocate"));
 
@@ -1713,6 +1943,26 @@ void MemoryPool::freeBlock(void* pBlockPtr)
 	if (!pBlockPtr)
 		return;	// my, that was easy
 
+#ifdef MEMORYPOOL_MAGAZINES
+	MemoryPoolMagazine *magazine = getThreadMagazine();
+	if (magazine != NULL)
+	{
+		MemoryPoolSingleBlock *block = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
+		DEBUG_ASSERTCRASH(block->getOwningBlob() && block->getOwningBlob()->getOwningPool() == this, ("block does not belong to this pool"));
+
+		if (magazine->m_count >= m_magazineCapacity)
+			drainMagazine(magazine, m_magazineCapacity / 2);
+
+		block->setNextFreeBlock(magazine->m_firstBlock);
+		magazine->m_firstBlock = block;
+		++magazine->m_count;
+
+		adjustUsedBlockCount(-1);
+
+		return;
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
 
 	MemoryPoolSingleBlock *block = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
@@ -2171,6 +2421,17 @@ void DynamicMemoryAllocator::debugIgnoreLeaksForThisBlock(void* pBlockPtr)
 */
 void *DynamicMemoryAllocator::allocateBytesDoNotZeroImplementation(Int numBytes DECLARE_LITERALSTRING_ARG2)
 {
+#ifdef MEMORYPOOL_MAGAZINES
+	// the subpools never change after init and do their own locking, so only raw blocks need the dma lock.
+	MemoryPool *subPool = findPoolForSize(numBytes);
+	if (subPool != NULL)
+	{
+		void *subPoolResult = subPool->allocateBlockDoNotZeroImplementation();	// throws on failure
+		::InterlockedIncrement((LONG *)&m_usedBlocksInDma);
+		return subPoolResult;
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheDmaCriticalSection);
 
 	void *result = NULL;
@@ -2245,7 +2506,11 @@ void *DynamicMemoryAllocator::allocateBytesDoNotZeroImplementation(Int numBytes
 }
 #endif // MEMORYPOOL_DEBUG
 
+#ifdef MEMORYPOOL_MAGAZINES
+	::InterlockedIncrement((LONG *)&m_usedBlocksInDma);
+#else
 	++m_usedBlocksInDma;
+#endif
 	DEBUG_ASSERTCRASH(m_usedBlocksInDma >= 0, ("negative count for m_usedBlocksInDma"));
 #ifdef MEMORYPOOL_DEBUG
 	#ifdef USE_FILLER_VALUE
@@ -2287,6 +2552,18 @@ void DynamicMemoryAllocator::freeBytes(void* pBlockPtr)
 	if (!pBlockPtr)
 		return;
 
+#ifdef MEMORYPOOL_MAGAZINES
+	{
+		MemoryPoolSingleBlock *subPoolBlock = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
+		if (subPoolBlock->getOwningBlob())
+		{
+			subPoolBlock->getOwningBlob()->getOwningPool()->freeBlock(pBlockPtr);
+			::InterlockedDecrement((LONG *)&m_usedBlocksInDma);
+			return;
+		}
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheDmaCriticalSection);
 
 #ifdef MEMORYPOOL_CHECK_BLOCK_OWNERSHIP
@@ -2354,7 +2631,11 @@ void DynamicMemoryAllocator::freeBytes(void* pBlockPtr)
 		::sysFree((void *)block);
 
 	}
+#ifdef MEMORYPOOL_MAGAZINES
+	::InterlockedDecrement((LONG *)&m_usedBlocksInDma);
+#else
 	--m_usedBlocksInDma;
+#endif
 	DEBUG_ASSERTCRASH(m_usedBlocksInDma >= 0, ("negative count for m_usedBlocksInDma"));
 
 #ifdef INTENSE_DMA_BOOKKEEPING
@@ -3478,6 +3759,68 @@ void initMemoryManager()
 
 }
 
+//-----------------------------------------------------------------------------
+/**
+	return every block cached by the calling thread to its pool, and free the
+	thread's magazine table. safe to call from threads that never used a pool.
+*/
+void releaseThreadMemoryPoolMagazines()
+{
+#ifdef MEMORYPOOL_MAGAZINES
+	MemoryPoolMagazine *magazines = theThreadMagazines;
+	if (magazines == NULL)
+		return;
+
+	theThreadMagazines = NULL;
+
+	{
+		ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+		for (Int i = 0; i < theNextMagazineSlot; ++i)
+		{
+			MemoryPool *pool = theMagazineSlotPools[i];
+			MemoryPoolMagazine *magazine = &magazines[i];
+			if (pool != NULL && magazine->m_count > 0 && magazine->m_generation == pool->m_magazineGeneration)
+				pool->drainMagazine(magazine, magazine->m_count);
+		}
+	}
+
+	::sysFree((void *)magazines);
+#endif
+}
+
+#ifdef MEMORYPOOL_MAGAZINES
+//-----------------------------------------------------------------------------
+/**
+	TLS callback, called by the loader for every thread that exits, including the
+	threads of libraries that know nothing about the pools. the thread's
+	magazines are still valid at this point.
+*/
+static void NTAPI releaseThreadMemoryPoolMagazinesOnExit(PVOID, DWORD reason, PVOID)
+{
+	if (reason == DLL_THREAD_DETACH)
+		releaseThreadMemoryPoolMagazines();
+}
+
+#if defined(_MSC_VER)
+	#if defined(_WIN64)
+		#pragma comment(linker, "/INCLUDE:_tls_used")
+		#pragma comment(linker, "/INCLUDE:theMemoryPoolMagazineExitCallback")
+		#pragma const_seg(".CRT$XLM")
+		extern "C" const PIMAGE_TLS_CALLBACK theMemoryPoolMagazineExitCallback = releaseThreadMemoryPoolMagazinesOnExit;
+		#pragma const_seg()
+	#else
+		#pragma comment(linker, "/INCLUDE:__tls_used")
+		#pragma comment(linker, "/INCLUDE:_theMemoryPoolMagazineExitCallback")
+		#pragma data_seg(".CRT$XLM")
+		extern "C" PIMAGE_TLS_CALLBACK theMemoryPoolMagazineExitCallback = releaseThreadMemoryPoolMagazinesOnExit;
+		#pragma data_seg()
+	#endif
+#else
+	extern "C" PIMAGE_TLS_CALLBACK theMemoryPoolMagazineExitCallback __attribute__((section(".CRT$XLM"), used)) = releaseThreadMemoryPoolMagazinesOnExit;
+#endif
+#endif
+
 //-----------------------------------------------------------------------------
 Bool isMemoryManagerOfficiallyInited()
 {
@@ -3525,6 +3868,8 @@ void shutdownMemoryManager()
 	}
 	else
 	{
+		releaseThreadMemoryPoolMagazines();
+
 		if (TheDynamicMemoryAllocator)
 		{
 			DEBUG_ASSERTCRASH(TheMemoryPoolFactory, ("hmm, no factory"));
@@ -554,6 +554,7 @@ static PoolSizeRec sizes[] =
 	{ "Win32LocalFile", 1024, 256 },
 	{ "StdLocalFile", 1024, 256 },
 	{ "RAMFile", 32, 32 },
+	{ "MappedArchiveFile", 32, 32 },
 	{ "BattlePlanBonuses", 32, 32 },
 	{ "KindOfPercentProductionChange", 32, 32 },
 	{ "UserParser", 4096, 256 },
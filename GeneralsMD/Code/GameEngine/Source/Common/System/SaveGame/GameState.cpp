@@ -42,7 +42,7 @@
 #include "Common/Team.h"
 #include "Common/WellKnownKeys.h"
 #include "Common/XferLoad.h"
-#include "Common/XferSave.h"
+#include "Common/XferMemory.h"
 #include "GameClient/CampaignManager.h"
 #include "GameClient/GadgetListBox.h"
 #include "GameClient/GameClient.h"
@@ -59,6 +59,11 @@
 #include "GameLogic/SidesList.h"
 #include "GameLogic/TerrainLogic.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 
 // PUBLIC DATA ////////////////////////////////////////////////////////////////////////////////////
 GameState *TheGameState = NULL;
@@ -73,6 +78,134 @@ static const Int MAX_SAVE_FILE_NUMBER  =  99999999;
 #define GAME_STATE_BLOCK_STRING "CHUNK_GameState"  // block of save game data with game info data
 #define CAMPAIGN_BLOCK_STRING "CHUNK_Campaign"		 // block of game data that has campaign info
 
+// PRIVATE TYPES //////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+/** A save game that is serialized but not yet on disk. The writer thread only touches the plain
+	* data and paths, everything else is left for the main thread */
+//-------------------------------------------------------------------------------------------------
+struct SaveGameWriteJob
+{
+	std::vector<UnsignedByte> data;
+	std::string filepath;							///< full path of the save file
+	std::string filename;							///< filename only, as passed to saveGame
+	SaveGameCallback callback;
+	void *callbackUserData;
+	Bool succeeded;
+};
+
+//-------------------------------------------------------------------------------------------------
+/** TheSuperHackers @performance Writes save files on a background thread in the order they were
+	* saved. Each file is written next to the old one and only moved over it once it is complete,
+	* so a crash or full disk in the middle of writing leaves the previous save intact */
+//-------------------------------------------------------------------------------------------------
+class SaveGameWriter
+{
+public:
+	SaveGameWriter() : m_writing(false), m_stop(false) { m_thread = std::thread(&SaveGameWriter::run, this); }
+
+	~SaveGameWriter()	///< finishes all queued writes
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_pendingCondition.notify_all();
+		m_thread.join();
+
+		for (size_t i = 0; i < m_finished.size(); ++i)
+			delete m_finished[i];
+	}
+
+	void write(SaveGameWriteJob *job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pending.push_back(job);
+		}
+		m_pendingCondition.notify_all();
+	}
+
+	void waitUntilIdle()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idleCondition.wait(lock, [this] { return m_pending.empty() && !m_writing; });
+	}
+
+	SaveGameWriteJob *popFinished()	///< returns NULL if no write finished since the last call
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_finished.empty())
+			return NULL;
+
+		SaveGameWriteJob *job = m_finished.front();
+		m_finished.pop_front();
+		return job;
+	}
+
+private:
+	void run()
+	{
+		for (;;)
+		{
+			SaveGameWriteJob *job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_pendingCondition.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+				if (m_pending.empty())
+					break;
+				job = m_pending.front();
+				m_pending.pop_front();
+				m_writing = true;
+			}
+
+			job->succeeded = writeFile(*job);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_finished.push_back(job);
+				m_writing = false;
+			}
+			m_idleCondition.notify_all();
+		}
+	}
+
+	static Bool writeFile(const SaveGameWriteJob& job)
+	{
+		const std::string tempPath = job.filepath + ".tmp";
+		FILE *fp = fopen(tempPath.c_str(), "wb");
+		if (fp == NULL)
+			return FALSE;
+
+		Bool ok = job.data.empty() || fwrite(&job.data[0], job.data.size(), 1, fp) == 1;
+		ok = fflush(fp) == 0 && ok;
+		ok = fclose(fp) == 0 && ok;
+
+		if (ok)
+		{
+#ifdef _WIN32
+			ok = MoveFileEx(tempPath.c_str(), job.filepath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+			ok = rename(tempPath.c_str(), job.filepath.c_str()) == 0;
+#endif
+		}
+
+		if (!ok)
+			remove(tempPath.c_str());
+
+		return ok;
+	}
+
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_pendingCondition;	///< signaled when a job was queued or the writer must stop
+	std::condition_variable m_idleCondition;		///< signaled when a job was written
+	std::deque<SaveGameWriteJob*> m_pending;
+	std::deque<SaveGameWriteJob*> m_finished;
+	bool m_writing;
+	bool m_stop;
+};
+
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 SaveGameInfo::SaveGameInfo( void )
@@ -278,6 +411,7 @@ GameState::GameState( void )
 
 	m_availableGames = NULL;
 	m_isInLoadGame = FALSE;
+	m_saveGameWriter = NULL;
 
 }
 
@@ -296,6 +430,10 @@ GameState::~GameState( void )
 	// clear any available game
 	clearAvailableGames();
 
+	// finish writing any save that is still in flight
+	delete m_saveGameWriter;
+	m_saveGameWriter = NULL;
+
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -351,6 +489,65 @@ void GameState::reset( void )
 
 }
 
+// ------------------------------------------------------------------------------------------------
+/** Report saves that the background writer has finished. Without a callback the user gets the
+	* same messages as when saves were written right away */
+// ------------------------------------------------------------------------------------------------
+void GameState::update( void )
+{
+
+	if( m_saveGameWriter == NULL )
+		return;
+
+	SaveGameWriteJob *job;
+	while( (job = m_saveGameWriter->popFinished()) != NULL )
+	{
+
+		const SaveCode code = job->succeeded ? SC_OK : SC_ERROR;
+		DEBUG_LOG(( "GameState::update - Writing '%s' %s", job->filepath.c_str(), job->succeeded ? "succeeded" : "failed" ));
+
+		if( job->callback != NULL )
+		{
+			job->callback( code, AsciiString( job->filename.c_str() ), job->callbackUserData );
+		}
+		else if( code == SC_OK )
+		{
+			// print message to the user for game successfully saved
+			UnicodeString msg = TheGameText->fetch( "GUI:GameSaveComplete" );
+			TheInGameUI->message( msg );
+		}
+		else
+		{
+			UnicodeString ufilepath;
+			ufilepath.translate( AsciiString( job->filepath.c_str() ) );
+
+			UnicodeString msg;
+			msg.format( TheGameText->fetch("GUI:ErrorSavingGame"), ufilepath.str() );
+
+			MessageBoxOk(TheGameText->fetch("GUI:Error"), msg, NULL);
+		}
+
+		delete job;
+
+	}
+
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Save files are only complete on disk after their background write, so everything that reads
+	* the save directory waits for pending saves first */
+// ------------------------------------------------------------------------------------------------
+void GameState::waitForPendingSaves( void )
+{
+
+	if( m_saveGameWriter == NULL )
+		return;
+
+	m_saveGameWriter->waitUntilIdle();
+	update();
+
+}
+
 // ------------------------------------------------------------------------------------------------
 /** Clear any available games entries */
 // ------------------------------------------------------------------------------------------------
@@ -531,10 +728,15 @@ AsciiString GameState::findNextSaveFilename( UnicodeString desc )
 
 // ------------------------------------------------------------------------------------------------
 /** Save the current state of the engine in a save file
-	* NOTE: filename is a *filename only* */
+	* NOTE: filename is a *filename only*
+	* TheSuperHackers @performance The game is serialized into memory right away, which is the only
+	* part that needs the game state. The file is written on a background thread and the result is
+	* reported from update() through 'callback', or with the usual user messages if there is none.
+	* SC_OK only means that the save was serialized */
 // ------------------------------------------------------------------------------------------------
 SaveCode GameState::saveGame( AsciiString filename, UnicodeString desc,
-															SaveFileType saveType, SnapshotType which )
+															SaveFileType saveType, SnapshotType which,
+															SaveGameCallback callback, void *callbackUserData )
 {
 
 	// if there is no filename, this is a new file being created, find an appropriate filename
@@ -557,16 +759,10 @@ SaveCode GameState::saveGame( AsciiString filename, UnicodeString desc,
 	// save description as current description in the game state
 	m_gameInfo.description = desc;
 
-	// open the save file
-	XferSave xferSave;
-	try {
-		xferSave.open( filepath );
-	} catch(...) {
-		// print error message to the user
-		TheInGameUI->message( "GUI:Error" );
-		DEBUG_LOG(( "Error opening file '%s'", filepath.str() ));
-		return SC_ERROR;
-	}
+	// open the save buffer
+	const UnsignedInt startTime = GetTickCount();
+	XferMemorySave xferSave;
+	xferSave.open( filepath );
 
 	// save our save file type
 	SaveGameInfo *gameInfo = getSaveGameInfo();
@@ -601,18 +797,56 @@ SaveCode GameState::saveGame( AsciiString filename, UnicodeString desc,
 
 		MessageBoxOk(TheGameText->fetch("GUI:Error"), msg, NULL);
 
-		// close the file and get out of here
+		// close the buffer and get out of here
 		xferSave.close();
 		return SC_ERROR;
 
 	}
 
-	// close the file
+	// close the buffer
 	xferSave.close();
 
-	// print message to the user for game successfully saved
-	UnicodeString msg = TheGameText->fetch( "GUI:GameSaveComplete" );
-	TheInGameUI->message( msg );
+	DEBUG_LOG(( "GameState::saveGame - Serialized %d bytes for '%s' in %u ms",
+							xferSave.getDataSize(), filepath.str(), GetTickCount() - startTime ));
+
+	// hand the data to the background writer
+	SaveGameWriteJob *job = NEW SaveGameWriteJob;
+	xferSave.swapData( job->data );
+	job->filepath = filepath.str();
+	job->filename = filename.str();
+	job->callback = callback;
+	job->callbackUserData = callbackUserData;
+	job->succeeded = FALSE;
+
+	if( m_saveGameWriter == NULL )
+		m_saveGameWriter = NEW SaveGameWriter;
+	m_saveGameWriter->write( job );
+
+	return SC_OK;
+
+}
+
+// ------------------------------------------------------------------------------------------------
+/** TheSuperHackers @feature Save the game state into an already opened xfer. This is the data
+	* part of saveGame without the file handling and user messages, so that replay playback can
+	* keep checkpoints in memory */
+// ------------------------------------------------------------------------------------------------
+SaveCode GameState::saveCheckpoint( Xfer *xfer )
+{
+
+	SaveGameInfo *gameInfo = getSaveGameInfo();
+	gameInfo->saveFileType = SAVE_FILE_TYPE_NORMAL;
+	gameInfo->missionMapName.clear();
+
+	try
+	{
+		xferSaveData( xfer, SNAPSHOT_SAVELOAD );
+	}
+	catch( ... )
+	{
+		DEBUG_LOG(( "GameState::saveCheckpoint - Error saving '%s'", xfer->getIdentifier().str() ));
+		return SC_ERROR;
+	}
 
 	return SC_OK;
 
@@ -758,6 +992,61 @@ SaveCode GameState::loadGame( AvailableGameInfo gameInfo )
 
 }
 
+// ------------------------------------------------------------------------------------------------
+/** TheSuperHackers @feature Replace the running game with the state in an already opened xfer
+	* that was written by saveCheckpoint. Unlike loadGame this does not show any user interface
+	* on failure, the game is cleared and the caller decides how to carry on */
+// ------------------------------------------------------------------------------------------------
+SaveCode GameState::loadCheckpoint( Xfer *xfer )
+{
+
+	TheGameStateMap->clearScratchPadMaps();
+
+	// clear out the game engine
+	TheGameEngine->reset();
+
+	// lock creation of new ghost objects
+	TheGhostObjectManager->saveLockGhostObjects( TRUE );
+
+	Bool error = FALSE;
+	{
+		LatchRestore<Bool> inLoadGame(m_isInLoadGame, TRUE);
+
+		try
+		{
+			xferSaveData( xfer, SNAPSHOT_SAVELOAD );
+		}
+		catch( ... )
+		{
+			error = TRUE;
+		}
+
+		// un-savelock the ghost objects
+		TheGhostObjectManager->saveLockGhostObjects( FALSE );
+
+		try
+		{
+			gameStatePostProcessLoad();
+		}
+		catch( ... )
+		{
+			error = TRUE;
+		}
+	}
+
+	if( error == TRUE )
+	{
+		DEBUG_LOG(( "GameState::loadCheckpoint - Error loading '%s'", xfer->getIdentifier().str() ));
+		if (TheGameLogic->isInGame())
+			TheGameLogic->clearGameData( FALSE );
+		TheGameEngine->reset();
+		return SC_INVALID_DATA;
+	}
+
+	return SC_OK;
+
+}
+
 //-------------------------------------------------------------------------------------------------
 AsciiString GameState::getSaveDirectory() const
 {
@@ -943,6 +1232,8 @@ AsciiString GameState::portableMapPathToRealMapPath(const AsciiString& in) const
 Bool GameState::doesSaveGameExist( AsciiString filename )
 {
 
+	waitForPendingSaves();
+
 	// construct full path to file
 	AsciiString filepath = getFilePathInSaveDirectory(filename);
 
@@ -980,6 +1271,8 @@ void GameState::getSaveGameInfoFromFile( AsciiString filename, SaveGameInfo *sav
 	Bool done = FALSE;
 	SnapshotBlock *blockInfo;
 
+	waitForPendingSaves();
+
 	// sanity
 	if( filename.isEmpty() == TRUE || saveGameInfo == NULL )
 	{
@@ -1253,6 +1546,8 @@ void GameState::populateSaveGameListbox( GameWindow *listbox, SaveLoadLayoutType
 void GameState::iterateSaveFiles( IterateSaveFileCallback callback, void *userData )
 {
 
+	waitForPendingSaves();
+
 	// sanity
 	if( callback == NULL )
 		return;
@@ -2877,6 +2877,8 @@ ParticleSystemManager::ParticleSystemManager( void )
 	m_fieldParticleCount = 0;
 	m_particleSystemCount = 0;
 	//
+	m_systemLookupCountThisFrame = 0;
+	m_evictedParticleCountThisFrame = 0;
 
 	for( Int i = 0; i < NUM_PARTICLE_PRIORITIES; ++i )
 	{
@@ -2937,6 +2939,8 @@ void ParticleSystemManager::reset( void )
 		deleteInstance(m_allParticleSystemList.front());
 	}
 	DEBUG_ASSERTCRASH(m_particleSystemCount == 0, ("ParticleSystemManager::reset: m_particleSystemCount is %u, not 0", m_particleSystemCount));
+	DEBUG_ASSERTCRASH(m_systemIDMap.empty(), ("ParticleSystemManager::reset: m_systemIDMap is not empty"));
+	m_systemIDMap.clear();
 
 	// sanity, our lists must be empty!!
 	for( Int i = 0; i < NUM_PARTICLE_PRIORITIES; ++i )
@@ -2959,6 +2963,8 @@ void ParticleSystemManager::reset( void )
 	m_uniqueSystemID = INVALID_PARTICLE_SYSTEM_ID;
 
 	m_lastLogicFrameUpdate = -1;
+	m_systemLookupCountThisFrame = 0;
+	m_evictedParticleCountThisFrame = 0;
 	// leave templates as-is
 }
 
@@ -2981,6 +2987,8 @@ void ParticleSystemManager::update( void )
 	m_lastLogicFrameUpdate = TheGameClient->getFrame();
 #endif
 
+	m_systemLookupCountThisFrame = 0;
+	m_evictedParticleCountThisFrame = 0;
 
 	//USE_PERF_TIMER(ParticleSystemManager)
 	ParticleSystemListIt it = m_allParticleSystemList.begin();
@@ -3041,18 +3049,15 @@ ParticleSystem *ParticleSystemManager::findParticleSystem( ParticleSystemID id )
 	if (id == INVALID_PARTICLE_SYSTEM_ID)
 		return NULL;	// my, that was easy
 
-	ParticleSystem *system = NULL;
+	++m_systemLookupCountThisFrame;
 
-	for( ParticleSystemListIt it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end(); ++it ) {
-		system = *it;
-		DEBUG_ASSERTCRASH(system != NULL, ("ParticleSystemManager::findParticleSystem: ParticleSystem is null"));
-
-		if( system->getSystemID() == id ) {
-			return system;
-		}
-	}
+	ParticleSystemIDMap::const_iterator it = m_systemIDMap.find(id);
+	if (it == m_systemIDMap.end())
+		return NULL;
 
-	return NULL;
+	ParticleSystem *system = *it->second;
+	DEBUG_ASSERTCRASH(system != NULL, ("ParticleSystemManager::findParticleSystem: ParticleSystem is null"));
+	return system;
 
 }
 
@@ -3216,7 +3221,9 @@ void ParticleSystemManager::removeParticle( Particle *particleToRemove)
 void ParticleSystemManager::friend_addParticleSystem( ParticleSystem *particleSystemToAdd )
 {
 	DEBUG_ASSERTCRASH(particleSystemToAdd != NULL, ("ParticleSystemManager::friend_addParticleSystem: ParticleSystem is null"));
-	m_allParticleSystemList.push_back(particleSystemToAdd);
+	ParticleSystemListIt it = m_allParticleSystemList.insert(m_allParticleSystemList.end(), particleSystemToAdd);
+	Bool inserted = m_systemIDMap.insert(std::make_pair(particleSystemToAdd->getSystemID(), it)).second;
+	DEBUG_ASSERTCRASH(inserted, ("ParticleSystemManager::friend_addParticleSystem: ParticleSystem ID %d is already in use", (Int)particleSystemToAdd->getSystemID()));
 	++m_particleSystemCount;
 }
 
@@ -3225,15 +3232,42 @@ void ParticleSystemManager::friend_addParticleSystem( ParticleSystem *particleSy
 // ------------------------------------------------------------------------------------------------
 void ParticleSystemManager::friend_removeParticleSystem( ParticleSystem *particleSystemToRemove )
 {
-	ParticleSystemListIt it = std::find(m_allParticleSystemList.begin(), m_allParticleSystemList.end(), particleSystemToRemove);
-	if (it != m_allParticleSystemList.end()) {
-		m_allParticleSystemList.erase(it);
+	ParticleSystemIDMap::iterator mapIt = m_systemIDMap.find(particleSystemToRemove->getSystemID());
+	if (mapIt != m_systemIDMap.end() && *mapIt->second == particleSystemToRemove) {
+		m_allParticleSystemList.erase(mapIt->second);
+		m_systemIDMap.erase(mapIt);
 		--m_particleSystemCount;
 	} else {
 		DEBUG_CRASH(("ParticleSystemManager::friend_removeParticleSystem: ParticleSystem to remove was not recognized"));
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+/** Re-key a particle system whose ID was changed after it was added, as loading does. */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystemManager::friend_changeParticleSystemID( ParticleSystem *particleSystem, ParticleSystemID oldID )
+{
+	ParticleSystemIDMap::iterator mapIt = m_systemIDMap.find(oldID);
+	if (mapIt == m_systemIDMap.end() || *mapIt->second != particleSystem) {
+		DEBUG_CRASH(("ParticleSystemManager::friend_changeParticleSystemID: ParticleSystem was not recognized"));
+		return;
+	}
+
+	if (particleSystem->getSystemID() == oldID) {
+		return;
+	}
+
+	// Insert the new ID first, so that a failed insert leaves the system findable under its old ID.
+	// The insert may rehash the map, so the old entry is erased by its key rather than through mapIt.
+	Bool inserted = m_systemIDMap.insert(std::make_pair(particleSystem->getSystemID(), mapIt->second)).second;
+	if (!inserted) {
+		DEBUG_CRASH(("ParticleSystemManager::friend_changeParticleSystemID: ParticleSystem ID %d is already in use", (Int)particleSystem->getSystemID()));
+		return;
+	}
+
+	m_systemIDMap.erase(oldID);
+}
+
 // ------------------------------------------------------------------------------------------------
 /** Remove the oldest N number of particles from the lowest priority lists first.  We will
  * not remove particles from any priorities higher or equal to the priorityCap parameter. */
@@ -3241,24 +3275,27 @@ void ParticleSystemManager::friend_removeParticleSystem( ParticleSystem *particl
 Int ParticleSystemManager::removeOldestParticles( UnsignedInt count,
 																									ParticlePriorityType priorityCap )
 {
-	Int countToRemove = count;
+	// TheSuperHackers @performance Each priority list is in creation order, so its head is always
+	// the oldest. Drain the lists from the lowest priority up, visiting each of them only once.
+	// TheSuperHackers @bugfix The count used to wrap around, so this never returned the number
+	// of particles actually removed and the caller never made room for its new particle.
+	UnsignedInt removed = 0;
 
-	while (count-- && getParticleCount())
+	for( Int i = PARTICLE_PRIORITY_LOWEST;
+			 i < priorityCap && removed < count;
+			 ++i )
 	{
-		for( Int i = PARTICLE_PRIORITY_LOWEST;
-				 i < priorityCap;
-				 ++i )
+		while( removed < count && m_allParticlesHead[ i ] )
 		{
-			if( m_allParticlesHead[ i ] )
-			{
-				deleteInstance(m_allParticlesHead[ i ]);
-				break;  // exit for
-			}
+			deleteInstance(m_allParticlesHead[ i ]);
+			++removed;
 		}
 	}
 
+	m_evictedParticleCountThisFrame += removed;
+
 	// return the number of particles actually removed
-	return countToRemove - count;
+	return removed;
 
 }
 
@@ -3377,8 +3414,11 @@ void ParticleSystemManager::xfer( Xfer *xfer )
 
 			}
 
-			// read system data
+			// read system data, which carries the ID the system was saved with
+			ParticleSystemID createdID = system->getSystemID();
 			xfer->xferSnapshot( system );
+			if( system->getSystemID() != createdID )
+				friend_changeParticleSystemID( system, createdID );
 
 		}
 
@@ -3409,6 +3449,8 @@ void ParticleSystemDebugDisplay( DebugDisplayInterface *dd, void *, FILE *fp )
 	dd->printf( "Total Particles: %d\n", TheParticleSystemManager->getParticleCount() );
 	dd->printf( "Total Particles (On Screen): %d\n", TheParticleSystemManager->getOnScreenParticleCount());
 	dd->printf( "Total Particle Systems: %d\n", TheParticleSystemManager->getParticleSystemCount() );
+	dd->printf( "System Lookups (This Frame): %d\n", TheParticleSystemManager->getSystemLookupCountThisFrame() );
+	dd->printf( "Evicted Particles (This Frame): %d\n", TheParticleSystemManager->getEvictedParticleCountThisFrame() );
 
 	ParticleSystemManager::ParticleSystemList list = TheParticleSystemManager->getAllParticleSystems();
 	ParticleSystemManager::ParticleSystemList::iterator it;
@@ -1098,6 +1098,19 @@ enum { PATHFIND_CELLS_PER_FRAME=5000}; // Number of cells we will search pathfin
 enum {CELL_INFOS_TO_ALLOCATE = 30000};
 PathfindCellInfo *PathfindCellInfo::s_infoArray = NULL;
 PathfindCellInfo *PathfindCellInfo::s_firstFree = NULL;
+UnsignedInt64 PathfindCellInfo::s_allocatedCellsKey = 0;
+
+// Scrambles the cell address, so the xor of all allocated cells is a usable key for the set of cells.
+static inline UnsignedInt64 hashCellForKey(const PathfindCell *cell)
+{
+	UnsignedInt64 h = (UnsignedInt64)(uintptr_t)cell;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
 
 #if RETAIL_COMPATIBLE_PATHFINDING
 // TheSuperHackers @info This variable is here so the code will run down the retail compatible path till a failure mode is hit
@@ -1138,6 +1151,7 @@ void PathfindCellInfo::allocateCellInfos(void)
 {
 	releaseCellInfos();
 	s_infoArray = MSGNEW("PathfindCellInfo") PathfindCellInfo[CELL_INFOS_TO_ALLOCATE];	// pool[]ify
+	s_allocatedCellsKey = 0;
 	s_infoArray[CELL_INFOS_TO_ALLOCATE-1].m_pathParent = NULL;
 	s_infoArray[CELL_INFOS_TO_ALLOCATE-1].m_isFree = true;
 	s_firstFree = s_infoArray;
@@ -1165,6 +1179,7 @@ void PathfindCellInfo::releaseCellInfos(void)
 	delete[] s_infoArray;
 	s_infoArray = NULL;
 	s_firstFree = NULL;
+	s_allocatedCellsKey = 0;
 }
 
 /**
@@ -1178,6 +1193,7 @@ PathfindCellInfo *PathfindCellInfo::getACellInfo(PathfindCell *cell,const ICoord
 		s_firstFree = s_firstFree->m_pathParent;
 		info->m_isFree = false;  // Just allocated it.
 		info->m_cell = cell;
+		s_allocatedCellsKey ^= hashCellForKey(cell);
 		info->m_pos = pos;
 
 		info->m_nextOpen = NULL;
@@ -1206,6 +1222,7 @@ void PathfindCellInfo::releaseACellInfo(PathfindCellInfo *theInfo)
 	DEBUG_ASSERTCRASH(!theInfo->m_isFree, ("Shouldn't be free."));
 	//@ todo -fix this assert on usa04.  jba.
 	//DEBUG_ASSERTCRASH(theInfo->m_obstacleID==0, ("Shouldn't be obstacle."));
+	s_allocatedCellsKey ^= hashCellForKey(theInfo->m_cell);
 	theInfo->m_pathParent = s_firstFree;
 	s_firstFree = theInfo;
 	s_firstFree->m_isFree = true;
@@ -3701,6 +3718,10 @@ void Pathfinder::reset( void )
 	m_isMapReady = false;
 	m_cumulativeCellsAllocated = 0;
 
+	invalidateHierarchicalPathCache();
+	m_hierarchicalPathCacheHits = 0;
+	m_hierarchicalPathCacheMisses = 0;
+
 	debugPathPos.x = 0.0f;
 	debugPathPos.y = 0.0f;
 	debugPathPos.z = 0.0f;
@@ -3745,6 +3766,7 @@ void Pathfinder::addWallPiece(Object *wallPiece)
 	if (m_numWallPieces<MAX_WALL_PIECES-1) {
 		m_wallPieces[m_numWallPieces] = wallPiece->getID();
 		m_numWallPieces++;
+		invalidateHierarchicalPathCache();
 	}
 }
 
@@ -3804,6 +3826,8 @@ Bool Pathfinder::isPointOnWall(const Coord3D *pos)
  */
 PathfindLayerEnum Pathfinder::addBridge(Bridge *theBridge)
 {
+	invalidateHierarchicalPathCache();
+
 	Int layer = LAYER_GROUND+1;
 	while (layer<=LAYER_WALL) {
 		if (m_layers[layer].isUnused()) {
@@ -3906,6 +3930,7 @@ void Pathfinder::classifyFence( Object *obj, Bool insert )
  		}
  	}
 	if (didAnything) {
+		invalidateHierarchicalPathCache();
 		m_zoneManager.markZonesDirty( insert );
 		m_zoneManager.updateZonesForModify(m_map, m_layers, cellBounds, m_extent);
 	}
@@ -3940,6 +3965,9 @@ void Pathfinder::classifyObjectFootprint( Object *obj, Bool insert )
 	}
 
 	if (!insert) {
+		// Removing a wall piece reclassifies the wall layer.
+		invalidateHierarchicalPathCache();
+
 		// Just in case, remove the object.  Remove checks that the object has been added before
 		// removing, so it's safer to just remove it, as by the time some units "die", they've become
 		// lifeless immobile husks of debris, but we still need to remove them.  jba.
@@ -4000,6 +4028,8 @@ void Pathfinder::classifyObjectFootprint( Object *obj, Bool insert )
 
 void Pathfinder::internal_classifyObjectFootprint( Object *obj, Bool insert )
 {
+	invalidateHierarchicalPathCache();
+
 	IRegion2D cellBounds;
 	const Coord3D *pos = obj->getPosition();
 	cellBounds.lo.x = REAL_TO_INT_FLOOR((pos->x + 0.5f)/PATHFIND_CELL_SIZE_F);
@@ -4406,6 +4436,7 @@ void Pathfinder::classifyMap(void)
 		m_layers[LAYER_WALL].classifyWallCells(m_wallPieces, m_numWallPieces);
 	}
 	m_zoneManager.calculateZones(m_map, m_layers, m_extent);
+	invalidateHierarchicalPathCache();
 }
 
 
@@ -5598,6 +5629,7 @@ void Pathfinder::processPathfindQueue(void)
     m_zoneManager.needToCalculateZones())
   {
 		m_zoneManager.calculateZones(m_map, m_layers, m_extent);
+		invalidateHierarchicalPathCache();
 		return;
 	}
 
@@ -5611,6 +5643,11 @@ void Pathfinder::processPathfindQueue(void)
 	bounds.hi.y = REAL_TO_INT_FLOOR(terrainExtent.hi.y / PATHFIND_CELL_SIZE_F);
 	bounds.hi.x--;
 	bounds.hi.y--;
+	if (bounds.lo.x != m_logicalExtent.lo.x || bounds.lo.y != m_logicalExtent.lo.y ||
+		bounds.hi.x != m_logicalExtent.hi.x || bounds.hi.y != m_logicalExtent.hi.y) {
+		// Searches for human players are clipped to the logical extent.
+		invalidateHierarchicalPathCache();
+	}
 	m_logicalExtent = bounds;
 
 	m_cumulativeCellsAllocated = 0;	// Number of pathfind cells examined.
@@ -6522,6 +6559,105 @@ Path *Pathfinder::buildHierachicalPath( const Coord3D *fromPos, PathfindCell *go
 }
 
 
+//-----------------------------------------------------------------------------
+bool Pathfinder::HierarchicalPathKey::operator<(const HierarchicalPathKey &other) const
+{
+	if (startCell != other.startCell) return startCell < other.startCell;
+	if (goalCell != other.goalCell) return goalCell < other.goalCell;
+	if (locomotorSurface != other.locomotorSurface) return locomotorSurface < other.locomotorSurface;
+	if (crusher != other.crusher) return crusher < other.crusher;
+	if (closestOK != other.closestOK) return closestOK < other.closestOK;
+	return isHuman < other.isHuman;
+}
+
+/**
+ * The cache is only used on the fixed pathfinding code path. The retail code path leaves
+ * parent links behind in cell infos, and a search answered from the cache would not.
+ */
+Bool Pathfinder::isHierarchicalPathCacheUsable( void )
+{
+#if RETAIL_COMPATIBLE_PATHFINDING
+	return s_useFixedPathfinding;
+#else
+	return true;
+#endif
+}
+
+void Pathfinder::invalidateHierarchicalPathCache( void )
+{
+	m_hierarchicalPathCache.clear();
+}
+
+void Pathfinder::getHierarchicalPathCacheStats(UnsignedInt *hits, UnsignedInt *misses) const
+{
+	*hits = m_hierarchicalPathCacheHits;
+	*misses = m_hierarchicalPathCacheMisses;
+}
+
+/**
+ * Remember the result of a hierarchical search.  Must be called before the path is built, as building
+ * the path clears the parent links.  If lastCell is NULL, the search failed.
+ */
+Pathfinder::HierarchicalPathEntry *Pathfinder::storeHierarchicalPath(const HierarchicalPathKey &key,
+	UnsignedInt64 allocatedCellsKey, PathfindCell *lastCell)
+{
+	enum {MAX_CACHED_HIERARCHICAL_PATHS = 512};
+	if (m_hierarchicalPathCache.size() >= MAX_CACHED_HIERARCHICAL_PATHS) {
+		m_hierarchicalPathCache.clear();
+	}
+
+	HierarchicalPathEntry &entry = m_hierarchicalPathCache[key];
+	entry.allocatedCellsKey = allocatedCellsKey;
+	entry.cellsExamined = 0;
+	entry.cells.clear();
+	for (PathfindCell *cell = lastCell; cell; cell = cell->getParentCell()) {
+		HierarchicalPathCell pathCell;
+		pathCell.cell = cell;
+		pathCell.pos.x = cell->getXIndex();
+		pathCell.pos.y = cell->getYIndex();
+		entry.cells.push_back(pathCell);
+	}
+	return &entry;
+}
+
+/**
+ * Rebuild the path of a cached hierarchical search.  The parent links of the cached cells are restored,
+ * so buildHierachicalPath produces exactly the path the search would have.  Returns with built
+ * false if the cell infos could not be allocated, in which case the search has to be done.
+ */
+Path *Pathfinder::buildCachedHierarchicalPath(const Coord3D *fromPos, const HierarchicalPathEntry &entry, Bool &built)
+{
+	const Int numCells = (Int)entry.cells.size();
+	built = false;
+	if (numCells == 0) {
+		built = true;
+		return NULL;
+	}
+
+	Int i;
+	for (i=0; i<numCells; i++) {
+		if (!entry.cells[i].cell->allocateInfo(entry.cells[i].pos)) {
+			while (i-- > 0) {
+				entry.cells[i].cell->releaseInfo();
+			}
+			return NULL;
+		}
+	}
+	for (i=0; i<numCells-1; i++) {
+		entry.cells[i].cell->setParentCellHierarchical(entry.cells[i+1].cell);
+	}
+	entry.cells[numCells-1].cell->clearParentCell();
+
+	Path *path = buildHierachicalPath(fromPos, entry.cells[0].cell);
+
+	for (i=0; i<numCells; i++) {
+		entry.cells[i].cell->releaseInfo();
+	}
+	built = true;
+	return path;
+}
+
+
 struct MADStruct
 {
 	Pathfinder					*thePathfinder;
@@ -7202,6 +7338,41 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 		return NULL;
 	}
 
+	// TheSuperHackers @performance Group moves and repaths repeat the same hierarchical search many times.
+	// The result depends on the start and goal cells, the zones, and on which cells have an info, so a
+	// cached result is used only while the set of cells with an info is the same as when it was stored.
+	HierarchicalPathKey cacheKey;
+	cacheKey.startCell = parentCell;
+	cacheKey.goalCell = goalCell;
+	cacheKey.locomotorSurface = locomotorSurface;
+	cacheKey.crusher = crusher;
+	cacheKey.closestOK = closestOK;
+	cacheKey.isHuman = isHuman;
+	const Bool useCache = isHierarchicalPathCacheUsable();
+	const UnsignedInt64 allocatedCellsKey = PathfindCellInfo::getAllocatedCellsKey();
+	const Int cellsExaminedBefore = m_cumulativeCellsAllocated;
+	if (useCache) {
+		HierarchicalPathCache::const_iterator it = m_hierarchicalPathCache.find(cacheKey);
+		if (it != m_hierarchicalPathCache.end() && it->second.allocatedCellsKey == allocatedCellsKey) {
+			Bool built;
+			Path *path = buildCachedHierarchicalPath(from, it->second, built);
+			if (built) {
+				m_hierarchicalPathCacheHits++;
+				// Charge the queue for the cells the search examined, so the same requests get processed each frame.
+				m_cumulativeCellsAllocated += it->second.cellsExamined;
+				parentCell->releaseInfo();
+				goalCell->releaseInfo();
+#ifdef DUMP_PERF_STATS
+				if (path == NULL) {
+					TheGameLogic->incrementOverallFailedPathfinds();
+				}
+#endif
+				return path;
+			}
+		}
+		m_hierarchicalPathCacheMisses++;
+	}
+
 	parentCell->startPathfind(goalCell);
 
 	// "closed" list is initially empty
@@ -7430,6 +7601,7 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 			// success - found a path to the goal
 
 			m_isTunneling = false;
+			HierarchicalPathEntry *cacheEntry = useCache ? storeHierarchicalPath(cacheKey, allocatedCellsKey, goalCell) : NULL;
 			// construct and return path
 			Path *path =  buildHierachicalPath( from, goalCell );
 #if defined(RTS_DEBUG)
@@ -7455,6 +7627,9 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 				parentCell->releaseInfo();
 				goalCell->releaseInfo();
 			}
+			if (cacheEntry) {
+				cacheEntry->cellsExamined = m_cumulativeCellsAllocated - cellsExaminedBefore;
+			}
 			return path;
 		}
 
@@ -7619,6 +7794,7 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 
 	if (closestOK && closestCell) {
 		m_isTunneling = false;
+		HierarchicalPathEntry *cacheEntry = useCache ? storeHierarchicalPath(cacheKey, allocatedCellsKey, closestCell) : NULL;
 		// construct and return path
 		Path *path =  buildHierachicalPath( from, closestCell );
 
@@ -7637,6 +7813,9 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 			parentCell->releaseInfo();
 			goalCell->releaseInfo();
 		}
+		if (cacheEntry) {
+			cacheEntry->cellsExamined = m_cumulativeCellsAllocated - cellsExaminedBefore;
+		}
 		return path;
 	}
 
@@ -7682,6 +7861,7 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 	TheGameLogic->incrementOverallFailedPathfinds();
 #endif
 	m_isTunneling = false;
+	HierarchicalPathEntry *cacheEntry = useCache ? storeHierarchicalPath(cacheKey, allocatedCellsKey, NULL) : NULL;
 #if RETAIL_COMPATIBLE_PATHFINDING
 	if (!s_useFixedPathfinding)
 	{
@@ -7695,6 +7875,9 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 		parentCell->releaseInfo();
 		goalCell->releaseInfo();
 	}
+	if (cacheEntry) {
+		cacheEntry->cellsExamined = m_cumulativeCellsAllocated - cellsExaminedBefore;
+	}
 
 	return NULL;
 }
@@ -9536,6 +9719,7 @@ void Pathfinder::changeBridgeState( PathfindLayerEnum layer, Bool repaired)
 {
 	if (m_layers[layer].isUnused()) return;
 	if (m_layers[layer].setDestroyed(!repaired)) {
+		invalidateHierarchicalPathCache();
 		m_zoneManager.markZonesDirty( repaired );
 	}
 }
@@ -38,6 +38,7 @@
 /* ********* PolygonTrigger class ****************************/
 PolygonTrigger *PolygonTrigger::ThePolygonTriggerListPtr = NULL;
 Int PolygonTrigger::s_currentID = 1;
+UnsignedInt PolygonTrigger::s_listGeneration = 0;
 /**
  PolygonTrigger - Constructor.
 */
@@ -304,6 +305,7 @@ void PolygonTrigger::addPolygonTrigger(PolygonTrigger *pTrigger)
 	}
 	pTrigger->m_nextPolygonTrigger = ThePolygonTriggerListPtr;
 	ThePolygonTriggerListPtr = pTrigger;
+	++s_listGeneration;
 }
 
 /**
@@ -329,6 +331,7 @@ void PolygonTrigger::removePolygonTrigger(PolygonTrigger *pTrigger)
 		}
 	}
 	pTrigger->m_nextPolygonTrigger = NULL;
+	++s_listGeneration;
 }
 
 /**
@@ -339,6 +342,7 @@ void PolygonTrigger::deleteTriggers(void)
 	PolygonTrigger *pList = ThePolygonTriggerListPtr;
 	ThePolygonTriggerListPtr = NULL;
 	s_currentID = 1;
+	++s_listGeneration;
 	deleteInstance(pList);
 }
 
@@ -34,6 +34,7 @@
 #include "Common/GameState.h"
 #include "Common/MapObject.h"
 #include "Common/Radar.h"
+#include "Common/Recorder.h"
 #include "Common/ThingFactory.h"
 #include "Common/ThingTemplate.h"
 #include "Common/WellKnownKeys.h"
@@ -978,6 +979,8 @@ TerrainLogic::TerrainLogic()
 
 	m_waypointListHead = NULL;
 	m_bridgeListHead = NULL;
+	m_triggerAreaIndexGeneration = 0;
+	m_triggerAreaIndexValid = FALSE;
 	m_mapData = NULL;
 	m_bridgeDamageStatesChanged = FALSE;
 	m_mapDX = 0;
@@ -1363,6 +1366,8 @@ void TerrainLogic::addWaypoint(MapObject *pMapObj)
 																&loc, label1, label2, label3, biDirectional);
 	pWay->setNext(m_waypointListHead);
 	m_waypointListHead = pWay;
+	// the new head of the list is the first match for its name
+	m_waypointIndex[pWay->getName()] = pWay;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1418,6 +1423,7 @@ void TerrainLogic::deleteWaypoints(void)
 		deleteInstance(pWay);
 	}
 	m_waypointListHead = NULL;
+	m_waypointIndex.clear();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1554,16 +1560,37 @@ void TerrainLogic::addLandmarkBridgeToLogic(Object *bridgeObj)
 
 }
 
+//-------------------------------------------------------------------------------------------------
+/** With -verifyScriptLookups, reports a name index lookup that differs from the list search it replaced. */
+//-------------------------------------------------------------------------------------------------
+static void verifyNameLookup( const char *kind, const AsciiString& name, Bool matches )
+{
+	if (!matches)
+	{
+		AsciiString failure;
+		failure.format("Indexed lookup of %s '%s' differs from the linear search.", kind, name.str());
+		DEBUG_CRASH(("%s", failure.str()));
+		TheRecorder->logVerificationFailure(failure.str());
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 /** Given a name, return the associated waypoint. */
 //-------------------------------------------------------------------------------------------------
-Waypoint *TerrainLogic::getWaypointByName( AsciiString name )
+Waypoint *TerrainLogic::getWaypointByName( const AsciiString& name )
 {
-	for( Waypoint *way = m_waypointListHead; way; way = way->getNext() )
-		if (way->getName() == name)
-			return way;
+	NameToWaypointMap::const_iterator it = m_waypointIndex.find(name);
+	Waypoint *way = it != m_waypointIndex.end() ? it->second : NULL;
 
-	return NULL;
+	if (TheGlobalData->m_verifyScriptLookups)
+	{
+		Waypoint *searched = m_waypointListHead;
+		while (searched && searched->getName() != name)
+			searched = searched->getNext();
+		verifyNameLookup("waypoint", name, way == searched);
+	}
+
+	return way;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1633,14 +1660,31 @@ Bool TerrainLogic::isPurposeOfPath( Waypoint *pWay, AsciiString label )
 //-------------------------------------------------------------------------------------------------
 /** Given a name, return the associated trigger area, or NULL if one doesn't exist. */
 //-------------------------------------------------------------------------------------------------
-PolygonTrigger *TerrainLogic::getTriggerAreaByName( AsciiString name )
+PolygonTrigger *TerrainLogic::getTriggerAreaByName( const AsciiString& name )
 {
-	for (PolygonTrigger* pTrig = PolygonTrigger::getFirstPolygonTrigger(); pTrig; pTrig = pTrig->getNext()) {
-		AsciiString trigName = pTrig->getTriggerName();
-		if (name == trigName)
-			return pTrig;
+	// The trigger list belongs to PolygonTrigger, so rebuild the index whenever it reports a change.
+	if (!m_triggerAreaIndexValid || m_triggerAreaIndexGeneration != PolygonTrigger::getListGeneration()) {
+		m_triggerAreaIndex.clear();
+		for (PolygonTrigger* pTrig = PolygonTrigger::getFirstPolygonTrigger(); pTrig; pTrig = pTrig->getNext()) {
+			// insert keeps the first trigger with a name, as the linear search did
+			m_triggerAreaIndex.insert(NameToTriggerAreaMap::value_type(pTrig->getTriggerName(), pTrig));
+		}
+		m_triggerAreaIndexGeneration = PolygonTrigger::getListGeneration();
+		m_triggerAreaIndexValid = TRUE;
 	}
-	return NULL;
+
+	NameToTriggerAreaMap::const_iterator it = m_triggerAreaIndex.find(name);
+	PolygonTrigger *trigger = it != m_triggerAreaIndex.end() ? it->second : NULL;
+
+	if (TheGlobalData->m_verifyScriptLookups)
+	{
+		PolygonTrigger *searched = PolygonTrigger::getFirstPolygonTrigger();
+		while (searched && searched->getTriggerName() != name)
+			searched = searched->getNext();
+		verifyNameLookup("trigger area", name, trigger == searched);
+	}
+
+	return trigger;
 }
 
 
@@ -4804,26 +4804,33 @@ void Object::handleShroud()
 //-------------------------------------------------------------------------------------------------
 void Object::handleValueMap()
 {
-	removeValue();
-	addValue();
+	// TheSuperHackers @performance Build the new value first, so that the partition manager only needs
+	// to apply the difference to the value map, instead of removing and adding the whole footprint.
+	SightingInfo *newValue = newInstance(SightingInfo);
+	makeValueSighting(newValue);
+
+	ThePartitionManager->moveValueAffect(m_partitionLastValue, newValue);
+
+	deleteInstance(m_partitionLastValue);
+	m_partitionLastValue = newValue;
 }
 
 //-------------------------------------------------------------------------------------------------
 void Object::handleThreatMap()
 {
-	removeThreat();
-	addThreat();
+	// TheSuperHackers @performance Same as the value map.
+	SightingInfo *newThreat = newInstance(SightingInfo);
+	makeThreatSighting(newThreat);
+
+	ThePartitionManager->moveThreatAffect(m_partitionLastThreat, newThreat);
+
+	deleteInstance(m_partitionLastThreat);
+	m_partitionLastThreat = newThreat;
 }
 
 //-------------------------------------------------------------------------------------------------
-void Object::addValue()
+void Object::makeValueSighting( SightingInfo *info )
 {
-	if( !m_partitionLastValue->isInvalid() )
-	{
-		DEBUG_CRASH( ("An Object is adding value, but hasn't removed his previous value.") );
-		return;
-	}
-
 	if (!getControllingPlayer())
 		return;
 
@@ -4831,49 +4838,16 @@ void Object::addValue()
 		return;
 
 
-	m_partitionLastValue->m_where = *getPosition();
-	m_partitionLastValue->m_data = getTemplate()->friend_getBuildCost();
-
-	m_partitionLastValue->m_forWhom = getControllingPlayer()->getPlayerMask();
-	m_partitionLastValue->m_howFar = getVisionRange();	// we are valuable all the way to where we can target.
-
-	ThePartitionManager->doValueAffect(m_partitionLastValue->m_where.x,
-																		 m_partitionLastValue->m_where.y,
-																		 m_partitionLastValue->m_howFar,
-																		 m_partitionLastValue->m_data,
-																		 m_partitionLastValue->m_forWhom
-																		 );
-}
-
-//-------------------------------------------------------------------------------------------------
-void Object::removeValue()
-{
-	if( m_partitionLastValue->isInvalid() )
-	{
-		// removing before adding is valid, cause we always remove before adding. (So the first remove
-		// will occur before the first add)
-		return;
-	}
-
-	ThePartitionManager->undoValueAffect(m_partitionLastValue->m_where.x,
-																			 m_partitionLastValue->m_where.y,
-																			 m_partitionLastValue->m_howFar,
-																			 m_partitionLastValue->m_data,
-																			 m_partitionLastValue->m_forWhom
-																			);
+	info->m_where = *getPosition();
+	info->m_data = getTemplate()->friend_getBuildCost();
 
-	m_partitionLastValue->reset();
+	info->m_forWhom = getControllingPlayer()->getPlayerMask();
+	info->m_howFar = getVisionRange();	// we are valuable all the way to where we can target.
 }
 
 //-------------------------------------------------------------------------------------------------
-void Object::addThreat()
+void Object::makeThreatSighting( SightingInfo *info )
 {
-	if( !m_partitionLastThreat->isInvalid() )
-	{
-		DEBUG_CRASH( ("An Object is adding threat, but hasn't removed his previous threat. (He hasn't finished the threat?)") );
-		return;
-	}
-
 	if (!getControllingPlayer())
 		return;
 
@@ -4881,38 +4855,11 @@ void Object::addThreat()
 		return;
 
 
-	m_partitionLastThreat->m_where = *getPosition();
-	m_partitionLastThreat->m_data = getTemplate()->getThreatValue();
-
-	m_partitionLastThreat->m_forWhom = getControllingPlayer()->getPlayerMask();
-	m_partitionLastThreat->m_howFar = getVisionRange();	// we are threatening all the way to where we can target.
-
-	ThePartitionManager->doThreatAffect(m_partitionLastThreat->m_where.x,
-																			m_partitionLastThreat->m_where.y,
-																			m_partitionLastThreat->m_howFar,
-																			m_partitionLastThreat->m_data,
-																			m_partitionLastThreat->m_forWhom
-																		 );
-}
+	info->m_where = *getPosition();
+	info->m_data = getTemplate()->getThreatValue();
 
-//-------------------------------------------------------------------------------------------------
-void Object::removeThreat()
-{
-	if( m_partitionLastThreat->isInvalid() )
-	{
-		// removing before adding is valid, cause we always remove before adding. (So the first remove
-		// will occur before the first add)
-		return;
-	}
-
-	ThePartitionManager->undoThreatAffect(m_partitionLastThreat->m_where.x,
-																			  m_partitionLastThreat->m_where.y,
-																			  m_partitionLastThreat->m_howFar,
-																				m_partitionLastThreat->m_data,
-																			  m_partitionLastThreat->m_forWhom
-																			 );
-
-	m_partitionLastThreat->reset();
+	info->m_forWhom = getControllingPlayer()->getPlayerMask();
+	info->m_howFar = getVisionRange();	// we are threatening all the way to where we can target.
 }
 
 
@@ -60,6 +60,7 @@
 #include "Common/Player.h"
 #include "Common/PlayerList.h"
 #include "Common/Radar.h"
+#include "Common/Recorder.h"
 #include "Common/ThingFactory.h"	// for bullet type hack
 #include "Common/ThingTemplate.h"
 #include "Common/Xfer.h"
@@ -119,9 +120,25 @@ static PartitionContactList* TheContactList = NULL;
 //-----------------------------------------------------------------------------
 //         Local Types
 //-----------------------------------------------------------------------------
+struct ThreatValueFootprint
+{
+	Int cellCenterX;
+	Int cellCenterY;
+	Int cellRadius;
+	UnsignedInt threatOrValue;
+	PlayerMaskType playerMask;		///< 0 for a footprint that covers nothing
+
+	void clear();
+	void set( Real centerX, Real centerY, Real radius, UnsignedInt value, PlayerMaskType mask );
+	void set( const SightingInfo *info );
+	Bool isSame( const ThreatValueFootprint &other ) const;
+	UnsignedInt getValueAt( Int x, Int y ) const;
+};
+
+/// one player's circle of a footprint, for the reference planes of -verifyThreatValues
 struct ThreatValueParms
 {
-	Int playerIndex;
+	UnsignedInt *plane;
 	Real xCenter;
 	Real yCenter;
 	Real radius;
@@ -147,6 +164,8 @@ struct CellValueProcParms
 };
 
 static int cellValueProc(PartitionCell* cell, void* userData);
+static void hLineAddThreatValue(Int x1, Int x2, Int y, void *threatValueParms);
+static void hLineRemoveThreatValue(Int x1, Int x2, Int y, void *threatValueParms);
 
 /*
 	Notes:
@@ -333,15 +352,6 @@ inline Real maxReal(Real a, Real b)
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
-static void hLineAddLooker(Int x1, Int x2, Int y, void *playerIndexVoid);
-static void hLineRemoveLooker(Int x1, Int x2, Int y, void *playerIndexVoid);
-static void hLineAddShrouder(Int x1, Int x2, Int y, void *playerIndexVoid);
-static void hLineRemoveShrouder(Int x1, Int x2, Int y, void *playerIndexVoid);
-static void hLineAddThreat(Int x1, Int x2, Int y, void *threatValueParms);
-static void hLineRemoveThreat(Int x1, Int x2, Int y, void *threatValueParms);
-static void hLineAddValue(Int x1, Int x2, Int y, void *threatValueParms);
-static void hLineRemoveValue(Int x1, Int x2, Int y, void *threatValueParms);
-
 static void projectCoord3D(Coord3D *coord, const Coord3D *unitDir, Real dist);
 static void flipCoord3D(Coord3D *coord);
 
@@ -1247,12 +1257,6 @@ PartitionCell::PartitionCell()
 		// Default is "passive shroud".  1,0.
 		m_shroudLevel[i].m_currentShroud = 1;
 		m_shroudLevel[i].m_activeShroudLevel = 0;
-
-		// default cash value is 0
-		m_cashValue[i] = 0;
-
-		// default threat value is 0
-		m_threatValue[i] = 0;
 	}
 }
 
@@ -1395,72 +1399,6 @@ CellShroudStatus PartitionCell::getShroudStatusForPlayer( Int playerIndex ) cons
 		return CELLSHROUD_CLEAR;
 }
 
-//-----------------------------------------------------------------------------
-UnsignedInt PartitionCell::getThreatValue( Int playerIndex )
-{
-	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
-		return m_threatValue[playerIndex];
-	}
-	return 0;
-}
-
-//-----------------------------------------------------------------------------
-void PartitionCell::addThreatValue( Int playerIndex, UnsignedInt threatValue )
-{
-	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
-#ifdef DEBUG_CRASHING
-		UnsignedInt oldThreatVal = m_threatValue[playerIndex];
-		DEBUG_ASSERTCRASH(oldThreatVal <= oldThreatVal + threatValue, ("adding new threat value overflowed allotted storage."));
-#endif
-		m_threatValue[playerIndex] += threatValue;
-	}
-}
-
-//-----------------------------------------------------------------------------
-void PartitionCell::removeThreatValue( Int playerIndex, UnsignedInt threatValue )
-{
-	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
-#ifdef DEBUG_CRASHING
-		UnsignedInt oldThreatVal = m_threatValue[playerIndex];
-		DEBUG_ASSERTCRASH(oldThreatVal >= oldThreatVal - threatValue, ("removing new threat value underflowed allotted storage."));
-#endif
-		m_threatValue[playerIndex] -= threatValue;
-	}
-}
-
-//-----------------------------------------------------------------------------
-UnsignedInt PartitionCell::getCashValue( Int playerIndex )
-{
-	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
-		return m_cashValue[playerIndex];
-	}
-	return 0;
-}
-
-//-----------------------------------------------------------------------------
-void PartitionCell::addCashValue( Int playerIndex, UnsignedInt cashValue )
-{
-	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
-#ifdef DEBUG_CRASHING
-		UnsignedInt oldCashVal = m_cashValue[playerIndex];
-		DEBUG_ASSERTCRASH(oldCashVal <= oldCashVal + cashValue, ("adding new cash value overflowed allotted storage."));
-#endif
-		m_cashValue[playerIndex] += cashValue;
-	}
-}
-
-//-----------------------------------------------------------------------------
-void PartitionCell::removeCashValue( Int playerIndex, UnsignedInt cashValue )
-{
-	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
-#ifdef DEBUG_CRASHING
-		UnsignedInt oldCashVal = m_cashValue[playerIndex];
-		DEBUG_ASSERTCRASH(oldCashVal >= oldCashVal - cashValue, ("removing new cash value underflowed allotted storage."));
-#endif
-		m_cashValue[playerIndex] -= cashValue;
-	}
-}
-
 //-----------------------------------------------------------------------------
 void PartitionCell::friend_addToCellList(CellAndObjectIntersection *coi)
 {
@@ -1543,6 +1481,77 @@ void PartitionCell::loadPostProcess( void )
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+static volatile LONG s_queryContextSlotsInUse = 0;	///< one bit per PartitionQueryContext slot
+static Int s_queryContextIterFlag[PARTITION_QUERY_CONTEXT_SLOTS] = { 0 };	///< only touched by the slot owner
+
+//-----------------------------------------------------------------------------
+PartitionQueryContext::PartitionQueryContext() :
+	m_slot(-1),
+	m_iterFlag(0),
+	m_overflowVisited(NULL)
+{
+	// the first guess is read interlocked too, a plain read would race with other threads
+	LONG inUse = ::InterlockedCompareExchange(&s_queryContextSlotsInUse, 0, 0);
+	for (;;)
+	{
+		Int slot = 0;
+		while (slot < PARTITION_QUERY_CONTEXT_SLOTS && (inUse & (1 << slot)) != 0)
+			++slot;
+		if (slot == PARTITION_QUERY_CONTEXT_SLOTS)
+			break;
+
+		const LONG prev = ::InterlockedCompareExchange(&s_queryContextSlotsInUse, inUse | (1 << slot), inUse);
+		if (prev == inUse)
+		{
+			m_slot = slot;
+			break;
+		}
+		inUse = prev;
+	}
+
+	if (m_slot >= 0)
+	{
+		// nonzero, thanks. (done flags start out as zero.)
+		m_iterFlag = ++s_queryContextIterFlag[m_slot];
+	}
+	else
+	{
+		DEBUG_LOG(("PartitionQueryContext: all %d slots in use, falling back to a private visited-set", PARTITION_QUERY_CONTEXT_SLOTS));
+		m_overflowVisited = new std::set<PartitionData*>;
+	}
+}
+
+//-----------------------------------------------------------------------------
+PartitionQueryContext::~PartitionQueryContext()
+{
+	if (m_slot >= 0)
+	{
+		LONG inUse = ::InterlockedCompareExchange(&s_queryContextSlotsInUse, 0, 0);
+		for (;;)
+		{
+			const LONG prev = ::InterlockedCompareExchange(&s_queryContextSlotsInUse, inUse & ~(1 << m_slot), inUse);
+			if (prev == inUse)
+				break;
+			inUse = prev;
+		}
+	}
+	delete m_overflowVisited;
+}
+
+//-----------------------------------------------------------------------------
+Bool PartitionQueryContext::markVisited(PartitionData *data)
+{
+	if (m_slot >= 0)
+	{
+		if (data->friend_getDoneFlag(m_slot) == m_iterFlag)
+			return FALSE;
+		data->friend_setDoneFlag(m_slot, m_iterFlag);
+		return TRUE;
+	}
+	return m_overflowVisited->insert(data).second;
+}
+
 //-----------------------------------------------------------------------------
 PartitionData::PartitionData()
 {
@@ -1556,7 +1565,8 @@ PartitionData::PartitionData()
 	m_coiArrayCount = 0;
 	m_coiArray = NULL;
 	m_coiInUseCount = 0;
-	m_doneFlag = 0;
+	for (Int slot = 0; slot < PARTITION_QUERY_CONTEXT_SLOTS; ++slot)
+		m_doneFlag[slot] = 0;
 	m_dirtyStatus = NOT_DIRTY;
 	m_lastCell = NULL;
 	for (int i = 0; i < MAX_PLAYER_COUNT; ++i)
@@ -2567,6 +2577,10 @@ PartitionManager::PartitionManager()
 	m_cellCountY = 0;
 	m_totalCellCount = 0;
 	m_cells = NULL;
+	m_threatValues = NULL;
+	m_cashValues = NULL;
+	m_threatValuesReference = NULL;
+	m_cashValuesReference = NULL;
 	m_worldExtents.lo.zero();
 	m_worldExtents.hi.zero();
 	m_dirtyModules = NULL;
@@ -2634,6 +2648,18 @@ void PartitionManager::init()
 		m_cellCountY = REAL_TO_INT_CEIL(m_worldExtents.height() * m_cellSizeInv);
 		m_totalCellCount = m_cellCountX * m_cellCountY;
 		m_cells = MSGNEW("PartitionManager_Cells") PartitionCell[m_totalCellCount];
+		m_threatValues = MSGNEW("PartitionManager_ThreatValues") UnsignedInt[m_totalCellCount * MAX_PLAYER_COUNT];
+		m_cashValues = MSGNEW("PartitionManager_CashValues") UnsignedInt[m_totalCellCount * MAX_PLAYER_COUNT];
+		memset(m_threatValues, 0, sizeof(UnsignedInt) * m_totalCellCount * MAX_PLAYER_COUNT);
+		memset(m_cashValues, 0, sizeof(UnsignedInt) * m_totalCellCount * MAX_PLAYER_COUNT);
+		m_threatValueRow.resize(m_cellCountX);
+		if (TheGlobalData->m_verifyThreatValues)
+		{
+			m_threatValuesReference = MSGNEW("PartitionManager_ThreatValues") UnsignedInt[m_totalCellCount * MAX_PLAYER_COUNT];
+			m_cashValuesReference = MSGNEW("PartitionManager_CashValues") UnsignedInt[m_totalCellCount * MAX_PLAYER_COUNT];
+			memset(m_threatValuesReference, 0, sizeof(UnsignedInt) * m_totalCellCount * MAX_PLAYER_COUNT);
+			memset(m_cashValuesReference, 0, sizeof(UnsignedInt) * m_totalCellCount * MAX_PLAYER_COUNT);
+		}
 		for (Int x = 0; x < m_cellCountX; x++)
 		{
 			for (Int y = 0; y < m_cellCountY; y++)
@@ -2660,6 +2686,10 @@ void PartitionManager::init()
 		m_cellCountY = 0;
 		m_totalCellCount = 0;
 		m_cells = NULL;
+		m_threatValues = NULL;
+		m_cashValues = NULL;
+		m_threatValuesReference = NULL;
+		m_cashValuesReference = NULL;
 		m_worldExtents.lo.zero();
 		m_worldExtents.hi.zero();
 	}
@@ -2722,6 +2752,14 @@ void PartitionManager::shutdown()
 
 	delete [] m_cells;
 	m_cells = NULL;
+	delete [] m_threatValues;
+	m_threatValues = NULL;
+	delete [] m_cashValues;
+	m_cashValues = NULL;
+	delete [] m_threatValuesReference;
+	m_threatValuesReference = NULL;
+	delete [] m_cashValuesReference;
+	m_cashValuesReference = NULL;
 
 	m_cellSize = m_cellSizeInv = 0.0f;
 	m_cellCountX = 0;
@@ -2794,7 +2832,7 @@ void PartitionManager::update()
 			Int cellCount = m_cellCountX * m_cellCountY;
 			for (int i = 0; i < cellCount; ++i)
 			{
-				UnsignedInt threat = m_cells[i].getThreatValue(rts::getObservedOrLocalPlayer()->getPlayerIndex());
+				UnsignedInt threat = getThreatValue(&m_cells[i], rts::getObservedOrLocalPlayer()->getPlayerIndex());
 				if (threat > 0)
 				{
 					Real threatMul = INT_TO_REAL(threat) / TheGlobalData->m_maxDebugThreat;
@@ -2824,7 +2862,7 @@ void PartitionManager::update()
 			Int cellCount = m_cellCountX * m_cellCountY;
 			for (int i = 0; i < cellCount; ++i)
 			{
-				UnsignedInt value = m_cells[i].getCashValue(rts::getObservedOrLocalPlayer()->getPlayerIndex());
+				UnsignedInt value = getCashValue(&m_cells[i], rts::getObservedOrLocalPlayer()->getPlayerIndex());
 				if (value > 0)
 				{
 					Real valueMul = INT_TO_REAL(value) / TheGlobalData->m_maxDebugValue;
@@ -3243,12 +3281,6 @@ Object *PartitionManager::getClosestObjects(
 	GetPrecisionTimer(&startTime64);
 #endif
 
-#ifdef RTS_DEBUG
-	static Int theEntrancyCount = 0;
-	DEBUG_ASSERTCRASH(theEntrancyCount == 0, ("sorry, this routine is not reentrant"));
-	++theEntrancyCount;
-#endif
-
 	DEBUG_ASSERTCRASH((obj==NULL) != (pos == NULL), ("either obj or pos must be null"));
 
 	DistCalcProc distProc = theDistCalcProcs[dc];
@@ -3298,8 +3330,8 @@ Object *PartitionManager::getClosestObjects(
 
 	Bool foundAny = false;
 
-	static Int theIterFlag = 1;	// nonzero, thanks
-	++theIterFlag;
+	// since an object can exist in multiple COIs, this tracks which ones this query has already processed.
+	PartitionQueryContext context;
 
 	/*
 		m_radiusVec[curRadius] contains a list of the cells (foo) that could
@@ -3325,11 +3357,8 @@ Object *PartitionManager::getClosestObjects(
 				if (thisObj == obj || thisObj == NULL)
 					continue;
 
-				// since an object can exist in multiple COIs, we use this to avoid processing
-				// the same one more than once.
-				if (thisMod->friend_getDoneFlag() == theIterFlag)
+				if (!context.markVisited(thisMod))
 					continue;
-				thisMod->friend_setDoneFlag(theIterFlag);
 
 				Real thisDistSqr;
 				Coord3D distVec;
@@ -3381,8 +3410,8 @@ Object *PartitionManager::getClosestObjects(
 
 	Bool foundAny = false;
 
-	static Int theIterFlag = 1;	// nonzero, thanks
-	++theIterFlag;
+	// since an object can exist in multiple COIs, this tracks which ones this query has already processed.
+	PartitionQueryContext context;
 
 	PartitionCell *thisCell;
 	while ((thisCell = iter.nextNonEmpty()) != NULL)
@@ -3400,11 +3429,9 @@ Object *PartitionManager::getClosestObjects(
 			if (thisObj == obj)
 				continue;
 
-			if (thisMod->friend_getDoneFlag() == theIterFlag)
+			if (!context.markVisited(thisMod))
 				continue;
 
-			thisMod->friend_setDoneFlag(theIterFlag);
-
 			// hmm, ok, calc the distance.
 			Real thisDistSqr;
 			Coord3D distVec;
@@ -3451,9 +3478,6 @@ Object *PartitionManager::getClosestObjects(
 		*closestDistArg = (Real)sqrtf(closestDistSqr);
 	}
 
-#ifdef RTS_DEBUG
-	--theEntrancyCount;
-#endif
 #ifdef DUMP_PERF_STATS
 	Int64 endTime64;
 	GetPrecisionTimer(&endTime64);
@@ -3988,25 +4012,9 @@ Bool PartitionManager::findPositionAround( const Coord3D *center,
 // allies.  They'll use the RevealWholeDamnMap series, which call addLooker directly.
 void PartitionManager::doShroudReveal(Real centerX, Real centerY, Real radius, PlayerMaskType playerMask)
 {
-	Int cellCenterX, cellCenterY;
-	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
-
-	Int cellRadius = ThePartitionManager->worldToCellDist(radius);
-	if (cellRadius < 1)
-		cellRadius = 1;
-
-	DiscreteCircle circle(cellCenterX, cellCenterY, cellRadius);
-
-	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
-	{
-		// Object's Look is the one who knows about allies.  Anyone can pask a player mask to me and all
-		// of those players will have an active looker applied to a bunch of cells
-		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
-		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
-		{
-			circle.drawCircle(hLineAddLooker, (void*)currentIndex);
-		}
-	}
+	// Object's Look is the one who knows about allies.  Anyone can pask a player mask to me and all
+	// of those players will have an active looker applied to a bunch of cells
+	applyShroudCircle(centerX, centerY, radius, playerMask, &PartitionCell::addLooker);
 }
 
 //-----------------------------------------------------------------------------
@@ -4055,23 +4063,7 @@ void PartitionManager::resetPendingUndoShroudRevealQueue()
 //-----------------------------------------------------------------------------
 void PartitionManager::undoShroudReveal(Real centerX, Real centerY, Real radius, PlayerMaskType playerMask)
 {
-	Int cellCenterX, cellCenterY;
-	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
-
-	Int cellRadius = ThePartitionManager->worldToCellDist(radius);
-	if (cellRadius < 1)
-		cellRadius = 1;
-
-	DiscreteCircle circle(cellCenterX, cellCenterY, cellRadius);
-
-	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
-	{
-		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
-		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
-		{
-			circle.drawCircle(hLineRemoveLooker, (void*)currentIndex);
-		}
-	}
+	applyShroudCircle(centerX, centerY, radius, playerMask, &PartitionCell::removeLooker);
 }
 
 //-----------------------------------------------------------------------------
@@ -4092,177 +4084,353 @@ void PartitionManager::queueUndoShroudReveal(Real centerX, Real centerY, Real ra
 //-----------------------------------------------------------------------------
 void PartitionManager::doShroudCover(Real centerX, Real centerY, Real radius, PlayerMaskType playerMask)
 {
-	Int cellCenterX, cellCenterY;
-	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
+	// Object's Shroud is the one who knows about allies.  Anyone can pask a player mask to me and all
+	// of those players will have an active shrouder applied to a bunch of cells
+	applyShroudCircle(centerX, centerY, radius, playerMask, &PartitionCell::addShrouder);
+}
 
-	Int cellRadius = ThePartitionManager->worldToCellDist(radius);
-	if (cellRadius < 1)
-		cellRadius = 1;
+//-----------------------------------------------------------------------------
+void PartitionManager::undoShroudCover(Real centerX, Real centerY, Real radius, PlayerMaskType playerMask)
+{
+	applyShroudCircle(centerX, centerY, radius, playerMask, &PartitionCell::removeShrouder);
+}
 
-	DiscreteCircle circle(cellCenterX, cellCenterY, cellRadius);
+//-----------------------------------------------------------------------------
+void PartitionManager::doThreatAffect( Real centerX, Real centerY, Real radius, UnsignedInt threatVal, PlayerMaskType playerMask)
+{
+	ThreatValueFootprint none;
+	none.clear();
 
-	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
-	{
-		// Object's Shroud is the one who knows about allies.  Anyone can pask a player mask to me and all
-		// of those players will have an active shrouder applied to a bunch of cells
-		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
-		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
-		{
-			circle.drawCircle(hLineAddShrouder, (void*)currentIndex);
-		}
-	}
+	ThreatValueFootprint footprint;
+	footprint.set(centerX, centerY, radius, threatVal, playerMask);
+
+	moveThreatValueFootprint(m_threatValues, none, footprint);
 }
 
 //-----------------------------------------------------------------------------
-void PartitionManager::undoShroudCover(Real centerX, Real centerY, Real radius, PlayerMaskType playerMask)
+void PartitionManager::undoThreatAffect( Real centerX, Real centerY, Real radius, UnsignedInt threatVal, PlayerMaskType playerMask)
 {
-	Int cellCenterX, cellCenterY;
-	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
+	ThreatValueFootprint none;
+	none.clear();
 
-	Int cellRadius = ThePartitionManager->worldToCellDist(radius);
-	if (cellRadius < 1)
-		cellRadius = 1;
+	ThreatValueFootprint footprint;
+	footprint.set(centerX, centerY, radius, threatVal, playerMask);
 
-	DiscreteCircle circle(cellCenterX, cellCenterY, cellRadius);
+	moveThreatValueFootprint(m_threatValues, footprint, none);
+}
 
-	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
-	{
-		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
-		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
-		{
-			circle.drawCircle(hLineRemoveShrouder, (void*)currentIndex);
-		}
-	}
+//-----------------------------------------------------------------------------
+void PartitionManager::doValueAffect( Real centerX, Real centerY, Real radius, UnsignedInt valueVal, PlayerMaskType playerMask)
+{
+	ThreatValueFootprint none;
+	none.clear();
+
+	ThreatValueFootprint footprint;
+	footprint.set(centerX, centerY, radius, valueVal, playerMask);
+
+	moveThreatValueFootprint(m_cashValues, none, footprint);
 }
 
 //-----------------------------------------------------------------------------
-void PartitionManager::doThreatAffect( Real centerX, Real centerY, Real radius, UnsignedInt threatVal, PlayerMaskType playerMask)
+void PartitionManager::undoValueAffect( Real centerX, Real centerY, Real radius, UnsignedInt valueVal, PlayerMaskType playerMask)
 {
-	Int cellCenterX, cellCenterY;
-	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
-	Real fCellCenterX = INT_TO_REAL(cellCenterX);
-	Real fCellCenterY = INT_TO_REAL(cellCenterY);
+	ThreatValueFootprint none;
+	none.clear();
 
-	Int cellRadius = ThePartitionManager->worldToCellDist(radius);
-	if (cellRadius < 1)
-		cellRadius = 1;
+	ThreatValueFootprint footprint;
+	footprint.set(centerX, centerY, radius, valueVal, playerMask);
 
-	Real fCellRadius = INT_TO_REAL(cellRadius + 1);
+	moveThreatValueFootprint(m_cashValues, footprint, none);
+}
 
-	DiscreteCircle circle(cellCenterX, cellCenterY, cellRadius);
+//-----------------------------------------------------------------------------
+void PartitionManager::moveThreatAffect( const SightingInfo *lastThreat, const SightingInfo *newThreat )
+{
+	// An invalid last sighting was never added, but a new one is added as long as it is for anyone.
+	ThreatValueFootprint lastFootprint;
+	if (lastThreat->isInvalid())
+		lastFootprint.clear();
+	else
+		lastFootprint.set(lastThreat);
 
-	ThreatValueParms parms;
-	parms.radius = fCellRadius;
-	parms.threatOrValue = threatVal;
-	parms.xCenter = fCellCenterX;
-	parms.yCenter = fCellCenterY;
+	ThreatValueFootprint newFootprint;
+	newFootprint.set(newThreat);
 
-	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
-	{
-		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
-		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
-		{
-			parms.playerIndex = currentIndex;
-			circle.drawCircle(hLineAddThreat, &parms);
-		}
-	}
+	moveThreatValueFootprint(m_threatValues, lastFootprint, newFootprint);
 }
 
 //-----------------------------------------------------------------------------
-void PartitionManager::undoThreatAffect( Real centerX, Real centerY, Real radius, UnsignedInt threatVal, PlayerMaskType playerMask)
+void PartitionManager::moveValueAffect( const SightingInfo *lastValue, const SightingInfo *newValue )
 {
-	Int cellCenterX, cellCenterY;
-	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
-	Real fCellCenterX = INT_TO_REAL(cellCenterX);
-	Real fCellCenterY = INT_TO_REAL(cellCenterY);
+	// An invalid last sighting was never added, but a new one is added as long as it is for anyone.
+	ThreatValueFootprint lastFootprint;
+	if (lastValue->isInvalid())
+		lastFootprint.clear();
+	else
+		lastFootprint.set(lastValue);
 
-	Int cellRadius = ThePartitionManager->worldToCellDist(radius);
-	if (cellRadius < 1)
-		cellRadius = 1;
+	ThreatValueFootprint newFootprint;
+	newFootprint.set(newValue);
 
-	Real fCellRadius = INT_TO_REAL(cellRadius + 1);
+	moveThreatValueFootprint(m_cashValues, lastFootprint, newFootprint);
+}
 
-	DiscreteCircle circle(cellCenterX, cellCenterY, cellRadius);
+//-----------------------------------------------------------------------------
+UnsignedInt PartitionManager::getThreatValue( const PartitionCell *cell, Int playerIndex ) const
+{
+	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
+		return m_threatValues[playerIndex * m_totalCellCount + (cell - m_cells)];
+	}
+	return 0;
+}
 
-	ThreatValueParms parms;
-	parms.radius = fCellRadius;
-	parms.threatOrValue = threatVal;
-	parms.xCenter = fCellCenterX;
-	parms.yCenter = fCellCenterY;
+//-----------------------------------------------------------------------------
+UnsignedInt PartitionManager::getCashValue( const PartitionCell *cell, Int playerIndex ) const
+{
+	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
+		return m_cashValues[playerIndex * m_totalCellCount + (cell - m_cells)];
+	}
+	return 0;
+}
 
-	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
+//-----------------------------------------------------------------------------
+const std::vector<Int>& PartitionManager::getCircleHalfWidths( Int cellRadius )
+{
+	if (cellRadius >= (Int)m_circleHalfWidths.size())
+		m_circleHalfWidths.resize(cellRadius + 1);
+
+	std::vector<Int> &halfWidths = m_circleHalfWidths[cellRadius];
+	if (halfWidths.empty())
 	{
-		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
-		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
+		// Rows that the circle does not cover keep a negative half width.
+		halfWidths.resize(cellRadius + 1, -1);
+
+		DiscreteCircle circle(0, 0, cellRadius);
+		const VecHorzLine &edges = circle.getEdges();
+		for (VecHorzLine::const_iterator it = edges.begin(); it != edges.end(); ++it)
 		{
-			parms.playerIndex = currentIndex;
-			circle.drawCircle(hLineRemoveThreat, &parms);
+			if (it->yPos >= 0 && it->yPos <= cellRadius)
+				halfWidths[it->yPos] = it->xEnd;
 		}
 	}
+
+	return halfWidths;
 }
 
 //-----------------------------------------------------------------------------
-void PartitionManager::doValueAffect( Real centerX, Real centerY, Real radius, UnsignedInt valueVal, PlayerMaskType playerMask)
+void PartitionManager::applyShroudCircle( Real centerX, Real centerY, Real radius, PlayerMaskType playerMask, ShroudCellFunc func )
 {
+	Int playerIndices[MAX_PLAYER_COUNT];
+	Int playerCount = 0;
+	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
+	{
+		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
+		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
+			playerIndices[playerCount++] = currentIndex;
+	}
+
+	if (playerCount == 0 || m_cells == NULL)
+		return;
+
 	Int cellCenterX, cellCenterY;
-	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
-	Real fCellCenterX = INT_TO_REAL(cellCenterX);
-	Real fCellCenterY = INT_TO_REAL(cellCenterY);
+	worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
 
-	Int cellRadius = ThePartitionManager->worldToCellDist(radius);
+	Int cellRadius = worldToCellDist(radius);
 	if (cellRadius < 1)
 		cellRadius = 1;
 
-	Real fCellRadius = INT_TO_REAL(cellRadius + 1);
+	const std::vector<Int> &halfWidths = getCircleHalfWidths(cellRadius);
+
+	const Int yStart = max(cellCenterY - cellRadius, 0);
+	const Int yEnd = min(cellCenterY + cellRadius, m_cellCountY - 1);
+	for (Int y = yStart; y <= yEnd; ++y)
+	{
+		const Int halfWidth = halfWidths[abs(y - cellCenterY)];
+		const Int xStart = max(cellCenterX - halfWidth, 0);
+		const Int xEnd = min(cellCenterX + halfWidth, m_cellCountX - 1);
+		if (xStart > xEnd)
+			continue;
+
+		// Players are independent of each other, so each one gets the whole span before the next one.
+		PartitionCell *rowCells = &m_cells[y * m_cellCountX];
+		for (Int i = 0; i < playerCount; ++i)
+		{
+			const Int playerIndex = playerIndices[i];
+			for (Int x = xStart; x <= xEnd; ++x)
+				(rowCells[x].*func)(playerIndex);
+		}
+	}
+}
 
-	DiscreteCircle circle(cellCenterX, cellCenterY, cellRadius);
+//-----------------------------------------------------------------------------
+// TheSuperHackers @performance Threat and cash values are sums with unsigned wrap around, so removing the
+// last footprint and adding the new one can be merged into one change per cell. That change is computed
+// once per row and then added to the plane of every player with a simple loop the compiler can vectorize.
+void PartitionManager::moveThreatValueFootprint( UnsignedInt *planes, const ThreatValueFootprint &oldFootprint, const ThreatValueFootprint &newFootprint )
+{
+	if (planes == NULL || oldFootprint.isSame(newFootprint))
+		return;
 
-	ThreatValueParms parms;
-	parms.radius = fCellRadius;
-	parms.threatOrValue = valueVal;
-	parms.xCenter = fCellCenterX;
-	parms.yCenter = fCellCenterY;
+	if (oldFootprint.playerMask != 0 && newFootprint.playerMask != 0 && oldFootprint.playerMask != newFootprint.playerMask)
+	{
+		// Different players are affected, so the footprints have nothing to share.
+		ThreatValueFootprint none;
+		none.clear();
+		moveThreatValueFootprint(planes, oldFootprint, none);
+		moveThreatValueFootprint(planes, none, newFootprint);
+		return;
+	}
 
+	const PlayerMaskType playerMask = oldFootprint.playerMask | newFootprint.playerMask;
+
+	Int playerIndices[MAX_PLAYER_COUNT];
+	Int playerCount = 0;
 	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
 	{
 		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
 		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
+			playerIndices[playerCount++] = currentIndex;
+	}
+
+	if (playerCount == 0)
+		return;
+
+	const std::vector<Int> *oldHalfWidths = oldFootprint.playerMask != 0 ? &getCircleHalfWidths(oldFootprint.cellRadius) : NULL;
+	const std::vector<Int> *newHalfWidths = newFootprint.playerMask != 0 ? &getCircleHalfWidths(newFootprint.cellRadius) : NULL;
+
+	Int yStart = INT_MAX;
+	Int yEnd = INT_MIN;
+	if (oldHalfWidths)
+	{
+		yStart = min(yStart, oldFootprint.cellCenterY - oldFootprint.cellRadius);
+		yEnd = max(yEnd, oldFootprint.cellCenterY + oldFootprint.cellRadius);
+	}
+	if (newHalfWidths)
+	{
+		yStart = min(yStart, newFootprint.cellCenterY - newFootprint.cellRadius);
+		yEnd = max(yEnd, newFootprint.cellCenterY + newFootprint.cellRadius);
+	}
+	yStart = max(yStart, 0);
+	yEnd = min(yEnd, m_cellCountY - 1);
+
+	UnsignedInt *rowChange = &m_threatValueRow[0];
+
+	for (Int y = yStart; y <= yEnd; ++y)
+	{
+		Int oldStart = 0, oldEnd = -1;
+		if (oldHalfWidths && abs(y - oldFootprint.cellCenterY) <= oldFootprint.cellRadius)
+		{
+			const Int halfWidth = (*oldHalfWidths)[abs(y - oldFootprint.cellCenterY)];
+			oldStart = max(oldFootprint.cellCenterX - halfWidth, 0);
+			oldEnd = min(oldFootprint.cellCenterX + halfWidth, m_cellCountX - 1);
+		}
+
+		Int newStart = 0, newEnd = -1;
+		if (newHalfWidths && abs(y - newFootprint.cellCenterY) <= newFootprint.cellRadius)
+		{
+			const Int halfWidth = (*newHalfWidths)[abs(y - newFootprint.cellCenterY)];
+			newStart = max(newFootprint.cellCenterX - halfWidth, 0);
+			newEnd = min(newFootprint.cellCenterX + halfWidth, m_cellCountX - 1);
+		}
+
+		Int xStart, xEnd;
+		if (oldStart > oldEnd)
+		{
+			xStart = newStart;
+			xEnd = newEnd;
+		}
+		else if (newStart > newEnd)
+		{
+			xStart = oldStart;
+			xEnd = oldEnd;
+		}
+		else
 		{
-			parms.playerIndex = currentIndex;
-			circle.drawCircle(hLineAddValue, &parms);
+			xStart = min(oldStart, newStart);
+			xEnd = max(oldEnd, newEnd);
+		}
+
+		if (xStart > xEnd)
+			continue;
+
+		for (Int x = xStart; x <= xEnd; ++x)
+		{
+			UnsignedInt change = 0;
+			if (x >= newStart && x <= newEnd)
+				change += newFootprint.getValueAt(x, y);
+			if (x >= oldStart && x <= oldEnd)
+				change -= oldFootprint.getValueAt(x, y);
+			rowChange[x] = change;
+		}
+
+		for (Int i = 0; i < playerCount; ++i)
+		{
+			UnsignedInt *row = planes + playerIndices[i] * m_totalCellCount + y * m_cellCountX;
+			for (Int x = xStart; x <= xEnd; ++x)
+				row[x] += rowChange[x];
 		}
 	}
+
+	if (m_threatValuesReference != NULL)
+		verifyThreatValueFootprint(planes, oldFootprint, newFootprint, yStart, yEnd);
 }
 
 //-----------------------------------------------------------------------------
-void PartitionManager::undoValueAffect( Real centerX, Real centerY, Real radius, UnsignedInt valueVal, PlayerMaskType playerMask)
+// TheSuperHackers @info With -verifyThreatValues, every footprint move is also applied to reference planes
+// the way it was done before the moves were merged into rows: the old footprint is removed and the new
+// one is added with one circle per player. The rows the move touched must then match.
+void PartitionManager::verifyThreatValueFootprint( const UnsignedInt *planes, const ThreatValueFootprint &oldFootprint, const ThreatValueFootprint &newFootprint, Int yStart, Int yEnd )
 {
-	Int cellCenterX, cellCenterY;
-	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
-	Real fCellCenterX = INT_TO_REAL(cellCenterX);
-	Real fCellCenterY = INT_TO_REAL(cellCenterY);
+	const Bool isThreat = (planes == m_threatValues);
+	UnsignedInt *referencePlanes = isThreat ? m_threatValuesReference : m_cashValuesReference;
 
-	Int cellRadius = ThePartitionManager->worldToCellDist(radius);
-	if (cellRadius < 1)
-		cellRadius = 1;
+	const ThreatValueFootprint *footprints[2] = { &oldFootprint, &newFootprint };
+	for (Int f = 0; f < 2; ++f)
+	{
+		const ThreatValueFootprint &footprint = *footprints[f];
+		if (footprint.playerMask == 0)
+			continue;
 
-	Real fCellRadius = INT_TO_REAL(cellRadius + 1);
+		DiscreteCircle circle(footprint.cellCenterX, footprint.cellCenterY, footprint.cellRadius);
 
-	DiscreteCircle circle(cellCenterX, cellCenterY, cellRadius);
+		ThreatValueParms parms;
+		parms.radius = INT_TO_REAL(footprint.cellRadius + 1);
+		parms.threatOrValue = footprint.threatOrValue;
+		parms.xCenter = INT_TO_REAL(footprint.cellCenterX);
+		parms.yCenter = INT_TO_REAL(footprint.cellCenterY);
 
-	ThreatValueParms parms;
-	parms.radius = fCellRadius;
-	parms.threatOrValue = valueVal;
-	parms.xCenter = fCellCenterX;
-	parms.yCenter = fCellCenterY;
+		for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
+		{
+			const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
+			if( BitIsSet( footprint.playerMask, currentPlayer->getPlayerMask() ) )
+			{
+				parms.plane = referencePlanes + currentIndex * m_totalCellCount;
+				circle.drawCircle(f == 0 ? hLineRemoveThreatValue : hLineAddThreatValue, &parms);
+			}
+		}
+	}
 
-	for( Int currentIndex = ThePlayerList->getPlayerCount() - 1; currentIndex >=0; currentIndex-- )
+	for (Int playerIndex = 0; playerIndex < ThePlayerList->getPlayerCount(); ++playerIndex)
 	{
-		const Player *currentPlayer = ThePlayerList->getNthPlayer( currentIndex );
-		if( BitIsSet( playerMask, currentPlayer->getPlayerMask() ) )
+		for (Int y = yStart; y <= yEnd; ++y)
 		{
-			parms.playerIndex = currentIndex;
-			circle.drawCircle(hLineRemoveValue, &parms);
+			const UnsignedInt *row = planes + playerIndex * m_totalCellCount + y * m_cellCountX;
+			UnsignedInt *referenceRow = referencePlanes + playerIndex * m_totalCellCount + y * m_cellCountX;
+			for (Int x = 0; x < m_cellCountX; ++x)
+			{
+				if (row[x] == referenceRow[x])
+					continue;
+
+				AsciiString failure;
+				failure.format("%s value of player %d in cell (%d, %d) is %u, but per player circles give %u.",
+					isThreat ? "Threat" : "Cash", playerIndex, x, y, row[x], referenceRow[x]);
+				DEBUG_CRASH(("%s", failure.str()));
+				TheRecorder->logVerificationFailure(failure.str());
+
+				// Report every difference once.
+				memcpy(referenceRow, row, sizeof(UnsignedInt) * m_cellCountX);
+				break;
+			}
 		}
 	}
 }
@@ -4786,9 +4954,9 @@ void PartitionManager::getMostValuableLocation( Int playerIndex, UnsignedInt whi
 		for (Int player = 0; player < MAX_PLAYER_COUNT; ++player) {
 			if (BitIsSet(allPlayerMasks[player], playerMask)) {
 				if (valType == VOT_CashValue) {
-					cellValue += m_cells[i].getCashValue(player);
+					cellValue += getCashValue(&m_cells[i], player);
 				} else {
-					cellValue += m_cells[i].getThreatValue(player);
+					cellValue += getThreatValue(&m_cells[i], player);
 				}
 			}
 		}
@@ -5600,9 +5768,9 @@ static int cellValueProc(PartitionCell* cell, void* userData)
 	for (Int i = 0; i < MAX_PLAYER_COUNT; ++i) {
 		if (BitIsSet(parms->allowedPlayersMasks, parms->allPlayersMask[i])) {
 			if (parms->valueType == VOT_CashValue) {
-				val += cell->getCashValue(i);
+				val += ThePartitionManager->getCashValue(cell, i);
 			} else {
-				val += cell->getThreatValue(i);
+				val += ThePartitionManager->getThreatValue(cell, i);
 			}
 		}
 	}
@@ -5616,133 +5784,69 @@ static int cellValueProc(PartitionCell* cell, void* userData)
 }
 
 // -----------------------------------------------------------------------------
-static void hLineAddLooker(Int x1, Int x2, Int y, void *playerIndexVoid)
+void ThreatValueFootprint::clear()
 {
-	if (y < 0 || y >= ThePartitionManager->m_cellCountY || x1 >= ThePartitionManager->m_cellCountX || x2 < 0)
-		return;
-
-	Int playerIndex = (Int)(playerIndexVoid);
-
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
-	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-		cell->addLooker(playerIndex);
-	}
+	cellCenterX = 0;
+	cellCenterY = 0;
+	cellRadius = 0;
+	threatOrValue = 0;
+	playerMask = 0;
 }
 
 // -----------------------------------------------------------------------------
-static void hLineRemoveLooker(Int x1, Int x2, Int y, void *playerIndexVoid)
+void ThreatValueFootprint::set( Real centerX, Real centerY, Real radius, UnsignedInt value, PlayerMaskType mask )
 {
-	if (y < 0 || y >= ThePartitionManager->m_cellCountY || x1 >= ThePartitionManager->m_cellCountX || x2 < 0)
-		return;
+	ThePartitionManager->worldToCell(centerX, centerY, &cellCenterX, &cellCenterY);
 
-	Int playerIndex = (Int)(playerIndexVoid);
+	cellRadius = ThePartitionManager->worldToCellDist(radius);
+	if (cellRadius < 1)
+		cellRadius = 1;
 
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
-	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-		cell->removeLooker(playerIndex);
-	}
+	threatOrValue = value;
+	playerMask = mask;
 }
 
 // -----------------------------------------------------------------------------
-static void hLineAddShrouder(Int x1, Int x2, Int y, void *playerIndexVoid)
+void ThreatValueFootprint::set( const SightingInfo *info )
 {
-	if (y < 0 || y >= ThePartitionManager->m_cellCountY || x1 >= ThePartitionManager->m_cellCountX || x2 < 0)
-		return;
-
-	Int playerIndex = (Int)(playerIndexVoid);
-
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
-	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-		cell->addShrouder( playerIndex );
-	}
+	set(info->m_where.x, info->m_where.y, info->m_howFar, info->m_data, info->m_forWhom);
 }
 
 // -----------------------------------------------------------------------------
-static void hLineRemoveShrouder(Int x1, Int x2, Int y, void *playerIndexVoid)
+Bool ThreatValueFootprint::isSame( const ThreatValueFootprint &other ) const
 {
-	if (y < 0 || y >= ThePartitionManager->m_cellCountY || x1 >= ThePartitionManager->m_cellCountX || x2 < 0)
-		return;
-
-	Int playerIndex = (Int)(playerIndexVoid);
-
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
-	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-		cell->removeShrouder( playerIndex );
-	}
-}
-
-// -----------------------------------------------------------------------------
-static void hLineAddThreat(Int x1, Int x2, Int y, void *threatValueParms)
-{
-	if (y < 0 || y >= ThePartitionManager->m_cellCountY || x1 >= ThePartitionManager->m_cellCountX || x2 < 0)
-		return;
-
-	ThreatValueParms *parms = (ThreatValueParms*)threatValueParms;
-
-	Real distance;
-	Real mulVal = 1.0f;
-
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
-	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-
-		distance = sqrt( pow(x - parms->xCenter, 2) + pow(y - parms->yCenter, 2) );
-		mulVal = 1 - distance / parms->radius;
-		if (mulVal < 0.0f)
-			mulVal = 0.0f;
-		else if (mulVal > 1.0f)
-			mulVal = 1.0f;
+	if (playerMask == 0 && other.playerMask == 0)
+		return TRUE;
 
-		cell->addThreatValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
-	}
+	return playerMask == other.playerMask
+		&& cellCenterX == other.cellCenterX
+		&& cellCenterY == other.cellCenterY
+		&& cellRadius == other.cellRadius
+		&& threatOrValue == other.threatOrValue;
 }
 
 // -----------------------------------------------------------------------------
-static void hLineRemoveThreat(Int x1, Int x2, Int y, void *threatValueParms)
+UnsignedInt ThreatValueFootprint::getValueAt( Int x, Int y ) const
 {
-	if (y < 0 || y >= ThePartitionManager->m_cellCountY || x1 >= ThePartitionManager->m_cellCountX || x2 < 0)
-		return;
-
-	ThreatValueParms *parms = (ThreatValueParms*)threatValueParms;
-
-	Real distance;
-	Real mulVal = 1.0f;
-
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
-	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
+	const Real xCenter = INT_TO_REAL(cellCenterX);
+	const Real yCenter = INT_TO_REAL(cellCenterY);
+	const Real radius = INT_TO_REAL(cellRadius + 1);
 
-		distance = sqrt( pow(x - parms->xCenter, 2) + pow(y - parms->yCenter, 2) );
-		mulVal = 1 - distance / parms->radius;
-		if (mulVal < 0.0f)
-			mulVal = 0.0f;
-		else if (mulVal > 1.0f)
-			mulVal = 1.0f;
+	Real distance = sqrt( pow(x - xCenter, 2) + pow(y - yCenter, 2) );
+	Real mulVal = 1 - distance / radius;
+	if (mulVal < 0.0f)
+		mulVal = 0.0f;
+	else if (mulVal > 1.0f)
+		mulVal = 1.0f;
 
-		cell->removeThreatValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
-	}
+	return REAL_TO_UNSIGNEDINT(threatOrValue * mulVal);
 }
 
 // -----------------------------------------------------------------------------
-static void hLineAddValue(Int x1, Int x2, Int y, void *threatValueParms)
+static void hLineAddThreatValue(Int x1, Int x2, Int y, void *threatValueParms)
 {
-	if (y < 0 || y >= ThePartitionManager->m_cellCountY || x1 >= ThePartitionManager->m_cellCountX || x2 < 0)
+	const Int cellCountX = ThePartitionManager->getCellCountX();
+	if (y < 0 || y >= ThePartitionManager->getCellCountY() || x1 >= cellCountX || x2 < 0)
 		return;
 
 	ThreatValueParms *parms = (ThreatValueParms*)threatValueParms;
@@ -5750,12 +5854,8 @@ static void hLineAddValue(Int x1, Int x2, Int y, void *threatValueParms)
 	Real distance;
 	Real mulVal = 1.0f;
 
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
+	for (Int x = max(x1, 0); x <= x2 && x < cellCountX; ++x)
 	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-
 		distance = sqrt( pow(x - parms->xCenter, 2) + pow(y - parms->yCenter, 2) );
 		mulVal = 1 - distance / parms->radius;
 		if (mulVal < 0.0f)
@@ -5763,14 +5863,15 @@ static void hLineAddValue(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 
-		cell->addCashValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		parms->plane[y * cellCountX + x] += REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal);
 	}
 }
 
 // -----------------------------------------------------------------------------
-static void hLineRemoveValue(Int x1, Int x2, Int y, void *threatValueParms)
+static void hLineRemoveThreatValue(Int x1, Int x2, Int y, void *threatValueParms)
 {
-	if (y < 0 || y >= ThePartitionManager->m_cellCountY || x1 >= ThePartitionManager->m_cellCountX || x2 < 0)
+	const Int cellCountX = ThePartitionManager->getCellCountX();
+	if (y < 0 || y >= ThePartitionManager->getCellCountY() || x1 >= cellCountX || x2 < 0)
 		return;
 
 	ThreatValueParms *parms = (ThreatValueParms*)threatValueParms;
@@ -5778,12 +5879,8 @@ static void hLineRemoveValue(Int x1, Int x2, Int y, void *threatValueParms)
 	Real distance;
 	Real mulVal = 1.0f;
 
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
+	for (Int x = max(x1, 0); x <= x2 && x < cellCountX; ++x)
 	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-
 		distance = sqrt( pow(x - parms->xCenter, 2) + pow(y - parms->yCenter, 2) );
 		mulVal = 1 - distance / parms->radius;
 		if (mulVal < 0.0f)
@@ -5791,7 +5888,7 @@ static void hLineRemoveValue(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 
-		cell->removeCashValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		parms->plane[y * cellCountX + x] -= REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal);
 	}
 }
 
@@ -38,6 +38,7 @@
 #include "Common/PerfTimer.h"
 #include "Common/Player.h"
 #include "Common/PlayerList.h"
+#include "Common/Recorder.h"
 #include "Common/Team.h"
 #include "Common/ThingFactory.h"
 #include "Common/ThingTemplate.h"
@@ -474,6 +475,8 @@ ScriptEngine::ScriptEngine() :
 	m_fade(FADE_NONE),
 	m_freezeByScript(FALSE),
 	m_frameObjectCountChanged(0),
+	m_scriptInputGeneration(0),
+	m_frameTriggerAreaChanged(0),
 	//Added By Sadullah Nader
 	//Initializations inserted
 	m_closeWindowTimer(0),
@@ -484,6 +487,8 @@ ScriptEngine::ScriptEngine() :
 	m_fadeFramesHold(0),
 	m_fadeFramesIncrease(0),
 	m_firstUpdate(TRUE),
+	m_namedObjectIndexValid(FALSE),
+	m_scriptIndexValid(FALSE),
 	m_maxFade(0.0f),
 	m_minFade(0.0f),
 	m_numAttackInfo(0),
@@ -497,6 +502,9 @@ ScriptEngine::ScriptEngine() :
 	// By default, difficulty should be normal.
 	setGlobalDifficulty(DIFFICULTY_NORMAL);
 
+	for (Int i = 0; i < SCRIPT_INPUT_COUNT; ++i) {
+		m_scriptInputChangedAt[i] = 0;
+	}
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -5331,6 +5339,9 @@ void ScriptEngine::reset(void)
 		m_flags[i].value = false;
 		m_flags[i].name.clear();
 	}
+	m_counterIndex.clear();
+	m_flagIndex.clear();
+	invalidateScriptConditionResults();
 
 	m_breezeInfo.m_direction = PI / 3;
 	m_breezeInfo.m_directionVec.x = Sin(m_breezeInfo.m_direction);
@@ -5428,6 +5439,8 @@ void ScriptEngine::reset(void)
 
 	// Clear the named objects list.
 	m_namedObjects.clear();
+	m_namedObjectIndex.clear();
+	m_namedObjectIndexValid = FALSE;
 
 	m_completedVideo.clear();
 	m_testingSpeech.clear();
@@ -5443,6 +5456,9 @@ void ScriptEngine::reset(void)
 	}
 
 	ScriptList::reset(); // Deletes scripts loaded when the map was loaded.
+	m_scriptIndex.clear();
+	m_scriptGroupIndex.clear();
+	m_scriptIndexValid = FALSE;
 
 	// reset the attack priority data
 	for (i = 0; i < MAX_ATTACK_PRIORITIES; ++i)
@@ -5474,6 +5490,13 @@ void ScriptEngine::newMap(void)
 		m_flags[i].value = false;
 		m_flags[i].name.clear();
 	}
+	m_counterIndex.clear();
+	m_flagIndex.clear();
+	invalidateScriptConditionResults();
+	// GameLogic still adds scripts after this, so the script index is built on the first update.
+	m_scriptIndex.clear();
+	m_scriptGroupIndex.clear();
+	m_scriptIndexValid = FALSE;
 	m_endGameTimer = -1;
 	m_closeWindowTimer = -1;
 #ifdef SPECIAL_SCRIPT_PROFILING
@@ -5553,6 +5576,7 @@ void ScriptEngine::update(void)
 #endif
 	if (m_firstUpdate) {
 		createNamedCache();
+		buildScriptIndex();
 		particleEditorUpdate();
 		m_firstUpdate = false;
 	}
@@ -5595,15 +5619,28 @@ void ScriptEngine::update(void)
 	}
 	// Update any countdown timers.
 	Int i;
+	Bool timerTicked = false;
+	Bool timerExpired = false;
 	// Note - counters start at 1.  0 means not assigned.
 	for (i = 1; i < m_numCounters; i++) {
 		if (m_counters[i].isCountdownTimer) {
 			// If counter has any time left, decrement.  Counters go to -1 and stop.
 			if (m_counters[i].value >= 0) {
 				m_counters[i].value--;
+				timerTicked = true;
+				// Going from 1 to 0 is the only step that changes the result of a TIMER_EXPIRED condition.
+				if (m_counters[i].value == 0) {
+					timerExpired = true;
+				}
 			}
 		}
 	}
+	if (timerTicked) {
+		noteScriptInputChanged(SCRIPT_INPUT_COUNTERS);
+	}
+	if (timerExpired) {
+		noteScriptInputChanged(SCRIPT_INPUT_TIMERS);
+	}
 
 	// Evaluate the scripts.
 	for (i = 0; i < TheSidesList->getNumSides(); i++) {
@@ -5629,7 +5666,11 @@ void ScriptEngine::update(void)
 	ThePlayerList->updateTeamStates();
 
 	// Clear the UI Interaction flags.
-	m_uiInteractions.clear();
+	// Flag conditions also test the ui interactions, so clearing them is a flag change.
+	if (!m_uiInteractions.empty()) {
+		m_uiInteractions.clear();
+		noteScriptInputChanged(SCRIPT_INPUT_FLAGS);
+	}
 
 	// update all sequential stuff.
 	evaluateAndProgressAllSequentialScripts();
@@ -5817,12 +5858,13 @@ void ScriptEngine::clearFlag(const AsciiString& name)
 	for (j = 0; j < MAX_PLAYER_COUNT; j++) {
 		AsciiString modName;
 		modName.format("%s%d", name.str(), j);
-		// Note - flags start at 1.  0 means not assigned.
-		Int i;
-		for (i = 1; i < m_numFlags; i++) {
-			if ((modName == m_flags[i].name)) {
-				m_flags[i].value = FALSE;
-			}
+		NameToIndexMap::const_iterator it = m_flagIndex.find(modName);
+		if (TheGlobalData->m_verifyScriptLookups) {
+			verifyLookup("flag", modName, (it != m_flagIndex.end() ? it->second : -1) == searchFlag(modName));
+		}
+		if (it != m_flagIndex.end() && m_flags[it->second].value) {
+			m_flags[it->second].value = FALSE;
+			noteScriptInputChanged(SCRIPT_INPUT_FLAGS);
 		}
 	}
 }
@@ -6056,10 +6098,9 @@ Object* ScriptEngine::getUnitNamed(const AsciiString& unitName)
 		return m_conditionObject;
 	}
 
-	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
-		if (unitName == (it->first)) {
-			return it->second;
-		}
+	Int index = findNamedObject(unitName);
+	if (index >= 0) {
+		return m_namedObjects[index].second;
 	}
 	return NULL;
 }
@@ -6069,14 +6110,62 @@ Object* ScriptEngine::getUnitNamed(const AsciiString& unitName)
 //-------------------------------------------------------------------------------------------------
 Bool ScriptEngine::didUnitExist(const AsciiString& unitName)
 {
-	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
-		if (unitName == (it->first)) {
-			return (it->second == NULL);
-		}
+	Int index = findNamedObject(unitName);
+	if (index >= 0) {
+		return (m_namedObjects[index].second == NULL);
 	}
 	return false;
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Returns the index of the first entry in m_namedObjects with this name, or -1. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::findNamedObject(const AsciiString& name)
+{
+	if (!m_namedObjectIndexValid) {
+		m_namedObjectIndex.clear();
+		for (Int i = 0; i < (Int)m_namedObjects.size(); ++i) {
+			// insert does not overwrite, so each name keeps its first entry.
+			m_namedObjectIndex.insert(std::make_pair(m_namedObjects[i].first, i));
+		}
+		m_namedObjectIndexValid = TRUE;
+	}
+
+	NameToIndexMap::const_iterator it = m_namedObjectIndex.find(name);
+	Int index = it != m_namedObjectIndex.end() ? it->second : -1;
+	if (TheGlobalData->m_verifyScriptLookups) {
+		verifyLookup("named object", name, index == searchNamedObject(name));
+	}
+	DEBUG_ASSERTCRASH(index < 0 || m_namedObjects[index].first == name, ("ScriptEngine::findNamedObject - stale index for '%s'", name.str()));
+	return index;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Returns the index of the first entry in m_namedObjects with this name, or -1, by searching the list. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::searchNamedObject(const AsciiString& name) const
+{
+	for (Int i = 0; i < (Int)m_namedObjects.size(); ++i) {
+		if (name == m_namedObjects[i].first) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** With -verifyScriptLookups, reports an indexed lookup that differs from the search it replaced. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::verifyLookup(const char* kind, const AsciiString& name, Bool matches)
+{
+	if (!matches) {
+		AsciiString failure;
+		failure.format("Indexed lookup of %s '%s' differs from the linear search.", kind, name.str());
+		DEBUG_CRASH(("%s", failure.str()));
+		TheRecorder->logVerificationFailure(failure.str());
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 /** runScript - Executes a subroutine script, or script group - tests conditions, and executes actions or false actions.  */
 //-------------------------------------------------------------------------------------------------
@@ -6193,16 +6282,19 @@ Int ScriptEngine::allocateCounter(const AsciiString& name)
 {
 	Int i;
 	// Note - counters start at 1.  0 means not assigned.
-	for (i = 1; i < m_numCounters; i++) {
-		if (name == m_counters[i].name) {
-			return i;
-		}
+	NameToIndexMap::const_iterator it = m_counterIndex.find(name);
+	if (TheGlobalData->m_verifyScriptLookups) {
+		verifyLookup("counter", name, (it != m_counterIndex.end() ? it->second : -1) == searchCounter(name));
+	}
+	if (it != m_counterIndex.end()) {
+		return it->second;
 	}
 	DEBUG_ASSERTCRASH(m_numCounters < MAX_COUNTERS, ("Too many counters, failed to make '%s'.", name.str()));
 	if (m_numCounters < MAX_COUNTERS) {
 		m_counters[m_numCounters].name = name;
 		i = m_numCounters;
 		m_numCounters++;
+		m_counterIndex[name] = i;
 		return(i);
 	}
 	return 0; // Shouldn't ever happen.
@@ -6213,17 +6305,32 @@ Int ScriptEngine::allocateCounter(const AsciiString& name)
 //-------------------------------------------------------------------------------------------------
 const TCounter* ScriptEngine::getCounter(const AsciiString& counterName)
 {
-	Int i;
-	for (i = 1; i < m_numCounters; i++)
+	NameToIndexMap::const_iterator it = m_counterIndex.find(counterName);
+	if (TheGlobalData->m_verifyScriptLookups)
 	{
-		if (counterName == m_counters[i].name)
-		{
-			return &(m_counters[i]);
-		}
+		verifyLookup("counter", counterName, (it != m_counterIndex.end() ? it->second : -1) == searchCounter(counterName));
+	}
+	if (it != m_counterIndex.end())
+	{
+		return &(m_counters[it->second]);
 	}
 	return NULL;
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Returns the slot of the counter with this name, or -1, by searching the counters. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::searchCounter(const AsciiString& name) const
+{
+	// Note - counters start at 1.  0 means not assigned.
+	for (Int i = 1; i < m_numCounters; i++) {
+		if (name == m_counters[i].name) {
+			return i;
+		}
+	}
+	return -1;
+}
+
 //-------------------------------------------------------------------------------------------------
 void ScriptEngine::createNamedMapReveal(const AsciiString& revealName, const AsciiString& waypointName, Real radiusToReveal, const AsciiString& playerName)
 {
@@ -6331,25 +6438,103 @@ Int ScriptEngine::allocateFlag(const AsciiString& name)
 {
 	Int i;
 	// Note - flags start at 1.  0 means not assigned.
-	for (i = 1; i < m_numFlags; i++) {
-		if ((name == m_flags[i].name)) {
-			return i;
-		}
+	NameToIndexMap::const_iterator it = m_flagIndex.find(name);
+	if (TheGlobalData->m_verifyScriptLookups) {
+		verifyLookup("flag", name, (it != m_flagIndex.end() ? it->second : -1) == searchFlag(name));
+	}
+	if (it != m_flagIndex.end()) {
+		return it->second;
 	}
 	DEBUG_ASSERTCRASH(m_numFlags < MAX_FLAGS, ("Too many flags, failed to make '%s'..", name.str()));
 	if (m_numFlags < MAX_FLAGS) {
 		m_flags[m_numFlags].name = name;
 		i = m_numFlags;
 		m_numFlags++;
+		m_flagIndex[name] = i;
 		return(i);
 	}
 	return 0; // Shouldn't ever happen.
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Returns the slot of the flag with this name, or -1, by searching the flags. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::searchFlag(const AsciiString& name) const
+{
+	// Note - flags start at 1.  0 means not assigned.
+	for (Int i = 1; i < m_numFlags; i++) {
+		if (name == m_flags[i].name) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Rebuilds the counter and flag name lookups, after the arrays were loaded. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::rebuildCounterAndFlagIndex(void)
+{
+	Int i;
+	m_counterIndex.clear();
+	for (i = 1; i < m_numCounters; i++) {
+		m_counterIndex.insert(std::make_pair(m_counters[i].name, i));
+	}
+	m_flagIndex.clear();
+	for (i = 1; i < m_numFlags; i++) {
+		m_flagIndex.insert(std::make_pair(m_flags[i].name, i));
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Builds the script and group name lookups, once all scripts for the map have been added. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::buildScriptIndex(void)
+{
+	m_scriptIndex.clear();
+	m_scriptGroupIndex.clear();
+
+	// visit in the same order as findScript and findGroup, and keep the first of each name.
+	Int i;
+	for (i = 0; i < TheSidesList->getNumSides(); i++) {
+		ScriptList* pSL = TheSidesList->getSideInfo(i)->getScriptList();
+		if (pSL == NULL) continue;
+		Script* pScr;
+		for (pScr = pSL->getScript(); pScr; pScr = pScr->getNext()) {
+			m_scriptIndex.insert(std::make_pair(pScr->getName(), pScr));
+		}
+		ScriptGroup* pGroup;
+		for (pGroup = pSL->getScriptGroup(); pGroup; pGroup = pGroup->getNext()) {
+			m_scriptGroupIndex.insert(std::make_pair(pGroup->getName(), pGroup));
+			for (pScr = pGroup->getScript(); pScr; pScr = pScr->getNext()) {
+				m_scriptIndex.insert(std::make_pair(pScr->getName(), pScr));
+			}
+		}
+	}
+	m_scriptIndexValid = TRUE;
+}
+
 //-------------------------------------------------------------------------------------------------
 /** Locates a group by name. */
 //-------------------------------------------------------------------------------------------------
 ScriptGroup* ScriptEngine::findGroup(const AsciiString& name)
+{
+	if (!m_scriptIndexValid) {
+		return searchGroup(name);
+	}
+
+	NameToScriptGroupMap::const_iterator it = m_scriptGroupIndex.find(name);
+	ScriptGroup* pGroup = it != m_scriptGroupIndex.end() ? it->second : NULL;
+	if (TheGlobalData->m_verifyScriptLookups) {
+		verifyLookup("script group", name, pGroup == searchGroup(name));
+	}
+	return pGroup;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Locates a group by name, by searching the sides. */
+//-------------------------------------------------------------------------------------------------
+ScriptGroup* ScriptEngine::searchGroup(const AsciiString& name) const
 {
 	Int i;
 	for (i = 0; i < TheSidesList->getNumSides(); i++) {
@@ -6369,6 +6554,23 @@ ScriptGroup* ScriptEngine::findGroup(const AsciiString& name)
 /** Locates a script by name. */
 //-------------------------------------------------------------------------------------------------
 Script* ScriptEngine::findScript(const AsciiString& name)
+{
+	if (!m_scriptIndexValid) {
+		return searchScript(name);
+	}
+
+	NameToScriptMap::const_iterator it = m_scriptIndex.find(name);
+	Script* pScr = it != m_scriptIndex.end() ? it->second : NULL;
+	if (TheGlobalData->m_verifyScriptLookups) {
+		verifyLookup("script", name, pScr == searchScript(name));
+	}
+	return pScr;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Locates a script by name, by searching the sides. */
+//-------------------------------------------------------------------------------------------------
+Script* ScriptEngine::searchScript(const AsciiString& name) const
 {
 	Int i;
 	for (i = 0; i < TheSidesList->getNumSides(); i++) {
@@ -6429,6 +6631,8 @@ void ScriptEngine::setCounter(ScriptAction* pAction)
 	}
 	Int value = pAction->getParameter(1)->getInt();
 	m_counters[counterNdx].value = value;
+	noteScriptInputChanged(SCRIPT_INPUT_COUNTERS);
+	noteScriptInputChanged(SCRIPT_INPUT_TIMERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6497,6 +6701,8 @@ void ScriptEngine::addCounter(ScriptAction* pAction)
 		pAction->getParameter(1)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].value += value;
+	noteScriptInputChanged(SCRIPT_INPUT_COUNTERS);
+	noteScriptInputChanged(SCRIPT_INPUT_TIMERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6512,6 +6718,8 @@ void ScriptEngine::subCounter(ScriptAction* pAction)
 		pAction->getParameter(1)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].value -= value;
+	noteScriptInputChanged(SCRIPT_INPUT_COUNTERS);
+	noteScriptInputChanged(SCRIPT_INPUT_TIMERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6555,7 +6763,10 @@ void ScriptEngine::setFlag(ScriptAction* pAction)
 		pAction->getParameter(0)->friend_setInt(flagNdx);
 	}
 	Bool value = pAction->getParameter(1)->getInt();
-	m_flags[flagNdx].value = value;
+	if (m_flags[flagNdx].value != value) {
+		m_flags[flagNdx].value = value;
+		noteScriptInputChanged(SCRIPT_INPUT_FLAGS);
+	}
 }
 
 
@@ -6819,6 +7030,8 @@ void ScriptEngine::setTimer(ScriptAction* pAction, Bool millisecondTimer, Bool r
 		m_counters[counterNdx].value = value;
 	}
 	m_counters[counterNdx].isCountdownTimer = true;
+	noteScriptInputChanged(SCRIPT_INPUT_COUNTERS);
+	noteScriptInputChanged(SCRIPT_INPUT_TIMERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6833,6 +7046,7 @@ void ScriptEngine::pauseTimer(ScriptAction* pAction)
 		pAction->getParameter(0)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].isCountdownTimer = false;
+	noteScriptInputChanged(SCRIPT_INPUT_TIMERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6848,6 +7062,7 @@ void ScriptEngine::restartTimer(ScriptAction* pAction)
 	}
 	if (m_counters[counterNdx].value > 0) {
 		m_counters[counterNdx].isCountdownTimer = true;
+		noteScriptInputChanged(SCRIPT_INPUT_TIMERS);
 	}
 }
 
@@ -6874,6 +7089,8 @@ void ScriptEngine::adjustTimer(ScriptAction* pAction, Bool millisecondTimer, Boo
 			value = -value;
 		m_counters[counterNdx].value += value;
 	}
+	noteScriptInputChanged(SCRIPT_INPUT_COUNTERS);
+	noteScriptInputChanged(SCRIPT_INPUT_TIMERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7091,7 +7308,7 @@ void ScriptEngine::executeScript(Script* pScript)
 	else {
 		m_conditionTeam = NULL;
 		// If conditions evaluate to true, execute actions.
-		if (evaluateConditions(pScript)) {
+		if (evaluateScriptConditions(pScript)) {
 			if (pScript->getAction()) {
 				// Script Debug window
 				_appendMessage(pScript->getName());
@@ -7181,6 +7398,7 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 				TheScriptEngine->AppendDebugMessage(newNameForDead, FALSE);
 				DEBUG_LOG((newNameForDead.str()));
 				it->second = pNewObject;
+				noteScriptInputChanged(SCRIPT_INPUT_NAMED_OBJECTS);
 				return;
 			}
 			else {
@@ -7194,6 +7412,8 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 
 		if (pNewObject == (it->second)) {
 			it->first = objName;
+			m_namedObjectIndexValid = FALSE;
+			noteScriptInputChanged(SCRIPT_INPUT_NAMED_OBJECTS);
 			return;
 		}
 	}
@@ -7203,6 +7423,10 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 	req.second = pNewObject;
 
 	m_namedObjects.push_back(req);
+	if (m_namedObjectIndexValid) {
+		m_namedObjectIndex.insert(std::make_pair(objName, (Int)m_namedObjects.size() - 1));
+	}
+	noteScriptInputChanged(SCRIPT_INPUT_NAMED_OBJECTS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7213,6 +7437,7 @@ void ScriptEngine::removeObjectFromCache(Object* pDeadObject)
 	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
 		if (pDeadObject == (it->second)) {
 			it->second = NULL;	// Don't remove it, cause we want to check whether we ever knew a name later
+			noteScriptInputChanged(SCRIPT_INPUT_NAMED_OBJECTS);
 			break;
 		}
 	}
@@ -7260,6 +7485,7 @@ void ScriptEngine::transferObjectName(const AsciiString& unitName, Object* pNewO
 			}
 
 			it->second = pNewObject;
+			noteScriptInputChanged(SCRIPT_INPUT_NAMED_OBJECTS);
 
 			return;
 		}
@@ -7339,6 +7565,7 @@ void ScriptEngine::notifyOfAcquiredScience(Int playerIndex, ScienceType science)
 void ScriptEngine::signalUIInteract(const AsciiString& hookName)
 {
 	m_uiInteractions.push_front(hookName);
+	noteScriptInputChanged(SCRIPT_INPUT_FLAGS);
 #ifdef DEBUG_LOGGING
 	AppendDebugMessage(hookName, false); // don't bother in Release
 #endif
@@ -7699,6 +7926,126 @@ Bool ScriptEngine::evaluateConditions(Script* pScript, Team* thisTeam, Player* p
 	return testValue; // If none of the or's fired, then it is false.
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Returns the inputs a condition reads, or SCRIPT_INPUTS_UNTRACKED if it reads any state
+	that does not notify the script engine when it changes. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::getConditionInputs(Condition* pCondition)
+{
+	switch (pCondition->getConditionType()) {
+	default: return SCRIPT_INPUTS_UNTRACKED;
+	case Condition::CONDITION_FALSE: return 0;
+	case Condition::CONDITION_TRUE: return 0;
+	case Condition::COUNTER: return 1 << SCRIPT_INPUT_COUNTERS;
+	case Condition::FLAG: return 1 << SCRIPT_INPUT_FLAGS;
+	case Condition::TIMER_EXPIRED: return 1 << SCRIPT_INPUT_TIMERS;
+	case Condition::NAMED_CREATED: return 1 << SCRIPT_INPUT_NAMED_OBJECTS;
+
+	// These keep their own result until the object count changes, so they cannot see anything else change
+	// in between either. The enemy player is picked without notification, so it stays untracked.
+	case Condition::BUILT_BY_PLAYER:
+		if (pCondition->getParameter(1)->getString() == THIS_PLAYER_ENEMY) return SCRIPT_INPUTS_UNTRACKED;
+		return 1 << SCRIPT_INPUT_OBJECT_COUNTS;
+	case Condition::PLAYER_HAS_OBJECT_COMPARISON:
+		if (pCondition->getParameter(0)->getString() == THIS_PLAYER_ENEMY) return SCRIPT_INPUTS_UNTRACKED;
+		return 1 << SCRIPT_INPUT_OBJECT_COUNTS;
+	// This one also recounts when a member of one of the player's teams enters or exits a trigger area.
+	// The kind variant never reuses its own result and counts dying objects at once, so it stays untracked.
+	case Condition::PLAYER_HAS_COMPARISON_UNIT_TYPE_IN_TRIGGER_AREA:
+		if (pCondition->getNumParameters() < 5) return SCRIPT_INPUTS_UNTRACKED;
+		if (pCondition->getParameter(0)->getString() == THIS_PLAYER_ENEMY) return SCRIPT_INPUTS_UNTRACKED;
+		return (1 << SCRIPT_INPUT_OBJECT_COUNTS) | (1 << SCRIPT_INPUT_TRIGGER_AREAS);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Returns the union of the inputs of all conditions of a script. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::classifyConditionInputs(Script* pScript)
+{
+	Int inputs = 0;
+	for (OrCondition* pOr = pScript->getOrCondition(); pOr; pOr = pOr->getNextOrCondition()) {
+		for (Condition* pCondition = pOr->getFirstAndCondition(); pCondition; pCondition = pCondition->getNext()) {
+			inputs |= getConditionInputs(pCondition);
+		}
+	}
+	return inputs;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Evaluates the conditions of a script for the current player. If all of its conditions declare
+	their inputs and none of those changed since the last evaluation, the last result is reused. */
+//-------------------------------------------------------------------------------------------------
+Bool ScriptEngine::evaluateScriptConditions(Script* pScript)
+{
+	// TheSuperHackers @performance Skip condition trees whose inputs are unchanged.
+	Int inputs = pScript->getConditionInputs();
+	if (inputs == Script::CONDITION_INPUTS_UNKNOWN) {
+		inputs = classifyConditionInputs(pScript);
+		pScript->setConditionInputs(inputs);
+	}
+
+	// THIS_OBJECT resolves through the calling and condition objects, which are not part of the cache key.
+	if ((inputs & SCRIPT_INPUTS_UNTRACKED) || m_callingObject || m_conditionObject) {
+		return evaluateConditions(pScript);
+	}
+
+	// A team keeps reporting an enter or exit until its next update, and area conditions recount on every
+	// evaluation while it does.
+	if ((inputs & (1 << SCRIPT_INPUT_TRIGGER_AREAS)) && TheGameLogic->getFrame() <= m_frameTriggerAreaChanged + 1) {
+		return evaluateConditions(pScript);
+	}
+
+	Int playerIndex = m_currentPlayer ? m_currentPlayer->getPlayerIndex() : -1;
+	UnsignedInt generation = pScript->getConditionResultGeneration();
+	Bool current = (generation != 0 && pScript->getConditionResultPlayer() == playerIndex);
+	for (Int i = 0; current && i < SCRIPT_INPUT_COUNT; ++i) {
+		if ((inputs & (1 << i)) && m_scriptInputChangedAt[i] > generation) {
+			current = false;
+		}
+	}
+
+	if (current) {
+		if (TheGlobalData->m_verifyScriptConditions) {
+			Bool evaluated = evaluateConditions(pScript);
+			if (evaluated != pScript->getConditionResult()) {
+				AsciiString failure;
+				failure.format("Script '%s' reused condition result %d, but full evaluation gives %d.",
+					pScript->getName().str(), pScript->getConditionResult(), evaluated);
+				DEBUG_CRASH(("%s", failure.str()));
+				TheRecorder->logVerificationFailure(failure.str());
+			}
+		}
+		return pScript->getConditionResult();
+	}
+
+	Bool result = evaluateConditions(pScript);
+	pScript->setConditionResult(result, m_scriptInputGeneration, playerIndex);
+	return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Marks every script input as changed, so no script reuses a result from before this call. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::invalidateScriptConditionResults(void)
+{
+	++m_scriptInputGeneration;
+	for (Int i = 0; i < SCRIPT_INPUT_COUNT; ++i) {
+		m_scriptInputChangedAt[i] = m_scriptInputGeneration;
+	}
+	// Loaded teams may still report an enter or exit.
+	m_frameTriggerAreaChanged = TheGameLogic ? TheGameLogic->getFrame() : 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** A team member entered or exited a trigger area. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::notifyOfTriggerAreaEnteredOrExited(void)
+{
+	m_frameTriggerAreaChanged = TheGameLogic->getFrame();
+	noteScriptInputChanged(SCRIPT_INPUT_TRIGGER_AREAS);
+}
+
 
 
 //-------------------------------------------------------------------------------------------------
@@ -7791,6 +8138,8 @@ const ConditionTemplate* ScriptEngine::getConditionTemplate(Int ndx)
 void ScriptEngine::createNamedCache(void)
 {
 	m_namedObjects.clear();
+	m_namedObjectIndexValid = FALSE;
+	noteScriptInputChanged(SCRIPT_INPUT_NAMED_OBJECTS);
 
 	if (!TheGameLogic)
 	{
@@ -7883,6 +8232,7 @@ void ScriptEngine::removeAllSequentialScripts(Team* team)
 void ScriptEngine::notifyOfObjectCreationOrDestruction(void)
 {
 	m_frameObjectCountChanged = TheGameLogic->getFrame();
+	noteScriptInputChanged(SCRIPT_INPUT_OBJECT_COUNTS);
 }
 
 void ScriptEngine::notifyOfTeamDestruction(Team* teamDestroyed)
@@ -9042,6 +9392,12 @@ void ScriptEngine::xfer(Xfer* xfer)
 	// num flags
 	xfer->xferInt(&m_numFlags);
 
+	if (xfer->getXferMode() == XFER_LOAD)
+	{
+		rebuildCounterAndFlagIndex();
+		invalidateScriptConditionResults();
+	}
+
 	// attack priority info
 	UnsignedShort attackPriorityInfoSize = m_numAttackInfo;
 	xfer->xferUnsignedShort(&attackPriorityInfoSize);
@@ -9102,6 +9458,8 @@ void ScriptEngine::xfer(Xfer* xfer)
 		// according to John M., so we're clearing it now
 		//
 		m_namedObjects.clear();
+		m_namedObjectIndexValid = FALSE;
+		noteScriptInputChanged(SCRIPT_INPUT_NAMED_OBJECTS);
 
 		// read each element
 		for (UnsignedShort i = 0; i < namedObjectsCount; ++i)
@@ -9417,6 +9775,8 @@ void ScriptEngine::xfer(Xfer* xfer)
 // ------------------------------------------------------------------------------------------------
 void ScriptEngine::loadPostProcess(void)
 {
+	// all scripts for the map have been added by now.
+	buildScriptIndex();
 
 	// Now that we've loaded everything, go through and set them all back in sync with what we
 	// currently think they should be.
@@ -908,6 +908,10 @@ m_hard(true),
 m_delayEvaluationSeconds(0),
 m_conditionTime(0),
 m_conditionExecutedCount(0),
+m_conditionInputs(CONDITION_INPUTS_UNKNOWN),
+m_conditionResultGeneration(0),
+m_conditionResultPlayer(-1),
+m_conditionResult(false),
 m_frameToEvaluateAt(0),
 m_isSubroutine(false),
 m_hasWarnings(false),
@@ -1072,6 +1076,7 @@ void Script::updateFrom(Script *pSrc)
 	deleteInstance(this->m_condition);
 	this->m_condition = pSrc->m_condition;
 	pSrc->m_condition = NULL;
+	invalidateConditionCache();
 
 	deleteInstance(this->m_action);
 	this->m_action = pSrc->m_action;
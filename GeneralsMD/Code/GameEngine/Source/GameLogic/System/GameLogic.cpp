@@ -41,6 +41,7 @@
 #include "Common/GameUtility.h"
 #include "Common/INI.h"
 #include "Common/LatchRestore.h"
+#include "Common/LogicFrameProfiler.h"
 #include "Common/MapObject.h"
 #include "Common/MultiplayerSettings.h"
 #include "Common/OSDisplay.h"
@@ -297,9 +298,9 @@ void GameLogic::setDefaults(Bool loadingSaveGame)
 #ifdef ALLOW_NONSLEEPY_UPDATES
 	m_normalUpdates.clear();
 #endif
-	for (std::vector<UpdateModulePtr>::iterator it = m_sleepyUpdates.begin(); it != m_sleepyUpdates.end(); ++it)
+	for (std::vector<SleepyUpdateEntry>::iterator it = m_sleepyUpdates.begin(); it != m_sleepyUpdates.end(); ++it)
 	{
-		(*it)->friend_setIndexInLogic(-1);
+		it->module->friend_setIndexInLogic(-1);
 	}
 	m_sleepyUpdates.clear();
 	m_curUpdateModule = NULL;
@@ -2617,20 +2618,35 @@ void GameLogic::processDestroyList(void)
 		UpdateModulePtr sleepyUpdatesForThisObject[MAX_SUO];
 		Int numSUO = 0;
 
-		for (std::vector<UpdateModulePtr>::iterator it2 = m_sleepyUpdates.begin(); it2 != m_sleepyUpdates.end(); ++it2)
+		// TheSuperHackers @performance Find this object's updates through its own modules instead of
+		// scanning the whole heap. They are sorted by heap index so that they are erased in the same
+		// order as the original heap scan found them, which keeps the resulting heap layout identical.
+		for (BehaviorModule** b = currentObject->getBehaviorModules(); *b && numSUO < MAX_SUO; ++b)
 		{
-			UpdateModulePtr u = *it2;
-			if (u->friend_getObject() == currentObject && numSUO < MAX_SUO)
+#ifdef DIRECT_UPDATEMODULE_ACCESS
+			UpdateModulePtr u = (UpdateModulePtr)((*b)->getUpdate());
+#else
+			UpdateModulePtr u = (*b)->getUpdate();
+#endif
+			if (!u || u->friend_getIndexInLogic() < 0)
+				continue;
+
+			Int idx = u->friend_getIndexInLogic();
+			Int insertAt = numSUO;
+			while (insertAt > 0 && sleepyUpdatesForThisObject[insertAt - 1]->friend_getIndexInLogic() > idx)
 			{
-				sleepyUpdatesForThisObject[numSUO++] = u;
+				sleepyUpdatesForThisObject[insertAt] = sleepyUpdatesForThisObject[insertAt - 1];
+				--insertAt;
 			}
+			sleepyUpdatesForThisObject[insertAt] = u;
+			++numSUO;
 		}
 
 		for (--numSUO; numSUO >= 0; --numSUO)
 		{
 			// have to re-get idx each time since each call to erase might change others.
 			Int idx = sleepyUpdatesForThisObject[numSUO]->friend_getIndexInLogic();
-			DEBUG_ASSERTCRASH(m_sleepyUpdates[idx] == sleepyUpdatesForThisObject[numSUO], ("Hmm, expected update mismatch here"));
+			DEBUG_ASSERTCRASH(m_sleepyUpdates[idx].module == sleepyUpdatesForThisObject[numSUO], ("Hmm, expected update mismatch here"));
 			eraseSleepyUpdate(idx);
 			DEBUG_ASSERTCRASH(sleepyUpdatesForThisObject[numSUO]->friend_getIndexInLogic() == -1, ("Hmm, expected index to be -1 here"));
 		}
@@ -2945,28 +2961,29 @@ inline void GameLogic::validateSleepyUpdate() const
 	//DEBUG_LOG(("\n"));
 	//for (i = 0; i < sz; ++i)
 	//{
-	//	DEBUG_LOG(("u %04d: %08lx %08lx",i,m_sleepyUpdates[i],m_sleepyUpdates[i]->friend_getNextCallFrame()));
+	//	DEBUG_LOG(("u %04d: %08lx %08lx",i,m_sleepyUpdates[i].module,m_sleepyUpdates[i].module->friend_getNextCallFrame()));
 	//}
 	for (i = 0; i < sz; ++i)
 	{
-		DEBUG_ASSERTCRASH(m_sleepyUpdates[i]->friend_getIndexInLogic() == i, ("index mismatch: expected %d, got %d", i, m_sleepyUpdates[i]->friend_getIndexInLogic()));
-		UnsignedInt pri = m_sleepyUpdates[i]->friend_getPriority();
+		DEBUG_ASSERTCRASH(m_sleepyUpdates[i].module->friend_getIndexInLogic() == i, ("index mismatch: expected %d, got %d", i, m_sleepyUpdates[i].module->friend_getIndexInLogic()));
+		UnsignedInt pri = m_sleepyUpdates[i].module->friend_getPriority();
+		DEBUG_ASSERTCRASH(m_sleepyUpdates[i].priority == pri, ("stale sleepy priority: expected %08x, got %08x", pri, m_sleepyUpdates[i].priority));
 		if (i > 0)
 		{
 			Int i0 = (i + 1) / 2 - 1;
-			UnsignedInt pri0 = m_sleepyUpdates[i0]->friend_getPriority();
+			UnsignedInt pri0 = m_sleepyUpdates[i0].module->friend_getPriority();
 			DEBUG_ASSERTCRASH(pri >= pri0, ("sleepyUpdates are munged (0)"));
 		}
 		Int i1 = 2 * (i + 1) - 1;
 		Int i2 = 2 * (i + 1);
 		if (i1 < sz)
 		{
-			UnsignedInt pri1 = m_sleepyUpdates[i1]->friend_getPriority();
+			UnsignedInt pri1 = m_sleepyUpdates[i1].module->friend_getPriority();
 			DEBUG_ASSERTCRASH(pri <= pri1, ("sleepyUpdates are munged (1)"));
 		}
 		if (i2 < sz)
 		{
-			UnsignedInt pri2 = m_sleepyUpdates[i2]->friend_getPriority();
+			UnsignedInt pri2 = m_sleepyUpdates[i2].module->friend_getPriority();
 			DEBUG_ASSERTCRASH(pri <= pri2, ("sleepyUpdates are munged (2)"));
 		}
 	}
@@ -2981,13 +2998,13 @@ void GameLogic::eraseSleepyUpdate(Int i)
 		DEBUG_ASSERTCRASH(i >= 0 && i < m_sleepyUpdates.size(), ("bad sleepy idx"));
 
 	// swap with the final item, toss the final item, then rebalance
-	m_sleepyUpdates[i]->friend_setIndexInLogic(-1);
+	m_sleepyUpdates[i].module->friend_setIndexInLogic(-1);
 
 	Int final = m_sleepyUpdates.size() - 1;
 	if (i < final)
 	{
 		m_sleepyUpdates[i] = m_sleepyUpdates[final];
-		m_sleepyUpdates[i]->friend_setIndexInLogic(i);
+		m_sleepyUpdates[i].module->friend_setIndexInLogic(i);
 		m_sleepyUpdates.pop_back();
 		rebalanceSleepyUpdate(i);
 	}
@@ -2998,14 +3015,11 @@ void GameLogic::eraseSleepyUpdate(Int i)
 }
 
 // ------------------------------------------------------------------------------------------------
-inline Bool isLowerPriority(const UpdateModulePtr a, const UpdateModulePtr b)
+inline Bool isLowerPriority(UnsignedInt f1, UnsignedInt f2)
 {
-	// return true iff a is lower pri than b.
+	// return true iff f1 is lower pri than f2.
 	// remember: lower ordinal value means higher priority.
 	// therefore, higher ordinal value means lower priority.
-	DEBUG_ASSERTCRASH(a && b, ("these may no longer be null"));
-	UnsignedInt f1 = a->friend_getPriority();
-	UnsignedInt f2 = b->friend_getPriority();
 	return f1 > f2;
 }
 
@@ -3017,16 +3031,16 @@ Int GameLogic::rebalanceParentSleepyUpdate(Int i)
 		DEBUG_ASSERTCRASH(i >= 0 && i < m_sleepyUpdates.size(), ("bad sleepy idx"));
 
 	Int parent = ((i + 1) >> 1) - 1;
-	while (parent >= 0 && isLowerPriority(m_sleepyUpdates[parent], m_sleepyUpdates[i]))
+	while (parent >= 0 && isLowerPriority(m_sleepyUpdates[parent].priority, m_sleepyUpdates[i].priority))
 	{
-		UpdateModulePtr a = m_sleepyUpdates[parent];
-		UpdateModulePtr b = m_sleepyUpdates[i];
+		SleepyUpdateEntry a = m_sleepyUpdates[parent];
+		SleepyUpdateEntry b = m_sleepyUpdates[i];
 
 		m_sleepyUpdates[i] = a;
 		m_sleepyUpdates[parent] = b;
 
-		a->friend_setIndexInLogic(i);
-		b->friend_setIndexInLogic(parent);
+		a.module->friend_setIndexInLogic(i);
+		b.module->friend_setIndexInLogic(parent);
 
 		i = parent;
 		parent = ((parent + 1) >> 1) - 1;
@@ -3047,37 +3061,37 @@ Int GameLogic::rebalanceChildSleepyUpdate(Int i)
 	// max efficiency. I have left the pristine non-unrolled
 	// version present for clarity. (Yes, this is worth doing.) (srj)
 #if 1
-	UpdateModulePtr* pI = &m_sleepyUpdates[i];
+	SleepyUpdateEntry* pI = &m_sleepyUpdates[i];
 
 	// our children are i*2 and i*2+1
 	Int child = ((i) << 1) + 1;
-	UpdateModulePtr* pChild = &m_sleepyUpdates[0] + child;
-	UpdateModulePtr* pSZ = &m_sleepyUpdates[0] + m_sleepyUpdates.size();	// yes, this is off the end.
+	SleepyUpdateEntry* pChild = &m_sleepyUpdates[0] + child;
+	SleepyUpdateEntry* pSZ = &m_sleepyUpdates[0] + m_sleepyUpdates.size();	// yes, this is off the end.
 
 	while (pChild < pSZ)
 	{
 		// choose the higher-priority of the two children; we must be higher-pri than that.
-		if (pChild < pSZ - 1 && isLowerPriority(*pChild, *(pChild + 1)))
+		if (pChild < pSZ - 1 && isLowerPriority(pChild->priority, (pChild + 1)->priority))
 		{
 			++pChild;
 			++child;
 		}
 
 		// if we're higher-pri than our children, we're done.
-		if (!isLowerPriority(*pI, *pChild))
+		if (!isLowerPriority(pI->priority, pChild->priority))
 		{
 			break;
 		}
 
 		// doh. swap with the highest-pri child we have.
-		UpdateModulePtr a = *pChild;
-		UpdateModulePtr b = *pI;
+		SleepyUpdateEntry a = *pChild;
+		SleepyUpdateEntry b = *pI;
 
 		*pI = a;
 		*pChild = b;
 
-		a->friend_setIndexInLogic(i);
-		b->friend_setIndexInLogic(child);
+		a.module->friend_setIndexInLogic(i);
+		b.module->friend_setIndexInLogic(child);
 
 		i = child;
 		pI = pChild;
@@ -3092,24 +3106,24 @@ Int GameLogic::rebalanceChildSleepyUpdate(Int i)
 	while (child < sz)
 	{
 		// choose the higher-priority of the two children; we must be higher-pri than that.
-		if (child < sz - 1 && isLowerPriority(m_sleepyUpdates[child], m_sleepyUpdates[child + 1]))
+		if (child < sz - 1 && isLowerPriority(m_sleepyUpdates[child].priority, m_sleepyUpdates[child + 1].priority))
 			++child;
 
 		// if we're higher-pri than our children, we're done.
-		if (!isLowerPriority(m_sleepyUpdates[i], m_sleepyUpdates[child]))
+		if (!isLowerPriority(m_sleepyUpdates[i].priority, m_sleepyUpdates[child].priority))
 		{
 			break;
 		}
 
 		// doh. swap with the highest-pri child we have.
-		UpdateModulePtr a = m_sleepyUpdates[child];
-		UpdateModulePtr b = m_sleepyUpdates[i];
+		SleepyUpdateEntry a = m_sleepyUpdates[child];
+		SleepyUpdateEntry b = m_sleepyUpdates[i];
 
 		m_sleepyUpdates[i] = a;
 		m_sleepyUpdates[child] = b;
 
-		a->friend_setIndexInLogic(i);
-		b->friend_setIndexInLogic(child);
+		a.module->friend_setIndexInLogic(i);
+		b.module->friend_setIndexInLogic(child);
 		i = child;
 		child = ((i) << 1) + 1;
 	}
@@ -3122,7 +3136,12 @@ void GameLogic::rebalanceSleepyUpdate(Int i)
 {
 	USE_PERF_TIMER(SleepyMaintenance)
 
-		i = rebalanceParentSleepyUpdate(i);
+		DEBUG_ASSERTCRASH(i >= 0 && i < m_sleepyUpdates.size(), ("bad sleepy idx"));
+
+	// the module's wake frame may have changed, so pick up its new priority first.
+	m_sleepyUpdates[i].priority = m_sleepyUpdates[i].module->friend_getPriority();
+
+	i = rebalanceParentSleepyUpdate(i);
 	i = rebalanceChildSleepyUpdate(i);
 }
 
@@ -3150,7 +3169,10 @@ void GameLogic::pushSleepyUpdate(UpdateModulePtr u)
 
 		DEBUG_ASSERTCRASH(u != NULL, ("You may not pass null for sleepy update info"));
 
-	m_sleepyUpdates.push_back(u);
+	SleepyUpdateEntry entry;
+	entry.priority = u->friend_getPriority();
+	entry.module = u;
+	m_sleepyUpdates.push_back(entry);
 	u->friend_setIndexInLogic(m_sleepyUpdates.size() - 1);
 
 	rebalanceParentSleepyUpdate(m_sleepyUpdates.size() - 1);
@@ -3161,7 +3183,7 @@ UpdateModulePtr GameLogic::peekSleepyUpdate() const
 {
 	USE_PERF_TIMER(SleepyMaintenance)
 
-		UpdateModulePtr u = m_sleepyUpdates.front();
+		UpdateModulePtr u = m_sleepyUpdates.front().module;
 	DEBUG_ASSERTCRASH(u->friend_getIndexInLogic() == 0, ("index mismatch: expected %d, got %d", 0, u->friend_getIndexInLogic()));
 	return u;
 }
@@ -3178,11 +3200,11 @@ void GameLogic::popSleepyUpdate()
 		return;
 	}
 
-	m_sleepyUpdates[0]->friend_setIndexInLogic(-1);
+	m_sleepyUpdates[0].module->friend_setIndexInLogic(-1);
 	if (sz > 1)
 	{
 		m_sleepyUpdates[0] = m_sleepyUpdates[sz - 1];
-		m_sleepyUpdates[0]->friend_setIndexInLogic(0);
+		m_sleepyUpdates[0].module->friend_setIndexInLogic(0);
 		m_sleepyUpdates.pop_back();
 		rebalanceChildSleepyUpdate(0);
 	}
@@ -3230,7 +3252,7 @@ void GameLogic::friend_awakenUpdateModule(Object* obj, UpdateModulePtr u, Unsign
 			return;
 		}
 
-		if (m_sleepyUpdates[idx] != u)
+		if (m_sleepyUpdates[idx].module != u)
 		{
 			RELEASE_CRASH("fatal error! sleepy update module index mismatch.");
 			return;
@@ -3802,6 +3824,11 @@ void GameLogic::update(void)
 		}
 #endif
 
+	// TheSuperHackers @feature Replay checkpoints are taken and restored between two logic frames.
+	// A restore replaces the whole game, so this update is skipped and the next one continues from there.
+	if (!m_startNewGame && isInGame() && TheRecorder && TheRecorder->isPlaybackMode() && TheRecorder->updateCheckpoints())
+		return;
+
 	LatchRestore<Bool> inUpdateLatch(m_isInUpdate, TRUE);
 #ifdef DO_UNIT_TIMINGS
 	unitTimings();
@@ -3847,16 +3874,21 @@ void GameLogic::update(void)
 	UnsignedInt now = TheGameLogic->getFrame();
 	TheGameClient->setFrame(now);
 
+	if (TheLogicFrameProfiler)
+		TheLogicFrameProfiler->beginFrame(now);
+
 	// update (execute) scripts
 	{
 		TheScriptEngine->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_SCRIPT_ENGINE);
 
 	// Note - TerrainLogic update needs to happen after ScriptEngine update, but before object updates.  jba.
 	// This way changes in bridges are noted in the script engine before being cleared in TerrainLogic->update
 	{
 		TheTerrainLogic->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_TERRAIN_LOGIC);
 
 	// force CRC calculation, so we can keep a cache of the last N CRCs.  We do this right where the recorder
 	// would be getting the CRC anyway, so replays can get the CRCs from the exact instant in time as the original.
@@ -3889,6 +3921,7 @@ void GameLogic::update(void)
 
 		DEBUG_LOG(("Appended %sCRC on frame %d: %8.8X", isPlayback ? "Playback " : "", m_frame, m_CRC));
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_CRC);
 
 	// collect stats
 	if (TheStatsCollector)
@@ -3900,11 +3933,13 @@ void GameLogic::update(void)
 	{
 		TheRecorder->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_OTHER);
 
 	// process client commands
 	{
 		processCommandList(TheCommandList);
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_COMMAND_LIST);
 
 #ifdef ALLOW_NONSLEEPY_UPDATES
 	{
@@ -3976,20 +4011,30 @@ void GameLogic::update(void)
 
 	validateSleepyUpdate();
 
+	UnsignedInt pathfindQueueDepth = 0;
+	if (TheLogicFrameProfiler)
+	{
+		TheLogicFrameProfiler->endPhase(LogicFrameProfiler::PHASE_SLEEPY_UPDATES);
+		pathfindQueueDepth = TheAI->pathfinder()->getQueuedPathfindRequestCount();
+	}
+
 	// update the Artificial Intelligence system
 	{
 		TheAI->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_AI);
 
 	// production updates
 	{
 		TheBuildAssistant->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_BUILD_ASSISTANT);
 
 	// update partition info
 	{
 		ThePartitionManager->UPDATE();
 	}
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_PARTITION_MANAGER);
 
 	//
 	// End of frame clean-up
@@ -3997,18 +4042,23 @@ void GameLogic::update(void)
 
 	// destroy all pending objects
 	processDestroyList();
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_DESTROY_LIST);
 
 	// reset the command list, destroying all messages
 	TheCommandList->reset();
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_OTHER);
 
 	TheWeaponStore->UPDATE();
 	TheLocomotorStore->UPDATE();
+	LOGIC_FRAME_PROFILE_PHASE(PHASE_WEAPON_LOCOMOTOR_STORES);
 	TheVictoryConditions->UPDATE();
 
+	UnsignedInt objectCount = 0;
 	{
 		//Handle disabled statii (and re-enable objects once frame matches)
 		for (Object* obj = m_objList; obj; obj = obj->getNextObject())
 		{
+			++objectCount;
 			if (obj->isDisabled())
 			{
 				obj->checkDisabledStatus();
@@ -4016,6 +4066,9 @@ void GameLogic::update(void)
 		}
 	}
 
+	if (TheLogicFrameProfiler)
+		TheLogicFrameProfiler->endFrame(objectCount, (UnsignedInt)m_sleepyUpdates.size(), pathfindQueueDepth);
+
 
 
 
@@ -4766,7 +4819,8 @@ Bool GameLogic::findControlBarOverride(const AsciiString& commandSetName, Int sl
 
 #ifdef DUMP_PERF_STATS
 // ------------------------------------------------------------------------------------------------
-void GameLogic::getAIMetricsStatistics(UnsignedInt* numAI, UnsignedInt* numMoving, UnsignedInt* numAttacking, UnsignedInt* numWaitingForPath, UnsignedInt* overallFailedPathfinds)
+void GameLogic::getAIMetricsStatistics(UnsignedInt* numAI, UnsignedInt* numMoving, UnsignedInt* numAttacking, UnsignedInt* numWaitingForPath, UnsignedInt* overallFailedPathfinds,
+	UnsignedInt* hierarchicalPathCacheHits, UnsignedInt* hierarchicalPathCacheMisses)
 {
 	Object* obj;
 	*numAI = 0;
@@ -4795,6 +4849,7 @@ void GameLogic::getAIMetricsStatistics(UnsignedInt* numAI, UnsignedInt* numMovin
 		}
 	}
 	*overallFailedPathfinds = m_overallFailedPathfinds;
+	TheAI->pathfinder()->getHierarchicalPathCacheStats(hierarchicalPathCacheHits, hierarchicalPathCacheMisses);
 }
 #endif
 
@@ -5363,9 +5418,9 @@ void GameLogic::loadPostProcess(void)
 			m_nextObjID = (ObjectID)((UnsignedInt)obj->getID() + 1);
 
 	// blow away the sleepy update and normal update module lists
-	for (std::vector<UpdateModulePtr>::iterator it = m_sleepyUpdates.begin(); it != m_sleepyUpdates.end(); ++it)
+	for (std::vector<SleepyUpdateEntry>::iterator it = m_sleepyUpdates.begin(); it != m_sleepyUpdates.end(); ++it)
 	{
-		(*it)->friend_setIndexInLogic(-1);
+		it->module->friend_setIndexInLogic(-1);
 	}
 	m_sleepyUpdates.clear();
 #ifdef ALLOW_NONSLEEPY_UPDATES
@@ -5409,7 +5464,10 @@ void GameLogic::loadPostProcess(void)
 				u->friend_setNextCallFrame(now);
 #endif
 			{
-				m_sleepyUpdates.push_back(u);
+				SleepyUpdateEntry entry;
+				entry.priority = u->friend_getPriority();
+				entry.module = u;
+				m_sleepyUpdates.push_back(entry);
 				u->friend_setIndexInLogic(m_sleepyUpdates.size() - 1);
 			}
 
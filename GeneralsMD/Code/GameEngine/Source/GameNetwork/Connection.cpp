@@ -363,13 +363,9 @@ NetCommandRef * Connection::processAck(NetCommandMsg *msg) {
  * Take that message off the list of commands to send.
  */
 NetCommandRef * Connection::processAck(UnsignedShort commandID, UnsignedByte originalPlayerID) {
-	NetCommandRef *temp = m_netCommandList->getFirstMessage();
-	while ((temp != NULL) && ((temp->getCommand()->getID() != commandID) || (temp->getCommand()->getPlayerID() != originalPlayerID))) {
-
-		// cycle through the commands till we find the one we need to remove.
-		// Need to check for both the command ID and the player ID.
-		temp = temp->getNext();
-	}
+	// find the command we need to remove.
+	// Need to check for both the command ID and the player ID.
+	NetCommandRef *temp = m_netCommandList->findMessageByID(commandID, originalPlayerID);
 	if (temp == NULL) {
 		return NULL;
 	}
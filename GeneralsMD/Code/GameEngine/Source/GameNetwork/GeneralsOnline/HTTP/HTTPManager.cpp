@@ -65,49 +65,43 @@ void HTTPManager::Shutdown()
 	}
 	m_vecRequestsPendingStart.clear();
 
-	NetworkLog(ELogVerbosity::LOG_RELEASE, "[HTTPManager] Waiting for %d in-flight requests to complete...", (int)m_vecRequestsInFlight.size());
+	NetworkLog(ELogVerbosity::LOG_RELEASE, "[HTTPManager] Waiting for %d in-flight requests to complete...", (int)m_setRequestsInFlight.size());
 
-	// Wait for all in-flight requests to complete
+	// Wait for all in-flight requests to complete, the IO thread exits once it has nothing left to transfer
 	if (m_pCurl != nullptr)
 	{
-		int numRunning = 0;
-		do
+		if (m_ioThread.joinable())
 		{
-			// Perform any pending operations
-			curl_multi_perform(m_pCurl, &numRunning);
-			
-			// Check for completed requests
-			int msgq = 0;
-			CURLMsg* m = nullptr;
-			while ((m = curl_multi_info_read(m_pCurl, &msgq)) != nullptr)
-			{
-				if (m->msg == CURLMSG_DONE)
-				{
-					CURL* pCurlHandle = m->easy_handle;
-					
-					// Find and remove the associated request
-					for (auto it = m_vecRequestsInFlight.begin(); it != m_vecRequestsInFlight.end(); ++it)
-					{
-						HTTPRequest* pRequest = *it;
-						if (pRequest != nullptr && pRequest->EasyHandleMatches(pCurlHandle))
-						{
-							pRequest->Threaded_SetComplete(m->data.result);
-							delete pRequest;
-							m_vecRequestsInFlight.erase(it);
-							break;
-						}
-					}
-				}
-			}
-			
-			// Small sleep to avoid busy-waiting if there are still operations pending
-			if (numRunning > 0)
+			curl_multi_wakeup(m_pCurl);
+			m_ioThread.join();
+		}
+
+		HTTPRequest* pRequest = PopAllQueuedRequests(m_pRequestsCompleted);
+		while (pRequest != nullptr)
+		{
+			HTTPRequest* pNextRequest = pRequest->m_pNextQueued;
+			pRequest->m_pNextQueued = nullptr;
+
+			// same order as Tick, the last progress update comes before the completion
+			if (pRequest->NeedsProgressUpdate())
 			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				pRequest->InvokeProgressUpdateCallback();
 			}
-			
-		} while (numRunning > 0 || !m_vecRequestsInFlight.empty());
-		
+
+			pRequest->Threaded_SetComplete(pRequest->m_completionResult);
+			m_setRequestsInFlight.erase(pRequest);
+			delete pRequest;
+
+			pRequest = pNextRequest;
+		}
+
+		// only requests held back by ARTIFICIAL_DELAY_HTTP_REQUESTS can remain here
+		for (HTTPRequest* pDelayedRequest : m_setRequestsInFlight)
+		{
+			delete pDelayedRequest;
+		}
+		m_setRequestsInFlight.clear();
+
 		NetworkLog(ELogVerbosity::LOG_RELEASE, "[HTTPManager] All in-flight requests completed");
 
 		// Now safe to cleanup
@@ -171,30 +165,41 @@ void HTTPManager::Initialize()
 
 	m_pCurl = curl_multi_init();
 	m_bProxyEnabled = DeterminePlatformProxySettings();
+
+	m_ioThread = std::thread(&HTTPManager::IOThreadMain, this);
 }
 
 void HTTPManager::Tick()
 {
 	CHECK_MAIN_THREAD;
 
-	std::vector<HTTPRequest*> vecItemsToRemove = std::vector<HTTPRequest*>();
-
-	// start anything needing starting
-	for (HTTPRequest* pRequest : m_vecRequestsPendingStart)
+	// start anything needing starting, setup stays on the main thread because it reads the auth token
+	if (!m_vecRequestsPendingStart.empty())
 	{
-		pRequest->StartRequest();
-		m_vecRequestsInFlight.push_back(pRequest);
+		for (HTTPRequest* pRequest : m_vecRequestsPendingStart)
+		{
+			pRequest->StartRequest();
+			m_setRequestsInFlight.insert(pRequest);
+			PushQueuedRequest(m_pRequestsToAdd, pRequest);
+		}
+		m_vecRequestsPendingStart.clear();
+
+		curl_multi_wakeup(m_pCurl);
 	}
-	m_vecRequestsPendingStart.clear();
 
-	// perform and poll
-	int numReqs = 0;
-	curl_multi_perform(m_pCurl, &numReqs);
-	curl_multi_poll(m_pCurl, NULL, 0, 0, NULL);
+	// progress updates flagged by the IO thread
+	for (HTTPRequest* pRequest : m_setRequestsInFlight)
+	{
+		if (pRequest->NeedsProgressUpdate())
+		{
+			pRequest->InvokeProgressUpdateCallback();
+		}
+	}
 
 #if defined(ARTIFICIAL_DELAY_HTTP_REQUESTS)
 	// tick delays
-	for (HTTPRequest* pRequest : m_vecRequestsInFlight)
+	std::vector<HTTPRequest*> vecItemsToRemove = std::vector<HTTPRequest*>();
+	for (HTTPRequest* pRequest : m_setRequestsInFlight)
 	{
 		if (pRequest->WaitingDelayAction())
 		{
@@ -204,54 +209,121 @@ void HTTPManager::Tick()
 				vecItemsToRemove.push_back(pRequest);
 			}
 		}
-		
+	}
+
+	for (HTTPRequest* pRequestToDestroy : vecItemsToRemove)
+	{
+		m_setRequestsInFlight.erase(pRequestToDestroy);
+		delete pRequestToDestroy;
 	}
 #endif
 
-	// are we done?
-	int msgq = 0;
-	CURLMsg* m = curl_multi_info_read(m_pCurl, &msgq);
-	
-	if (m != nullptr && m->msg == CURLMSG_DONE)
+	// drain every request the IO thread has finished since the last tick
+	HTTPRequest* pRequest = PopAllQueuedRequests(m_pRequestsCompleted);
+	while (pRequest != nullptr)
 	{
-		CURL* pCurlHandle = m->easy_handle;
+		HTTPRequest* pNextRequest = pRequest->m_pNextQueued;
+		pRequest->m_pNextQueued = nullptr;
 
-		if (pCurlHandle != nullptr)
+		// deliver any bytes that arrived after the progress pass above
+		if (pRequest->NeedsProgressUpdate())
 		{
-			// find the associated request
-			for (HTTPRequest* pRequest : m_vecRequestsInFlight)
-			{
-				if (pRequest != nullptr && pRequest->EasyHandleMatches(pCurlHandle))
-				{
+			pRequest->InvokeProgressUpdateCallback();
+		}
+
 #if defined(ARTIFICIAL_DELAY_HTTP_REQUESTS)
-					pRequest->SetWaitingDelay(m->data.result);
+		pRequest->SetWaitingDelay(pRequest->m_completionResult);
 #else
-					pRequest->Threaded_SetComplete(m->data.result);
-					vecItemsToRemove.push_back(pRequest);
+		pRequest->Threaded_SetComplete(pRequest->m_completionResult);
+		m_setRequestsInFlight.erase(pRequest);
+		delete pRequest;
 #endif
-				}
-			}
-		}
+
+		pRequest = pNextRequest;
 	}
+}
 
-	// remove any completed
-	for (HTTPRequest* pRequestToDestroy : vecItemsToRemove)
+void HTTPManager::IOThreadMain()
+{
+	while (true)
 	{
-		m_vecRequestsInFlight.erase(std::remove(m_vecRequestsInFlight.begin(), m_vecRequestsInFlight.end(), pRequestToDestroy));
-		delete pRequestToDestroy;
+		// take ownership of newly started requests
+		HTTPRequest* pRequest = PopAllQueuedRequests(m_pRequestsToAdd);
+		while (pRequest != nullptr)
+		{
+			HTTPRequest* pNextRequest = pRequest->m_pNextQueued;
+			pRequest->m_pNextQueued = nullptr;
+
+			m_mapRequestsByHandle[pRequest->m_pCURL] = pRequest;
+			curl_multi_add_handle(m_pCurl, pRequest->m_pCURL);
+
+			pRequest = pNextRequest;
+		}
+
+		int numRunning = 0;
+		curl_multi_perform(m_pCurl, &numRunning);
+
+		// hand back everything that finished
+		int msgq = 0;
+		CURLMsg* m = nullptr;
+		while ((m = curl_multi_info_read(m_pCurl, &msgq)) != nullptr)
+		{
+			if (m->msg != CURLMSG_DONE)
+			{
+				continue;
+			}
+
+			// the message does not survive curl_multi_remove_handle
+			CURL* pCurlHandle = m->easy_handle;
+			CURLcode result = m->data.result;
+
+			auto it = m_mapRequestsByHandle.find(pCurlHandle);
+			if (it == m_mapRequestsByHandle.end())
+			{
+				continue;
+			}
+
+			HTTPRequest* pCompletedRequest = it->second;
+			m_mapRequestsByHandle.erase(it);
+
+			curl_multi_remove_handle(m_pCurl, pCurlHandle);
+
+			pCompletedRequest->m_completionResult = result;
+			PushQueuedRequest(m_pRequestsCompleted, pCompletedRequest);
+		}
+
+		if (m_bShuttingDown && m_mapRequestsByHandle.empty() && m_pRequestsToAdd.load(std::memory_order_acquire) == nullptr)
+		{
+			break;
+		}
+
+		// sleeps until there is socket activity, a curl timeout expires or curl_multi_wakeup is called
+		curl_multi_poll(m_pCurl, NULL, 0, 1000, NULL);
 	}
 }
 
-void HTTPManager::AddHandleToMulti(CURL* pNewHandle)
+void HTTPManager::PushQueuedRequest(std::atomic<HTTPRequest*>& queueHead, HTTPRequest* pRequest)
 {
-	CHECK_MAIN_THREAD;
-
-	curl_multi_add_handle(m_pCurl, pNewHandle);
+	HTTPRequest* pHead = queueHead.load(std::memory_order_relaxed);
+	do
+	{
+		pRequest->m_pNextQueued = pHead;
+	} while (!queueHead.compare_exchange_weak(pHead, pRequest, std::memory_order_release, std::memory_order_relaxed));
 }
 
-void HTTPManager::RemoveHandleFromMulti(CURL* pHandleToRemove)
+HTTPRequest* HTTPManager::PopAllQueuedRequests(std::atomic<HTTPRequest*>& queueHead)
 {
-	CHECK_MAIN_THREAD;
+	// take the whole list at once and reverse it, so requests come out in the order they were pushed
+	HTTPRequest* pRequest = queueHead.exchange(nullptr, std::memory_order_acquire);
+
+	HTTPRequest* pReversed = nullptr;
+	while (pRequest != nullptr)
+	{
+		HTTPRequest* pNextRequest = pRequest->m_pNextQueued;
+		pRequest->m_pNextQueued = pReversed;
+		pReversed = pRequest;
+		pRequest = pNextRequest;
+	}
 
-	curl_multi_remove_handle(m_pCurl, pHandleToRemove);
+	return pReversed;
 }
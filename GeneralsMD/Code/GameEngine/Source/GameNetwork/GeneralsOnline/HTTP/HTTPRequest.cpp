@@ -35,9 +35,7 @@ HTTPRequest::HTTPRequest(EHTTPVerb httpVerb, EIPProtocolVersion protover, const
 
 HTTPRequest::~HTTPRequest()
 {
-	HTTPManager* pHTTPManager = NGMP_OnlineServicesManager::GetInstance()->GetHTTPManager();
-	pHTTPManager->RemoveHandleFromMulti(m_pCURL);
-
+	// the HTTPManager IO thread removes the easy handle from the multi handle before the request is handed back
 	curl_easy_cleanup(m_pCURL);
 
 	m_vecBuffer.clear();
@@ -66,6 +64,8 @@ void HTTPRequest::StartRequest()
 	m_vecBuffer.resize(g_initialBufSize);
 
 	m_currentBufSize_Used = 0;
+	m_bytesReceived = 0;
+	m_bNeedsProgressUpdate = false;
 
 	NetworkLog(ELogVerbosity::LOG_DEBUG, "[%p|%s|Verb %d] Transfer is starting: Body is %s", this, m_strURI.c_str(), m_httpVerb, m_strPostData.c_str());
 	PlatformStartRequest();
@@ -91,7 +91,9 @@ void HTTPRequest::OnResponsePartialWrite(std::uint8_t* pBuffer, size_t numBytes)
 
 	NetworkLog(ELogVerbosity::LOG_DEBUG, "[%p] Received: %d bytes", this, numBytes);
 
-	InvokeProgressUpdateCallback();
+	// runs on the HTTPManager IO thread, the progress callback is invoked on the next main thread tick
+	m_bytesReceived = m_currentBufSize_Used;
+	m_bNeedsProgressUpdate = true;
 }
 
 void HTTPRequest::InvokeCallbackIfComplete()
@@ -185,9 +187,6 @@ void HTTPRequest::PlatformStartRequest()
 {
 	if (m_pCURL)
 	{
-		HTTPManager* pHTTPManager = static_cast<HTTPManager*>(NGMP_OnlineServicesManager::GetInstance()->GetHTTPManager());
-		pHTTPManager->AddHandleToMulti(m_pCURL);
-
 		curl_easy_setopt(m_pCURL, CURLOPT_URL, m_strURI.c_str());
 		curl_easy_setopt(m_pCURL, CURLOPT_FOLLOWLOCATION, 1L);
 		curl_easy_setopt(m_pCURL, CURLOPT_WRITEDATA, (void*)this);
@@ -247,7 +246,10 @@ void HTTPRequest::PlatformStartRequest()
 		}
 
 #if _DEBUG
-		if (pHTTPManager->IsProxyEnabled())
+		// tools drive an HTTPManager of their own without the online services
+		NGMP_OnlineServicesManager* pOnlineServicesManager = NGMP_OnlineServicesManager::GetInstance();
+		HTTPManager* pHTTPManager = pOnlineServicesManager != nullptr ? pOnlineServicesManager->GetHTTPManager() : nullptr;
+		if (pHTTPManager != nullptr && pHTTPManager->IsProxyEnabled())
 		{
 			curl_easy_setopt(m_pCURL, CURLOPT_PROXY, pHTTPManager->GetProxyAddress().c_str());
 			curl_easy_setopt(m_pCURL, CURLOPT_PROXYPORT, pHTTPManager->GetProxyPort());
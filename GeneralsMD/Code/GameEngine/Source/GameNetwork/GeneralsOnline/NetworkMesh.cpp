@@ -954,7 +954,7 @@ PlayerConnection::PlayerConnection(int64_t userID, HSteamNetConnection hSteamCon
 	}
 }
 
-int PlayerConnection::SendGamePacket(void* pBuffer, uint32_t totalDataSize)
+int PlayerConnection::GetGamePacketSendFlags()
 {
 	int sendFlags = k_nSteamNetworkingSend_Reliable | k_nSteamNetworkingSend_AutoRestartBrokenSession; // default from last patch
 
@@ -985,6 +985,13 @@ int PlayerConnection::SendGamePacket(void* pBuffer, uint32_t totalDataSize)
 		}
 	}
 
+	return sendFlags;
+}
+
+int PlayerConnection::SendGamePacket(void* pBuffer, uint32_t totalDataSize)
+{
+	int sendFlags = GetGamePacketSendFlags();
+
 	NetworkLog(ELogVerbosity::LOG_DEBUG, "[GAME PACKET] Sending msg of size %ld to user %lld\n", totalDataSize, m_userID);
 	EResult r = SteamNetworkingSockets()->SendMessageToConnection(
 		m_hSteamConnection, pBuffer, (int)totalDataSize, sendFlags, nullptr);
@@ -997,6 +1004,28 @@ int PlayerConnection::SendGamePacket(void* pBuffer, uint32_t totalDataSize)
 	return (int)r;
 }
 
+// Builds a message for ISteamNetworkingSockets::SendMessages, which takes ownership of it.
+SteamNetworkingMessage_t* PlayerConnection::CreateGamePacketMessage(const void* pBuffer, uint32_t totalDataSize, int sendFlags)
+{
+	if (m_hSteamConnection == k_HSteamNetConnection_Invalid)
+	{
+		return nullptr;
+	}
+
+	SteamNetworkingMessage_t* pMsg = SteamNetworkingUtils()->AllocateMessage((int)totalDataSize);
+	if (pMsg == nullptr)
+	{
+		return nullptr;
+	}
+
+	memcpy(pMsg->m_pData, pBuffer, totalDataSize);
+	pMsg->m_conn = m_hSteamConnection;
+	pMsg->m_nFlags = sendFlags;
+
+	NetworkLog(ELogVerbosity::LOG_DEBUG, "[GAME PACKET] Sending msg of size %ld to user %lld\n", totalDataSize, m_userID);
+	return pMsg;
+}
+
 
 void PlayerConnection::UpdateLatencyHistogram()
 {
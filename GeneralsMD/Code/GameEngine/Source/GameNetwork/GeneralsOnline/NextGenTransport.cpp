@@ -14,8 +14,18 @@
 #endif
 
 NextGenTransport::NextGenTransport()
+	: m_numQueuedSends(0)
+	, m_firstFreeSendSlot(0)
 {
+	for (int i = 0; i < MAX_MESSAGES; ++i)
+	{
+		m_inBuffer[i].length = 0;
+		m_outBuffer[i].length = 0;
+	}
 
+	m_sendBatch.reserve(MAX_MESSAGES);
+	m_sendBatchSlots.reserve(MAX_MESSAGES);
+	m_sendBatchResults.reserve(MAX_MESSAGES);
 }
 
 NextGenTransport::~NextGenTransport()
@@ -59,11 +69,13 @@ Bool NextGenTransport::doRecv(void)
 {
 	bool bRet = false;
 
-	TransportMessage incomingMessage;
-	unsigned char* buf = (unsigned char*)&incomingMessage;
-
 	int numRead = 0;
 
+	// TheSuperHackers @performance Each packet is copied straight from the Steam message into the first free
+	// receive slot. Slots are only filled here, so the search for the next free slot resumes where the last
+	// one was found instead of starting over at the front of m_inBuffer.
+	int freeSlot = 0;
+
 	NGMP_OnlineServices_LobbyInterface* pLobbyInterface = NGMP_OnlineServicesManager::GetInterface<NGMP_OnlineServices_LobbyInterface>();
 	if (pLobbyInterface != nullptr)
 	{
@@ -85,12 +97,6 @@ Bool NextGenTransport::doRecv(void)
 					++numRead;
 					bRet = true;
 
-					memcpy(buf, pMsg[i]->m_pData, numBytes);
-
-					// Free message struct and buffer.
-					pMsg[i]->Release();
-
-
 					// generals logic
 #if defined(RTS_DEBUG) || defined(RTS_INTERNAL)
 // Packet loss simulation
@@ -98,26 +104,42 @@ Bool NextGenTransport::doRecv(void)
 					{
 						if (TheGlobalData->m_packetLoss >= GameClientRandomValue(0, 100))
 						{
+							pMsg[i]->Release();
 							continue;
 						}
 					}
 #endif
 
-					incomingMessage.length = numBytes - sizeof(TransportMessageHeader);
-
-					// is it a generals packet?
-					if (isGeneralsPacket(&incomingMessage))
+					if (numBytes <= sizeof(TransportMessageHeader) || numBytes > sizeof(TransportMessageHeader) + MAX_MESSAGE_LEN)
 					{
-						//NetworkLog(ELogVerbosity::LOG_RELEASE, "Game Packet Recv: Is a generals packet");
+						NetworkLog(ELogVerbosity::LOG_RELEASE, "Game Packet Recv: Is NOT a generals packet");
+						m_unknownPackets[m_statisticsSlot]++;
+						m_unknownBytes[m_statisticsSlot] += numBytes;
+						pMsg[i]->Release();
+						continue;
 					}
-					else
+
+					while (freeSlot < MAX_MESSAGES && m_inBuffer[freeSlot].length != 0)
 					{
-						NetworkLog(ELogVerbosity::LOG_RELEASE, "Game Packet Recv: Is NOT a generals packet");
+						++freeSlot;
 					}
 
-					if (numBytes <= sizeof(TransportMessageHeader) || !isGeneralsPacket(&incomingMessage))
-						//if (numBytes <= sizeof(TransportMessageHeader))
+					// When every slot is taken the packet is still validated for the statistics, then dropped.
+					TransportMessage overflowMessage;
+					TransportMessage* pIncomingMessage = (freeSlot < MAX_MESSAGES) ? &m_inBuffer[freeSlot] : &overflowMessage;
+
+					// dont care about address anymore
+					memcpy(pIncomingMessage, pMsg[i]->m_pData, numBytes);
+					pIncomingMessage->length = numBytes - sizeof(TransportMessageHeader);
+
+					// Free message struct and buffer.
+					pMsg[i]->Release();
+
+					// is it a generals packet?
+					if (!isGeneralsPacket(pIncomingMessage))
 					{
+						NetworkLog(ELogVerbosity::LOG_RELEASE, "Game Packet Recv: Is NOT a generals packet");
+						pIncomingMessage->length = 0;
 						m_unknownPackets[m_statisticsSlot]++;
 						m_unknownBytes[m_statisticsSlot] += numBytes;
 						continue;
@@ -127,22 +149,6 @@ Bool NextGenTransport::doRecv(void)
 			//		DEBUG_LOG(("Saw %d bytes from %d:%d\n", len, ntohl(from.sin_addr.S_un.S_addr), ntohs(from.sin_port)));
 					m_incomingPackets[m_statisticsSlot]++;
 					m_incomingBytes[m_statisticsSlot] += numBytes;
-
-					for (int i = 0; i < MAX_MESSAGES; ++i)
-					{
-						if (m_inBuffer[i].length == 0)
-						{
-							// Empty slot; use it
-							m_inBuffer[i].length = incomingMessage.length;
-
-							// dont care about address anymore
-							//m_inBuffer[i].addr = ntohl(from.sin_addr.S_un.S_addr);
-							//m_inBuffer[i].port = ntohs(from.sin_port);
-
-							memcpy(&m_inBuffer[i], buf, numBytes);
-							break;
-						}
-					}
 				}
 			}
 		}
@@ -155,66 +161,141 @@ Bool NextGenTransport::doRecv(void)
 
 Bool NextGenTransport::doSend(void)
 {
+	if (m_numQueuedSends == 0)
+	{
+		NetworkLog(ELogVerbosity::LOG_DEBUG, "Game Packet Send: Sent %d packets this frame", 0);
+		return true;
+	}
+
+	// TODO_NGMP: Get this from game info, not the lobby, we should tear lobby down probably
+	NGMP_OnlineServicesManager* pOnlineServicesManager = NGMP_OnlineServicesManager::GetInstance();
+	if (pOnlineServicesManager == nullptr)
+	{
+		return FALSE;
+	}
+
+	NGMP_OnlineServices_LobbyInterface* pLobbyInterface = NGMP_OnlineServicesManager::GetInterface<NGMP_OnlineServices_LobbyInterface>();
+	if (pLobbyInterface == nullptr)
+	{
+		return FALSE;
+	}
+
+	if (TheNGMPGame == nullptr)
+	{
+		return FALSE;
+	}
+
+	NetworkMesh* pMesh = NGMP_OnlineServicesManager::GetNetworkMesh();
+	if (pMesh == nullptr)
+	{
+		return FALSE;
+	}
+
 	bool retval = true;
 
 	int numSent = 0;
 
-	int i;
-	for (i = 0; i < MAX_MESSAGES; ++i)
+	// TheSuperHackers @performance The queued packets are gathered into one batch and handed to Steam with a
+	// single SendMessages call. Packets for the same peer keep their queue order within the batch.
+	PlayerConnection* slotConnections[MAX_SLOTS];
+	Bool slotResolved[MAX_SLOTS];
+	for (int slot = 0; slot < MAX_SLOTS; ++slot)
+	{
+		slotResolved[slot] = FALSE;
+	}
+
+	const int sendFlags = PlayerConnection::GetGamePacketSendFlags();
+
+	m_sendBatch.clear();
+	m_sendBatchSlots.clear();
+
+	int numVisited = 0;
+	for (int i = 0; i < MAX_MESSAGES && numVisited < m_numQueuedSends; ++i)
 	{
-		if (m_outBuffer[i].length != 0)
+		if (m_outBuffer[i].length == 0)
 		{
-			// TODO_NGMP: Get this from game info, not the lobby, we should tear lobby down probably
-			// addr is actually player index...
-			// TODO: What if it's empty?
-			NGMP_OnlineServicesManager* pOnlineServicesManager = NGMP_OnlineServicesManager::GetInstance();
+			continue;
+		}
 
-			if (pOnlineServicesManager == nullptr)
-			{
-				return FALSE;
-			}
+		++numVisited;
 
-			NGMP_OnlineServices_LobbyInterface* pLobbyInterface = NGMP_OnlineServicesManager::GetInterface<NGMP_OnlineServices_LobbyInterface>();
-			if (pLobbyInterface == nullptr)
+		// addr is actually player index...
+		// TODO: What if it's empty?
+		UnsignedInt addr = m_outBuffer[i].addr;
+		PlayerConnection* pConnection = nullptr;
+		if (addr < MAX_SLOTS && slotResolved[addr])
+		{
+			pConnection = slotConnections[addr];
+		}
+		else
+		{
+			NGMPGameSlot* pSlot = (NGMPGameSlot*)TheNGMPGame->getSlot(addr);
+			if (pSlot != nullptr)
 			{
-				return FALSE;
+				pConnection = pMesh->GetConnectionForUser(pSlot->m_userID);
 			}
 
-			if (TheNGMPGame == nullptr)
+			if (addr < MAX_SLOTS)
 			{
-				return FALSE;
+				slotConnections[addr] = pConnection;
+				slotResolved[addr] = TRUE;
 			}
+		}
 
-			NGMPGameSlot* pSlot = (NGMPGameSlot*)TheNGMPGame->getSlot(m_outBuffer[i].addr);
+		if (pConnection == nullptr)
+		{
+			// No connection yet; leave it queued.
+			retval = false;
+			continue;
+		}
 
-			if (pSlot != nullptr)
-			{
-				retval = (NGMP_OnlineServicesManager::GetNetworkMesh()->SendGamePacket((void*)(&m_outBuffer[i]), (uint32_t)m_outBuffer[i].length + sizeof(TransportMessageHeader), pSlot->m_userID) >= 0);
-			}
-			else
+		SteamNetworkingMessage_t* pMsg = pConnection->CreateGamePacketMessage((void*)(&m_outBuffer[i]), (uint32_t)m_outBuffer[i].length + sizeof(TransportMessageHeader), sendFlags);
+		if (pMsg == nullptr)
+		{
+			// Steam would reject this send, which also takes it off the queue.
+			NetworkLog(ELogVerbosity::LOG_RELEASE, "[GAME PACKET] Failed to send, no connection to user %lld", pConnection->m_userID);
+			m_outBuffer[i].length = 0;
+			--m_numQueuedSends;
+			m_firstFreeSendSlot = min(m_firstFreeSendSlot, i);
+			--numVisited;
+			retval = false;
+			continue;
+		}
+
+		m_sendBatch.push_back(pMsg);
+		m_sendBatchSlots.push_back(i);
+	}
+
+	if (!m_sendBatch.empty())
+	{
+		m_sendBatchResults.resize(m_sendBatch.size());
+		SteamNetworkingSockets()->SendMessages((int)m_sendBatch.size(), m_sendBatch.data(), m_sendBatchResults.data());
+
+		for (size_t batchIndex = 0; batchIndex < m_sendBatch.size(); ++batchIndex)
+		{
+			const int i = m_sendBatchSlots[batchIndex];
+
+			if (m_sendBatchResults[batchIndex] < 0)
 			{
+				NetworkLog(ELogVerbosity::LOG_RELEASE, "[GAME PACKET] Failed to send, err code was %d", (int)-m_sendBatchResults[batchIndex]);
 				retval = false;
 			}
-
-			if (retval)
+			else
 			{
 				++numSent;
 				//DEBUG_LOG(("Sending %d bytes to %d:%d\n", m_outBuffer[i].length + sizeof(TransportMessageHeader), m_outBuffer[i].addr, m_outBuffer[i].port));
 				m_outgoingPackets[m_statisticsSlot]++;
 				m_outgoingBytes[m_statisticsSlot] += m_outBuffer[i].length + sizeof(TransportMessageHeader);
-				m_outBuffer[i].length = 0;  // Remove from queue
-				//				DEBUG_LOG(("UDPTransport::doSend - sent %d butes to %d.%d.%d.%d:%d\n", bytesSent,
-				//					(m_outBuffer[i].addr >> 24) & 0xff,
-				//					(m_outBuffer[i].addr >> 16) & 0xff,
-				//					(m_outBuffer[i].addr >> 8) & 0xff,
-				//					m_outBuffer[i].addr & 0xff,
-				//					m_outBuffer[i].port));
-			}
-			else
-			{
-				retval = FALSE;
 			}
+
+			// Steam owns the message now, so it leaves the queue either way.
+			m_outBuffer[i].length = 0;  // Remove from queue
+			--m_numQueuedSends;
+			m_firstFreeSendSlot = min(m_firstFreeSendSlot, i);
 		}
+
+		m_sendBatch.clear();
+		m_sendBatchSlots.clear();
 	}
 
 	NetworkLog(ELogVerbosity::LOG_DEBUG, "Game Packet Send: Sent %d packets this frame", numSent);
@@ -232,7 +313,7 @@ Bool NextGenTransport::queueSend(UnsignedInt addr, UnsignedShort port, const Uns
 		return false;
 	}
 
-	for (i = 0; i < MAX_MESSAGES; ++i)
+	for (i = m_firstFreeSendSlot; i < MAX_MESSAGES; ++i)
 	{
 		if (m_outBuffer[i].length == 0)
 		{
@@ -250,18 +331,13 @@ Bool NextGenTransport::queueSend(UnsignedInt addr, UnsignedShort port, const Uns
 			//			DEBUG_LOG(("About to assign the CRC for the packet\n"));
 			m_outBuffer[i].header.crc = crc.get();
 
-			// is it a generals packet?
-			if (isGeneralsPacket(&m_outBuffer[i]))
-			{
-				//NetworkLog(ELogVerbosity::LOG_RELEASE, "Game Packet Queue Sending: Is a generals packet");
-			}
-			else
-			{
-				NetworkLog(ELogVerbosity::LOG_RELEASE, "Game Packet Queue Sending: Is NOT a generals packet");
-			}
+			++m_numQueuedSends;
+			m_firstFreeSendSlot = i + 1;
 
 			return true;
 		}
 	}
+
+	m_firstFreeSendSlot = MAX_MESSAGES;
 	return false;
 }
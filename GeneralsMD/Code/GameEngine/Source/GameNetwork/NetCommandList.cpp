@@ -35,6 +35,8 @@ NetCommandList::NetCommandList() {
 	m_first = NULL;
 	m_last = NULL;
 	m_lastMessageInserted = NULL;
+	m_count = 0;
+	m_index = NULL;
 }
 
 /**
@@ -77,6 +79,11 @@ NetCommandRef *NetCommandList::getFirstMessage() {
  * Remove the given message from this list.
  */
 void NetCommandList::removeMessage(NetCommandRef *msg) {
+	--m_count;
+	if (m_index != NULL) {
+		unindexMessage(msg);
+	}
+
 	if (m_lastMessageInserted == msg) {
 		m_lastMessageInserted = msg->getNext();
 	}
@@ -120,13 +127,41 @@ void NetCommandList::reset() {
 	}
 	m_last = NULL;
 	m_lastMessageInserted = NULL;
+	m_count = 0;
+
+	if (m_index != NULL) {
+		delete m_index;
+		m_index = NULL;
+	}
+}
+
+/**
+ * Add msg to the list in its properly ordered place and keep the index up to date.
+ */
+NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
+	NetCommandRef *msg = insertMessage(cmdMsg);
+	if (msg == NULL) {
+		return NULL;
+	}
+
+	++m_count;
+	if (m_index != NULL) {
+		indexMessage(msg);
+	} else if (m_count >= NET_COMMAND_LIST_INDEX_THRESHOLD) {
+		m_index = new Index;
+		for (NetCommandRef *ref = m_first; ref != NULL; ref = ref->getNext()) {
+			indexMessage(ref);
+		}
+	}
+
+	return msg;
 }
 
 /**
  * Insert sorts msg.  Assumes that all the previous message inserts were done using this function.
  * The message is sorted in based first on command type, then player id, and then command id.
  */
-NetCommandRef * NetCommandList::addMessage(NetCommandMsg *cmdMsg) {
+NetCommandRef * NetCommandList::insertMessage(NetCommandMsg *cmdMsg) {
 	if (cmdMsg == NULL) {
 		DEBUG_ASSERTCRASH(cmdMsg != NULL, ("NetCommandList::addMessage - command message was NULL"));
 		return NULL;
@@ -350,6 +385,11 @@ Int NetCommandList::length() {
  * there shouldn't be too many messages for any given frame.
  */
 NetCommandRef * NetCommandList::findMessage(NetCommandMsg *msg) {
+	if (DoesCommandRequireACommandID(msg->getNetCommandType())) {
+		// Messages that require a command id are equal exactly when the player id and command id match.
+		return findMessage(msg->getID(), msg->getPlayerID());
+	}
+
 	NetCommandRef *retval = m_first;
 	while ((retval != NULL) && (isEqualCommandMsg(retval->getCommand(), msg) == FALSE)) {
 		retval = retval->getNext();
@@ -358,6 +398,15 @@ NetCommandRef * NetCommandList::findMessage(NetCommandMsg *msg) {
 }
 
 NetCommandRef * NetCommandList::findMessage(UnsignedShort commandID, UnsignedByte playerID) {
+	Bool found = FALSE;
+	NetCommandRef *indexed = findIndexedMessage(commandID, playerID, found);
+	if (found) {
+		if ((indexed != NULL) && !DoesCommandRequireACommandID(indexed->getCommand()->getNetCommandType())) {
+			indexed = NULL;
+		}
+		return indexed;
+	}
+
 	NetCommandRef *retval = m_first;
 	while (retval != NULL) {
 		if (DoesCommandRequireACommandID(retval->getCommand()->getNetCommandType())) {
@@ -370,6 +419,70 @@ NetCommandRef * NetCommandList::findMessage(UnsignedShort commandID, UnsignedByt
 	return retval;
 }
 
+NetCommandRef * NetCommandList::findMessageByID(UnsignedShort commandID, UnsignedByte playerID) {
+	Bool found = FALSE;
+	NetCommandRef *retval = findIndexedMessage(commandID, playerID, found);
+	if (found) {
+		return retval;
+	}
+
+	retval = m_first;
+	while ((retval != NULL) && ((retval->getCommand()->getID() != commandID) || (retval->getCommand()->getPlayerID() != playerID))) {
+		retval = retval->getNext();
+	}
+	return retval;
+}
+
+/**
+ * Look the key up in the index. found is set when the index gives a definite answer, which is either
+ * no message or the single message with this key. When several messages share the key, the caller
+ * has to walk the list to find the first one.
+ */
+NetCommandRef * NetCommandList::findIndexedMessage(UnsignedShort commandID, UnsignedInt playerID, Bool &found) {
+	found = FALSE;
+	if (m_index == NULL) {
+		return NULL;
+	}
+
+	Index::iterator it = m_index->find(getIndexKey(commandID, playerID));
+	if (it == m_index->end()) {
+		found = TRUE;
+		return NULL;
+	}
+
+	if (it->second.ref != NULL) {
+		found = TRUE;
+		return it->second.ref;
+	}
+
+	return NULL;
+}
+
+void NetCommandList::indexMessage(NetCommandRef *msg) {
+	IndexEntry &entry = (*m_index)[getIndexKey(msg->getCommand()->getID(), msg->getCommand()->getPlayerID())];
+	if (entry.count == 0) {
+		entry.ref = msg;
+	} else {
+		entry.ref = NULL;
+	}
+	++entry.count;
+}
+
+void NetCommandList::unindexMessage(NetCommandRef *msg) {
+	Index::iterator it = m_index->find(getIndexKey(msg->getCommand()->getID(), msg->getCommand()->getPlayerID()));
+	if (it == m_index->end()) {
+		DEBUG_CRASH(("NetCommandList::unindexMessage - message is not in the index"));
+		return;
+	}
+
+	if (--it->second.count == 0) {
+		m_index->erase(it);
+	} else {
+		// The one that is left is not known here; lookups walk the list for it.
+		it->second.ref = NULL;
+	}
+}
+
 Bool NetCommandList::isEqualCommandMsg(NetCommandMsg *msg1, NetCommandMsg *msg2) {
 	if (DoesCommandRequireACommandID(msg1->getNetCommandType()) != DoesCommandRequireACommandID(msg2->getNetCommandType())) {
 		return FALSE;
@@ -102,9 +102,16 @@ void NetCommandWrapperListNode::copyChunkData(NetWrapperCommandMsg *msg) {
 		return;
 	}
 
-	m_chunksPresent[msg->getChunkNumber()] = TRUE;
 	UnsignedInt offset = msg->getDataOffset();
-	memcpy(m_data + offset, msg->getData(), msg->getDataLength());
+	UnsignedInt dataLength = msg->getDataLength();
+	if (dataLength > m_dataLength || offset > m_dataLength - dataLength) {
+		DEBUG_LOG(("NetCommandWrapperListNode::copyChunkData() - chunk %d at offset %d with length %d does not fit in %d bytes",
+			msg->getChunkNumber(), offset, dataLength, m_dataLength));
+		return;
+	}
+
+	m_chunksPresent[msg->getChunkNumber()] = TRUE;
+	memcpy(m_data + offset, msg->getData(), dataLength);
 	++m_numChunksPresent;
 }
 
@@ -185,11 +192,17 @@ NetCommandList * NetCommandWrapperList::getReadyCommands()
 		next = temp->m_next;
 		if (temp->isComplete()) {
 			NetCommandRef *msg = NetPacket::ConstructNetCommandMsgFromRawData(temp->getRawData(), temp->getRawDataLength());
-			NetCommandRef *ret = retlist->addMessage(msg->getCommand());
-			ret->setRelay(msg->getRelay());
-
-			deleteInstance(msg);
-			msg = NULL;
+			if (msg != NULL) {
+				NetCommandRef *ret = retlist->addMessage(msg->getCommand());
+				if (ret != NULL) {
+					ret->setRelay(msg->getRelay());
+				}
+
+				deleteInstance(msg);
+				msg = NULL;
+			} else {
+				DEBUG_LOG(("NetCommandWrapperList::getReadyCommands - discarding malformed wrapped command %d", temp->getCommandID()));
+			}
 
 			removeFromList(temp);
 			temp = NULL;
@@ -44,9 +44,185 @@ namespace NetPacketFieldTypes {
 	constexpr const NetPacketFieldType Data = 'D';				// Data payload field
 }
 
+// TheSuperHackers @performance Each command type is described once here: the header fields that precede its data,
+// in the order they are written, and the size of its data when that size is fixed. The encoder writes and sizes
+// all command headers from this table, and the decoder uses it to validate a command before reading its data.
+struct NetCommandLayout
+{
+	const char* headerFields;	///< NetPacketFieldTypes written before the data, NULL if the type is never sent
+	Int dataSize;				///< size of the data in bytes, or NET_COMMAND_DATA_SIZE_VARIABLE
+};
+
+enum { NET_COMMAND_DATA_SIZE_VARIABLE = -1 };
+
+static const NetCommandLayout s_netCommandLayouts[] =
+{
+	{ "TP",			sizeof(UnsignedShort) + sizeof(UnsignedByte) },							// NETCOMMANDTYPE_ACKBOTH
+	{ "TP",			sizeof(UnsignedShort) + sizeof(UnsignedByte) },							// NETCOMMANDTYPE_ACKSTAGE1
+	{ "TP",			sizeof(UnsignedShort) + sizeof(UnsignedByte) },							// NETCOMMANDTYPE_ACKSTAGE2
+	{ "TFRPC",	sizeof(UnsignedShort) },																// NETCOMMANDTYPE_FRAMEINFO
+	{ "TFRPC",	NET_COMMAND_DATA_SIZE_VARIABLE },												// NETCOMMANDTYPE_GAMECOMMAND
+	{ "TRFPC",	sizeof(UnsignedByte) },																	// NETCOMMANDTYPE_PLAYERLEAVE
+	{ "TRPC",		sizeof(Real) + sizeof(UnsignedShort) },									// NETCOMMANDTYPE_RUNAHEADMETRICS
+	{ "TRFPC",	sizeof(UnsignedShort) + sizeof(UnsignedByte) },							// NETCOMMANDTYPE_RUNAHEAD
+	{ "TRFPC",	sizeof(UnsignedInt) },																	// NETCOMMANDTYPE_DESTROYPLAYER
+	{ "TRP",		0 },																										// NETCOMMANDTYPE_KEEPALIVE
+	{ "TRP",		NET_COMMAND_DATA_SIZE_VARIABLE },												// NETCOMMANDTYPE_DISCONNECTCHAT
+	{ "TFRPC",	NET_COMMAND_DATA_SIZE_VARIABLE },												// NETCOMMANDTYPE_CHAT
+	{ NULL,			0 },																										// NETCOMMANDTYPE_MANGLERQUERY
+	{ NULL,			0 },																										// NETCOMMANDTYPE_MANGLERRESPONSE
+	{ "TRP",		sizeof(UnsignedByte) },																	// NETCOMMANDTYPE_PROGRESS
+	{ "TRPC",		0 },																										// NETCOMMANDTYPE_LOADCOMPLETE
+	{ "TRPC",		0 },																										// NETCOMMANDTYPE_TIMEOUTSTART
+	{ "TRPC",		NET_COMMAND_DATA_SIZE_VARIABLE },												// NETCOMMANDTYPE_WRAPPER
+	{ "TRPC",		NET_COMMAND_DATA_SIZE_VARIABLE },												// NETCOMMANDTYPE_FILE
+	{ "TRPC",		NET_COMMAND_DATA_SIZE_VARIABLE },												// NETCOMMANDTYPE_FILEANNOUNCE
+	{ "TRPC",		sizeof(UnsignedShort) + sizeof(Int) },									// NETCOMMANDTYPE_FILEPROGRESS
+	{ "TFRPC",	sizeof(UnsignedInt) },																	// NETCOMMANDTYPE_FRAMERESENDREQUEST
+	{ NULL,			0 },																										// NETCOMMANDTYPE_DISCONNECTSTART
+	{ "TRP",		0 },																										// NETCOMMANDTYPE_DISCONNECTKEEPALIVE
+	{ "TRPC",		sizeof(UnsignedByte) + sizeof(UnsignedInt) },						// NETCOMMANDTYPE_DISCONNECTPLAYER
+	{ "TRP",		0 },																										// NETCOMMANDTYPE_PACKETROUTERQUERY
+	{ "TRP",		0 },																										// NETCOMMANDTYPE_PACKETROUTERACK
+	{ "TRPC",		sizeof(UnsignedByte) + sizeof(UnsignedInt) },						// NETCOMMANDTYPE_DISCONNECTVOTE
+	{ "TFRPC",	sizeof(UnsignedInt) },																	// NETCOMMANDTYPE_DISCONNECTFRAME
+	{ "TFRPC",	sizeof(UnsignedInt) },																	// NETCOMMANDTYPE_DISCONNECTSCREENOFF
+	{ NULL,			0 },																										// NETCOMMANDTYPE_DISCONNECTEND
+};
+static_assert(ARRAY_SIZE(s_netCommandLayouts) == NETCOMMANDTYPE_DISCONNECTEND + 1, "Incorrect array size");
+
+static const NetCommandLayout* getNetCommandLayout(Int commandType)
+{
+	if (commandType < 0 || commandType >= ARRAY_SIZE(s_netCommandLayouts))
+		return NULL;
+	if (s_netCommandLayouts[commandType].headerFields == NULL)
+		return NULL;
+	return &s_netCommandLayouts[commandType];
+}
+
+// Returns the size of the value that follows the given field marker.
+static Int getFieldValueSize(UnsignedByte field)
+{
+	switch (field)
+	{
+		case NetPacketFieldTypes::CommandType: return sizeof(UnsignedByte);
+		case NetPacketFieldTypes::Relay: return sizeof(UnsignedByte);
+		case NetPacketFieldTypes::PlayerId: return sizeof(UnsignedByte);
+		case NetPacketFieldTypes::CommandId: return sizeof(UnsignedShort);
+		case NetPacketFieldTypes::Frame: return sizeof(UnsignedInt);
+	}
+	return 0;
+}
+
+static Int getGameMessageArgumentSize(GameMessageArgumentDataType type)
+{
+	switch (type)
+	{
+		case ARGUMENTDATATYPE_INTEGER: return sizeof(Int);
+		case ARGUMENTDATATYPE_REAL: return sizeof(Real);
+		case ARGUMENTDATATYPE_BOOLEAN: return sizeof(Bool);
+		case ARGUMENTDATATYPE_OBJECTID: return sizeof(ObjectID);
+		case ARGUMENTDATATYPE_DRAWABLEID: return sizeof(DrawableID);
+		case ARGUMENTDATATYPE_TEAMID: return sizeof(UnsignedInt);
+		case ARGUMENTDATATYPE_LOCATION: return sizeof(Coord3D);
+		case ARGUMENTDATATYPE_PIXEL: return sizeof(ICoord2D);
+		case ARGUMENTDATATYPE_PIXELREGION: return sizeof(IRegion2D);
+		case ARGUMENTDATATYPE_TIMESTAMP: return sizeof(UnsignedInt);
+		case ARGUMENTDATATYPE_WIDECHAR: return sizeof(WideChar);
+		default: return 0;
+	}
+}
+
+/**
+ * Returns the number of bytes the data of a command of the given type occupies at offset, or -1 if the type
+ * is unknown or the data does not fit in length. Peers are not trusted, so this must be checked before the
+ * data is handed to one of the read functions.
+ */
+static Int getCommandDataSize(Int commandType, const UnsignedByte* data, Int offset, Int length)
+{
+	const NetCommandLayout* layout = getNetCommandLayout(commandType);
+	if (layout == NULL || offset > length)
+		return -1;
+
+	const Int available = length - offset;
+	const UnsignedByte* p = data + offset;
+	Int size = layout->dataSize;
+
+	switch (commandType)
+	{
+		case NETCOMMANDTYPE_GAMECOMMAND:
+		{
+			size = sizeof(GameMessage::Type) + sizeof(UnsignedByte);
+			if (size > available)
+				return -1;
+			const Int numArgTypes = p[sizeof(GameMessage::Type)];
+			const UnsignedByte* argTypes = p + size;
+			if (size + numArgTypes * 2 > available)
+				return -1;
+			for (Int j = 0; j < numArgTypes; ++j)
+			{
+				const UnsignedByte type = argTypes[j * 2];
+				const UnsignedByte argCount = argTypes[j * 2 + 1];
+				// readGameMessage cannot step past an empty argument type, so such a message is malformed.
+				if (argCount == 0)
+					return -1;
+				size += argCount * getGameMessageArgumentSize((GameMessageArgumentDataType)type);
+			}
+			size += numArgTypes * 2;
+			break;
+		}
+		case NETCOMMANDTYPE_DISCONNECTCHAT:
+		case NETCOMMANDTYPE_CHAT:
+			if (available < (Int)sizeof(UnsignedByte))
+				return -1;
+			size = sizeof(UnsignedByte) + p[0] * sizeof(WideChar);
+			if (commandType == NETCOMMANDTYPE_CHAT)
+				size += sizeof(Int);
+			break;
+		case NETCOMMANDTYPE_WRAPPER:
+		{
+			size = sizeof(UnsignedShort) + 5 * sizeof(UnsignedInt);
+			if (size > available)
+				return -1;
+			UnsignedInt dataLength;
+			memcpy(&dataLength, p + sizeof(UnsignedShort) + 3 * sizeof(UnsignedInt), sizeof(dataLength));
+			if (dataLength > (UnsignedInt)(available - size))
+				return -1;
+			size += dataLength;
+			break;
+		}
+		case NETCOMMANDTYPE_FILE:
+		case NETCOMMANDTYPE_FILEANNOUNCE:
+		{
+			const UnsignedByte* end = (const UnsignedByte*)memchr(p, 0, available);
+			if (end == NULL)
+				return -1;
+			size = (Int)(end - p) + 1;
+			if (commandType == NETCOMMANDTYPE_FILEANNOUNCE)
+			{
+				size += sizeof(UnsignedShort) + sizeof(UnsignedByte);
+				break;
+			}
+			if (size + (Int)sizeof(UnsignedInt) > available)
+				return -1;
+			UnsignedInt dataLength;
+			memcpy(&dataLength, p + size, sizeof(dataLength));
+			size += sizeof(UnsignedInt);
+			if (dataLength > (UnsignedInt)(available - size))
+				return -1;
+			size += dataLength;
+			break;
+		}
+	}
+
+	if (size > available)
+		return -1;
+	return size;
+}
+
 // This function assumes that all of the fields are either of default value or are
 // present in the raw data.
-NetCommandRef* NetPacket::ConstructNetCommandMsgFromRawData(UnsignedByte* data, UnsignedShort dataLength) {
+NetCommandRef* NetPacket::ConstructNetCommandMsgFromRawData(UnsignedByte* data, UnsignedInt dataLength) {
 	NetCommandType commandType = NETCOMMANDTYPE_GAMECOMMAND;
 	UnsignedShort commandID = 0;
 	UnsignedInt frame = 0;
@@ -59,6 +235,11 @@ NetCommandRef* NetPacket::ConstructNetCommandMsgFromRawData(UnsignedByte* data,
 
 	while (offset < (Int)dataLength) {
 
+		if (offset + 1 + getFieldValueSize(data[offset]) > (Int)dataLength) {
+			DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::ConstructNetCommandMsgFromRawData - field at index %d is cut off", offset));
+			break;
+		}
+
 		switch (data[offset]) {
 
 		case NetPacketFieldTypes::CommandType:
@@ -91,9 +272,16 @@ NetCommandRef* NetPacket::ConstructNetCommandMsgFromRawData(UnsignedByte* data,
 			offset += sizeof(UnsignedInt);
 			break;
 
-		case NetPacketFieldTypes::Data:
+		case NetPacketFieldTypes::Data: {
 			++offset;
 
+			const Int dataSize = getCommandDataSize(commandType, data, offset, dataLength);
+			if (dataSize < 0) {
+				DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::ConstructNetCommandMsgFromRawData - command of type %d is unknown or cut off", commandType));
+				return NULL;
+			}
+			const Int dataEnd = offset + dataSize;
+
 			switch (commandType) {
 
 			case NETCOMMANDTYPE_GAMECOMMAND:
@@ -180,6 +368,13 @@ NetCommandRef* NetPacket::ConstructNetCommandMsgFromRawData(UnsignedByte* data,
 
 			}
 
+			if (offset != dataEnd) {
+				DEBUG_CRASH(("Command of type %d read %d bytes, expected %d", commandType, offset + dataSize - dataEnd, dataSize));
+			}
+			if (msg == NULL) {
+				return NULL;
+			}
+
 			msg->setExecutionFrame(frame);
 			msg->setID(commandID);
 			msg->setPlayerID(playerID);
@@ -193,7 +388,12 @@ NetCommandRef* NetPacket::ConstructNetCommandMsgFromRawData(UnsignedByte* data,
 			msg = NULL;
 
 			return ref;
+		}
 
+		default:
+			// Stop at anything that is not a field, the rest of the data cannot be trusted.
+			DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::ConstructNetCommandMsgFromRawData - unrecognized entry at index %d", offset));
+			return NULL;
 		}
 
 	}
@@ -2127,75 +2327,141 @@ Bool NetPacket::addCommand(NetCommandRef* msg) {
 	return TRUE;
 }
 
-/*
-T = Net command type
-F = Execution frame
-P = Player ID
-C = Command ID
-R = Relay
-D = Command Data
-Z = Repeat last command
-*/
-Bool NetPacket::addFrameResendRequestCommand(NetCommandRef* msg) {
+/**
+ * Writes the header fields of this command that differ from the previous command, as listed
+ * in the layout of its command type, followed by the start of its data.
+ */
+void NetPacket::writeCommandHeader(NetCommandRef* msg) {
+	NetCommandMsg* cmdMsg = msg->getCommand();
+	const NetCommandLayout* layout = getNetCommandLayout(cmdMsg->getNetCommandType());
+	DEBUG_ASSERTCRASH(layout != NULL, ("No layout for NETCOMMANDTYPE %d", cmdMsg->getNetCommandType()));
+
 	Bool needNewCommandID = FALSE;
-	if (isRoomForFrameResendRequestMessage(msg)) {
-		NetFrameResendRequestCommandMsg* cmdMsg = (NetFrameResendRequestCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
+	for (const char* field = layout->headerFields; *field != 0; ++field) {
+		switch ((NetPacketFieldType)*field) {
 
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
+		case NetPacketFieldTypes::CommandType:
+			if (m_lastCommandType != cmdMsg->getNetCommandType()) {
+				m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
+				++m_packetLen;
+				m_packet[m_packetLen] = cmdMsg->getNetCommandType();
+				m_packetLen += sizeof(UnsignedByte);
 
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
+				m_lastCommandType = cmdMsg->getNetCommandType();
+			}
+			break;
 
-			m_lastFrame = newframe;
-		}
+		case NetPacketFieldTypes::Frame:
+			if (m_lastFrame != cmdMsg->getExecutionFrame()) {
+				m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
+				++m_packetLen;
+				UnsignedInt newframe = cmdMsg->getExecutionFrame();
+				memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
+				m_packetLen += sizeof(UnsignedInt);
+
+				m_lastFrame = newframe;
+			}
+			break;
+
+		case NetPacketFieldTypes::Relay:
+			if (m_lastRelay != msg->getRelay()) {
+				m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
+				++m_packetLen;
+				UnsignedByte newRelay = msg->getRelay();
+				memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
+				m_packetLen += sizeof(UnsignedByte);
+
+				m_lastRelay = newRelay;
+			}
+			break;
 
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
+		case NetPacketFieldTypes::PlayerId:
+			if (m_lastPlayerID != cmdMsg->getPlayerID()) {
+				m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
+				++m_packetLen;
+				m_packet[m_packetLen] = cmdMsg->getPlayerID();
+				m_packetLen += sizeof(UnsignedByte);
+
+				m_lastPlayerID = cmdMsg->getPlayerID();
+				// A new player has to respecify the starting command ID.
+				needNewCommandID = TRUE;
+			}
+			break;
 
-			m_lastRelay = newRelay;
+		case NetPacketFieldTypes::CommandId:
+			if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
+				m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
+				++m_packetLen;
+				UnsignedShort newID = cmdMsg->getID();
+				memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
+				m_packetLen += sizeof(UnsignedShort);
+			}
+			m_lastCommandID = cmdMsg->getID();
+			break;
 		}
+	}
+
+	m_packet[m_packetLen] = NetPacketFieldTypes::Data;
+	++m_packetLen;
+}
+
+/**
+ * Returns the number of bytes writeCommandHeader would write for this command.
+ */
+Int NetPacket::getCommandHeaderLength(NetCommandRef* msg) const {
+	NetCommandMsg* cmdMsg = msg->getCommand();
+	const NetCommandLayout* layout = getNetCommandLayout(cmdMsg->getNetCommandType());
+	DEBUG_ASSERTCRASH(layout != NULL, ("No layout for NETCOMMANDTYPE %d", cmdMsg->getNetCommandType()));
 
-		// If necessary put the player ID into the packet.
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
+	Int len = 0;
+	Bool needNewCommandID = FALSE;
 
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
+	for (const char* field = layout->headerFields; *field != 0; ++field) {
+		Bool present = FALSE;
+
+		switch ((NetPacketFieldType)*field) {
+		case NetPacketFieldTypes::CommandType:
+			present = m_lastCommandType != cmdMsg->getNetCommandType();
+			break;
+		case NetPacketFieldTypes::Frame:
+			present = m_lastFrame != cmdMsg->getExecutionFrame();
+			break;
+		case NetPacketFieldTypes::Relay:
+			present = m_lastRelay != msg->getRelay();
+			break;
+		case NetPacketFieldTypes::PlayerId:
+			present = m_lastPlayerID != cmdMsg->getPlayerID();
+			needNewCommandID = present;
+			break;
+		case NetPacketFieldTypes::CommandId:
+			present = ((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE);
+			break;
 		}
 
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
+		if (present) {
+			len += sizeof(UnsignedByte) + getFieldValueSize(*field);
 		}
-		m_lastCommandID = cmdMsg->getID();
+	}
 
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+	++len; // for NetPacketFieldTypes::Data
+	return len;
+}
+
+/*
+T = Net command type
+F = Execution frame
+P = Player ID
+C = Command ID
+R = Relay
+D = Command Data
+Z = Repeat last command
+*/
+Bool NetPacket::addFrameResendRequestCommand(NetCommandRef* msg) {
+	if (isRoomForFrameResendRequestMessage(msg)) {
+		NetFrameResendRequestCommandMsg* cmdMsg = (NetFrameResendRequestCommandMsg*)(msg->getCommand());
+
+		writeCommandHeader(msg);
 
 		UnsignedInt frameToResend = cmdMsg->getFrameToResend();
 		memcpy(m_packet + m_packetLen, &frameToResend, sizeof(frameToResend));
@@ -2215,29 +2481,8 @@ Bool NetPacket::addFrameResendRequestCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForFrameResendRequestMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetFrameResendRequestCommandMsg* cmdMsg = (NetFrameResendRequestCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		len += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // for NetPacketFieldTypes::Data
 	len += sizeof(UnsignedInt); // for the frame to be resent
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
@@ -2246,65 +2491,10 @@ Bool NetPacket::isRoomForFrameResendRequestMessage(NetCommandRef* msg) {
 }
 
 Bool NetPacket::addDisconnectScreenOffCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForDisconnectScreenOffMessage(msg)) {
 		NetDisconnectScreenOffCommandMsg* cmdMsg = (NetDisconnectScreenOffCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary put the player ID into the packet.
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		UnsignedInt newFrame = cmdMsg->getNewFrame();
 		memcpy(m_packet + m_packetLen, &newFrame, sizeof(newFrame));
@@ -2324,29 +2514,8 @@ Bool NetPacket::addDisconnectScreenOffCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForDisconnectScreenOffMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetDisconnectScreenOffCommandMsg* cmdMsg = (NetDisconnectScreenOffCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		len += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // for NetPacketFieldTypes::Data
 	len += sizeof(UnsignedInt); // for the disconnect frame
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
@@ -2355,65 +2524,10 @@ Bool NetPacket::isRoomForDisconnectScreenOffMessage(NetCommandRef* msg) {
 }
 
 Bool NetPacket::addDisconnectFrameCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForDisconnectFrameMessage(msg)) {
 		NetDisconnectFrameCommandMsg* cmdMsg = (NetDisconnectFrameCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary put the player ID into the packet.
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		UnsignedInt disconnectFrame = cmdMsg->getDisconnectFrame();
 		memcpy(m_packet + m_packetLen, &disconnectFrame, sizeof(disconnectFrame));
@@ -2433,29 +2547,8 @@ Bool NetPacket::addDisconnectFrameCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForDisconnectFrameMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetDisconnectFrameCommandMsg* cmdMsg = (NetDisconnectFrameCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		len += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // for NetPacketFieldTypes::Data
 	len += sizeof(UnsignedInt); // for the disconnect frame
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
@@ -2464,55 +2557,10 @@ Bool NetPacket::isRoomForDisconnectFrameMessage(NetCommandRef* msg) {
 }
 
 Bool NetPacket::addFileCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForFileMessage(msg)) {
 		NetFileCommandMsg* cmdMsg = (NetFileCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary put the player ID into the packet.
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		AsciiString filename = cmdMsg->getPortableFilename();		// PORTABLE
 		strcpy((char*)(m_packet + m_packetLen), filename.str());
@@ -2536,24 +2584,9 @@ Bool NetPacket::addFileCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForFileMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
 	NetFileCommandMsg* cmdMsg = (NetFileCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedShort);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // NetPacketFieldTypes::Data
 	len += cmdMsg->getPortableFilename().getLength() + 1; // PORTABLE filename + the terminating 0
 	len += sizeof(UnsignedInt); // filedata length
 	len += cmdMsg->getFileLength();
@@ -2566,55 +2599,10 @@ Bool NetPacket::isRoomForFileMessage(NetCommandRef* msg) {
 }
 
 Bool NetPacket::addFileAnnounceCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForFileAnnounceMessage(msg)) {
 		NetFileAnnounceCommandMsg* cmdMsg = (NetFileAnnounceCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary put the player ID into the packet.
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		AsciiString filename = cmdMsg->getPortableFilename();	// PORTABLE
 		strcpy((char*)(m_packet + m_packetLen), filename.str());
@@ -2643,24 +2631,9 @@ Bool NetPacket::addFileAnnounceCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForFileAnnounceMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
 	NetFileAnnounceCommandMsg* cmdMsg = (NetFileAnnounceCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedShort);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // NetPacketFieldTypes::Data
 	len += cmdMsg->getPortableFilename().getLength() + 1; // PORTABLE filename + the terminating 0
 	len += sizeof(UnsignedShort); // m_fileID
 	len += sizeof(UnsignedByte); // m_playerMask
@@ -2673,55 +2646,10 @@ Bool NetPacket::isRoomForFileAnnounceMessage(NetCommandRef* msg) {
 }
 
 Bool NetPacket::addFileProgressCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForFileProgressMessage(msg)) {
 		NetFileProgressCommandMsg* cmdMsg = (NetFileProgressCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary put the player ID into the packet.
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		UnsignedShort fileID = cmdMsg->getFileID();
 		memcpy(m_packet + m_packetLen, &fileID, sizeof(fileID));
@@ -2743,24 +2671,8 @@ Bool NetPacket::addFileProgressCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForFileProgressMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetFileProgressCommandMsg* cmdMsg = (NetFileProgressCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedShort);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // NetPacketFieldTypes::Data
 	len += sizeof(UnsignedShort); // m_fileID
 	len += sizeof(Int); // m_progress
 
@@ -2772,55 +2684,10 @@ Bool NetPacket::isRoomForFileProgressMessage(NetCommandRef* msg) {
 }
 
 Bool NetPacket::addWrapperCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForWrapperMessage(msg)) {
 		NetWrapperCommandMsg* cmdMsg = (NetWrapperCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary put the player ID into the packet.
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		// wrapped command ID
 		UnsignedShort wrappedCommandID = cmdMsg->getWrappedCommandID();
@@ -2873,24 +2740,9 @@ Bool NetPacket::addWrapperCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForWrapperMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
 	NetWrapperCommandMsg* cmdMsg = (NetWrapperCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedShort);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // NetPacketFieldTypes::Data
 	len += sizeof(UnsignedShort); // wrapped command ID
 	len += sizeof(UnsignedInt); // chunk number
 	len += sizeof(UnsignedInt); // number of chunks
@@ -2910,53 +2762,8 @@ Bool NetPacket::isRoomForWrapperMessage(NetCommandRef* msg) {
  * Add a TimeOutGameStart  to the packet. Returns true if successful.
  */
 Bool NetPacket::addTimeOutGameStartMessage(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForLoadCompleteMessage(msg)) {
-		NetCommandMsg* cmdMsg = (NetCommandMsg*)(msg->getCommand());
-
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		++m_numCommands;
 
@@ -2975,21 +2782,8 @@ Bool NetPacket::addTimeOutGameStartMessage(NetCommandRef* msg) {
  * Returns true if there is room in the packet for this command.
  */
 Bool NetPacket::isRoomForTimeOutGameStartMessage(NetCommandRef* msg) {
-	Int len = 0;
-	NetCommandMsg* cmdMsg = (NetCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // For the NetPacketFieldTypes::Data
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
 	}
@@ -3002,53 +2796,8 @@ Bool NetPacket::isRoomForTimeOutGameStartMessage(NetCommandRef* msg) {
  * Add a Progress command to the packet. Returns true if successful.
  */
 Bool NetPacket::addLoadCompleteMessage(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForLoadCompleteMessage(msg)) {
-		NetCommandMsg* cmdMsg = (NetCommandMsg*)(msg->getCommand());
-
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		++m_numCommands;
 
@@ -3067,21 +2816,8 @@ Bool NetPacket::addLoadCompleteMessage(NetCommandRef* msg) {
  * Returns true if there is room in the packet for this command.
  */
 Bool NetPacket::isRoomForLoadCompleteMessage(NetCommandRef* msg) {
-	Int len = 0;
-	NetCommandMsg* cmdMsg = (NetCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // For the NetPacketFieldTypes::Data
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
 	}
@@ -3098,38 +2834,7 @@ Bool NetPacket::addProgressMessage(NetCommandRef* msg) {
 	if (isRoomForProgressMessage(msg)) {
 		NetProgressCommandMsg* cmdMsg = (NetProgressCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-		}
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		m_packet[m_packetLen] = cmdMsg->getPercentage();
 		++m_packetLen;
@@ -3151,21 +2856,8 @@ Bool NetPacket::addProgressMessage(NetCommandRef* msg) {
  * Returns true if there is room in the packet for this command.
  */
 Bool NetPacket::isRoomForProgressMessage(NetCommandRef* msg) {
-	Int len = 0;
-	NetProgressCommandMsg* cmdMsg = (NetProgressCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // For the NetPacketFieldTypes::Data
 	++len; // percentage
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
@@ -3176,7 +2868,6 @@ Bool NetPacket::isRoomForProgressMessage(NetCommandRef* msg) {
 
 
 Bool NetPacket::addDisconnectVoteCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 
 	//	DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addDisconnectVoteCommand - entering..."));
 		//  need type, player id, relay, command id, slot number
@@ -3184,55 +2875,8 @@ Bool NetPacket::addDisconnectVoteCommand(NetCommandRef* msg) {
 		NetDisconnectVoteCommandMsg* cmdMsg = (NetDisconnectVoteCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addDisconnectVoteCommand - adding run ahead command"));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-				// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("command id = %d", m_lastCommandID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		UnsignedByte slot = cmdMsg->getSlot();
 		memcpy(m_packet + m_packetLen, &slot, sizeof(slot));
 		m_packetLen += sizeof(slot);
@@ -3257,26 +2901,8 @@ Bool NetPacket::addDisconnectVoteCommand(NetCommandRef* msg) {
  * Returns true if there is room for this player disconnect command in this packet.
  */
 Bool NetPacket::isRoomForDisconnectVoteMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetDisconnectVoteCommandMsg* cmdMsg = (NetDisconnectVoteCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // the NetPacketFieldTypes::Data
 	len += sizeof(UnsignedByte); // slot number
 	len += sizeof(UnsignedInt); // vote frame
 
@@ -3294,42 +2920,8 @@ Bool NetPacket::addDisconnectChatCommand(NetCommandRef* msg) {
 		NetDisconnectChatCommandMsg* cmdMsg = (NetDisconnectChatCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addDisconnectChatCommand - adding run ahead command"));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-		}
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		UnicodeString unitext = cmdMsg->getText();
 		UnsignedByte length = unitext.getLength();
 		memcpy(m_packet + m_packetLen, &length, sizeof(UnsignedByte));
@@ -3351,21 +2943,9 @@ Bool NetPacket::addDisconnectChatCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForDisconnectChatMessage(NetCommandRef* msg) {
-	Int len = 0;
 	NetDisconnectChatCommandMsg* cmdMsg = (NetDisconnectChatCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // the NetPacketFieldTypes::Data
 	len += sizeof(UnsignedByte); // string length
 	UnsignedByte textLen = cmdMsg->getText().getLength();
 	len += textLen * sizeof(UnsignedShort);
@@ -3376,71 +2956,12 @@ Bool NetPacket::isRoomForDisconnectChatMessage(NetCommandRef* msg) {
 }
 
 Bool NetPacket::addChatCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForChatMessage(msg)) {
 		NetChatCommandMsg* cmdMsg = (NetChatCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addDisconnectChatCommand - adding run ahead command"));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-				// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("command id = %d", m_lastCommandID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		UnicodeString unitext = cmdMsg->getText();
 		UnsignedByte length = unitext.getLength();
 		Int playerMask = cmdMsg->getPlayerMask();
@@ -3466,29 +2987,9 @@ Bool NetPacket::addChatCommand(NetCommandRef* msg) {
 }
 
 Bool NetPacket::isRoomForChatMessage(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
-	Int len = 0;
 	NetChatCommandMsg* cmdMsg = (NetChatCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		len += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // the NetPacketFieldTypes::Data
 	len += sizeof(UnsignedByte); // string length
 	UnsignedByte textLen = cmdMsg->getText().getLength();
 	len += textLen * sizeof(UnsignedShort);
@@ -3502,46 +3003,11 @@ Bool NetPacket::isRoomForChatMessage(NetCommandRef* msg) {
 Bool NetPacket::addPacketRouterAckCommand(NetCommandRef* msg) {
 	//  need type, player id, relay, command id, slot number
 	if (isRoomForPacketRouterAckMessage(msg)) {
-		NetPacketRouterAckCommandMsg* cmdMsg = (NetPacketRouterAckCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addPacketRouterAckCommand - adding packet router query command"));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-		}
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
 
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
-
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket - added packet router ack command, player id %d", m_lastPlayerID));
 
 		++m_numCommands;
@@ -3558,21 +3024,8 @@ Bool NetPacket::addPacketRouterAckCommand(NetCommandRef* msg) {
  * Returns true if there is room for this packet router ack command in this packet.
  */
 Bool NetPacket::isRoomForPacketRouterAckMessage(NetCommandRef* msg) {
-	Int len = 0;
-	NetPacketRouterAckCommandMsg* cmdMsg = (NetPacketRouterAckCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // the NetPacketFieldTypes::Data
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
 	}
@@ -3582,46 +3035,11 @@ Bool NetPacket::isRoomForPacketRouterAckMessage(NetCommandRef* msg) {
 Bool NetPacket::addPacketRouterQueryCommand(NetCommandRef* msg) {
 	//  need type, player id, relay, command id, slot number
 	if (isRoomForPacketRouterQueryMessage(msg)) {
-		NetPacketRouterQueryCommandMsg* cmdMsg = (NetPacketRouterQueryCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addPacketRouterQueryCommand - adding packet router query command"));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-		}
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
 
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
-
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket - added packet router query command, player id %d", m_lastPlayerID));
 
 		++m_numCommands;
@@ -3638,21 +3056,8 @@ Bool NetPacket::addPacketRouterQueryCommand(NetCommandRef* msg) {
  * Returns true if there is room for this packet router query command in this packet.
  */
 Bool NetPacket::isRoomForPacketRouterQueryMessage(NetCommandRef* msg) {
-	Int len = 0;
-	NetPacketRouterQueryCommandMsg* cmdMsg = (NetPacketRouterQueryCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // the NetPacketFieldTypes::Data
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
 	}
@@ -3660,7 +3065,6 @@ Bool NetPacket::isRoomForPacketRouterQueryMessage(NetCommandRef* msg) {
 }
 
 Bool NetPacket::addDisconnectPlayerCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 
 	//	DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addDisconnectPlayerCommand - entering..."));
 		//  need type, player id, relay, command id, slot number
@@ -3668,55 +3072,8 @@ Bool NetPacket::addDisconnectPlayerCommand(NetCommandRef* msg) {
 		NetDisconnectPlayerCommandMsg* cmdMsg = (NetDisconnectPlayerCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addDisconnectPlayerCommand - adding run ahead command"));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-				// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("command id = %d", m_lastCommandID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		UnsignedByte slot = cmdMsg->getDisconnectSlot();
 		memcpy(m_packet + m_packetLen, &slot, sizeof(slot));
 		m_packetLen += sizeof(slot);
@@ -3741,26 +3098,8 @@ Bool NetPacket::addDisconnectPlayerCommand(NetCommandRef* msg) {
  * Returns true if there is room for this player disconnect command in this packet.
  */
 Bool NetPacket::isRoomForDisconnectPlayerMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetDisconnectPlayerCommandMsg* cmdMsg = (NetDisconnectPlayerCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // the NetPacketFieldTypes::Data
 	len += sizeof(UnsignedByte); // slot number
 	len += sizeof(UnsignedInt);	// disconnectFrame
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
@@ -3775,40 +3114,7 @@ Bool NetPacket::isRoomForDisconnectPlayerMessage(NetCommandRef* msg) {
  */
 Bool NetPacket::addDisconnectKeepAliveCommand(NetCommandRef* msg) {
 	if (isRoomForDisconnectKeepAliveMessage(msg)) {
-		NetDisconnectKeepAliveCommandMsg* cmdMsg = (NetDisconnectKeepAliveCommandMsg*)(msg->getCommand());
-
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-		}
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		++m_numCommands;
 
@@ -3827,21 +3133,8 @@ Bool NetPacket::addDisconnectKeepAliveCommand(NetCommandRef* msg) {
  * Returns true if there is room in the packet for this command.
  */
 Bool NetPacket::isRoomForDisconnectKeepAliveMessage(NetCommandRef* msg) {
-	Int len = 0;
-	NetDisconnectKeepAliveCommandMsg* cmdMsg = (NetDisconnectKeepAliveCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // For the NetPacketFieldTypes::Data
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
 	}
@@ -3853,40 +3146,7 @@ Bool NetPacket::isRoomForDisconnectKeepAliveMessage(NetCommandRef* msg) {
  */
 Bool NetPacket::addKeepAliveCommand(NetCommandRef* msg) {
 	if (isRoomForKeepAliveMessage(msg)) {
-		NetKeepAliveCommandMsg* cmdMsg = (NetKeepAliveCommandMsg*)(msg->getCommand());
-
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-		}
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		++m_numCommands;
 
@@ -3905,21 +3165,8 @@ Bool NetPacket::addKeepAliveCommand(NetCommandRef* msg) {
  * Returns true if there is room in the packet for this command.
  */
 Bool NetPacket::isRoomForKeepAliveMessage(NetCommandRef* msg) {
-	Int len = 0;
-	NetKeepAliveCommandMsg* cmdMsg = (NetKeepAliveCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // For the NetPacketFieldTypes::Data
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
 	}
@@ -3930,71 +3177,12 @@ Bool NetPacket::isRoomForKeepAliveMessage(NetCommandRef* msg) {
  * Add a run ahead command to the packet. Returns true if successful.
  */
 Bool NetPacket::addRunAheadCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForRunAheadMessage(msg)) {
 		NetRunAheadCommandMsg* cmdMsg = (NetRunAheadCommandMsg*)(msg->getCommand());
 		//DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addRunAheadCommand - adding run ahead command"));
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-				// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("command id = %d", m_lastCommandID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		UnsignedShort newRunAhead = cmdMsg->getRunAhead();
 		memcpy(m_packet + m_packetLen, &newRunAhead, sizeof(UnsignedShort));
 		m_packetLen += sizeof(UnsignedShort);
@@ -4019,29 +3207,8 @@ Bool NetPacket::addRunAheadCommand(NetCommandRef* msg) {
  * Returns true if there is room for this run ahead command in this packet.
  */
 Bool NetPacket::isRoomForRunAheadMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetRunAheadCommandMsg* cmdMsg = (NetRunAheadCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		len += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // for NetPacketFieldTypes::Data
 	len += sizeof(UnsignedShort);
 	len += sizeof(UnsignedByte);
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
@@ -4054,70 +3221,11 @@ Bool NetPacket::isRoomForRunAheadMessage(NetCommandRef* msg) {
  * Add a DestroyPlayer command to the packet. Returns true if successful.
  */
 Bool NetPacket::addDestroyPlayerCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForDestroyPlayerMessage(msg)) {
 		NetDestroyPlayerCommandMsg* cmdMsg = (NetDestroyPlayerCommandMsg*)(msg->getCommand());
 
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-				// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("command id = %d", m_lastCommandID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		UnsignedInt newVal = cmdMsg->getPlayerIndex();
 		memcpy(m_packet + m_packetLen, &newVal, sizeof(UnsignedInt));
 		m_packetLen += sizeof(UnsignedInt);
@@ -4138,29 +3246,8 @@ Bool NetPacket::addDestroyPlayerCommand(NetCommandRef* msg) {
  * Returns true if there is room for this DestroyPlayer command in this packet.
  */
 Bool NetPacket::isRoomForDestroyPlayerMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetDestroyPlayerCommandMsg* cmdMsg = (NetDestroyPlayerCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		len += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // for NetPacketFieldTypes::Data
 	len += sizeof(UnsignedInt);
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
@@ -4172,60 +3259,12 @@ Bool NetPacket::isRoomForDestroyPlayerMessage(NetCommandRef* msg) {
  * Add a run ahead metrics command to the packet. Returns true if successful.
  */
 Bool NetPacket::addRunAheadMetricsCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForRunAheadMetricsMessage(msg)) {
 		NetRunAheadMetricsCommandMsg* cmdMsg = (NetRunAheadMetricsCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addRunAheadMetricsCommand - adding run ahead metrics for player %d, fps = %d, latency = %f", cmdMsg->getPlayerID(), cmdMsg->getAverageFps(), cmdMsg->getAverageLatency()));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-				// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("command id = %d", m_lastCommandID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		// write the average latency
 		Real averageLatency = cmdMsg->getAverageLatency();
 		memcpy(m_packet + m_packetLen, &averageLatency, sizeof(averageLatency));
@@ -4249,26 +3288,8 @@ Bool NetPacket::addRunAheadMetricsCommand(NetCommandRef* msg) {
  * Returns true if there is enough room in the packet to fit this message.
  */
 Bool NetPacket::isRoomForRunAheadMetricsMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetRunAheadMetricsCommandMsg* cmdMsg = (NetRunAheadMetricsCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // NetPacketFieldTypes::Data
 	len += sizeof(UnsignedShort);
 	len += sizeof(Real);
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
@@ -4282,71 +3303,12 @@ Bool NetPacket::isRoomForRunAheadMetricsMessage(NetCommandRef* msg) {
  * Add a player leave command to the packet. Returns true if successful.
  */
 Bool NetPacket::addPlayerLeaveCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isRoomForPlayerLeaveMessage(msg)) {
 		NetPlayerLeaveCommandMsg* cmdMsg = (NetPlayerLeaveCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addPlayerLeaveCommand - adding player leave command for player %d", cmdMsg->getLeavingPlayerID()));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-				// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("command id = %d", m_lastCommandID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		UnsignedByte leavingPlayerID = cmdMsg->getLeavingPlayerID();
 		memcpy(m_packet + m_packetLen, &leavingPlayerID, sizeof(UnsignedByte));
 		m_packetLen += sizeof(UnsignedByte);
@@ -4365,29 +3327,8 @@ Bool NetPacket::addPlayerLeaveCommand(NetCommandRef* msg) {
  * Returns true if there is enough room in the packet to fit this message.
  */
 Bool NetPacket::isRoomForPlayerLeaveMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetPlayerLeaveCommandMsg* cmdMsg = (NetPlayerLeaveCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		len += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // for NetPacketFieldTypes::Data
 	len += sizeof(UnsignedByte);
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
@@ -4399,7 +3340,6 @@ Bool NetPacket::isRoomForPlayerLeaveMessage(NetCommandRef* msg) {
  * Add this frame command message. Returns true if successful.
  */
 Bool NetPacket::addFrameCommand(NetCommandRef* msg) {
-	Bool needNewCommandID = FALSE;
 	if (isFrameRepeat(msg)) {
 		if (m_packetLen >= MAX_PACKET_SIZE) {
 			return FALSE;
@@ -4420,66 +3360,8 @@ Bool NetPacket::addFrameCommand(NetCommandRef* msg) {
 		NetFrameCommandMsg* cmdMsg = (NetFrameCommandMsg*)(msg->getCommand());
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addFrameCommand - adding frame command for frame %d, command count = %d, command id = %d", cmdMsg->getExecutionFrame(), cmdMsg->getCommandCount(), cmdMsg->getID()));
 
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("relay = %d, ", m_lastRelay));
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-			needNewCommandID = TRUE;
-		}
-
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("player = %d", m_lastPlayerID));
-
-				// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
+		writeCommandHeader(msg);
 		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("command id = %d", m_lastCommandID));
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		UnsignedShort cmdCount = cmdMsg->getCommandCount();
 		memcpy(m_packet + m_packetLen, &cmdCount, sizeof(UnsignedShort));
 		m_packetLen += sizeof(UnsignedShort);
@@ -4501,29 +3383,8 @@ Bool NetPacket::addFrameCommand(NetCommandRef* msg) {
  * Returns true if there is enough room in this packet for this frame message.
  */
 Bool NetPacket::isRoomForFrameMessage(NetCommandRef* msg) {
-	Int len = 0;
-	Bool needNewCommandID = FALSE;
-	NetFrameCommandMsg* cmdMsg = (NetFrameCommandMsg*)(msg->getCommand());
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		len += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		len += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		len += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // for NetPacketFieldTypes::Data
 	len += sizeof(UnsignedShort);
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
 		return FALSE;
@@ -4597,30 +3458,8 @@ Bool NetPacket::addAckCommand(NetCommandRef* msg, UnsignedShort commandID, Unsig
 		return TRUE;
 	}
 	if (isRoomForAckMessage(msg)) {
-		NetCommandMsg* cmdMsg = msg->getCommand();
-		//		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addAckCommand - adding ack for command %d for player %d", cmdMsg->getCommandID(), msg->getCommand()->getPlayerID()));
-				// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-		}
-
+		writeCommandHeader(msg);
 		// Put in the command id of the command we are acking.
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
 		memcpy(m_packet + m_packetLen, &commandID, sizeof(UnsignedShort));
 		m_packetLen += sizeof(UnsignedShort);
 		memcpy(m_packet + m_packetLen, &originalPlayerID, sizeof(UnsignedByte));
@@ -4641,18 +3480,8 @@ Bool NetPacket::addAckCommand(NetCommandRef* msg, UnsignedShort commandID, Unsig
  * Returns true if there is enough room in the packet for this ack message.
  */
 Bool NetPacket::isRoomForAckMessage(NetCommandRef* msg) {
-	Int len = 0;
-	NetCommandMsg* cmdMsg = msg->getCommand();
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		++len;
-		len += sizeof(UnsignedByte);
-	}
+	Int len = getCommandHeaderLength(msg);
 
-	++len; // for NetPacketFieldTypes::Data
 	len += sizeof(UnsignedShort);
 	len += sizeof(UnsignedByte);
 	if ((len + m_packetLen) > MAX_PACKET_SIZE) {
@@ -4739,64 +3568,7 @@ Bool NetPacket::addGameCommand(NetCommandRef* msg) {
 	if (isRoomForGameMessage(msg, gmsg)) {
 		// Now we know there is enough room, put the new game message into the packet.
 
-		Bool needNewCommandID = FALSE; // this is to allow us to force the starting command ID to be respecified with this command.
-
-		// If necessary, put the NetCommandType into the packet.
-		if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandType;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getNetCommandType();
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastCommandType = cmdMsg->getNetCommandType();
-		}
-
-		// If necessary, put the execution frame into the packet.
-		if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Frame;
-			++m_packetLen;
-			UnsignedInt newframe = cmdMsg->getExecutionFrame();
-			memcpy(m_packet + m_packetLen, &newframe, sizeof(UnsignedInt));
-			m_packetLen += sizeof(UnsignedInt);
-
-			m_lastFrame = newframe;
-		}
-
-		// If necessary, put the relay into the packet.
-		if (m_lastRelay != msg->getRelay()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::Relay;
-			++m_packetLen;
-			UnsignedByte newRelay = msg->getRelay();
-			memcpy(m_packet + m_packetLen, &newRelay, sizeof(UnsignedByte));
-			m_packetLen += sizeof(UnsignedByte);
-
-			m_lastRelay = newRelay;
-		}
-
-		// If necessary, put the playerID into the packet.
-		if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::PlayerId;
-			++m_packetLen;
-			m_packet[m_packetLen] = cmdMsg->getPlayerID();
-			m_packetLen += sizeof(UnsignedByte);
-			//since if we have a new player we need to respecify the starting command ID, lets force the command id to be different.
-			needNewCommandID = TRUE;
-
-			m_lastPlayerID = cmdMsg->getPlayerID();
-		}
-
-		// If necessary, specify the command ID of this command.
-		if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-			m_packet[m_packetLen] = NetPacketFieldTypes::CommandId;
-			++m_packetLen;
-			UnsignedShort newID = cmdMsg->getID();
-			memcpy(m_packet + m_packetLen, &newID, sizeof(UnsignedShort));
-			m_packetLen += sizeof(UnsignedShort);
-		}
-		m_lastCommandID = cmdMsg->getID();
-
-		m_packet[m_packetLen] = NetPacketFieldTypes::Data;
-		++m_packetLen;
+		writeCommandHeader(msg);
 
 		// Now copy the GameMessage type into the packet.
 		GameMessage::Type newType = gmsg->getType();
@@ -4906,32 +3678,10 @@ void NetPacket::writeGameMessageArgumentToPacket(GameMessageArgumentDataType typ
  */
 Bool NetPacket::isRoomForGameMessage(NetCommandRef* msg, GameMessage* gmsg) {
 	// Calculate how much space the NetCommandMsg will take in this packet.
-	Int msglen = 0;
-
-	NetGameCommandMsg* cmdMsg = (NetGameCommandMsg*)(msg->getCommand());
-
-	Bool needNewCommandID = FALSE;
-
-	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
-		msglen += sizeof(UnsignedInt) + sizeof(UnsignedByte);
-	}
-	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
-		msglen += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-		needNewCommandID = TRUE;
-	}
-	if (m_lastRelay != msg->getRelay()) {
-		msglen += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
-		msglen += sizeof(UnsignedByte) + sizeof(UnsignedByte);
-	}
-	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
-		msglen += sizeof(UnsignedShort) + sizeof(UnsignedByte);
-	}
+	Int msglen = getCommandHeaderLength(msg);
 
 	GameMessageParser* parser = newInstance(GameMessageParser)(gmsg);
 
-	++msglen; // for NetPacketFieldTypes::Data
 	msglen += sizeof(GameMessage::Type);
 	msglen += sizeof(UnsignedByte);
 	//	Int numTypes = parser->getNumTypes();
@@ -5011,6 +3761,11 @@ NetCommandList* NetPacket::getCommandList() {
 	Int i = 0;
 	while (i < m_packetLen) {
 
+		if (i + 1 + getFieldValueSize(m_packet[i]) > m_packetLen) {
+			DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - field at index %d is cut off", i));
+			break;
+		}
+
 		switch (m_packet[i]) {
 
 		case NetPacketFieldTypes::CommandType:
@@ -5045,6 +3800,15 @@ NetCommandList* NetPacket::getCommandList() {
 
 			//DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList() - command of type %d(%s)", commandType, GetNetCommandTypeAsString((NetCommandType)commandType)));
 
+			// Nothing after a command that cannot be read can be trusted either, so stop reading the packet.
+			const Int dataSize = getCommandDataSize(commandType, m_packet, i, m_packetLen);
+			if (dataSize < 0) {
+				DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - command of type %d at index %d is unknown or cut off", commandType, i));
+				i = m_packetLen;
+				break;
+			}
+			const Int dataEnd = i + dataSize;
+
 			switch ((NetCommandType)commandType)
 			{
 			case NETCOMMANDTYPE_GAMECOMMAND:
@@ -5156,9 +3920,21 @@ NetCommandList* NetPacket::getCommandList() {
 				break;
 			}
 
+			// TheSuperHackers @bugfix The packet comes from a peer and cannot be trusted. A command that was
+			// not read to its expected end leaves the rest of the packet misaligned, so stop reading it.
+			if (i != dataEnd) {
+				DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - command of type %d read %d bytes, expected %d", commandType, i + dataSize - dataEnd, dataSize));
+				if (msg != NULL) {
+					msg->detach();
+				}
+				i = m_packetLen;
+				break;
+			}
+
 			if (msg == NULL) {
-				DEBUG_CRASH(("Didn't read a message from the packet. Things are about to go wrong."));
-				continue;
+				DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - didn't read a message of type %d from the packet", commandType));
+				i = m_packetLen;
+				break;
 			}
 
 			// set the info
@@ -5198,7 +3974,14 @@ NetCommandList* NetPacket::getCommandList() {
 			++i;
 			// Repeat the last command, doing some funky cool byte-saving stuff
 			if (lastCommand == NULL) {
-				DEBUG_CRASH(("Got a repeat command with no command to repeat."));
+				DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - got a repeat command with no command to repeat"));
+				break;
+			}
+
+			// TheSuperHackers @bugfix The last command is cast to the repeated type below, so it must be of that type.
+			if (lastCommand->getCommand()->getNetCommandType() != commandType) {
+				DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - repeat of type %d follows a command of type %d", commandType, lastCommand->getCommand()->getNetCommandType()));
+				break;
 			}
 
 			NetCommandMsg* msg = NULL;
@@ -5234,7 +4017,7 @@ NetCommandList* NetPacket::getCommandList() {
 				break;
 			}
 			default:
-				DEBUG_CRASH(("Trying to repeat a command that shouldn't be repeated."));
+				DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - trying to repeat a command of type %d that shouldn't be repeated", commandType));
 				continue;
 
 			}
@@ -5269,11 +4052,10 @@ NetCommandList* NetPacket::getCommandList() {
 		}
 
 		default:
-			// we don't recognize this command, but we have to increment i so we don't fall into an infinite loop.
-			DEBUG_CRASH(("Unrecognized packet entry, ignoring."));
+			// TheSuperHackers @bugfix An unrecognized field means the rest of the packet cannot be read, so stop reading it.
 			DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - Unrecognized packet entry at index %d", i));
 			dumpPacketToLog();
-			++i;
+			i = m_packetLen;
 			break;
 
 		}
@@ -5811,8 +4593,10 @@ NetCommandMsg* NetPacket::readFileMessage(UnsignedByte* data, Int& i) {
 	char* c = filename;
 
 	while (data[i] != 0) {
-		*c = data[i];
-		++c;
+		if (c < filename + _MAX_PATH - 1) {
+			*c = data[i];
+			++c;
+		}
 		++i;
 	}
 	*c = 0;
@@ -5838,8 +4622,10 @@ NetCommandMsg* NetPacket::readFileAnnounceMessage(UnsignedByte* data, Int& i) {
 	char* c = filename;
 
 	while (data[i] != 0) {
-		*c = data[i];
-		++c;
+		if (c < filename + _MAX_PATH - 1) {
+			*c = data[i];
+			++c;
+		}
 		++i;
 	}
 	*c = 0;
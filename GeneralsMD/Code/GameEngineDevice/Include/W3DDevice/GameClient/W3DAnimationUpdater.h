@@ -0,0 +1,94 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: W3DAnimationUpdater.h ////////////////////////////////////////////////////////////////////
+// Desc:   Updates the hierarchies of the drawn render objects on worker threads
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Lib/BaseType.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class HAnimClass;
+class HLodClass;
+class RenderObjClass;
+
+//-------------------------------------------------------------------------------------------------
+/** TheSuperHackers @performance The draw modules hand over the render objects they drew. Once all
+	* views are updated, the animation frames, bone transforms and bounding volumes of these render
+	* objects are brought up to date in batches on worker threads, so rendering finds them ready.
+	* Render objects that play the same compressed animation share its decompression caches, so they
+	* always go into the same batch. Everything not known to be safe off the main thread is left to
+	* rendering as before, and so is everything unless TheGlobalData->m_parallelAnimationUpdate is set. */
+//-------------------------------------------------------------------------------------------------
+class W3DAnimationUpdater
+{
+
+public:
+
+	W3DAnimationUpdater( void );
+	~W3DAnimationUpdater( void );
+
+	void addRenderObject( RenderObjClass *robj );		///< queue a render object that is drawn this frame
+	void update( void );														///< prepare the hierarchies of all queued render objects
+
+protected:
+
+	struct Item
+	{
+		HAnimClass *sharedMotion;			///< motion with caches shared between render objects, or NULL
+		HLodClass *hlod;
+	};
+
+	struct Batch
+	{
+		size_t begin;
+		size_t end;
+	};
+
+	static Bool canPrepareOnWorker( HLodClass *hlod );
+	static bool itemLess( const Item &a, const Item &b );
+	static bool itemEqual( const Item &a, const Item &b );
+	static bool batchLarger( const Batch &a, const Batch &b );
+
+	void buildBatches( void );
+	void prepareBatches( void );
+	void releaseQueue( void );
+	void run( void );
+
+	std::vector<RenderObjClass *> m_queue;
+	std::vector<Item> m_items;
+	std::vector<Batch> m_batches;
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;	///< signaled when there are new batches or the workers must stop
+	std::condition_variable m_doneCondition;	///< signaled when a worker is out of batches
+	size_t m_nextBatch;
+	size_t m_finishedWorkers;
+	UnsignedInt m_generation;
+	bool m_stop;
+
+};
+
+extern W3DAnimationUpdater *TheW3DAnimationUpdater;
@@ -79,6 +79,7 @@ public:
 	virtual void	enableClipping( Bool onoff )		{ m_isClippedEnabled = onoff; }
 
 	virtual void draw( void );  ///< redraw the entire display
+	virtual void updateViews( void );  ///< update all views, then prepare the animations of what they draw
 
 	/// @todo Replace these light management routines with a LightManager singleton
 	virtual void createLightPulse( const Coord3D *pos, const RGBColor *color, Real innerRadius,Real outerRadius,
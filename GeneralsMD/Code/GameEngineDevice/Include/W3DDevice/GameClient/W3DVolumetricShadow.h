@@ -67,6 +67,8 @@ public:
 	}
 	void invalidateCachedLightPositions(void);	///<forces shadow volumes to update regardless of last lightposition
 	void loadTerrainShadows(void);
+	/// builds the shadow geometry and polygon neighbors of a model without caching them, for tools. Returns number of meshes.
+	static Int buildShadowGeometry( RenderObjClass *robj, Int *polygonCount );
 
 	// rendering
 	void renderShadows( Bool forceStencilFill );
@@ -55,6 +55,7 @@
 #include "GameLogic/Module/AIUpdate.h"
 #include "GameLogic/Module/PhysicsUpdate.h"
 #include "W3DDevice/GameClient/Module/W3DModelDraw.h"
+#include "W3DDevice/GameClient/W3DAnimationUpdater.h"
 #include "W3DDevice/GameClient/W3DAssetManager.h"
 #include "W3DDevice/GameClient/W3DDisplay.h"
 #include "W3DDevice/GameClient/W3DScene.h"
@@ -2110,6 +2111,10 @@ void W3DModelDraw::doDrawModule(const Matrix3D* transformMtx)
 
   handleClientRecoil();
 
+	// TheSuperHackers @performance The hierarchy is brought up to date with all other drawn ones before rendering.
+	if (TheW3DAnimationUpdater)
+		TheW3DAnimationUpdater->addRenderObject(m_renderObject);
+
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -36,6 +36,8 @@
 
 // SYSTEM INCLUDES ////////////////////////////////////////////////////////////
 #include <assert.h>
+#include <algorithm>
+#include <vector>
 
 // USER INCLUDES //////////////////////////////////////////////////////////////
 #include "always.h"
@@ -619,6 +621,77 @@ class W3DShadowGeometry : public RefCountClass, public	HashableClass
 
 #define MAX_SHADOW_VOLUME_VERTS 16384
 
+// hashVertexCoordinate =======================================================
+// Hash of a vertex coordinate, -0 and +0 are the same position so they hash
+// alike.
+// ============================================================================
+static inline UnsignedInt hashVertexCoordinate(Real coordinate)
+{
+	if (coordinate == 0.0f)
+		return 0;
+
+	UnsignedInt bits;
+	memcpy(&bits,&coordinate,sizeof(bits));
+	return bits;
+}
+
+// findParentVertices =========================================================
+// Assign every vertex the index of the first vertex at the same position, or
+// its own index if it is the first one there. Returns the number of vertices
+// left after duplicates are removed.
+//
+// This is not exactly the old search. That one also welded two vertices whose
+// squared distance underflowed to zero, which happens below a distance of
+// about 3e-23, and such near matches depended on which vertex came first.
+// Here only vertices at exactly the same position are welded. Vertices with an
+// infinite or NaN coordinate are never welded, as before.
+// ============================================================================
+static Int findParentVertices(const Vector3 *verts, Int numVerts, UnsignedShort *vertParent)
+{
+	// TheSuperHackers @performance Look up the first vertex at each position in a hash table
+	// instead of comparing every vertex with all vertices after it.
+	UnsignedInt tableSize=1;
+	while (tableSize < (UnsignedInt)numVerts*2)
+		tableSize <<= 1;
+
+	std::vector<Int> firstVertex(tableSize,-1);
+	Int newVertexCount=0;
+
+	for (Int j=0; j<numVerts; j++)
+	{
+		const Vector3 *v_curr=&verts[j];
+
+		UnsignedInt hash=hashVertexCoordinate(v_curr->X);
+		hash=hash*31+hashVertexCoordinate(v_curr->Y);
+		hash=hash*31+hashVertexCoordinate(v_curr->Z);
+		hash^=hash>>16;
+		hash*=0x85ebca6b;
+		hash^=hash>>13;
+
+		for (UnsignedInt slot=hash&(tableSize-1); ; slot=(slot+1)&(tableSize-1))
+		{
+			if (firstVertex[slot] == -1)
+			{	//first instance of new vertex
+				firstVertex[slot]=j;
+				vertParent[j]=j;
+				newVertexCount++;
+				break;
+			}
+
+			// A zero difference means the same position, -0 and +0 included.
+			// An infinite coordinate gives a NaN difference, so it never matches.
+			Vector3 len(*v_curr - verts[firstVertex[slot]]);
+			if (len.X == 0 && len.Y == 0 && len.Z == 0)
+			{	//found duplicate vertex
+				vertParent[j]=firstVertex[slot];
+				break;
+			}
+		}
+	}
+
+	return newVertexCount;
+}
+
 Int W3DShadowGeometry::initFromHLOD(RenderObjClass *robj)
 {
 	HLodClass *hlod=(HLodClass *)robj;
@@ -626,7 +699,7 @@ Int W3DShadowGeometry::initFromHLOD(RenderObjClass *robj)
 	//vertices are removed.
 	UnsignedShort vertParent[MAX_SHADOW_VOLUME_VERTS];
 
-	Int i,j,k,newVertexCount;
+	Int i,newVertexCount;
 
 	Int top = hlod->Get_LOD_Count()-1;
 	W3DShadowGeometryMesh *geomMesh=&m_meshList[m_meshCount];
@@ -660,28 +733,8 @@ Int W3DShadowGeometry::initFromHLOD(RenderObjClass *robj)
 			if (geomMesh->m_numVerts > MAX_SHADOW_VOLUME_VERTS)
 				return FALSE;	//too many vertices to process
 
-			//reset index of all vertices
-			memset(vertParent,0xffffffff,sizeof(vertParent));
-			newVertexCount=geomMesh->m_numVerts;
 			//Find all duplicated vertices.
-			for (j=0; j<geomMesh->m_numVerts; j++)
-			{
-				if (vertParent[j] != 0xffff)
-					continue;	//this vertex has already been processed
-
-				const Vector3 *v_curr=&geomMesh->m_verts[j];
-
-				for (k=j+1; k<geomMesh->m_numVerts; k++)
-				{
-					Vector3 len(*v_curr - geomMesh->m_verts[k]);
-					if (len.Length2() == 0)
-					{	//found duplicate vertex
-						vertParent[k]=j;
-						newVertexCount--;	//decrease total vertices since duplicate found.
-					}
-				}
-				vertParent[j]=j;	//first instance of new vertex
-			}
+			newVertexCount=findParentVertices(geomMesh->m_verts,geomMesh->m_numVerts,vertParent);
 			geomMesh->m_parentVerts = NEW UnsignedShort[geomMesh->m_numVerts];
 			memcpy(geomMesh->m_parentVerts,vertParent,sizeof(UnsignedShort)*geomMesh->m_numVerts);
 			geomMesh->m_numVerts=newVertexCount;	//adjust actual vertex count to ignore duplicates
@@ -732,28 +785,8 @@ Int W3DShadowGeometry::initFromHLOD(RenderObjClass *robj)
 				if (geomMesh->m_numVerts > MAX_SHADOW_VOLUME_VERTS)
 					return FALSE;	//too many vertices to process
 
-				//reset index of all vertices
-				memset(vertParent,0xffffffff,sizeof(vertParent));
-				newVertexCount=geomMesh->m_numVerts;
 				//Find all duplicated vertices.
-				for (j=0; j<geomMesh->m_numVerts; j++)
-				{
-					if (vertParent[j] != 0xffff)
-						continue;	//this vertex has already been processed
-
-					const Vector3 *v_curr=&geomMesh->m_verts[j];
-
-					for (k=j+1; k<geomMesh->m_numVerts; k++)
-					{
-						Vector3 len(*v_curr - geomMesh->m_verts[k]);
-						if (len.Length2() == 0)
-						{	//found duplicate vertex
-							vertParent[k]=j;
-							newVertexCount--;	//decrease total vertices since duplicate found.
-						}
-					}
-					vertParent[j]=j;	//first instance of new vertex
-				}
+				newVertexCount=findParentVertices(geomMesh->m_verts,geomMesh->m_numVerts,vertParent);
 				geomMesh->m_parentVerts = new UnsignedShort[geomMesh->m_numVerts];
 				memcpy(geomMesh->m_parentVerts,vertParent,sizeof(UnsignedShort)*geomMesh->m_numVerts);
 				geomMesh->m_numVerts=newVertexCount;	//adjust actual vertex count to ignore duplicates
@@ -785,7 +818,7 @@ Int W3DShadowGeometry::initFromMesh(RenderObjClass *robj)
 	//vertices are removed.
 	UnsignedShort vertParent[MAX_SHADOW_VOLUME_VERTS];
 
-	Int j,k,newVertexCount;
+	Int newVertexCount;
 	W3DShadowGeometryMesh *geomMesh=&m_meshList[m_meshCount];
 
 	assert (m_meshCount < MAX_SHADOW_CASTER_MESHES);
@@ -804,28 +837,8 @@ Int W3DShadowGeometry::initFromMesh(RenderObjClass *robj)
 	if (geomMesh->m_numVerts > MAX_SHADOW_VOLUME_VERTS)
 		return FALSE;	//too many vertices to process
 
-	//reset index of all vertices
-	memset(vertParent,0xffffffff,sizeof(vertParent));
-	newVertexCount=geomMesh->m_numVerts;
 	//Find all duplicated vertices.
-	for (j=0; j<geomMesh->m_numVerts; j++)
-	{
-		if (vertParent[j] != 0xffff)
-			continue;	//this vertex has already been processed
-
-		const Vector3 *v_curr=&geomMesh->m_verts[j];
-
-		for (k=j+1; k<geomMesh->m_numVerts; k++)
-		{
-			Vector3 len(*v_curr - geomMesh->m_verts[k]);
-			if (len.Length2() == 0)
-			{	//found duplicate vertex
-				vertParent[k]=j;
-				newVertexCount--;	//decrease total vertices since duplicate found.
-			}
-		}
-		vertParent[j]=j;	//first instance of new vertex
-	}
+	newVertexCount=findParentVertices(geomMesh->m_verts,geomMesh->m_numVerts,vertParent);
 
 	geomMesh->m_parentVerts = NEW UnsignedShort[geomMesh->m_numVerts];
 	memcpy(geomMesh->m_parentVerts,vertParent,sizeof(UnsignedShort)*geomMesh->m_numVerts);
@@ -948,6 +961,50 @@ void W3DShadowGeometryMesh::buildPolygonNeighbors( void )
 
 	}
 
+	//
+	// TheSuperHackers @performance Only polygons that share a vertex with a
+	// polygon can be its neighbors, so list the polygons using each vertex and
+	// test just those instead of all polygons against each other. They are
+	// tested in ascending order as before, so the neighbors come out the same.
+	//
+	Short poly[ 3 ];  // vertex indices for this polygon
+	Int numVertexSlots = 0;
+	for( i = 0; i < m_numPolyNeighbors; i++ )
+	{
+
+		GetPolygonIndex( i, poly );
+		for( j = 0; j < 3; j++ )
+			if( (UnsignedShort)poly[ j ] >= numVertexSlots )
+				numVertexSlots = (UnsignedShort)poly[ j ] + 1;
+
+	}
+
+	// polygons using vertex v are vertexPolygons[ vertexPolygonStart[ v ] ] up to vertexPolygons[ vertexPolygonStart[ v + 1 ] ]
+	std::vector<Int> vertexPolygonStart( numVertexSlots + 1, 0 );
+	std::vector<Int> vertexPolygons( m_numPolyNeighbors * 3 );
+	for( i = 0; i < m_numPolyNeighbors; i++ )
+	{
+
+		GetPolygonIndex( i, poly );
+		for( j = 0; j < 3; j++ )
+			vertexPolygonStart[ (UnsignedShort)poly[ j ] + 1 ]++;
+
+	}
+	for( i = 0; i < numVertexSlots; i++ )
+		vertexPolygonStart[ i + 1 ] += vertexPolygonStart[ i ];
+
+	std::vector<Int> vertexPolygonEnd( vertexPolygonStart.begin(), vertexPolygonStart.end() - 1 );
+	for( i = 0; i < m_numPolyNeighbors; i++ )
+	{
+
+		GetPolygonIndex( i, poly );
+		for( j = 0; j < 3; j++ )
+			vertexPolygons[ vertexPolygonEnd[ (UnsignedShort)poly[ j ] ]++ ] = i;
+
+	}
+
+	std::vector<Int> candidates;
+
 	//
 	// initialize all polygon neighbor information to none and assign our
 	// own reference to myIndex so we know who we are
@@ -967,21 +1024,32 @@ void W3DShadowGeometryMesh::buildPolygonNeighbors( void )
 	// assign polygon data for each of our polygons
 	for( i = 0; i < m_numPolyNeighbors; i++ )
 	{
-		Short poly[ 3 ];  // vertex indices for this polygon
 		Short otherPoly[ 3 ];  // vertex indices for other polygon
 
 		// get the indices of the three triangle points for this polygon
 		GetPolygonIndex( i, poly );
 		const Vector3& vNorm=GetPolygonNormal(i);
 
+		// gather the polygons sharing a vertex with this polygon
+		candidates.clear();
+		for( j = 0; j < 3; j++ )
+		{
+			const UnsignedShort vertex = (UnsignedShort)poly[ j ];
+			candidates.insert( candidates.end(), vertexPolygons.begin() + vertexPolygonStart[ vertex ], vertexPolygons.begin() + vertexPolygonStart[ vertex + 1 ] );
+		}
+		std::sort( candidates.begin(), candidates.end() );
+		candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
 		// find the neighbors of this polygon
-		for( j = 0; j < m_numPolyNeighbors; j++ )
+		for( size_t candidate = 0; candidate < candidates.size(); candidate++ )
 		{
 			Int a, b;
 			Int index1, index2;
 			Int index1Pos[2]; //positions of shared edge vertices in triangle list. (0,1 or 2)
 			Int diff1,diff2;
 
+			j = candidates[ candidate ];
+
 			// ignore our own polygon
 			if( i == j )
 				continue;
@@ -3801,6 +3869,53 @@ void W3DVolumetricShadowManager::reset( void )
 
 }
 
+// buildShadowGeometry ========================================================
+// Build the same shadow geometry addShadow would cache for this model, plus
+// the polygon neighbors that are otherwise built on first use. Nothing is
+// cached, so every call pays the full cost. Used by the shadow geometry
+// benchmark tool, which has no D3D device.
+// ============================================================================
+Int W3DVolumetricShadowManager::buildShadowGeometry( RenderObjClass *robj, Int *polygonCount )
+{
+	if (polygonCount)
+		*polygonCount = 0;
+
+	if (!robj || !robj->Get_Name())
+		return 0;
+
+	W3DShadowGeometry *geom = NEW W3DShadowGeometry;
+	geom->Set_Name(robj->Get_Name());
+
+	Int res=FALSE;
+	switch (robj->Class_ID())
+	{
+		case RenderObjClass::CLASSID_HLOD:
+			res=geom->initFromHLOD(robj);
+			break;
+		case RenderObjClass::CLASSID_MESH:
+			res=geom->initFromMesh(robj);
+			break;
+		default:
+			break;	//unknown render object type
+	};
+
+	Int meshCount=0;
+	if (res == TRUE)
+	{
+		meshCount=geom->getMeshCount();
+		for (Int i=0; i<meshCount; i++)
+		{
+			W3DShadowGeometryMesh *mesh=geom->getMesh(i);
+			mesh->buildPolygonNeighbors();
+			if (polygonCount)
+				*polygonCount += mesh->GetNumPolygon();
+		}
+	}
+
+	geom->Release_Ref();
+	return meshCount;
+}
+
 // addShadow ==================================================================
 // Add the shadows for this hierarchy to the shadow management for
 // rendering.
@@ -0,0 +1,276 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: W3DAnimationUpdater.cpp //////////////////////////////////////////////////////////////////
+// Desc:   Updates the hierarchies of the drawn render objects on worker threads
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "W3DDevice/GameClient/W3DAnimationUpdater.h"
+
+#include "Common/GlobalData.h"
+#include "WW3D2/hanim.h"
+#include "WW3D2/hlod.h"
+
+#include <algorithm>
+
+W3DAnimationUpdater *TheW3DAnimationUpdater = NULL;
+
+/// Render objects that are prepared one after another by the same thread
+enum { ANIMATION_UPDATE_BATCH_SIZE = 16 };
+
+/// Worker threads next to the main thread. A frame rarely has enough batches to keep more of them busy,
+/// and the game needs the other cores for its own threads, the driver and the audio.
+enum { MAX_ANIMATION_UPDATE_WORKERS = 3 };
+
+//-------------------------------------------------------------------------------------------------
+W3DAnimationUpdater::W3DAnimationUpdater( void ) :
+	m_nextBatch(0),
+	m_finishedWorkers(0),
+	m_generation(0),
+	m_stop(false)
+{
+	if (!TheGlobalData->m_parallelAnimationUpdate)
+		return;
+
+	// The main thread prepares batches as well, so leave it a core of its own
+	const UnsignedInt hardwareThreads = std::thread::hardware_concurrency();
+	const UnsignedInt workers = std::min<UnsignedInt>(hardwareThreads > 1 ? hardwareThreads - 1 : 0, MAX_ANIMATION_UPDATE_WORKERS);
+	for (UnsignedInt i = 0; i < workers; ++i)
+		m_threads.push_back(std::thread(&W3DAnimationUpdater::run, this));
+}
+
+//-------------------------------------------------------------------------------------------------
+W3DAnimationUpdater::~W3DAnimationUpdater( void )
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_startCondition.notify_all();
+
+	for (size_t i = 0; i < m_threads.size(); ++i)
+		m_threads[i].join();
+	m_threads.clear();
+
+	releaseQueue();
+}
+
+//-------------------------------------------------------------------------------------------------
+void W3DAnimationUpdater::addRenderObject( RenderObjClass *robj )
+{
+	if (m_threads.empty())
+		return;
+
+	if (robj == NULL || robj->Class_ID() != RenderObjClass::CLASSID_HLOD)
+		return;
+
+	robj->Add_Ref();
+	m_queue.push_back(robj);
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Prepare the hierarchies of all queued render objects, the worker threads and the main thread
+	* share the batches. Embedded animation sounds are played afterwards on the main thread */
+//-------------------------------------------------------------------------------------------------
+void W3DAnimationUpdater::update( void )
+{
+	if (m_queue.empty())
+		return;
+
+	buildBatches();
+
+	if (m_batches.size() == 1)
+	{
+		// Waking the workers costs more than they could save on a single batch
+		m_nextBatch = 0;
+		prepareBatches();
+
+		for (size_t i = 0; i < m_items.size(); ++i)
+			m_items[i].hlod->Finish_Prepared_Hierarchy();
+	}
+	else if (!m_batches.empty())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_nextBatch = 0;
+			m_finishedWorkers = 0;
+			++m_generation;
+		}
+		m_startCondition.notify_all();
+
+		prepareBatches();
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCondition.wait(lock, [this] { return m_finishedWorkers == m_threads.size(); });
+		}
+
+		for (size_t i = 0; i < m_items.size(); ++i)
+			m_items[i].hlod->Finish_Prepared_Hierarchy();
+	}
+
+	m_items.clear();
+	m_batches.clear();
+	releaseQueue();
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Is preparing the hierarchy of this render object guaranteed to touch nothing but the render
+	* object itself, its sub-objects and the motion it plays */
+//-------------------------------------------------------------------------------------------------
+Bool W3DAnimationUpdater::canPrepareOnWorker( HLodClass *hlod )
+{
+	// Updating a contained render object would update its container as well
+	if (hlod->Get_Container() != NULL)
+		return FALSE;
+
+	if (!hlod->Can_Prepare_Hierarchy())
+		return FALSE;
+
+	// Meshes and boxes only follow their bones, anything else may reach out to shared state when it moves
+	for (Int i = 0; i < hlod->Get_Num_Sub_Objects(); ++i)
+	{
+		RenderObjClass *subObject = hlod->Get_Sub_Object(i);
+		const Int classId = subObject->Class_ID();
+		subObject->Release_Ref();
+
+		if (classId != RenderObjClass::CLASSID_MESH && classId != RenderObjClass::CLASSID_AABOX && classId != RenderObjClass::CLASSID_OBBOX)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+bool W3DAnimationUpdater::itemLess( const Item &a, const Item &b )
+{
+	if (a.sharedMotion != b.sharedMotion)
+		return a.sharedMotion < b.sharedMotion;
+	return a.hlod < b.hlod;
+}
+
+//-------------------------------------------------------------------------------------------------
+bool W3DAnimationUpdater::itemEqual( const Item &a, const Item &b )
+{
+	return a.hlod == b.hlod;
+}
+
+//-------------------------------------------------------------------------------------------------
+bool W3DAnimationUpdater::batchLarger( const Batch &a, const Batch &b )
+{
+	return a.end - a.begin > b.end - b.begin;
+}
+
+//-------------------------------------------------------------------------------------------------
+void W3DAnimationUpdater::buildBatches( void )
+{
+	for (size_t i = 0; i < m_queue.size(); ++i)
+	{
+		HLodClass *hlod = (HLodClass *)m_queue[i];
+		if (!canPrepareOnWorker(hlod))
+			continue;
+
+		// Only raw animations can be sampled from several threads at once
+		Item item;
+		item.sharedMotion = hlod->Peek_Animation();
+		if (item.sharedMotion != NULL && item.sharedMotion->Class_ID() == HAnimClass::CLASSID_HRAWANIM)
+			item.sharedMotion = NULL;
+		item.hlod = hlod;
+		m_items.push_back(item);
+	}
+
+	// A render object that is drawn in several views must be prepared only once
+	std::sort(m_items.begin(), m_items.end(), itemLess);
+	m_items.erase(std::unique(m_items.begin(), m_items.end(), itemEqual), m_items.end());
+
+	// Render objects without a shared motion are cut into batches of equal size,
+	// each shared motion gets a batch of its own
+	size_t begin = 0;
+	while (begin < m_items.size())
+	{
+		HAnimClass *sharedMotion = m_items[begin].sharedMotion;
+		size_t end = begin + 1;
+		while (end < m_items.size() && m_items[end].sharedMotion == sharedMotion && (sharedMotion != NULL || end - begin < (size_t)ANIMATION_UPDATE_BATCH_SIZE))
+			++end;
+
+		Batch batch;
+		batch.begin = begin;
+		batch.end = end;
+		m_batches.push_back(batch);
+
+		begin = end;
+	}
+
+	// Start with the largest batches so that no thread is left with a large one at the end
+	std::stable_sort(m_batches.begin(), m_batches.end(), batchLarger);
+}
+
+//-------------------------------------------------------------------------------------------------
+void W3DAnimationUpdater::prepareBatches( void )
+{
+	for (;;)
+	{
+		size_t index;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_nextBatch == m_batches.size())
+				break;
+			index = m_nextBatch++;
+		}
+
+		const Batch &batch = m_batches[index];
+		for (size_t i = batch.begin; i < batch.end; ++i)
+			m_items[i].hlod->Prepare_Hierarchy();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+void W3DAnimationUpdater::releaseQueue( void )
+{
+	for (size_t i = 0; i < m_queue.size(); ++i)
+		m_queue[i]->Release_Ref();
+	m_queue.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Every worker takes part in every update, so the main thread can safely rebuild the batches
+	* once all workers are finished */
+//-------------------------------------------------------------------------------------------------
+void W3DAnimationUpdater::run( void )
+{
+	UnsignedInt generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [this, generation] { return m_stop || m_generation != generation; });
+			if (m_stop)
+				break;
+			generation = m_generation;
+		}
+
+		prepareBatches();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_finishedWorkers;
+		}
+		m_doneCondition.notify_one();
+	}
+}
@@ -67,6 +67,7 @@ static void drawFramerateBar(void);
 #include "Common/ModelState.h"
 #include "Lib/BaseType.h"
 #include "W3DDevice/Common/W3DConvert.h"
+#include "W3DDevice/GameClient/W3DAnimationUpdater.h"
 #include "W3DDevice/GameClient/W3DAssetManager.h"
 #include "W3DDevice/GameClient/W3DGameClient.h"
 #include "W3DDevice/GameClient/W3DFileSystem.h"
@@ -245,7 +246,9 @@ void StatDumpClass::dumpStats( Bool brief, Bool flagSpikes )
 
 	//AI stats
 	UnsignedInt numAI, numMoving, numAttacking, numWaitingForPath, overallFailedPathfinds;
-	TheGameLogic->getAIMetricsStatistics( &numAI, &numMoving, &numAttacking, &numWaitingForPath, &overallFailedPathfinds );
+	UnsignedInt hierarchicalPathCacheHits, hierarchicalPathCacheMisses;
+	TheGameLogic->getAIMetricsStatistics( &numAI, &numMoving, &numAttacking, &numWaitingForPath, &overallFailedPathfinds,
+		&hierarchicalPathCacheHits, &hierarchicalPathCacheMisses );
 	fprintf( m_fp, "\n" );
 	fprintf( m_fp, "AI Statistics:\n" );
 	fprintf( m_fp, "  Total AI Objects: %d\n", numAI );
@@ -255,6 +258,7 @@ void StatDumpClass::dumpStats( Bool brief, Bool flagSpikes )
 	fprintf( m_fp, "  Total failed pathfinds: %d\n", overallFailedPathfinds );
   if ( flagSpikes && overallFailedPathfinds > 0 )
   	fprintf( m_fp, "                                                                      FAILEDPATHFINDS OUT OF TOLERANCE(0)\n" );
+	fprintf( m_fp, "  Hierarchical path cache: %d hits, %d misses\n", hierarchicalPathCacheHits, hierarchicalPathCacheMisses );
 	fprintf( m_fp, "\n" );
 
 	// Script stats
@@ -419,6 +423,9 @@ W3DDisplay::W3DDisplay()
 W3DDisplay::~W3DDisplay()
 {
 
+	delete TheW3DAnimationUpdater;
+	TheW3DAnimationUpdater = NULL;
+
 	// get rid of the debug display
 	delete m_debugDisplay;
 	m_debugDisplay = NULL;
@@ -656,6 +663,8 @@ void W3DDisplay::init( void )
 
 		// create our 3D scene
 		m_3DScene =NEW_REF( RTS3DScene, () );
+
+		TheW3DAnimationUpdater = NEW W3DAnimationUpdater;
 	#if defined(RTS_DEBUG)
 		if( TheGlobalData->m_wireframe )
 			m_3DScene->Set_Polygon_Mode( SceneClass::LINE );
@@ -894,6 +903,18 @@ void W3DDisplay::reset( void )
 		TheWritableGlobalData->m_drawSkyBox =0;
 }
 
+// W3DDisplay::updateViews ====================================================
+/** TheSuperHackers @performance Updating the views lets the draw modules set up their render
+	* objects. Their hierarchies are then brought up to date in parallel before anything renders them. */
+//=============================================================================
+void W3DDisplay::updateViews( void )
+{
+	Display::updateViews();
+
+	if (TheW3DAnimationUpdater)
+		TheW3DAnimationUpdater->update();
+}
+
 const UnsignedInt START_CUMU_FRAME = LOGICFRAMES_PER_SECOND / 2;	// skip first half-sec
 
 void W3DDisplay::updateAverageFPS(void)
@@ -55,6 +55,10 @@
  *   Animatable3DObjClass::Is_Bone_Captured -- returns whether the specified bone is captured  *
  *   Animatable3DObjClass::Control_Bone -- sets the transform for the bone                     *
  *   Animatable3DObjClass::Update_Sub_Object_Transforms -- recalculate the transforms for our  *
+ *   Animatable3DObjClass::Trigger_Embedded_Sounds -- play sounds of the current anim frames   *
+ *   Animatable3DObjClass::Can_Prepare_Hierarchy -- can the hierarchy be updated ahead of time *
+ *   Animatable3DObjClass::Prepare_Hierarchy -- update the hierarchy ahead of rendering        *
+ *   Animatable3DObjClass::Finish_Prepared_Hierarchy -- play the sounds of a prepared update   *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
@@ -83,6 +87,8 @@
  *=============================================================================================*/
 Animatable3DObjClass::Animatable3DObjClass(const char * htree_name) :
 	IsTreeValid(0),
+	IsTreePrepared(false),
+	AreSoundsDeferred(false),
 	CurMotionMode(BASE_POSE)
 {
 	// Inline struct members can't be initialized in init list for some reason...
@@ -138,6 +144,8 @@ Animatable3DObjClass::Animatable3DObjClass(const char * htree_name) :
 Animatable3DObjClass::Animatable3DObjClass(const Animatable3DObjClass & src) :
 	CompositeRenderObjClass(src),
 	IsTreeValid(0),
+	IsTreePrepared(false),
+	AreSoundsDeferred(false),
 	CurMotionMode(BASE_POSE),
 	HTree(NULL)
 {
@@ -201,6 +209,7 @@ Animatable3DObjClass & Animatable3DObjClass::operator = (const Animatable3DObjCl
 		CompositeRenderObjClass::operator = (that);
 
 		IsTreeValid = 0;
+		IsTreePrepared = false;
 		CurMotionMode = BASE_POSE;
 		ModeAnim.Motion = NULL;
 		ModeAnim.Frame = 0.0f;
@@ -291,10 +300,11 @@ void Animatable3DObjClass::Render(RenderInfoClass & rinfo)
 
 	//
 	// Force the hierarchy to be recalculated for single animations.
+	// TheSuperHackers @performance Unless it was already prepared for this logic time.
 	//
 	const bool isSingleAnim = CurMotionMode == SINGLE_ANIM && ModeAnim.AnimMode != ANIM_MODE_MANUAL;
 
-	if (isSingleAnim || !Is_Hierarchy_Valid() || Are_Sub_Object_Transforms_Dirty()) {
+	if ((isSingleAnim && !Is_Hierarchy_Prepared()) || !Is_Hierarchy_Valid() || Are_Sub_Object_Transforms_Dirty()) {
 		Update_Sub_Object_Transforms();
 	}
 }
@@ -320,7 +330,7 @@ void Animatable3DObjClass::Special_Render(SpecialRenderInfoClass & rinfo)
 	//
 	const bool isSingleAnim = CurMotionMode == SINGLE_ANIM && ModeAnim.AnimMode != ANIM_MODE_MANUAL;
 
-	if (isSingleAnim || !Is_Hierarchy_Valid()) {
+	if ((isSingleAnim && !Is_Hierarchy_Prepared()) || !Is_Hierarchy_Valid()) {
 		Update_Sub_Object_Transforms();
 	}
 }
@@ -779,6 +789,8 @@ void Animatable3DObjClass::Update_Sub_Object_Transforms(void)
 	*/
 	CompositeRenderObjClass::Update_Sub_Object_Transforms();
 
+	IsTreePrepared = false;
+
 	/*
 	** Update the transforms
 	*/
@@ -794,22 +806,53 @@ void Animatable3DObjClass::Update_Sub_Object_Transforms(void)
 				Single_Anim_Progress();
 			}
 			Anim_Update(Transform,ModeAnim.Motion,ModeAnim.Frame);
+			break;
+
+		case DOUBLE_ANIM:
+			Blend_Update(Transform,ModeInterp.Motion0,ModeInterp.Frame0,
+				ModeInterp.Motion1,ModeInterp.Frame1,ModeInterp.Percentage);
+			break;
+
+		case MULTIPLE_ANIM:
+			Combo_Update(Transform,ModeCombo.AnimCombo);
+			break;
+
+		default:
+			break;
+	}
+
+	if (!AreSoundsDeferred) {
+		Trigger_Embedded_Sounds();
+	}
+	Set_Hierarchy_Valid(true);
+}
+
+
+/***********************************************************************************************
+ * Animatable3DObjClass::Trigger_Embedded_Sounds -- play sounds of the current anim frames     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS: The hierarchy must be up to date                                                  *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void Animatable3DObjClass::Trigger_Embedded_Sounds(void)
+{
+	/*
+	**	Play any sounds that are triggered by this frame of animation
+	*/
+	switch (CurMotionMode) {
 
-			/*
-			**	Play any sounds that are triggered by this frame of animation
-			*/
+		case SINGLE_ANIM:
 			if ( ModeAnim.Motion->Has_Embedded_Sounds() ) {
 				ModeAnim.PrevFrame = AnimatedSoundMgrClass::Trigger_Sound(ModeAnim.Motion, ModeAnim.PrevFrame, ModeAnim.Frame, HTree->Get_Transform(ModeAnim.Motion->Get_Embedded_Sound_Bone_Index()));
 			}
 			break;
 
 		case DOUBLE_ANIM:
-			Blend_Update(Transform,ModeInterp.Motion0,ModeInterp.Frame0,
-				ModeInterp.Motion1,ModeInterp.Frame1,ModeInterp.Percentage);
-
-			/*
-			**	Play any sounds that are triggered by this frame of animation
-			*/
 			if ( ModeInterp.Motion0->Has_Embedded_Sounds() ) {
 				ModeInterp.PrevFrame0 = AnimatedSoundMgrClass::Trigger_Sound(ModeInterp.Motion0, ModeInterp.PrevFrame0, ModeInterp.Frame0, HTree->Get_Transform(ModeInterp.Motion0->Get_Embedded_Sound_Bone_Index()));
 			}
@@ -817,16 +860,10 @@ void Animatable3DObjClass::Update_Sub_Object_Transforms(void)
 			if ( ModeInterp.Motion1->Has_Embedded_Sounds() ) {
 				ModeInterp.PrevFrame1 = AnimatedSoundMgrClass::Trigger_Sound(ModeInterp.Motion1, ModeInterp.PrevFrame1, ModeInterp.Frame1, HTree->Get_Transform(ModeInterp.Motion1->Get_Embedded_Sound_Bone_Index()));
 			}
-
 			break;
 
 		case MULTIPLE_ANIM:
 		{
-			Combo_Update(Transform,ModeCombo.AnimCombo);
-
-			/*
-			**	Play any sounds that are triggered by this frame of animation
-			*/
 			int count = ModeCombo.AnimCombo->Get_Num_Anims();
 			for (int index = 0; index < count; index ++) {
 				HAnimClass *motion = ModeCombo.AnimCombo->Peek_Motion(index);
@@ -844,7 +881,101 @@ void Animatable3DObjClass::Update_Sub_Object_Transforms(void)
 		default:
 			break;
 	}
-	Set_Hierarchy_Valid(true);
+}
+
+
+/***********************************************************************************************
+ * Animatable3DObjClass::Can_Prepare_Hierarchy -- can the hierarchy be updated ahead of time   *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * true if the object shows the base pose or a single animation and Render would update the    *
+ * hierarchy.                                                                                  *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool Animatable3DObjClass::Can_Prepare_Hierarchy(void)
+{
+	if (HTree == NULL || Is_Not_Hidden_At_All() == false) {
+		return false;
+	}
+
+	if (CurMotionMode != BASE_POSE && CurMotionMode != SINGLE_ANIM) {
+		return false;
+	}
+
+	const bool isSingleAnim = CurMotionMode == SINGLE_ANIM && ModeAnim.AnimMode != ANIM_MODE_MANUAL;
+
+	return (isSingleAnim && !Is_Hierarchy_Prepared()) || !Is_Hierarchy_Valid() || Are_Sub_Object_Transforms_Dirty();
+}
+
+
+/***********************************************************************************************
+ * Animatable3DObjClass::Prepare_Hierarchy -- update the hierarchy ahead of rendering          *
+ *                                                                                             *
+ * Updates the hierarchy and the cached bounding volumes. Render and Special_Render use the    *
+ * result as long as the logic time does not advance and nothing invalidates the hierarchy.    *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS: Call Finish_Prepared_Hierarchy on the main thread before rendering                *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void Animatable3DObjClass::Prepare_Hierarchy(void)
+{
+	AreSoundsDeferred = true;
+	Update_Sub_Object_Transforms();
+	AreSoundsDeferred = false;
+
+	Get_Bounding_Sphere();
+	Get_Bounding_Box();
+
+	IsTreePrepared = true;
+}
+
+
+/***********************************************************************************************
+ * Animatable3DObjClass::Finish_Prepared_Hierarchy -- play the sounds of a prepared update     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void Animatable3DObjClass::Finish_Prepared_Hierarchy(void)
+{
+	Trigger_Embedded_Sounds();
+}
+
+
+/***********************************************************************************************
+ * Animatable3DObjClass::Is_Hierarchy_Prepared -- was the hierarchy prepared for this time     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool Animatable3DObjClass::Is_Hierarchy_Prepared(void) const
+{
+	if (!IsTreePrepared) {
+		return false;
+	}
+
+	// A single animation moves on with the logic time
+	return CurMotionMode != SINGLE_ANIM || ModeAnim.LastSyncTime == (int)WW3D::Get_Logic_Time_Milliseconds();
 }
 
 
@@ -120,6 +120,14 @@ public:
 	///when marked dirty.  DON'T USE THIS UNLESS YOU HAVE A GOOD REASON! -MW
 	void							Friend_Set_Hierarchy_Valid(bool onoff) const  	{ IsTreeValid = onoff; }
 
+	// TheSuperHackers @performance Update the hierarchy ahead of rendering, so that Render does not have to.
+	// Preparing only touches this object, its sub-objects and the motion it plays, so objects that do not share
+	// a motion can be prepared on different threads. Embedded sounds are held back until Finish_Prepared_Hierarchy,
+	// which must be called on the main thread.
+	bool							Can_Prepare_Hierarchy(void);
+	void							Prepare_Hierarchy(void);
+	void							Finish_Prepared_Hierarchy(void);
+
 protected:
 
 	// internally used to compute the current frame if the object is in ANIM_MODE_MANUAL
@@ -155,6 +163,12 @@ protected:
 	// Progress animations for single anim (loop and once)
 	void								Single_Anim_Progress( void );
 
+	// Was the hierarchy prepared for rendering at the current logic time
+	bool								Is_Hierarchy_Prepared(void) const;
+
+	// Play any sounds that are triggered by the current frames of animation
+	void								Trigger_Embedded_Sounds( void );
+
 	// Release any animations
 	void								Release( void );
 
@@ -163,6 +177,12 @@ protected:
 	// Is the hierarchy tree currently valid
 	mutable bool  					IsTreeValid;
 
+	// Was the hierarchy tree last updated by Prepare_Hierarchy
+	bool								IsTreePrepared;
+
+	// Are the embedded sounds of the hierarchy update left to Finish_Prepared_Hierarchy
+	bool								AreSoundsDeferred;
+
 	// Hierarchy Tree
 	HTreeClass *					HTree;
 
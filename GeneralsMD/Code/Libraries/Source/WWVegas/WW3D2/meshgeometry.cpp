@@ -2054,17 +2054,22 @@ void MeshGeometryClass::get_deformed_vertices(Vector3 *dst_vert,const HTreeClass
 {
 	Vector3 * src_vert = Vertex->Get_Array();
 	uint16 * bonelink = VertexBoneLink->Get_Array();
-	for (int vi = 0; vi < Get_Vertex_Count(); vi++) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-		Matrix3D::Transform_Vector(tm, src_vert[vi], &(dst_vert[vi]));
-	}
+
+	VectorProcessorClass::Transform_Skinned(
+		dst_vert,
+		NULL,
+		src_vert,
+		NULL,
+		bonelink,
+		&htree->Get_Transform(0),
+		htree->Get_Transform_Stride(),
+		Get_Vertex_Count());
 }
 
 
 // Destination pointers MUST point to arrays large enough to hold all vertices
 void MeshGeometryClass::get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_norm,const HTreeClass * htree)
 {
-	int vi;
 	int vertex_count=Get_Vertex_Count();
 	Vector3 * src_vert = Vertex->Get_Array();
 #if (OPTIMIZE_VNORMS)
@@ -2074,25 +2079,16 @@ void MeshGeometryClass::get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_no
 #endif
 	uint16 * bonelink = VertexBoneLink->Get_Array();
 
-	for (vi = 0; vi < vertex_count;) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-
-		// Make a copy so we can set the translation to zero
-		Matrix3D mytm=tm;
-
-		int idx=bonelink[vi];
-		int cnt;
-		for (cnt = vi; cnt < vertex_count; cnt++) {
-			if (idx!=bonelink[cnt]) {
-				break;
-			}
-		}
-
-		VectorProcessorClass::Transform(dst_vert+vi,src_vert+vi,mytm,cnt-vi);
-		mytm.Set_Translation(Vector3(0.0f,0.0f,0.0f));
-		VectorProcessorClass::Transform(dst_norm+vi,src_norm+vi,mytm,cnt-vi);
-		vi=cnt;
-	}
+	// TheSuperHackers @performance Positions and normals of all bones are transformed in one pass.
+	VectorProcessorClass::Transform_Skinned(
+		dst_vert,
+		dst_norm,
+		src_vert,
+		src_norm,
+		bonelink,
+		&htree->Get_Transform(0),
+		htree->Get_Transform_Stride(),
+		vertex_count);
 }
 
 // Destination pointers MUST point to arrays large enough to hold all vertices
@@ -0,0 +1,674 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: HTTPLoopback.cpp /////////////////////////////////////////////////////
+// Runs HTTPManager against a small HTTP server on 127.0.0.1 and checks what
+// reaches the main thread:
+//
+//   burst     many mixed requests started in one tick all complete once, on
+//             the main thread, with the right status, body and progress
+//   wakeup    a request sent while the IO thread sleeps in curl_multi_poll
+//             completes without waiting for the poll timeout
+//   shutdown  Shutdown delivers every request in flight exactly once, drops
+//             requests that were never started and lets the IO thread exit
+//
+// Usage: httploopback [-repeat <n>]
+//
+// Returns 0 when every check passed and 1 otherwise.
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// USER INCLUDES //////////////////////////////////////////////////////////////
+#include "Lib/BaseType.h"
+#include "Common/GameMemory.h"
+#include "GameNetwork/GeneralsOnline/HTTP/HTTPManager.h"
+#include "GameNetwork/GeneralsOnline/OnlineServices_Init.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC DATA ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+HINSTANCE ApplicationHInstance = NULL;
+
+/// just to satisfy the game libraries we link to
+HWND ApplicationHWnd = NULL;
+
+const char *gAppPrefix = "HL_";
+
+const Char *g_strFile = "data\\Generals.str";
+const Char *g_csfFile = "data\\%s\\Generals.csf";
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE DATA ///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+static int s_numFailures = 0;
+
+#define CHECK(condition, ...) \
+	if (!(condition)) \
+	{ \
+		++s_numFailures; \
+		printf("  FAILED: "); \
+		printf(__VA_ARGS__); \
+		printf("\n"); \
+	}
+
+///////////////////////////////////////////////////////////////////////////////
+// LOOPBACK SERVER ////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Answers one request per connection. The path picks the response:
+//   /bytes/<n>     200 with n bytes of a fixed pattern, written in small pieces
+//   /echo          200 with "<method> <request body>"
+//   /delay/<ms>    200 with "delayed" after ms milliseconds
+//   /status/<code> the given status with an empty body
+//   /drop          closes the connection without an answer
+class LoopbackServer
+{
+public:
+	bool Start()
+	{
+		m_listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (m_listenSocket == INVALID_SOCKET)
+		{
+			return false;
+		}
+
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+
+		socklen_t addrLen = sizeof(addr);
+		if (bind(m_listenSocket, (sockaddr*)&addr, sizeof(addr)) != 0
+			|| listen(m_listenSocket, SOMAXCONN) != 0
+			|| getsockname(m_listenSocket, (sockaddr*)&addr, &addrLen) != 0)
+		{
+			closesocket(m_listenSocket);
+			m_listenSocket = INVALID_SOCKET;
+			return false;
+		}
+
+		m_port = ntohs(addr.sin_port);
+		m_acceptThread = std::thread(&LoopbackServer::AcceptThreadMain, this);
+		return true;
+	}
+
+	void Stop()
+	{
+		if (m_listenSocket == INVALID_SOCKET)
+		{
+			return;
+		}
+
+		// a connection of our own wakes the blocking accept
+		m_bStopping = true;
+		SOCKET wakeSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(m_port);
+		connect(wakeSocket, (sockaddr*)&addr, sizeof(addr));
+		closesocket(wakeSocket);
+
+		m_acceptThread.join();
+		closesocket(m_listenSocket);
+		m_listenSocket = INVALID_SOCKET;
+
+		std::lock_guard<std::mutex> lock(m_connectionThreadsMutex);
+		for (std::thread& connectionThread : m_vecConnectionThreads)
+		{
+			connectionThread.join();
+		}
+		m_vecConnectionThreads.clear();
+	}
+
+	std::string GetURI(const std::string& strPath) const
+	{
+		char szURI[64];
+		snprintf(szURI, sizeof(szURI), "http://127.0.0.1:%d", m_port);
+		return szURI + strPath;
+	}
+
+	static std::string MakeBytes(size_t numBytes)
+	{
+		std::string strBytes(numBytes, '\0');
+		for (size_t i = 0; i < numBytes; ++i)
+		{
+			strBytes[i] = (char)('a' + i % 26);
+		}
+		return strBytes;
+	}
+
+private:
+	void AcceptThreadMain()
+	{
+		while (true)
+		{
+			SOCKET connectionSocket = accept(m_listenSocket, NULL, NULL);
+			if (m_bStopping)
+			{
+				if (connectionSocket != INVALID_SOCKET)
+				{
+					closesocket(connectionSocket);
+				}
+				break;
+			}
+
+			if (connectionSocket == INVALID_SOCKET)
+			{
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(m_connectionThreadsMutex);
+			m_vecConnectionThreads.push_back(std::thread(&LoopbackServer::ServeConnection, connectionSocket));
+		}
+	}
+
+	static bool SendAll(SOCKET connectionSocket, const char* pData, size_t numBytes)
+	{
+		while (numBytes > 0)
+		{
+			int numSent = send(connectionSocket, pData, (int)std::min<size_t>(numBytes, 4096), 0);
+			if (numSent <= 0)
+			{
+				return false;
+			}
+			pData += numSent;
+			numBytes -= numSent;
+		}
+		return true;
+	}
+
+	static void ServeConnection(SOCKET connectionSocket)
+	{
+		// read the request line, headers and body
+		std::string strRequest;
+		size_t headerEnd = std::string::npos;
+		size_t contentLength = 0;
+		char buffer[4096];
+		while (true)
+		{
+			if (headerEnd == std::string::npos)
+			{
+				headerEnd = strRequest.find("\r\n\r\n");
+				if (headerEnd != std::string::npos)
+				{
+					headerEnd += 4;
+					std::string strHeaders = strRequest.substr(0, headerEnd);
+					std::transform(strHeaders.begin(), strHeaders.end(), strHeaders.begin(), [](unsigned char c) { return (char)tolower(c); });
+					size_t lengthPos = strHeaders.find("\r\ncontent-length:");
+					if (lengthPos != std::string::npos)
+					{
+						contentLength = (size_t)atoi(strHeaders.c_str() + lengthPos + 17);
+					}
+				}
+			}
+
+			if (headerEnd != std::string::npos && strRequest.size() >= headerEnd + contentLength)
+			{
+				break;
+			}
+
+			int numReceived = recv(connectionSocket, buffer, sizeof(buffer), 0);
+			if (numReceived <= 0)
+			{
+				closesocket(connectionSocket);
+				return;
+			}
+			strRequest.append(buffer, numReceived);
+		}
+
+		const size_t methodEnd = strRequest.find(' ');
+		const size_t pathEnd = strRequest.find(' ', methodEnd + 1);
+		const std::string strMethod = strRequest.substr(0, methodEnd);
+		const std::string strPath = strRequest.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+		const std::string strBody = strRequest.substr(headerEnd, contentLength);
+
+		int statusCode = 200;
+		std::string strResponseBody;
+		if (strPath.compare(0, 7, "/bytes/") == 0)
+		{
+			strResponseBody = MakeBytes((size_t)atoi(strPath.c_str() + 7));
+		}
+		else if (strPath == "/echo")
+		{
+			strResponseBody = strMethod + " " + strBody;
+		}
+		else if (strPath.compare(0, 7, "/delay/") == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(atoi(strPath.c_str() + 7)));
+			strResponseBody = "delayed";
+		}
+		else if (strPath.compare(0, 8, "/status/") == 0)
+		{
+			statusCode = atoi(strPath.c_str() + 8);
+		}
+		else if (strPath == "/drop")
+		{
+			closesocket(connectionSocket);
+			return;
+		}
+		else
+		{
+			statusCode = 404;
+		}
+
+		char szHeader[256];
+		snprintf(szHeader, sizeof(szHeader), "HTTP/1.1 %d Loopback\r\nContent-Length: %d\r\nConnection: close\r\n\r\n", statusCode, (int)strResponseBody.size());
+
+		// small pieces with pauses in between, so large bodies arrive in several curl writes
+		if (SendAll(connectionSocket, szHeader, strlen(szHeader)))
+		{
+			const size_t pieceSize = 16 * 1024;
+			for (size_t offset = 0; offset < strResponseBody.size(); offset += pieceSize)
+			{
+				if (!SendAll(connectionSocket, strResponseBody.data() + offset, std::min(pieceSize, strResponseBody.size() - offset)))
+				{
+					break;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		closesocket(connectionSocket);
+	}
+
+private:
+	SOCKET m_listenSocket = INVALID_SOCKET;
+	int m_port = 0;
+	std::atomic<bool> m_bStopping = false;
+	std::thread m_acceptThread;
+	std::mutex m_connectionThreadsMutex;
+	std::vector<std::thread> m_vecConnectionThreads;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// REQUEST BOOKKEEPING ////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+struct LoopbackRequest
+{
+	EHTTPVerb verb = EHTTPVerb::HTTP_VERB_GET;
+	std::string strPath;
+	std::string strData;
+
+	int expectedStatusCode = 200;
+	std::string strExpectedBody;
+
+	int numCompletions = 0;
+	int statusCode = -1;
+	std::string strBody;
+	size_t lastProgress = 0;
+	bool bProgressDecreased = false;
+	bool bCallbackOffMainThread = false;
+	std::chrono::steady_clock::time_point timeSent;
+	std::chrono::steady_clock::time_point timeCompleted;
+};
+
+static void SendLoopbackRequest(HTTPManager* pHTTPManager, const LoopbackServer& server, LoopbackRequest* pRequest)
+{
+	std::map<std::string, std::string> mapHeaders;
+	const std::string strURI = server.GetURI(pRequest->strPath);
+
+	auto completionCallback = [pRequest](bool bSuccess, int statusCode, std::string strBody, HTTPRequest* pReq)
+	{
+		if (std::this_thread::get_id() != NGMP_OnlineServicesManager::g_MainThreadID)
+		{
+			pRequest->bCallbackOffMainThread = true;
+		}
+		++pRequest->numCompletions;
+		pRequest->statusCode = statusCode;
+		pRequest->strBody = strBody;
+		pRequest->timeCompleted = std::chrono::steady_clock::now();
+	};
+
+	auto progressCallback = [pRequest](size_t bytesReceived)
+	{
+		if (std::this_thread::get_id() != NGMP_OnlineServicesManager::g_MainThreadID)
+		{
+			pRequest->bCallbackOffMainThread = true;
+		}
+		if (bytesReceived < pRequest->lastProgress)
+		{
+			pRequest->bProgressDecreased = true;
+		}
+		pRequest->lastProgress = bytesReceived;
+	};
+
+	pRequest->timeSent = std::chrono::steady_clock::now();
+
+	switch (pRequest->verb)
+	{
+		case EHTTPVerb::HTTP_VERB_GET:
+			pHTTPManager->SendGETRequest(strURI.c_str(), EIPProtocolVersion::FORCE_IPV4, mapHeaders, completionCallback, progressCallback, 10000);
+			break;
+		case EHTTPVerb::HTTP_VERB_POST:
+			pHTTPManager->SendPOSTRequest(strURI.c_str(), EIPProtocolVersion::FORCE_IPV4, mapHeaders, pRequest->strData.c_str(), completionCallback, progressCallback, 10000);
+			break;
+		case EHTTPVerb::HTTP_VERB_PUT:
+			pHTTPManager->SendPUTRequest(strURI.c_str(), EIPProtocolVersion::FORCE_IPV4, mapHeaders, pRequest->strData.c_str(), completionCallback, progressCallback, 10000);
+			break;
+		case EHTTPVerb::HTTP_VERB_DELETE:
+			pHTTPManager->SendDELETERequest(strURI.c_str(), EIPProtocolVersion::FORCE_IPV4, mapHeaders, pRequest->strData.c_str(), completionCallback, progressCallback, 10000);
+			break;
+	}
+}
+
+static void CheckCompletedRequest(const LoopbackRequest& request)
+{
+	const char* szPath = request.strPath.c_str();
+
+	CHECK(request.numCompletions == 1, "%s completed %d times", szPath, request.numCompletions);
+	CHECK(!request.bCallbackOffMainThread, "%s called back off the main thread", szPath);
+	CHECK(request.statusCode == request.expectedStatusCode, "%s returned status %d, expected %d", szPath, request.statusCode, request.expectedStatusCode);
+	CHECK(request.strBody == request.strExpectedBody, "%s returned %d bytes that differ from the %d expected", szPath, (int)request.strBody.size(), (int)request.strExpectedBody.size());
+	CHECK(!request.bProgressDecreased, "%s reported decreasing progress", szPath);
+	CHECK(request.lastProgress == request.strExpectedBody.size(), "%s reported progress %d of %d bytes", szPath, (int)request.lastProgress, (int)request.strExpectedBody.size());
+}
+
+static bool AllCompleted(const std::vector<LoopbackRequest>& vecRequests)
+{
+	for (const LoopbackRequest& request : vecRequests)
+	{
+		if (request.numCompletions == 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TESTS //////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// testBurst ==================================================================
+/** Start a mix of requests in one tick and tick until all of them completed. */
+//=============================================================================
+static void testBurst(const LoopbackServer& server)
+{
+	printf("burst\n");
+
+	HTTPManager* pHTTPManager = new HTTPManager();
+	pHTTPManager->Initialize();
+
+	static const int byteCounts[] = { 0, 1, 100, 32 * 1024, 32 * 1024 + 1, 200 * 1024, 1024 * 1024 };
+
+	std::vector<LoopbackRequest> vecRequests;
+	for (int round = 0; round < 4; ++round)
+	{
+		for (int i = 0; i < ARRAY_SIZE(byteCounts); ++i)
+		{
+			LoopbackRequest request;
+			request.strPath = "/bytes/" + std::to_string(byteCounts[i]);
+			request.strExpectedBody = LoopbackServer::MakeBytes(byteCounts[i]);
+			vecRequests.push_back(request);
+		}
+
+		static const EHTTPVerb verbs[] = { EHTTPVerb::HTTP_VERB_POST, EHTTPVerb::HTTP_VERB_PUT, EHTTPVerb::HTTP_VERB_DELETE };
+		static const char* verbNames[] = { "POST", "PUT", "DELETE" };
+		for (int i = 0; i < ARRAY_SIZE(verbs); ++i)
+		{
+			LoopbackRequest request;
+			request.verb = verbs[i];
+			request.strPath = "/echo";
+			request.strData = "{\"round\":" + std::to_string(round) + "}";
+			request.strExpectedBody = std::string(verbNames[i]) + " " + request.strData;
+			vecRequests.push_back(request);
+		}
+
+		LoopbackRequest delayed;
+		delayed.strPath = "/delay/" + std::to_string(20 * round);
+		delayed.strExpectedBody = "delayed";
+		vecRequests.push_back(delayed);
+
+		LoopbackRequest notFound;
+		notFound.strPath = "/status/404";
+		notFound.expectedStatusCode = 404;
+		vecRequests.push_back(notFound);
+
+		// curl gives up on the empty reply and there is no status
+		LoopbackRequest dropped;
+		dropped.strPath = "/drop";
+		dropped.expectedStatusCode = 0;
+		vecRequests.push_back(dropped);
+	}
+
+	// the vector is not resized after this, the callbacks keep pointers into it
+	for (LoopbackRequest& request : vecRequests)
+	{
+		SendLoopbackRequest(pHTTPManager, server, &request);
+	}
+
+	int numTicks = 0;
+	int mostCompletedInOneTick = 0;
+	int numCompleted = 0;
+	const auto timeStart = std::chrono::steady_clock::now();
+	while (!AllCompleted(vecRequests) && std::chrono::steady_clock::now() - timeStart < std::chrono::seconds(20))
+	{
+		pHTTPManager->Tick();
+		++numTicks;
+
+		int numCompletedNow = 0;
+		for (const LoopbackRequest& request : vecRequests)
+		{
+			numCompletedNow += request.numCompletions;
+		}
+		mostCompletedInOneTick = std::max(mostCompletedInOneTick, numCompletedNow - numCompleted);
+		numCompleted = numCompletedNow;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	const auto timeEnd = std::chrono::steady_clock::now();
+
+	// a few more ticks show up duplicate completions
+	for (int i = 0; i < 10; ++i)
+	{
+		pHTTPManager->Tick();
+	}
+
+	for (const LoopbackRequest& request : vecRequests)
+	{
+		CheckCompletedRequest(request);
+	}
+
+	printf("  %d requests in %d ticks, %.1f ms, up to %d completions in one tick\n", (int)vecRequests.size(), numTicks,
+		std::chrono::duration<double, std::milli>(timeEnd - timeStart).count(), mostCompletedInOneTick);
+
+	delete pHTTPManager;
+}
+
+// testWakeup =================================================================
+/** Send single requests after the IO thread went idle and time how long they
+ take to come back. Without the wakeup they wait for the one second poll. */
+//=============================================================================
+static void testWakeup(const LoopbackServer& server)
+{
+	printf("wakeup\n");
+
+	HTTPManager* pHTTPManager = new HTTPManager();
+	pHTTPManager->Initialize();
+
+	const int numRequests = 10;
+	std::vector<LoopbackRequest> vecRequests(numRequests);
+	double slowestMS = 0.0;
+	double totalMS = 0.0;
+
+	for (int i = 0; i < numRequests; ++i)
+	{
+		// let the IO thread settle into curl_multi_poll
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		LoopbackRequest& request = vecRequests[i];
+		request.strPath = "/bytes/16";
+		request.strExpectedBody = LoopbackServer::MakeBytes(16);
+		SendLoopbackRequest(pHTTPManager, server, &request);
+
+		const auto timeStart = std::chrono::steady_clock::now();
+		while (request.numCompletions == 0 && std::chrono::steady_clock::now() - timeStart < std::chrono::seconds(5))
+		{
+			pHTTPManager->Tick();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		CheckCompletedRequest(request);
+
+		const double requestMS = std::chrono::duration<double, std::milli>(request.timeCompleted - request.timeSent).count();
+		slowestMS = std::max(slowestMS, requestMS);
+		totalMS += requestMS;
+	}
+
+	CHECK(slowestMS < 500.0, "slowest idle request took %.1f ms, the IO thread was not woken", slowestMS);
+
+	printf("  %d idle requests, %.1f ms average, %.1f ms slowest\n", numRequests, totalMS / numRequests, slowestMS);
+
+	delete pHTTPManager;
+}
+
+// testShutdown ===============================================================
+/** Shut down with requests in flight and requests that were never started. */
+//=============================================================================
+static void testShutdown(const LoopbackServer& server)
+{
+	printf("shutdown\n");
+
+	// nothing to transfer, the IO thread has to leave curl_multi_poll right away
+	{
+		HTTPManager* pHTTPManager = new HTTPManager();
+		pHTTPManager->Initialize();
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		const auto timeStart = std::chrono::steady_clock::now();
+		pHTTPManager->Shutdown();
+		const double shutdownMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeStart).count();
+
+		CHECK(shutdownMS < 500.0, "idle shutdown took %.1f ms, the IO thread was not woken", shutdownMS);
+		printf("  idle shutdown %.1f ms\n", shutdownMS);
+
+		// the destructor shuts down a second time
+		delete pHTTPManager;
+	}
+
+	{
+		HTTPManager* pHTTPManager = new HTTPManager();
+		pHTTPManager->Initialize();
+
+		std::vector<LoopbackRequest> vecInFlight(8);
+		for (LoopbackRequest& request : vecInFlight)
+		{
+			request.strPath = "/delay/200";
+			request.strExpectedBody = "delayed";
+			SendLoopbackRequest(pHTTPManager, server, &request);
+		}
+
+		// hands the requests above to the IO thread
+		pHTTPManager->Tick();
+
+		std::vector<LoopbackRequest> vecNeverStarted(4);
+		for (LoopbackRequest& request : vecNeverStarted)
+		{
+			request.strPath = "/bytes/16";
+			SendLoopbackRequest(pHTTPManager, server, &request);
+		}
+
+		const auto timeStart = std::chrono::steady_clock::now();
+		pHTTPManager->Shutdown();
+		const double shutdownMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeStart).count();
+
+		for (const LoopbackRequest& request : vecInFlight)
+		{
+			CheckCompletedRequest(request);
+		}
+
+		for (const LoopbackRequest& request : vecNeverStarted)
+		{
+			CHECK(request.numCompletions == 0, "%s completed %d times but was never started", request.strPath.c_str(), request.numCompletions);
+		}
+
+		printf("  shutdown with %d requests in flight and %d not started %.1f ms\n", (int)vecInFlight.size(), (int)vecNeverStarted.size(), shutdownMS);
+
+		delete pHTTPManager;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS ///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+	int repeatCount = 1;
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		if (strcmp(argv[arg], "-repeat") == 0 && arg + 1 < argc)
+		{
+			repeatCount = std::max(1, atoi(argv[++arg]));
+		}
+	}
+
+	initMemoryManager();
+
+	WSADATA wsaData;
+	WSAStartup(MAKEWORD(2, 2), &wsaData);
+
+	// HTTPManager asserts that it is used from the thread the online services started on
+	NGMP_OnlineServicesManager::g_MainThreadID = std::this_thread::get_id();
+
+	LoopbackServer server;
+	if (!server.Start())
+	{
+		printf("Cannot listen on 127.0.0.1\n");
+		WSACleanup();
+		shutdownMemoryManager();
+		return 1;
+	}
+
+	for (int i = 0; i < repeatCount; ++i)
+	{
+		testBurst(server);
+		testWakeup(server);
+		testShutdown(server);
+	}
+
+	server.Stop();
+
+	WSACleanup();
+
+	printf("%s, %d failures\n", s_numFailures == 0 ? "passed" : "FAILED", s_numFailures);
+
+	shutdownMemoryManager();
+
+	return s_numFailures == 0 ? 0 : 1;
+}
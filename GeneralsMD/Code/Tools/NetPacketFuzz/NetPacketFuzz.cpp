@@ -0,0 +1,251 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: NetPacketFuzz.cpp ////////////////////////////////////////////////////
+// Feeds untrusted bytes to the NetPacket decoder the way a packet from a peer
+// reaches it: through NetPacket(TransportMessage*) and getCommandList, and
+// through ConstructNetCommandMsgFromRawData as a reassembled wrapped command
+// does. Every decoded command except game commands is then encoded again with
+// addCommand.
+//
+// Built with RTS_NETPACKET_LIBFUZZER it is a libFuzzer target. Otherwise it
+// is a standalone driver:
+//
+//   netpacketfuzz [-seed <n>] [-iterations <n>] [file ...]
+//
+// It decodes each given file as one packet, then decodes the given number of
+// generated packets. The generated packets are random streams of the header
+// fields and data of the packet format, so most of them get past the field
+// parser and into the command readers.
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// USER INCLUDES //////////////////////////////////////////////////////////////
+#include "Lib/BaseType.h"
+#include "Common/Debug.h"
+#include "Common/GameMemory.h"
+#include "GameNetwork/NetCommandList.h"
+#include "GameNetwork/NetCommandMsg.h"
+#include "GameNetwork/NetCommandRef.h"
+#include "GameNetwork/NetPacket.h"
+#include "GameNetwork/NetworkDefs.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC DATA ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+HINSTANCE ApplicationHInstance = NULL;
+
+/// just to satisfy the game libraries we link to
+HWND ApplicationHWnd = NULL;
+
+const char *gAppPrefix = "NF_";
+
+const Char *g_strFile = "data\\Generals.str";
+const Char *g_csfFile = "data\\%s\\Generals.csf";
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS //////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// encodeCommands =============================================================
+/** Encode the decoded commands again, as a relaying peer would. Returns the
+ number of commands in the list. */
+//=============================================================================
+static Int encodeCommands(NetCommandList *list)
+{
+	Int count = 0;
+	NetPacket *packet = newInstance(NetPacket);
+	for (NetCommandRef *ref = list->getFirstMessage(); ref != NULL; ref = ref->getNext())
+	{
+		++count;
+
+		// encoding a game command builds a GameMessage, which needs the player list.
+		if (ref->getCommand()->getNetCommandType() == NETCOMMANDTYPE_GAMECOMMAND)
+			continue;
+
+		if (!packet->addCommand(ref))
+		{
+			// full, continue in an empty packet
+			deleteInstance(packet);
+			packet = newInstance(NetPacket);
+			packet->addCommand(ref);
+		}
+	}
+	deleteInstance(packet);
+	return count;
+}
+
+// decodePacket ===============================================================
+/** Decode one packet through both read paths. Returns the number of commands
+ getCommandList produced. */
+//=============================================================================
+static Int decodePacket(const UnsignedByte *data, size_t size)
+{
+	if (size > MAX_PACKET_SIZE)
+		size = MAX_PACKET_SIZE;
+
+	TransportMessage message;
+	memset(&message, 0, sizeof(message));
+	memcpy(message.data, data, size);
+	message.length = (Int)size;
+
+	NetPacket *packet = newInstance(NetPacket)(&message);
+	NetCommandList *list = packet->getCommandList();
+	const Int count = encodeCommands(list);
+	deleteInstance(list);
+	deleteInstance(packet);
+
+	NetCommandRef *ref = NetPacket::ConstructNetCommandMsgFromRawData(message.data, (UnsignedInt)size);
+	deleteInstance(ref);
+
+	return count;
+}
+
+#if defined(RTS_NETPACKET_LIBFUZZER)
+
+extern "C" int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size)
+{
+	static Bool initialized = FALSE;
+	if (!initialized)
+	{
+		initMemoryManager();
+		initialized = TRUE;
+	}
+
+	decodePacket(data, size);
+	return 0;
+}
+
+#else
+
+static UnsignedInt s_seed = 1;
+
+static UnsignedInt nextRandom(void)
+{
+	s_seed = s_seed * 1664525 + 1013904223;
+	return s_seed >> 8;
+}
+
+// makePacket =================================================================
+/** Fill a packet with a random stream of header fields and data. Command types
+ include a few values past the last valid type. */
+//=============================================================================
+static Int makePacket(UnsignedByte *packet)
+{
+	static const UnsignedByte fields[] = { 'T', 'F', 'R', 'P', 'C', 'D', 'Z' };
+	const Int length = nextRandom() % (MAX_PACKET_SIZE + 1);
+	Int i = 0;
+
+	while (i < length)
+	{
+		const UnsignedByte field = fields[nextRandom() % ARRAY_SIZE(fields)];
+		packet[i++] = field;
+
+		Int valueSize = 0;
+		switch (field)
+		{
+			case 'T':
+				if (i < length)
+					packet[i++] = (UnsignedByte)(nextRandom() % (NETCOMMANDTYPE_DISCONNECTEND + 4));
+				break;
+			case 'F': valueSize = sizeof(UnsignedInt); break;
+			case 'R': valueSize = sizeof(UnsignedByte); break;
+			case 'P': valueSize = sizeof(UnsignedByte); break;
+			case 'C': valueSize = sizeof(UnsignedShort); break;
+			case 'D': valueSize = nextRandom() % 64; break;
+		}
+
+		for (Int j = 0; j < valueSize && i < length; ++j)
+		{
+			// small values keep counts and lengths inside the packet more often
+			const UnsignedInt r = nextRandom();
+			packet[i++] = (UnsignedByte)((r & 3) ? r % 8 : r >> 8);
+		}
+	}
+
+	return length;
+}
+
+static Bool readFile(const char *filename, UnsignedByte *buffer, size_t *size)
+{
+	FILE *fp = fopen(filename, "rb");
+	if (fp == NULL)
+		return FALSE;
+	*size = fread(buffer, 1, MAX_PACKET_SIZE, fp);
+	fclose(fp);
+	return TRUE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS ///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+	Int iterations = 100000;
+	Int fileCount = 0;
+	Int commandCount = 0;
+
+	initMemoryManager();
+
+	for (Int arg = 1; arg < argc; ++arg)
+	{
+		if (strcmp(argv[arg], "-seed") == 0 && arg + 1 < argc)
+		{
+			s_seed = (UnsignedInt)strtoul(argv[++arg], NULL, 10);
+			continue;
+		}
+		if (strcmp(argv[arg], "-iterations") == 0 && arg + 1 < argc)
+		{
+			iterations = atoi(argv[++arg]);
+			continue;
+		}
+
+		UnsignedByte buffer[MAX_PACKET_SIZE];
+		size_t size = 0;
+		if (!readFile(argv[arg], buffer, &size))
+		{
+			printf("Cannot read %s\n", argv[arg]);
+			continue;
+		}
+		commandCount += decodePacket(buffer, size);
+		++fileCount;
+	}
+
+	printf("seed %u\n", s_seed);
+
+	for (Int i = 0; i < iterations; ++i)
+	{
+		UnsignedByte buffer[MAX_PACKET_SIZE];
+		const Int size = makePacket(buffer);
+		commandCount += decodePacket(buffer, size);
+	}
+
+	printf("%d files and %d generated packets decoded, %d commands\n", fileCount, iterations, commandCount);
+
+	shutdownMemoryManager();
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,205 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: PartitionQueryCheck.cpp //////////////////////////////////////////////
+// Checks the visited-set of PartitionQueryContext against a std::set for
+// every visit of random PartitionData:
+//
+//   sequential  many queries one after another
+//   nested      queries that run further queries halfway through, deeper
+//               than there are context slots, so the fallback set is used
+//   threads     nested queries on several threads at once
+//
+// Usage: partitionquerycheck [-seed <n>]
+//
+// Returns 0 when every visit matched and 1 otherwise.
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+
+// USER INCLUDES //////////////////////////////////////////////////////////////
+#include "Lib/BaseType.h"
+#include "Common/GameMemory.h"
+#include "GameLogic/PartitionManager.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC DATA ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+HINSTANCE ApplicationHInstance = NULL;
+
+/// just to satisfy the game libraries we link to
+HWND ApplicationHWnd = NULL;
+
+const char *gAppPrefix = "PQ_";
+
+const Char *g_strFile = "data\\Generals.str";
+const Char *g_csfFile = "data\\%s\\Generals.csf";
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE DATA ///////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+enum { DATA_COUNT = 512, THREAD_COUNT = 4 };
+
+static PartitionData *s_data[DATA_COUNT];
+
+struct QueryRandom
+{
+	UnsignedInt seed;
+
+	UnsignedInt next()
+	{
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8;
+	}
+};
+
+struct ThreadParams
+{
+	QueryRandom random;
+	Int queryCount;
+	Int maxDepth;
+	Int failures;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS //////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// checkQuery =================================================================
+/** Visit random data, some of it more than once, through a new context and
+ compare every markVisited result with a std::set. Halfway through, a query
+ one level deeper runs, the way a filter that does its own query would.
+ Returns the number of mismatches of this query and the nested ones. */
+//=============================================================================
+static Int checkQuery(QueryRandom &random, Int depth, Int maxDepth)
+{
+	PartitionQueryContext context;
+	std::set<PartitionData*> visited;
+	Int failures = 0;
+
+	const Int visitCount = DATA_COUNT * 2;
+	for (Int i = 0; i < visitCount; ++i)
+	{
+		if (i == visitCount / 2 && depth < maxDepth)
+			failures += checkQuery(random, depth + 1, maxDepth);
+
+		PartitionData *data = s_data[random.next() % DATA_COUNT];
+		const Bool firstVisit = visited.insert(data).second;
+		if (context.markVisited(data) != firstVisit)
+			++failures;
+	}
+
+	return failures;
+}
+
+static Int checkQueries(QueryRandom &random, Int queryCount, Int maxDepth)
+{
+	Int failures = 0;
+	for (Int i = 0; i < queryCount; ++i)
+		failures += checkQuery(random, 0, maxDepth);
+	return failures;
+}
+
+static DWORD WINAPI checkQueriesThread(LPVOID param)
+{
+	ThreadParams *params = (ThreadParams *)param;
+	params->failures = checkQueries(params->random, params->queryCount, params->maxDepth);
+	return 0;
+}
+
+static void report(const char *name, Int failures, DWORD startTime)
+{
+	printf("%-12s %s, %d mismatches, %u ms\n", name, failures == 0 ? "ok" : "FAILED", failures, (UnsignedInt)(GetTickCount() - startTime));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS ///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+	QueryRandom random;
+	random.seed = 1;
+	for (Int arg = 1; arg < argc; ++arg)
+	{
+		if (strcmp(argv[arg], "-seed") == 0 && arg + 1 < argc)
+			random.seed = (UnsignedInt)strtoul(argv[++arg], NULL, 10);
+	}
+
+	printf("seed %u\n", random.seed);
+
+	initMemoryManager();
+
+	// PartitionData unregisters itself from the manager when it is deleted.
+	ThePartitionManager = NEW PartitionManager;
+
+	for (Int i = 0; i < DATA_COUNT; ++i)
+		s_data[i] = newInstance(PartitionData);
+
+	Int totalFailures = 0;
+	DWORD startTime;
+	Int failures;
+
+	startTime = GetTickCount();
+	failures = checkQueries(random, 10000, 0);
+	report("sequential", failures, startTime);
+	totalFailures += failures;
+
+	startTime = GetTickCount();
+	failures = checkQueries(random, 1000, PARTITION_QUERY_CONTEXT_SLOTS + 3);
+	report("nested", failures, startTime);
+	totalFailures += failures;
+
+	// together the threads need more contexts than there are slots.
+	startTime = GetTickCount();
+	ThreadParams params[THREAD_COUNT];
+	HANDLE threads[THREAD_COUNT];
+	for (Int t = 0; t < THREAD_COUNT; ++t)
+	{
+		params[t].random.seed = random.next();
+		params[t].queryCount = 1000;
+		params[t].maxDepth = 3;
+		params[t].failures = 0;
+		threads[t] = CreateThread(NULL, 0, checkQueriesThread, &params[t], 0, NULL);
+	}
+	WaitForMultipleObjects(THREAD_COUNT, threads, TRUE, INFINITE);
+	failures = 0;
+	for (Int t = 0; t < THREAD_COUNT; ++t)
+	{
+		CloseHandle(threads[t]);
+		failures += params[t].failures;
+	}
+	report("threads", failures, startTime);
+	totalFailures += failures;
+
+	for (Int i = 0; i < DATA_COUNT; ++i)
+		deleteInstance(s_data[i]);
+
+	delete ThePartitionManager;
+	ThePartitionManager = NULL;
+
+	shutdownMemoryManager();
+
+	return totalFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,221 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: ShadowBench.cpp //////////////////////////////////////////////////////
+// Loads every model of a game install from its .big archives and times the
+// volumetric shadow geometry build (welded vertices and polygon neighbors)
+// for each of them.
+//
+// Usage: shadowbench <install path> [repeat count]
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES ////////////////////////////////////////////////////////////
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// USER INCLUDES //////////////////////////////////////////////////////////////
+#include "Lib/BaseType.h"
+#include "Common/Debug.h"
+#include "Common/FileSystem.h"
+#include "Common/GameMemory.h"
+#include "Common/GlobalData.h"
+#include "Common/INI.h"
+#include "Common/NameKeyGenerator.h"
+#include "Common/SubsystemInterface.h"
+#include "Win32Device/Common/Win32BIGFileSystem.h"
+#include "Win32Device/Common/Win32LocalFileSystem.h"
+#include "W3DDevice/GameClient/W3DAssetManager.h"
+#include "W3DDevice/GameClient/W3DFileSystem.h"
+#include "W3DDevice/GameClient/W3DVolumetricShadow.h"
+#include "WW3D2/rendobj.h"
+#include "wwmath.h"
+
+// PRIVATE DATA ///////////////////////////////////////////////////////////////
+
+static SubsystemInterfaceList _TheSubsystemList;
+
+template<class SUBSYSTEM>
+void initSubsystem(SUBSYSTEM*& sysref, SUBSYSTEM* sys, const char* path1 = NULL, const char* path2 = NULL, const char* dirpath = NULL)
+{
+	sysref = sys;
+	_TheSubsystemList.initSubsystem(sys, path1, path2, dirpath, NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC DATA ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+HINSTANCE ApplicationHInstance = NULL;
+
+/// just to satisfy the game libraries we link to
+HWND ApplicationHWnd = NULL;
+
+const char *gAppPrefix = "SB_";
+
+const Char *g_strFile = "data\\Generals.str";
+const Char *g_csfFile = "data\\%s\\Generals.csf";
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS //////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+static double getSeconds(const LARGE_INTEGER &start, const LARGE_INTEGER &end)
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return (double)(end.QuadPart - start.QuadPart) / (double)frequency.QuadPart;
+}
+
+// benchmarkModels ============================================================
+/** Build the shadow geometry of every model in Art\W3D repeatCount times and
+ print the average build time per model and in total. */
+//=============================================================================
+static void benchmarkModels(WW3DAssetManager *assetManager, Int repeatCount)
+{
+	FilenameList filenameList;
+	TheFileSystem->getFileListInDirectory("Art\\W3D\\", "*.w3d", filenameList, FALSE);
+
+	Int modelCount = 0;
+	Int totalPolygonCount = 0;
+	double totalSeconds = 0.0;
+	double slowestSeconds = 0.0;
+	AsciiString slowestModel;
+
+	printf("%-32s %8s %10s %12s\n", "model", "meshes", "polygons", "build ms");
+
+	for (FilenameListIter it = filenameList.begin(); it != filenameList.end(); ++it)
+	{
+		// the asset manager wants the model name without directory and extension.
+		AsciiString modelName = *it;
+		const char *fileName = strrchr(modelName.str(), '\\');
+		modelName = fileName ? fileName + 1 : modelName.str();
+		modelName.truncateBy(4);
+
+		RenderObjClass *robj = assetManager->Create_Render_Obj(modelName.str());
+		if (robj == NULL)
+			continue;	// hierarchy or animation only
+
+		Int meshCount = 0;
+		Int polygonCount = 0;
+		LARGE_INTEGER start, end;
+		QueryPerformanceCounter(&start);
+		for (Int i = 0; i < repeatCount; ++i)
+		{
+			meshCount = W3DVolumetricShadowManager::buildShadowGeometry(robj, &polygonCount);
+		}
+		QueryPerformanceCounter(&end);
+
+		robj->Release_Ref();
+
+		if (meshCount == 0)
+			continue;	// does not cast a volumetric shadow
+
+		const double seconds = getSeconds(start, end) / repeatCount;
+		printf("%-32s %8d %10d %12.3f\n", modelName.str(), meshCount, polygonCount, seconds * 1000.0);
+
+		++modelCount;
+		totalPolygonCount += polygonCount;
+		totalSeconds += seconds;
+		if (seconds > slowestSeconds)
+		{
+			slowestSeconds = seconds;
+			slowestModel = modelName;
+		}
+	}
+
+	printf("\n%d shadow casters, %d polygons, %.3f ms total", modelCount, totalPolygonCount, totalSeconds * 1000.0);
+	if (modelCount != 0)
+		printf(", slowest %s at %.3f ms", slowestModel.str(), slowestSeconds * 1000.0);
+	printf("\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS ///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: shadowbench <install path> [repeat count]\n");
+		return 1;
+	}
+
+	Int repeatCount = argc > 2 ? atoi(argv[2]) : 1;
+	if (repeatCount < 1)
+		repeatCount = 1;
+
+	// the file systems load the .big archives from the current directory.
+	if (!::SetCurrentDirectory(argv[1]))
+	{
+		printf("Cannot open install path %s\n", argv[1]);
+		return 1;
+	}
+
+	initMemoryManager();
+
+	try
+	{
+
+	TheNameKeyGenerator = new NameKeyGenerator;
+	TheNameKeyGenerator->init();
+
+	TheFileSystem = new FileSystem;
+
+	initSubsystem(TheLocalFileSystem, (LocalFileSystem*)new Win32LocalFileSystem);
+	initSubsystem(TheArchiveFileSystem, (ArchiveFileSystem*)new Win32BIGFileSystem);
+	INI ini;
+	initSubsystem(TheWritableGlobalData, new GlobalData(), "Data\\INI\\Default\\GameData.ini", "Data\\INI\\GameData.ini");
+
+	_TheSubsystemList.postProcessLoadAll();
+
+	// set up W3D the way W3DDisplay does it in headless mode, there is no device.
+	TheWritableGlobalData->m_headless = TRUE;
+
+	TheW3DFileSystem = NEW W3DFileSystem;
+	WWMath::Init();
+
+	W3DAssetManager *assetManager = NEW W3DAssetManager;
+	assetManager->Set_WW3D_Load_On_Demand( true );
+
+	benchmarkModels(assetManager, repeatCount);
+
+	assetManager->Free_Assets();
+	delete assetManager;
+	WWMath::Shutdown();
+	delete TheW3DFileSystem;
+	TheW3DFileSystem = NULL;
+
+	_TheSubsystemList.shutdownAll();
+
+	delete TheFileSystem;
+	TheFileSystem = NULL;
+
+	delete TheNameKeyGenerator;
+	TheNameKeyGenerator = NULL;
+
+	}
+	catch (...)
+	{
+		DEBUG_CRASH(("ShadowBench failed"));
+	}
+
+	shutdownMemoryManager();
+
+	return 0;
+}
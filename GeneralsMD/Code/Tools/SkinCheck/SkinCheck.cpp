@@ -0,0 +1,354 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: SkinCheck.cpp ////////////////////////////////////////////////////////
+// Reads the skin meshes of W3D files, loose or inside .big archives, and runs
+// VectorProcessorClass::Transform_Skinned on them with and without the SSE or
+// AVX2 path. Reports any vertex or normal that differs and the time of both paths.
+//
+// The bone transforms are made up, one fixed pseudo random rigid transform per
+// bone, because the hierarchies are not needed to compare the two paths.
+//
+// Usage: skincheck <.w3d file | .big file | directory> [repeat count]
+// Returns 0 when both paths agree on every skin, 1 otherwise.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "RAMFILE.h"
+#include "chunkio.h"
+#include "cpudetect.h"
+#include "matrix3d.h"
+#include "vector3.h"
+#include "vp.h"
+#include "w3d_file.h"
+
+struct SkinMesh
+{
+	std::string Name;
+	std::vector<Vector3> Verts;
+	std::vector<Vector3> Norms;
+	std::vector<unsigned short> BoneLinks;
+};
+
+struct CheckTotals
+{
+	CheckTotals() : Skins(0), Vertices(0), Mismatches(0), ScalarSeconds(0.0), DispatchSeconds(0.0) {}
+
+	int Skins;
+	int Vertices;
+	int Mismatches;
+	double ScalarSeconds;
+	double DispatchSeconds;
+};
+
+static int RepeatCount = 1;
+static CheckTotals Totals;
+
+static double Get_Seconds(const LARGE_INTEGER &start, const LARGE_INTEGER &end)
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return (double)(end.QuadPart - start.QuadPart) / (double)frequency.QuadPart;
+}
+
+static bool Has_Extension(const char *name, const char *ext)
+{
+	const size_t len = strlen(name);
+	const size_t extlen = strlen(ext);
+	return len >= extlen && _stricmp(name + len - extlen, ext) == 0;
+}
+
+static bool Read_File(const char *filename, std::vector<char> &data)
+{
+	FILE *fp = fopen(filename, "rb");
+	if (fp == NULL) {
+		return false;
+	}
+	fseek(fp, 0, SEEK_END);
+	const long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	data.resize(size > 0 ? size : 0);
+	const bool ok = size > 0 && fread(&data[0], 1, size, fp) == (size_t)size;
+	fclose(fp);
+	return ok;
+}
+
+/*
+** One fixed rigid transform per bone, the same for every mesh so runs are repeatable.
+*/
+static void Make_Bone_Transforms(std::vector<Matrix3D> &bone_tms, int bone_count)
+{
+	unsigned int seed = 12345;
+	bone_tms.resize(bone_count);
+	for (int i = 0; i < bone_count; i++) {
+		float values[6];
+		for (int j = 0; j < 6; j++) {
+			seed = seed * 1664525 + 1013904223;
+			values[j] = (float)(seed >> 8) / (float)(1 << 24) * 2.0f - 1.0f;
+		}
+		Matrix3D tm(true);
+		tm.Rotate_X(values[0] * 3.14159f);
+		tm.Rotate_Y(values[1] * 3.14159f);
+		tm.Rotate_Z(values[2] * 3.14159f);
+		tm.Set_Translation(Vector3(values[3] * 50.0f, values[4] * 50.0f, values[5] * 50.0f));
+		bone_tms[i] = tm;
+	}
+}
+
+static int Count_Mismatches(const std::vector<Vector3> &a, const std::vector<Vector3> &b)
+{
+	int mismatches = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		if (memcmp(&a[i], &b[i], sizeof(Vector3)) != 0) {
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+static void Check_Skin(const SkinMesh &skin)
+{
+	const int count = (int)skin.Verts.size();
+	int bone_count = 0;
+	for (int i = 0; i < count; i++) {
+		if (skin.BoneLinks[i] >= bone_count) {
+			bone_count = skin.BoneLinks[i] + 1;
+		}
+	}
+
+	std::vector<Matrix3D> bone_tms;
+	Make_Bone_Transforms(bone_tms, bone_count);
+
+	std::vector<Vector3> scalar_vert(count), scalar_norm(count);
+	std::vector<Vector3> dispatch_vert(count), dispatch_norm(count);
+	LARGE_INTEGER start, end;
+
+	QueryPerformanceCounter(&start);
+	for (int r = 0; r < RepeatCount; r++) {
+		VectorProcessorClass::Transform_Skinned_Scalar(&scalar_vert[0], &scalar_norm[0], &skin.Verts[0], &skin.Norms[0],
+			&skin.BoneLinks[0], &bone_tms[0], sizeof(Matrix3D), count);
+	}
+	QueryPerformanceCounter(&end);
+	const double scalar_seconds = Get_Seconds(start, end) / RepeatCount;
+
+	QueryPerformanceCounter(&start);
+	for (int r = 0; r < RepeatCount; r++) {
+		VectorProcessorClass::Transform_Skinned(&dispatch_vert[0], &dispatch_norm[0], &skin.Verts[0], &skin.Norms[0],
+			&skin.BoneLinks[0], &bone_tms[0], sizeof(Matrix3D), count);
+	}
+	QueryPerformanceCounter(&end);
+	const double dispatch_seconds = Get_Seconds(start, end) / RepeatCount;
+
+	const int mismatches = Count_Mismatches(scalar_vert, dispatch_vert) + Count_Mismatches(scalar_norm, dispatch_norm);
+	if (mismatches != 0) {
+		printf("%s: %d of %d vertices and normals differ\n", skin.Name.c_str(), mismatches, count * 2);
+	}
+
+	Totals.Skins++;
+	Totals.Vertices += count;
+	Totals.Mismatches += mismatches;
+	Totals.ScalarSeconds += scalar_seconds;
+	Totals.DispatchSeconds += dispatch_seconds;
+}
+
+/*
+** Reads the vertices, normals and bone links of a mesh chunk. Returns false for anything but a skin.
+*/
+static bool Load_Skin(ChunkLoadClass &cload, const char *filename, SkinMesh &skin)
+{
+	W3dMeshHeader3Struct header;
+	bool has_header = false;
+
+	while (cload.Open_Chunk()) {
+		const uint32 length = cload.Cur_Chunk_Length();
+		switch (cload.Cur_Chunk_ID()) {
+			case W3D_CHUNK_MESH_HEADER3:
+				has_header = cload.Read(&header, sizeof(header)) == sizeof(header);
+				break;
+
+			case W3D_CHUNK_VERTICES:
+				skin.Verts.resize(length / sizeof(W3dVectorStruct));
+				if (!skin.Verts.empty()) {
+					cload.Read(&skin.Verts[0], skin.Verts.size() * sizeof(W3dVectorStruct));
+				}
+				break;
+
+			case W3D_CHUNK_VERTEX_NORMALS:
+				skin.Norms.resize(length / sizeof(W3dVectorStruct));
+				if (!skin.Norms.empty()) {
+					cload.Read(&skin.Norms[0], skin.Norms.size() * sizeof(W3dVectorStruct));
+				}
+				break;
+
+			case W3D_CHUNK_VERTEX_INFLUENCES:
+			{
+				W3dVertInfStruct influence;
+				skin.BoneLinks.resize(length / sizeof(W3dVertInfStruct));
+				for (size_t i = 0; i < skin.BoneLinks.size(); i++) {
+					cload.Read(&influence, sizeof(influence));
+					skin.BoneLinks[i] = influence.BoneIdx;
+				}
+				break;
+			}
+		}
+		cload.Close_Chunk();
+	}
+
+	if (!has_header || (header.Attributes & W3D_MESH_FLAG_GEOMETRY_TYPE_MASK) != W3D_MESH_FLAG_GEOMETRY_TYPE_SKIN) {
+		return false;
+	}
+
+	const size_t count = skin.Verts.size();
+	if (count == 0 || skin.Norms.size() != count || skin.BoneLinks.size() != count) {
+		printf("%s: skipping skin with mismatched vertex arrays\n", filename);
+		return false;
+	}
+
+	char name[2 * W3D_NAME_LEN + 2];
+	_snprintf(name, sizeof(name), "%.*s.%.*s", W3D_NAME_LEN, header.ContainerName, W3D_NAME_LEN, header.MeshName);
+	name[sizeof(name) - 1] = 0;
+	skin.Name = name;
+	return true;
+}
+
+static void Check_W3D(const char *filename, std::vector<char> &data)
+{
+	RAMFileClass file(&data[0], (int)data.size());
+	file.Open();
+	ChunkLoadClass cload(&file);
+
+	while (cload.Open_Chunk()) {
+		if (cload.Cur_Chunk_ID() == W3D_CHUNK_MESH) {
+			SkinMesh skin;
+			if (Load_Skin(cload, filename, skin)) {
+				Check_Skin(skin);
+			}
+		}
+		cload.Close_Chunk();
+	}
+
+	file.Close();
+}
+
+static unsigned int Read_Big_Endian(const char *p)
+{
+	const unsigned char *b = (const unsigned char *)p;
+	return (b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+}
+
+/*
+** Walks the directory of a .big archive the same way Win32BIGFileSystem does and checks each .w3d in it.
+*/
+static void Check_Big(const char *filename)
+{
+	std::vector<char> archive;
+	if (!Read_File(filename, archive) || archive.size() < 16 || memcmp(&archive[0], "BIG", 3) != 0) {
+		printf("%s: not a BIG archive\n", filename);
+		return;
+	}
+
+	const unsigned int file_count = Read_Big_Endian(&archive[8]);
+	size_t pos = 0x10;
+	for (unsigned int i = 0; i < file_count; i++) {
+		if (pos + 8 > archive.size()) {
+			break;
+		}
+		const unsigned int offset = Read_Big_Endian(&archive[pos]);
+		const unsigned int size = Read_Big_Endian(&archive[pos + 4]);
+		const char *name = &archive[pos + 8];
+		const char *name_end = (const char *)memchr(name, 0, archive.size() - pos - 8);
+		if (name_end == NULL) {
+			break;
+		}
+		pos = name_end - &archive[0] + 1;
+
+		if (!Has_Extension(name, ".w3d") || size == 0 || offset > archive.size() || size > archive.size() - offset) {
+			continue;
+		}
+		std::vector<char> data(archive.begin() + offset, archive.begin() + offset + size);
+		Check_W3D(name, data);
+	}
+}
+
+static void Check_Path(const char *path)
+{
+	if (Has_Extension(path, ".big")) {
+		Check_Big(path);
+		return;
+	}
+	if (Has_Extension(path, ".w3d")) {
+		std::vector<char> data;
+		if (Read_File(path, data)) {
+			Check_W3D(path, data);
+		} else {
+			printf("%s: cannot read file\n", path);
+		}
+		return;
+	}
+
+	// a directory, check every archive and model in it
+	static const char *const masks[] = { "*.big", "*.w3d" };
+	for (int m = 0; m < 2; m++) {
+		std::string search = std::string(path) + "\\" + masks[m];
+		WIN32_FIND_DATA find_data;
+		HANDLE handle = FindFirstFile(search.c_str(), &find_data);
+		if (handle == INVALID_HANDLE_VALUE) {
+			continue;
+		}
+		do {
+			Check_Path((std::string(path) + "\\" + find_data.cFileName).c_str());
+		} while (FindNextFile(handle, &find_data));
+		FindClose(handle);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		printf("Usage: skincheck <.w3d file | .big file | directory> [repeat count]\n");
+		return 1;
+	}
+
+	if (argc > 2) {
+		RepeatCount = atoi(argv[2]);
+		if (RepeatCount < 1) {
+			RepeatCount = 1;
+		}
+	}
+
+	if (CPUDetectClass::Has_AVX2_Instruction_Set()) {
+		printf("Transform_Skinned runs the AVX2 code.\n");
+	} else if (CPUDetectClass::Has_SSE_Instruction_Set()) {
+		printf("Transform_Skinned runs the SSE code.\n");
+	} else {
+		printf("This CPU has no SSE, both paths run the scalar code.\n");
+	}
+
+	Check_Path(argv[1]);
+
+	printf("%d skins, %d vertices, %d differences\n", Totals.Skins, Totals.Vertices, Totals.Mismatches);
+	printf("scalar %.3f ms, Transform_Skinned %.3f ms\n", Totals.ScalarSeconds * 1000.0, Totals.DispatchSeconds * 1000.0);
+
+	return Totals.Mismatches == 0 ? 0 : 1;
+}
@@ -9,6 +9,7 @@ endif()
 # Memory pool features
 option(RTS_MEMORYPOOL_OVERRIDE_MALLOC "Enables the Dynamic Memory Allocator for malloc calls." OFF)
 option(RTS_MEMORYPOOL_MPSB_DLINK "Adds a backlink to MemoryPoolSingleBlock. Makes it faster to free raw DMA blocks, but increases memory consumption." ON)
+option(RTS_MEMORYPOOL_MAGAZINES "Adds per-thread caches of free blocks in front of each Memory Pool to avoid taking the pool lock on most allocations. Not used with Memory Pool debug." OFF)
 
 # Memory pool debugs
 option(RTS_MEMORYPOOL_DEBUG "Enables Memory Pool debug." ON)
@@ -26,6 +27,7 @@ add_feature_info(GameMemoryEnable RTS_GAMEMEMORY_ENABLE "Build with the original
 # Memory pool features
 add_feature_info(MemoryPoolOverrideMalloc RTS_MEMORYPOOL_OVERRIDE_MALLOC "Build with Memory Pool malloc")
 add_feature_info(MemoryPoolMpsbDlink RTS_MEMORYPOOL_MPSB_DLINK "Build with Memory Pool backlink")
+add_feature_info(MemoryPoolMagazines RTS_MEMORYPOOL_MAGAZINES "Build with Memory Pool per-thread magazines")
 
 # Memory pool debugs
 add_feature_info(MemoryPoolDebug RTS_MEMORYPOOL_DEBUG "Build with Memory Pool debug")
@@ -52,6 +54,10 @@ if(NOT RTS_MEMORYPOOL_MPSB_DLINK)
     target_compile_definitions(core_config INTERFACE DISABLE_MEMORYPOOL_MPSB_DLINK=1)
 endif()
 
+if(RTS_MEMORYPOOL_MAGAZINES)
+    target_compile_definitions(core_config INTERFACE MEMORYPOOL_MAGAZINES=1)
+endif()
+
 # Memory pool debugs
 if(NOT RTS_MEMORYPOOL_DEBUG)
     target_compile_definitions(core_config INTERFACE DISABLE_MEMORYPOOL_DEBUG=1)